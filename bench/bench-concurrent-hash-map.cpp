@@ -0,0 +1,84 @@
+#ifndef BENCH_BENCH_CONCURRENT_HASH_MAP
+#define BENCH_BENCH_CONCURRENT_HASH_MAP
+
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/concurrent_hash_map.hpp"
+#include "../src/multimap.hpp"
+
+// 以互斥锁保护的 multimap 作为对照，接口与 concurrent_hash_map 相同
+class bench_locked_multimap {
+  private:
+    tstl::multimap<int, long long> m_map;
+    std::mutex m_lock;
+
+  public:
+    bool find(int key, long long &out) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+    void insert_or_assign(int key, long long value) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            m_map.emplace(key, value);
+        } else {
+            it->second = value;
+        }
+    }
+};
+
+// threads 个线程共执行 ops 次操作，其中九成为查找、一成为写入
+template <class Map>
+void bench_cache_mix(const std::string &name, Map &mp, int threads, int ops, int keys) {
+    bench_run((name + " x" + std::to_string(threads)).c_str(), 3, [&] {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937 gen(t);
+                long long sum = 0;
+                for (int i = 0; i < ops / threads; ++i) {
+                    int key = static_cast<int>(gen() % keys);
+                    if (i % 10 == 0) {
+                        mp.insert_or_assign(key, static_cast<long long>(i));
+                    } else {
+                        long long v = 0;
+                        mp.find(key, v);
+                        sum += v;
+                    }
+                }
+                bench_keep(sum);
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+    });
+}
+
+void bench_concurrent_hash_map() {
+    const int keys = 1000000;
+    const int ops = 4000000;
+    tstl::concurrent_hash_map<int, long long> cmp;
+    bench_locked_multimap lmp;
+    for (int k = 0; k < keys; k += 2) {
+        cmp.insert_or_assign(k, k);
+        lmp.insert_or_assign(k, k);
+    }
+    for (int threads : {1, 4, 32}) {
+        bench_cache_mix("tstl::concurrent_hash_map", cmp, threads, ops, keys);
+        bench_cache_mix("mutex + tstl::multimap", lmp, threads, ops, keys);
+    }
+}
+
+#endif
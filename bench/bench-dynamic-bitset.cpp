@@ -0,0 +1,74 @@
+#ifndef BENCH_BENCH_DYNAMIC_BITSET
+#define BENCH_BENCH_DYNAMIC_BITSET
+
+#include <cstdint>
+#include <cstdio>
+
+#include "../src/dynamic_bitset.hpp"
+#include "../src/vector.hpp"
+
+void bench_dynamic_bitset() {
+    // 5000 万行上的两个过滤条件，约 1/3 与 1/2 的行命中
+    const std::size_t n = 50000000;
+    tstl::vector<unsigned char> fa(n);
+    tstl::vector<unsigned char> fb(n);
+    tstl::dynamic_bitset ba(n);
+    tstl::dynamic_bitset bb(n);
+    std::uint64_t x = 88172645463325252ull;
+    for (std::size_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        fa[i] = x % 3 == 0;
+        fb[i] = (x >> 8) % 2 == 0;
+        ba.set(i, fa[i] != 0);
+        bb.set(i, fb[i] != 0);
+    }
+#ifdef TSTL_BITSET_AVX2
+    std::printf("filter intersection over %zu rows (AVX2)\n", n);
+#else
+    std::printf("filter intersection over %zu rows\n", n);
+#endif
+
+    tstl::vector<unsigned char> fr(n);
+    bench_run("  byte flags a & b", 5, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            fr[i] = fa[i] & fb[i];
+        }
+        bench_keep(fr[n / 2]);
+    });
+    tstl::dynamic_bitset br(n);
+    bench_run("  dynamic_bitset assign_and", 5, [&] {
+        br.assign_and(ba, bb);
+        bench_keep(br.data()[0]);
+    });
+
+    bench_run("  byte flags count(a & b)", 5, [&] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            count += fa[i] & fb[i];
+        }
+        bench_keep(count);
+    });
+    bench_run("  dynamic_bitset and_count", 5, [&] { bench_keep(and_count(ba, bb)); });
+
+    bench_run("  byte flags collect rows of a & b", 3, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (fa[i] & fb[i]) {
+                sum += i;
+            }
+        }
+        bench_keep(sum);
+    });
+    bench_run("  dynamic_bitset for_each_one", 3, [&] {
+        std::size_t sum = 0;
+        br.for_each_one([&sum](std::size_t i) { sum += i; });
+        bench_keep(sum);
+    });
+
+    std::printf("%-40s %10.2f MB\n", "  byte flags", fa.memory_usage().total() / 1048576.0);
+    std::printf("%-40s %10.2f MB\n", "  dynamic_bitset", ba.memory_usage().total() / 1048576.0);
+}
+
+#endif
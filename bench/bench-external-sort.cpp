@@ -0,0 +1,45 @@
+#ifndef BENCH_BENCH_EXTERNAL_SORT
+#define BENCH_BENCH_EXTERNAL_SORT
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "../src/external_sort.hpp"
+#include "../src/vector.hpp"
+
+void bench_external_sort() {
+    const char *in = "/tmp/tstl_bench_external_sort_in.bin";
+    const char *out = "/tmp/tstl_bench_external_sort_out.bin";
+    const std::size_t n = std::size_t(32) << 20; // 256 MiB
+    tstl::vector<std::uint64_t> data;
+    data.reserve(n);
+    std::mt19937_64 gen(43);
+    for (std::size_t i = 0; i < n; ++i) {
+        data.push_back(gen());
+    }
+    std::FILE *f = std::fopen(in, "wb");
+    std::fwrite(data.data(), sizeof(std::uint64_t), n, f);
+    std::fclose(f);
+
+    bench_run("tstl::sort in memory (256 MiB)", 1, [&] {
+        tstl::vector<std::uint64_t> copy(data);
+        tstl::sort(copy.begin(), copy.end());
+        bench_keep(copy[n / 2]);
+    });
+    tstl::vector<std::uint64_t>().swap(data);
+
+    // 内存预算为数据量的 1/8 与 1/64，后者需要多轮归并
+    bench_run("external_sort_file 32 MiB budget", 1, [&] {
+        tstl::external_sort_file<std::uint64_t>(in, out, std::less<std::uint64_t>(),
+                                                std::size_t(32) << 20);
+    });
+    bench_run("external_sort_file 4 MiB budget", 1, [&] {
+        tstl::external_sort_file<std::uint64_t>(in, out, std::less<std::uint64_t>(),
+                                                std::size_t(4) << 20);
+    });
+    std::remove(in);
+    std::remove(out);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BENCH_BENCH_GROUPED_MULTIMAP
+#define BENCH_BENCH_GROUPED_MULTIMAP
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../src/grouped_multimap.hpp"
+#include "../src/multimap.hpp"
+
+// 按 Zipf 分布生成 n 个取值于 [0, keys) 的键值，s 越大越集中
+std::vector<int> bench_zipf_keys(int n, int keys, double s) {
+    std::vector<double> weights(keys);
+    for (int k = 0; k < keys; ++k) {
+        weights[k] = 1.0 / std::pow(k + 1, s);
+    }
+    std::discrete_distribution<int> dist(weights.begin(), weights.end());
+    std::mt19937 gen(5);
+    std::vector<int> result(n);
+    for (auto &k : result) {
+        k = dist(gen);
+    }
+    return result;
+}
+
+template <class Map>
+void bench_grouped_insert(const char *name, const std::vector<int> &keys) {
+    std::size_t before = bench_live_bytes.load(std::memory_order_relaxed);
+    std::size_t bytes = 0;
+    bench_run(
+        name, 5, [] { return Map(); },
+        [&](Map &mp) {
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                mp.emplace(keys[i], static_cast<int>(i));
+            }
+            bytes = bench_live_bytes.load(std::memory_order_relaxed) - before;
+        });
+    std::printf("%-40s %10.2f MB\n", "  live memory", bytes / 1048576.0);
+}
+
+void bench_grouped_multimap() {
+    const int n = 1000000;
+    const double skews[] = {0.8, 1.2};
+    for (double s : skews) {
+        auto keys = bench_zipf_keys(n, 100000, s);
+        std::printf("1M inserts, 100K keys, zipf s = %.1f\n", s);
+        bench_grouped_insert<tstl::multimap<int, int>>("tstl::multimap emplace", keys);
+        bench_grouped_insert<tstl::grouped_multimap<int, int>>("tstl::grouped_multimap emplace",
+                                                               keys);
+    }
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef BENCH_BENCH_MAPPED_VECTOR
+#define BENCH_BENCH_MAPPED_VECTOR
+
+#include <cstdint>
+#include <cstdio>
+
+#include "../src/mapped_vector.hpp"
+#include "../src/vector.hpp"
+
+// 模拟启动时加载查找表：逐个读出元素放入 vector，与直接映射文件相比较
+void bench_mapped_vector() {
+    const char *path = "/tmp/tstl_bench_mapped_vector.bin";
+    const std::size_t n = std::size_t(16) << 20;
+    {
+        using mvec = tstl::mapped_vector<std::uint64_t>;
+        mvec out(path, mvec::read_write);
+        out.clear();
+        out.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            out.push_back(i * 2654435761u);
+        }
+    }
+
+    bench_run("vector element-wise load", 3, [&] {
+        std::FILE *file = std::fopen(path, "rb");
+        std::fseek(file, static_cast<long>(tstl::_mapped_vector_header::data_offset), SEEK_SET);
+        tstl::vector<std::uint64_t> vec;
+        std::uint64_t x;
+        while (std::fread(&x, sizeof(x), 1, file) == 1) {
+            vec.push_back(x);
+        }
+        std::fclose(file);
+        bench_keep(vec[n / 2]);
+    });
+
+    bench_run("mapped_vector open", 3, [&] {
+        const tstl::mapped_vector<std::uint64_t> vec(path);
+        bench_keep(vec[n / 2]);
+    });
+
+    // 映射后完整扫描一遍，包含建立页表的开销
+    bench_run("mapped_vector open + scan", 3, [&] {
+        const tstl::mapped_vector<std::uint64_t> vec(path);
+        std::uint64_t sum = 0;
+        for (std::uint64_t x : vec) {
+            sum += x;
+        }
+        bench_keep(sum);
+    });
+
+    std::remove(path);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef BENCH_BENCH_MMAP_ALLOCATOR
+#define BENCH_BENCH_MMAP_ALLOCATOR
+
+#include <cstdint>
+
+#include "../src/memory/mmap_allocator.hpp"
+#include "../src/vector.hpp"
+
+// 逐个 push_back 到 n 个元素：std::allocator 每次扩容都要复制，mmap_allocator 借助 mremap 调整
+template <class Vector>
+void bench_mmap_growth(const char *name, std::size_t n) {
+    bench_run(name, 3, [&] {
+        Vector vec;
+        for (std::size_t i = 0; i < n; ++i) {
+            vec.push_back(i);
+        }
+        bench_keep(vec.back());
+    });
+}
+
+// 在大数组上随机读取，几乎每次访问都落在不同的页上，耗时主要取决于 TLB 缺失
+template <class Vector>
+void bench_mmap_gather(const char *name, std::size_t n, std::size_t reads) {
+    Vector vec;
+    vec.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(i * 2654435761u);
+    }
+    bench_run(name, 3, [&] {
+        std::uint64_t sum = 0;
+        std::uint64_t state = 88172645463325252ull;
+        for (std::size_t i = 0; i < reads; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            sum += vec[state % n];
+        }
+        bench_keep(sum);
+    });
+}
+
+// 分配后首次写入整段存储；Populate 把缺页的开销移到分配时并批量完成
+template <class Alloc>
+void bench_mmap_first_touch(const char *name, std::size_t n) {
+    bench_run(name, 3, [&] {
+        Alloc alloc;
+        std::uint64_t *p = alloc.allocate(n);
+        for (std::size_t i = 0; i < n; i += 512) {
+            p[i] = i;
+        }
+        bench_keep(p[n / 2]);
+        alloc.deallocate(p, n);
+    });
+}
+
+void bench_mmap_allocator() {
+    // 256 MiB 的数据，远超 TLB 以 4 KiB 页能覆盖的范围
+    const std::size_t n = std::size_t(32) << 20;
+    using std_vector = tstl::vector<std::uint64_t>;
+    using mmap_vector = tstl::vector<std::uint64_t, tstl::mmap_allocator<std::uint64_t>>;
+
+    bench_mmap_growth<std_vector>("vector std::allocator growth", n);
+    bench_mmap_growth<mmap_vector>("vector mmap_allocator growth", n);
+
+    bench_mmap_gather<std_vector>("std::allocator random gather", n, 20000000);
+    bench_mmap_gather<mmap_vector>("mmap_allocator random gather", n, 20000000);
+
+    bench_mmap_first_touch<std::allocator<std::uint64_t>>("std::allocator first touch", n);
+    bench_mmap_first_touch<tstl::mmap_allocator<std::uint64_t>>("mmap_allocator first touch", n);
+    bench_mmap_first_touch<tstl::mmap_allocator<std::uint64_t, true>>(
+        "mmap_allocator<Populate> first touch", n);
+}
+
+#endif
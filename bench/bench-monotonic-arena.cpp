@@ -0,0 +1,66 @@
+#ifndef BENCH_BENCH_MONOTONIC_ARENA
+#define BENCH_BENCH_MONOTONIC_ARENA
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/memory/monotonic_arena.hpp"
+#include "../src/multimap.hpp"
+#include "../src/vector.hpp"
+
+// 模拟按请求构建、用完即丢的临时容器：每个请求构建几个小容器，处理完整体销毁
+template <class Alloc, class MakeAlloc, class EndRequest>
+long long bench_request_scoped(const std::vector<int> &keys, int requests, int per_request,
+                               MakeAlloc make_alloc, EndRequest end_request) {
+    using traits = std::allocator_traits<Alloc>;
+    using int_alloc = typename traits::template rebind_alloc<int>;
+    using pair_alloc = typename traits::template rebind_alloc<std::pair<const int, int>>;
+
+    long long sum = 0;
+    std::size_t pos = 0;
+    for (int r = 0; r < requests; ++r) {
+        {
+            tstl::vector<int, int_alloc> vec{int_alloc(make_alloc())};
+            tstl::deque<int, int_alloc> deq{int_alloc(make_alloc())};
+            tstl::list<int, int_alloc> lst{int_alloc(make_alloc())};
+            tstl::multimap<int, int, std::less<int>, pair_alloc> mp{pair_alloc(make_alloc())};
+            for (int i = 0; i < per_request; ++i) {
+                int key = keys[pos++ % keys.size()];
+                vec.push_back(key);
+                deq.push_back(key);
+                lst.push_back(key);
+                mp.emplace(key, i);
+            }
+            sum += vec.back() + deq.front() + lst.front() + mp.begin()->second;
+        }
+        end_request();
+    }
+    return sum;
+}
+
+void bench_monotonic_arena() {
+    std::mt19937 gen(36);
+    std::vector<int> keys(1 << 16);
+    for (auto &key : keys) {
+        key = static_cast<int>(gen());
+    }
+
+    const int requests = 20000;
+    const int per_request = 64;
+    bench_run("std::allocator request-scoped", 5, [&] {
+        bench_keep(bench_request_scoped<std::allocator<int>>(
+            keys, requests, per_request, [] { return std::allocator<int>(); }, [] {}));
+    });
+
+    tstl::monotonic_arena arena;
+    bench_run("arena_allocator request-scoped", 5, [&] {
+        bench_keep(bench_request_scoped<tstl::arena_allocator<int>>(
+            keys, requests, per_request, [&] { return tstl::arena_allocator<int>(arena); },
+            [&] { arena.reset(); }));
+    });
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef BENCH_BENCH_MULTIMAP
+#define BENCH_BENCH_MULTIMAP
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../src/multimap.hpp"
+
+// 大树的复制与清空，与 std::multimap 对照
+template <class Map>
+void bench_multimap_copy_clear(const char *copy_name, const char *clear_name, int n) {
+    std::mt19937 gen(42);
+    Map src;
+    for (int i = 0; i < n; ++i) {
+        src.emplace(static_cast<int>(gen()), i);
+    }
+    bench_run(copy_name, 10, [&] {
+        Map dst(src);
+        bench_keep(dst);
+    });
+    bench_run(
+        clear_name, 10, [&] { return Map(src); }, [](Map &dst) { dst.clear(); });
+}
+
+// 两棵大树的合并：逐个插入的 merge 与基于 join 的 union_with
+void bench_multimap_union(int n, int m) {
+    using Map = tstl::multimap<int, int>;
+    std::mt19937 gen(7);
+    Map a;
+    Map b;
+    for (int i = 0; i < n; ++i) {
+        a.emplace(static_cast<int>(gen()), i);
+    }
+    for (int i = 0; i < m; ++i) {
+        b.emplace(static_cast<int>(gen()), i);
+    }
+    auto setup = [&] { return std::make_pair(Map(a), Map(b)); };
+    bench_run("tstl::multimap merge", 5, setup,
+              [](std::pair<Map, Map> &p) { p.first.merge(p.second); });
+    bench_run("tstl::multimap union_with", 5, setup,
+              [](std::pair<Map, Map> &p) { p.first.union_with(p.second); });
+}
+
+// 大树上的大量随机查找：逐个 find 与批量 find_batch
+void bench_multimap_find_batch(int n, int m) {
+    using Map = tstl::multimap<int, int>;
+    std::mt19937 gen(3);
+    Map mp;
+    for (int i = 0; i < n; ++i) {
+        mp.emplace(static_cast<int>(gen()), i);
+    }
+    std::vector<int> keys(m);
+    for (auto &k : keys) {
+        k = static_cast<int>(gen());
+    }
+    std::vector<Map::iterator> out(m);
+    bench_run("tstl::multimap find", 5, [&] {
+        for (int i = 0; i < m; ++i) {
+            out[i] = mp.find(keys[i]);
+        }
+        bench_keep(out);
+    });
+    bench_run("tstl::multimap find_batch", 5, [&] {
+        mp.find_batch(keys.begin(), keys.end(), out.begin());
+        bench_keep(out);
+    });
+}
+
+void bench_multimap() {
+    const int n = 1000000;
+    bench_multimap_copy_clear<tstl::multimap<int, int>>("tstl::multimap copy (1M)",
+                                                        "tstl::multimap clear (1M)", n);
+    bench_multimap_copy_clear<std::multimap<int, int>>("std::multimap copy (1M)",
+                                                       "std::multimap clear (1M)", n);
+    std::printf("union 1M + 1M\n");
+    bench_multimap_union(n, n);
+    std::printf("union 1M + 10K\n");
+    bench_multimap_union(n, n / 100);
+    std::printf("lookup 1M probes in 1M\n");
+    bench_multimap_find_batch(n, n);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BENCH_BENCH_PACKED_VECTOR
+#define BENCH_BENCH_PACKED_VECTOR
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#include "../src/delta_vector.hpp"
+#include "../src/packed_vector.hpp"
+
+void bench_packed_vector_memory(const char *name, tstl::container_memory usage) {
+    std::printf("%-40s %10.2f MB\n", name, usage.total() / 1048576.0);
+}
+
+void bench_packed_vector() {
+    // 16M 个时间戳，相邻差值小于 1024
+    const std::size_t n = std::size_t(16) << 20;
+    tstl::vector<std::uint64_t> plain;
+    plain.reserve(n);
+    std::uint64_t ts = 1700000000000ull;
+    for (std::size_t i = 0; i < n; ++i) {
+        ts += (i * 2654435761u) >> 22 & 1023;
+        plain.push_back(ts);
+    }
+    // packed_vector 存放相对首元素的偏移
+    tstl::packed_vector packed(tstl::_bit_width(ts - plain[0]));
+    packed.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        packed.push_back(plain[i] - plain[0]);
+    }
+    tstl::delta_vector delta(plain.data(), plain.data() + n);
+
+    std::printf("sequential sum of %zu sorted uint64\n", n);
+    bench_run("  uint64 vector", 5, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += plain[i];
+        }
+        bench_keep(sum);
+    });
+    bench_run("  packed_vector operator[]", 5, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += packed[i];
+        }
+        bench_keep(sum);
+    });
+    bench_run("  packed_vector unpack", 5, [&] {
+        std::uint64_t sum = 0;
+        std::uint64_t buf[1024];
+        for (std::size_t i = 0; i < n; i += 1024) {
+            packed.unpack(i, 1024, buf);
+            for (std::size_t j = 0; j < 1024; ++j) {
+                sum += buf[j];
+            }
+        }
+        bench_keep(sum);
+    });
+    bench_run("  delta_vector iterator", 5, [&] {
+        std::uint64_t sum = 0;
+        for (auto x : delta) {
+            sum += x;
+        }
+        bench_keep(sum);
+    });
+    bench_run("  uint64 vector lower_bound x 1M", 3, [&] {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < 1000000; ++i) {
+            const std::uint64_t key = plain[(i * 2654435761u) % n];
+            found += *std::lower_bound(plain.data(), plain.data() + n, key) == key;
+        }
+        bench_keep(found);
+    });
+    bench_run("  delta_vector lower_bound x 1M", 3, [&] {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < 1000000; ++i) {
+            found += delta.contains(plain[(i * 2654435761u) % n]);
+        }
+        bench_keep(found);
+    });
+
+    bench_packed_vector_memory("  uint64 vector", plain.memory_usage());
+    bench_packed_vector_memory("  packed_vector", packed.memory_usage());
+    bench_packed_vector_memory("  delta_vector", delta.memory_usage());
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef BENCH_BENCH_PAIRING_HEAP
+#define BENCH_BENCH_PAIRING_HEAP
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "../src/pairing_heap.hpp"
+#include "../src/queue.hpp"
+#include "../src/vector.hpp"
+
+// 以 CSR 存放的随机有向图
+struct bench_ph_graph {
+    tstl::vector<std::uint32_t> offset;
+    tstl::vector<std::uint32_t> target;
+    tstl::vector<std::uint32_t> weight;
+};
+
+inline bench_ph_graph bench_ph_make_graph(std::uint32_t n, std::uint32_t degree) {
+    bench_ph_graph g;
+    std::uint64_t x = 88172645463325252ull;
+    for (std::uint32_t u = 0; u < n; ++u) {
+        g.offset.push_back(static_cast<std::uint32_t>(g.target.size()));
+        for (std::uint32_t k = 0; k < degree; ++k) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            g.target.push_back(static_cast<std::uint32_t>(x % n));
+            g.weight.push_back(static_cast<std::uint32_t>((x >> 32) % 1000 + 1));
+        }
+    }
+    g.offset.push_back(static_cast<std::uint32_t>(g.target.size()));
+    return g;
+}
+
+using bench_ph_entry = std::pair<std::uint64_t, std::uint32_t>; // (距离, 顶点)
+
+// 不支持 decrease-key 的堆：距离变小时再放入一份，弹出过期的副本时跳过
+template <class Queue>
+std::uint64_t bench_ph_dijkstra_lazy(const bench_ph_graph &g, std::size_t &peak) {
+    const std::size_t n = g.offset.size() - 1;
+    tstl::vector<std::uint64_t> dist(n, std::numeric_limits<std::uint64_t>::max());
+    Queue pq;
+    dist[0] = 0;
+    pq.push(bench_ph_entry(0, 0));
+    peak = 0;
+    while (!pq.empty()) {
+        bench_ph_entry e = pq.top();
+        pq.pop();
+        if (e.first != dist[e.second]) {
+            continue;
+        }
+        for (std::uint32_t i = g.offset[e.second]; i < g.offset[e.second + 1]; ++i) {
+            const std::uint64_t d = e.first + g.weight[i];
+            if (d < dist[g.target[i]]) {
+                dist[g.target[i]] = d;
+                pq.push(bench_ph_entry(d, g.target[i]));
+                peak = pq.size() > peak ? pq.size() : peak;
+            }
+        }
+    }
+    return dist[n - 1];
+}
+
+std::uint64_t bench_ph_dijkstra_pairing(const bench_ph_graph &g, std::size_t &peak) {
+    using heap_type = tstl::pairing_heap<bench_ph_entry>;
+    const std::size_t n = g.offset.size() - 1;
+    tstl::vector<std::uint64_t> dist(n, std::numeric_limits<std::uint64_t>::max());
+    tstl::vector<heap_type::handle_type> handle(n);
+    heap_type pq;
+    dist[0] = 0;
+    handle[0] = pq.push(bench_ph_entry(0, 0));
+    peak = 0;
+    while (!pq.empty()) {
+        bench_ph_entry e = pq.top();
+        pq.pop();
+        for (std::uint32_t i = g.offset[e.second]; i < g.offset[e.second + 1]; ++i) {
+            const std::uint32_t v = g.target[i];
+            const std::uint64_t d = e.first + g.weight[i];
+            if (d < dist[v]) {
+                dist[v] = d;
+                // 边权为正，已弹出的顶点的距离不会再变小，有句柄即仍在堆中
+                if (handle[v]) {
+                    pq.decrease_key(handle[v], bench_ph_entry(d, v));
+                } else {
+                    handle[v] = pq.push(bench_ph_entry(d, v));
+                    peak = pq.size() > peak ? pq.size() : peak;
+                }
+            }
+        }
+    }
+    return dist[n - 1];
+}
+
+void bench_pairing_heap() {
+    using greater = std::greater<bench_ph_entry>;
+    using std_pq = std::priority_queue<bench_ph_entry, std::vector<bench_ph_entry>, greater>;
+    using quad_pq = tstl::priority_queue<bench_ph_entry, tstl::vector<bench_ph_entry>, greater, 4>;
+    const std::uint32_t n = 1u << 20;
+    for (std::uint32_t degree : {4u, 16u}) {
+        bench_ph_graph g = bench_ph_make_graph(n, degree);
+        std::size_t peak = 0;
+        std::printf("dijkstra, %u vertices, %u edges each\n", n, degree);
+        bench_run("  std::priority_queue + duplicates", 3,
+                  [&] { bench_keep(bench_ph_dijkstra_lazy<std_pq>(g, peak)); });
+        std::printf("%-40s %10zu\n", "    peak heap size", peak);
+        bench_run("  tstl::priority_queue 4-ary + duplicates", 3,
+                  [&] { bench_keep(bench_ph_dijkstra_lazy<quad_pq>(g, peak)); });
+        bench_run("  tstl::pairing_heap decrease_key", 3,
+                  [&] { bench_keep(bench_ph_dijkstra_pairing(g, peak)); });
+        std::printf("%-40s %10zu\n", "    peak heap size", peak);
+    }
+}
+
+#endif
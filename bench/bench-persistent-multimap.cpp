@@ -0,0 +1,48 @@
+#ifndef BENCH_BENCH_PERSISTENT_MULTIMAP
+#define BENCH_BENCH_PERSISTENT_MULTIMAP
+
+#include "../src/multimap.hpp"
+#include "../src/persistent_multimap.hpp"
+
+// 写入后发布快照：复制整棵 multimap 与可持久化树的 O(1) 快照对照
+void bench_persistent_multimap() {
+    const int n = 100000;
+    const int writes = 100;
+    tstl::multimap<int, int> mp;
+    tstl::persistent_multimap<int, int> pmp;
+    for (int i = 0; i < n; ++i) {
+        mp.emplace(i, i);
+        pmp.emplace(i, i);
+    }
+    bench_run("multimap write + copy (100K)", 1, [&] {
+        for (int i = 0; i < writes; ++i) {
+            mp.emplace(i, -i);
+            tstl::multimap<int, int> snapshot(mp);
+            bench_keep(snapshot);
+        }
+    });
+    bench_run("persistent_multimap write + snapshot (100K)", 1, [&] {
+        for (int i = 0; i < writes; ++i) {
+            pmp.emplace(i, -i);
+            auto snapshot = pmp.snapshot();
+            bench_keep(snapshot);
+        }
+    });
+    tstl::persistent_multimap<int, int>::snapshot_type snap = pmp.snapshot();
+    bench_run("persistent_multimap find (100K)", 10, [&] {
+        long sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += snap.find(i)->second;
+        }
+        bench_keep(sum);
+    });
+    bench_run("multimap find (100K)", 10, [&] {
+        long sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += mp.find(i)->second;
+        }
+        bench_keep(sum);
+    });
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef BENCH_BENCH_POOL_ALLOCATOR
+#define BENCH_BENCH_POOL_ALLOCATOR
+
+#include <random>
+#include <vector>
+
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/memory/pool_allocator.hpp"
+#include "../src/multimap.hpp"
+
+// 插入删除交替的负载：容器大小保持在 n 附近，结点不断被释放又重新分配
+template <class List>
+void bench_list_churn(const char *name, const std::vector<int> &ops, int n) {
+    bench_run(name, 5, [&] {
+        List lst;
+        for (int i = 0; i < n; ++i) {
+            lst.push_back(i);
+        }
+        for (int op : ops) {
+            if (op & 1) {
+                lst.pop_front();
+                lst.push_back(op);
+            } else {
+                lst.pop_back();
+                lst.push_front(op);
+            }
+        }
+        bench_keep(lst.front());
+    });
+}
+
+template <class Map>
+void bench_multimap_churn(const char *name, const std::vector<int> &ops, int n) {
+    bench_run(name, 5, [&] {
+        Map mp;
+        for (int i = 0; i < n; ++i) {
+            mp.emplace(ops[i], i);
+        }
+        for (std::size_t i = n; i < ops.size(); ++i) {
+            mp.erase(mp.find(ops[i - n]));
+            mp.emplace(ops[i], 0);
+        }
+        bench_keep(mp.size());
+    });
+}
+
+template <class Deque>
+void bench_deque_churn(const char *name, const std::vector<int> &ops, int n) {
+    bench_run(name, 5, [&] {
+        Deque deq;
+        long long sum = 0;
+        for (int op : ops) {
+            for (int i = 0; i < n; ++i) {
+                deq.push_back(op);
+            }
+            while (!deq.empty()) {
+                sum += deq.front();
+                deq.pop_front();
+            }
+        }
+        bench_keep(sum);
+    });
+}
+
+void bench_pool_allocator() {
+    std::mt19937 gen(37);
+    std::vector<int> ops(2000000);
+    for (auto &op : ops) {
+        op = static_cast<int>(gen() >> 1);
+    }
+
+    const int n = 100000;
+    bench_list_churn<tstl::list<int>>("list std::allocator churn", ops, n);
+    bench_list_churn<tstl::list<int, tstl::pool_allocator<int>>>("list pool_allocator churn",
+                                                                 ops, n);
+
+    using pool_pair = tstl::pool_allocator<std::pair<const int, int>>;
+    bench_multimap_churn<tstl::multimap<int, int>>("multimap std::allocator churn", ops, n);
+    bench_multimap_churn<tstl::multimap<int, int, std::less<int>, pool_pair>>(
+        "multimap pool_allocator churn", ops, n);
+
+    // 队列反复填满又清空，缓冲区不断被释放又重新分配
+    std::vector<int> rounds(ops.begin(), ops.begin() + 20000);
+    bench_deque_churn<tstl::deque<int>>("deque std::allocator churn", rounds, 1000);
+    bench_deque_churn<tstl::deque<int, tstl::pool_allocator<int>>>("deque pool_allocator churn",
+                                                                   rounds, 1000);
+}
+
+#endif
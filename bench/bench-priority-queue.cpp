@@ -0,0 +1,89 @@
+#ifndef BENCH_BENCH_PRIORITY_QUEUE
+#define BENCH_BENCH_PRIORITY_QUEUE
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "../src/queue.hpp"
+#include "../src/vector.hpp"
+
+// 定时器事件：按触发时间从早到晚出队
+struct bench_pq_event {
+    std::uint64_t time;
+    std::uint64_t id;
+
+    bool operator>(const bench_pq_event &rhs) const {
+        return time > rhs.time;
+    }
+};
+
+inline std::uint64_t bench_pq_next(std::uint64_t &x) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+// 先放入 n 个事件，再做 n 次“弹出最早的事件并安排一个更晚的事件”，最后全部弹出
+template <class Queue>
+void bench_pq_hold(const char *name, std::size_t n) {
+    bench_run(name, 3, [n] {
+        Queue pq;
+        std::uint64_t x = 88172645463325252ull;
+        for (std::size_t i = 0; i < n; ++i) {
+            pq.push(bench_pq_event{bench_pq_next(x) >> 20, i});
+        }
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            bench_pq_event e = pq.top();
+            pq.pop();
+            sum += e.id;
+            pq.push(bench_pq_event{e.time + (bench_pq_next(x) >> 40), e.id});
+        }
+        while (!pq.empty()) {
+            sum += pq.top().id;
+            pq.pop();
+        }
+        bench_keep(sum);
+    });
+}
+
+void bench_priority_queue() {
+    using greater = std::greater<bench_pq_event>;
+    using std_pq = std::priority_queue<bench_pq_event, std::vector<bench_pq_event>, greater>;
+    using binary_pq = tstl::priority_queue<bench_pq_event, tstl::vector<bench_pq_event>, greater>;
+    using quad_pq =
+        tstl::priority_queue<bench_pq_event, tstl::vector<bench_pq_event>, greater, 4>;
+    for (std::size_t n : {std::size_t(1) << 16, std::size_t(1) << 22}) {
+        std::printf("hold model, %zu timers\n", n);
+        bench_pq_hold<std_pq>("  std::priority_queue", n);
+        bench_pq_hold<binary_pq>("  tstl::priority_queue binary", n);
+        bench_pq_hold<quad_pq>("  tstl::priority_queue 4-ary", n);
+    }
+
+    // 批量加入：逐个 push 与 push_range 一次建堆
+    const std::size_t n = std::size_t(1) << 22;
+    tstl::vector<bench_pq_event> events;
+    std::uint64_t x = 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        events.push_back(bench_pq_event{bench_pq_next(x), i});
+    }
+    std::printf("bulk insert %zu events\n", n);
+    bench_run("  4-ary push one by one", 3, [&] {
+        quad_pq pq;
+        for (std::size_t i = 0; i < n; ++i) {
+            pq.push(events[i]);
+        }
+        bench_keep(pq.top().id);
+    });
+    bench_run("  4-ary push_range", 3, [&] {
+        quad_pq pq;
+        pq.push_range(events.begin(), events.end());
+        bench_keep(pq.top().id);
+    });
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef BENCH_BENCH_RING_BUFFER
+#define BENCH_BENCH_RING_BUFFER
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <queue>
+#include <vector>
+
+#include "../src/deque.hpp"
+#include "../src/queue.hpp"
+#include "../src/ring_buffer.hpp"
+
+// 生产者每次放入 burst 个元素，消费者随后全部取出，模拟有界的消息通道
+template <class Queue>
+void bench_rb_queue(const char *name, std::size_t total, std::size_t burst) {
+    bench_run(name, 3, [total, burst] {
+        Queue q;
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < total; i += burst) {
+            for (std::size_t j = 0; j < burst; ++j) {
+                q.push(i + j);
+            }
+            while (!q.empty()) {
+                sum += q.front();
+                q.pop();
+            }
+        }
+        bench_keep(sum);
+    });
+}
+
+void bench_ring_buffer() {
+    const std::size_t total = std::size_t(1) << 24;
+    const std::size_t burst = 256;
+    bench_rb_queue<std::queue<std::uint64_t>>("std::queue<deque> push/pop", total, burst);
+    bench_rb_queue<tstl::queue<std::uint64_t>>("tstl::queue<deque> push/pop", total, burst);
+
+    bench_run("ring_buffer push_back/pop_front", 3, [total, burst] {
+        tstl::ring_buffer<std::uint64_t> rb(burst);
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < total; i += burst) {
+            for (std::size_t j = 0; j < burst; ++j) {
+                rb.push_back(i + j);
+            }
+            while (!rb.empty()) {
+                sum += rb.front();
+                rb.pop_front();
+            }
+        }
+        bench_keep(sum);
+    });
+
+    bench_run("ring_buffer push_n/pop_n", 3, [total, burst] {
+        // 预先放入半批元素，使读、写位置错开，部分批次跨过缓冲区末尾、分为两段
+        tstl::ring_buffer<std::uint64_t> rb(2 * burst);
+        std::vector<std::uint64_t> src(burst);
+        std::uint64_t sum = 0;
+        for (std::size_t j = 0; j < burst / 2; ++j) {
+            rb.push_back(j);
+        }
+        for (std::size_t i = 0; i < total; i += burst) {
+            for (std::size_t j = 0; j < burst; ++j) {
+                src[j] = i + j;
+            }
+            rb.push_n(src.data(), burst);
+            tstl::ring_buffer<std::uint64_t>::spans s = rb.pop_n(burst);
+            for (std::uint64_t v : s.first) {
+                sum += v;
+            }
+            for (std::uint64_t v : s.second) {
+                sum += v;
+            }
+        }
+        bench_keep(sum);
+    });
+
+    tstl::ring_buffer<std::uint64_t> rb(burst);
+    tstl::deque<std::uint64_t> dq;
+    for (std::size_t i = 0; i < burst; ++i) {
+        rb.push_back(i);
+        dq.push_back(i);
+    }
+    std::printf("%-40s %10zu B\n", "ring_buffer memory", rb.memory_usage().total());
+    std::printf("%-40s %10zu B\n", "tstl::deque memory", dq.memory_usage().total());
+}
+
+#endif
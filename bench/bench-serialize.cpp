@@ -0,0 +1,83 @@
+#ifndef BENCH_BENCH_SERIALIZE
+#define BENCH_BENCH_SERIALIZE
+
+#include <cstdint>
+#include <sstream>
+
+#include "../src/serialize.hpp"
+
+// 逐个元素经 iostream 写入与读出，作为对照
+template <class Container>
+void bench_serialize_each(std::ostream &os, const Container &c) {
+    std::uint64_t n = c.size();
+    os.write(reinterpret_cast<const char *>(&n), sizeof(n));
+    for (const auto &x : c) {
+        os.write(reinterpret_cast<const char *>(&x), sizeof(x));
+    }
+}
+
+template <class Container>
+void bench_serialize_round_trip(const char *name, const char *each_name, const Container &c) {
+    using value_type = typename Container::value_type;
+    bench_run(each_name, 3, [&] {
+        std::stringstream ss;
+        bench_serialize_each(ss, c);
+        Container out;
+        std::uint64_t n;
+        ss.read(reinterpret_cast<char *>(&n), sizeof(n));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            value_type x;
+            ss.read(reinterpret_cast<char *>(&x), sizeof(x));
+            out.push_back(x);
+        }
+        bench_keep(out.back());
+    });
+    bench_run(name, 3, [&] {
+        std::stringstream ss;
+        tstl::serialize(ss, c);
+        Container out;
+        tstl::deserialize(ss, out);
+        bench_keep(out.back());
+    });
+}
+
+void bench_serialize() {
+    const std::size_t n = std::size_t(8) << 20;
+    tstl::vector<std::uint64_t> vec;
+    tstl::deque<std::uint64_t> deq;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(i * 2654435761u);
+        deq.push_back(i);
+    }
+    bench_serialize_round_trip("vector bulk round trip", "vector element-wise round trip", vec);
+    bench_serialize_round_trip("deque bulk round trip", "deque element-wise round trip", deq);
+
+    // multimap 逐个插入重建与按有序流线性重建
+    tstl::multimap<int, int> mp;
+    for (int i = 0; i < 1000000; ++i) {
+        mp.emplace(static_cast<int>((i * 2654435761u) >> 8), i);
+    }
+    std::stringstream ss;
+    tstl::serialize(ss, mp);
+    const std::string data = ss.str();
+    bench_run("multimap reload by insert", 3, [&] {
+        std::istringstream in(data);
+        std::size_t count = tstl::_deserialize_size(in);
+        tstl::multimap<int, int> out;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::pair<int, int> kv;
+            tstl::deserialize(in, kv.first);
+            tstl::deserialize(in, kv.second);
+            out.insert(kv);
+        }
+        bench_keep(out.size());
+    });
+    bench_run("multimap reload by assign_sorted", 3, [&] {
+        std::istringstream in(data);
+        tstl::multimap<int, int> out;
+        tstl::deserialize(in, out);
+        bench_keep(out.size());
+    });
+}
+
+#endif
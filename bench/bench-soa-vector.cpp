@@ -0,0 +1,78 @@
+#ifndef BENCH_BENCH_SOA_VECTOR
+#define BENCH_BENCH_SOA_VECTOR
+
+#include <cstdint>
+#include <cstdio>
+
+#include "../src/soa_vector.hpp"
+#include "../src/vector.hpp"
+
+// 十个字段的行，热循环只用到其中的 price 与 qty
+struct bench_soa_order {
+    std::uint64_t id;
+    std::uint64_t account;
+    std::uint64_t timestamp;
+    double price;
+    double qty;
+    double fee;
+    double tax;
+    std::uint32_t venue;
+    std::uint32_t flags;
+    std::uint64_t parent;
+};
+
+using bench_soa_orders =
+    tstl::soa_vector<std::uint64_t, std::uint64_t, std::uint64_t, double, double, double, double,
+                     std::uint32_t, std::uint32_t, std::uint64_t>;
+
+void bench_soa_vector() {
+    const std::size_t n = std::size_t(8) << 20;
+    tstl::vector<bench_soa_order> aos;
+    bench_soa_orders soa;
+    aos.reserve(n);
+    soa.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double price = static_cast<double>(i % 1000) * 0.25;
+        const double qty = static_cast<double>(i % 37);
+        aos.push_back(bench_soa_order{i, i % 1000, i, price, qty, 0.1, 0.2, 1, 0, 0});
+        soa.emplace_back(i, i % 1000, i, price, qty, 0.1, 0.2, 1u, 0u, 0u);
+    }
+
+    std::printf("notional = sum(price * qty) over %zu rows of %zu bytes\n", n,
+                sizeof(bench_soa_order));
+    bench_run("  AoS vector<struct>", 5, [&] {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += aos[i].price * aos[i].qty;
+        }
+        bench_keep(sum);
+    });
+    bench_run("  SoA column<3>, column<4>", 5, [&] {
+        tstl::span<const double> price = soa.column<3>();
+        tstl::span<const double> qty = soa.column<4>();
+        double sum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += price[i] * qty[i];
+        }
+        bench_keep(sum);
+    });
+
+    std::printf("count rows with venue == 1\n");
+    bench_run("  AoS vector<struct>", 5, [&] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            count += aos[i].venue == 1;
+        }
+        bench_keep(count);
+    });
+    bench_run("  SoA column<7>", 5, [&] {
+        tstl::span<const std::uint32_t> venue = soa.column<7>();
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            count += venue[i] == 1;
+        }
+        bench_keep(count);
+    });
+}
+
+#endif
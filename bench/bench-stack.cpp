@@ -0,0 +1,88 @@
+#ifndef BENCH_BENCH_STACK
+#define BENCH_BENCH_STACK
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "../src/chunked_storage.hpp"
+#include "../src/stack.hpp"
+#include "../src/vector.hpp"
+
+// 压入 n 个元素后全部弹出
+template <class Stack, class Make>
+void bench_stack_fill(const char *name, std::size_t n, Make make) {
+    bench_run(name, 3, [n, &make] {
+        Stack s;
+        for (std::size_t i = 0; i < n; ++i) {
+            s.push(make(i));
+        }
+        std::uint64_t sum = 0;
+        while (!s.empty()) {
+            sum += s.size();
+            s.pop();
+        }
+        bench_keep(sum);
+    });
+}
+
+// 深度优先遍历式的锯齿访问：栈在一个较小的范围内反复涨落
+template <class Stack>
+void bench_stack_sawtooth(const char *name, std::size_t rounds) {
+    bench_run(name, 3, [rounds] {
+        Stack s;
+        std::uint64_t sum = 0;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (std::size_t i = 0; i < 1000; ++i) {
+                s.push(i);
+            }
+            for (std::size_t i = 0; i < 1000; ++i) {
+                sum += s.top();
+                s.pop();
+            }
+        }
+        bench_keep(sum);
+    });
+}
+
+void bench_stack() {
+    using std_deque = std::stack<std::uint64_t, std::deque<std::uint64_t>>;
+    using tstl_vector = tstl::stack<std::uint64_t, tstl::vector<std::uint64_t>>;
+    using tstl_chunked = tstl::stack<std::uint64_t>;
+    const std::size_t n = std::size_t(1) << 24;
+    auto make_int = [](std::size_t i) { return static_cast<std::uint64_t>(i); };
+    bench_stack_fill<std_deque>("stack<std::deque> push/pop u64", n, make_int);
+    bench_stack_fill<tstl_vector>("stack<tstl::vector> push/pop u64", n, make_int);
+    bench_stack_fill<tstl_chunked>("stack<chunked_storage> push/pop u64", n, make_int);
+
+    // 长度超过 SSO 的字符串：vector 扩容时要移动全部已有元素
+    using std_deque_str = std::stack<std::string, std::deque<std::string>>;
+    using tstl_vector_str = tstl::stack<std::string, tstl::vector<std::string>>;
+    using tstl_chunked_str = tstl::stack<std::string>;
+    const std::size_t m = std::size_t(1) << 20;
+    auto make_str = [](std::size_t i) { return std::string(32, static_cast<char>('a' + i % 26)); };
+    bench_stack_fill<std_deque_str>("stack<std::deque> push/pop string", m, make_str);
+    bench_stack_fill<tstl_vector_str>("stack<tstl::vector> push/pop string", m, make_str);
+    bench_stack_fill<tstl_chunked_str>("stack<chunked_storage> push/pop string", m, make_str);
+
+    bench_stack_sawtooth<std_deque>("stack<std::deque> sawtooth", 10000);
+    bench_stack_sawtooth<tstl_vector>("stack<tstl::vector> sawtooth", 10000);
+    bench_stack_sawtooth<tstl_chunked>("stack<chunked_storage> sawtooth", 10000);
+
+    std::vector<std::uint64_t> src(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        src[i] = i;
+    }
+    bench_run("stack<chunked_storage> push_range/pop_n", 3, [&src] {
+        tstl_chunked s;
+        s.push_range(src.data(), src.data() + src.size());
+        std::uint64_t sum = s.top();
+        s.pop_n(s.size());
+        bench_keep(sum);
+    });
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef BENCH_BENCH_UNORDERED_MAP
+#define BENCH_BENCH_UNORDERED_MAP
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/multimap.hpp"
+#include "../src/unordered_map.hpp"
+
+// 点查询场景：插入、命中查找、未命中查找，以及插入与删除交替的混合负载
+template <class Map>
+void bench_point_lookup(const std::string &name, const std::vector<int> &keys,
+                        const std::vector<int> &misses) {
+    const int n = static_cast<int>(keys.size());
+    bench_run(
+        (name + " insert").c_str(), 5, [] { return Map(); },
+        [&](Map &mp) {
+            for (int i = 0; i < n; ++i) {
+                mp.emplace(keys[i], i);
+            }
+        });
+
+    Map mp;
+    for (int i = 0; i < n; ++i) {
+        mp.emplace(keys[i], i);
+    }
+    bench_run((name + " hit").c_str(), 5, [&] {
+        long long sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += mp.find(keys[i])->second;
+        }
+        bench_keep(sum);
+    });
+    bench_run((name + " miss").c_str(), 5, [&] {
+        int found = 0;
+        for (int i = 0; i < n; ++i) {
+            found += mp.find(misses[i]) != mp.end();
+        }
+        bench_keep(found);
+    });
+    // 每轮删除一个已有键值并插入一个新键值，元素个数保持不变
+    bench_run(
+        (name + " erase/insert mix").c_str(), 5, [&] { return Map(mp); },
+        [&](Map &m) {
+            for (int i = 0; i < n; ++i) {
+                m.erase(keys[i]);
+                m.emplace(misses[i], i);
+            }
+        });
+}
+
+void bench_unordered_map() {
+    const int n = 1000000;
+    // 偶数为已有键值，奇数为未命中的键值
+    std::mt19937 gen(17);
+    std::vector<int> keys(n);
+    std::vector<int> misses(n);
+    for (int i = 0; i < n; ++i) {
+        keys[i] = static_cast<int>(gen() & ~1u);
+        misses[i] = static_cast<int>(gen() | 1u);
+    }
+    bench_point_lookup<tstl::unordered_map<int, int>>("tstl::unordered_map", keys, misses);
+    bench_point_lookup<std::unordered_map<int, int>>("std::unordered_map", keys, misses);
+    bench_point_lookup<tstl::multimap<int, int>>("tstl::multimap", keys, misses);
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef BENCH_BENCH
+#define BENCH_BENCH
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <new>
+
+// 统计经 operator new 分配、仍未释放的字节数（按 malloc 实际可用的大小计，含对齐与取整）
+// 多线程的测试会同时分配与释放，计数须为原子变量
+static std::atomic<std::size_t> bench_live_bytes{0};
+
+void *operator new(std::size_t size) {
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    bench_live_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    if (p != nullptr) {
+        bench_live_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+// 简单计时工具，重复执行 fn 并报告单次平均耗时（毫秒），setup 的耗时不计入
+template <class Setup, class Fn>
+double bench_run(const char *name, int rounds, Setup setup, Fn fn) {
+    using clock = std::chrono::steady_clock;
+    std::chrono::duration<double, std::milli> elapsed(0);
+    for (int i = 0; i < rounds; ++i) {
+        auto state = setup();
+        auto start = clock::now();
+        fn(state);
+        elapsed += clock::now() - start;
+    }
+    double avg = elapsed.count() / rounds;
+    std::printf("%-40s %10.3f ms\n", name, avg);
+    return avg;
+}
+
+template <class Fn>
+double bench_run(const char *name, int rounds, Fn fn) {
+    return bench_run(name, rounds, [] { return 0; }, [&](int) { fn(); });
+}
+
+// 防止编译器把结果优化掉
+template <class T>
+void bench_keep(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#include "bench-multimap.cpp"
+#include "bench-persistent-multimap.cpp"
+#include "bench-grouped-multimap.cpp"
+#include "bench-unordered-map.cpp"
+#include "bench-concurrent-hash-map.cpp"
+#include "bench-monotonic-arena.cpp"
+#include "bench-pool-allocator.cpp"
+#include "bench-mmap-allocator.cpp"
+#include "bench-mapped-vector.cpp"
+#include "bench-serialize.cpp"
+#include "bench-external-sort.cpp"
+#include "bench-packed-vector.cpp"
+#include "bench-soa-vector.cpp"
+#include "bench-dynamic-bitset.cpp"
+#include "bench-priority-queue.cpp"
+#include "bench-pairing-heap.cpp"
+#include "bench-ring-buffer.cpp"
+#include "bench-stack.cpp"
+
+// 未指定用例时运行全部
+bool bench_selected(const char *filter, const char *name) {
+    return *filter == '\0' || std::strcmp(filter, name) == 0;
+}
+
+int main(int argc, char **argv) {
+    // 可通过参数指定单个用例，如 ./bench multimap
+    const char *filter = argc > 1 ? argv[1] : "";
+    if (bench_selected(filter, "multimap")) {
+        bench_multimap();
+    }
+    if (bench_selected(filter, "persistent_multimap")) {
+        bench_persistent_multimap();
+    }
+    if (bench_selected(filter, "grouped_multimap")) {
+        bench_grouped_multimap();
+    }
+    if (bench_selected(filter, "unordered_map")) {
+        bench_unordered_map();
+    }
+    if (bench_selected(filter, "concurrent_hash_map")) {
+        bench_concurrent_hash_map();
+    }
+    if (bench_selected(filter, "monotonic_arena")) {
+        bench_monotonic_arena();
+    }
+    if (bench_selected(filter, "pool_allocator")) {
+        bench_pool_allocator();
+    }
+    if (bench_selected(filter, "mmap_allocator")) {
+        bench_mmap_allocator();
+    }
+    if (bench_selected(filter, "mapped_vector")) {
+        bench_mapped_vector();
+    }
+    if (bench_selected(filter, "serialize")) {
+        bench_serialize();
+    }
+    if (bench_selected(filter, "external_sort")) {
+        bench_external_sort();
+    }
+    if (bench_selected(filter, "packed_vector")) {
+        bench_packed_vector();
+    }
+    if (bench_selected(filter, "soa_vector")) {
+        bench_soa_vector();
+    }
+    if (bench_selected(filter, "dynamic_bitset")) {
+        bench_dynamic_bitset();
+    }
+    if (bench_selected(filter, "priority_queue")) {
+        bench_priority_queue();
+    }
+    if (bench_selected(filter, "pairing_heap")) {
+        bench_pairing_heap();
+    }
+    if (bench_selected(filter, "ring_buffer")) {
+        bench_ring_buffer();
+    }
+    if (bench_selected(filter, "stack")) {
+        bench_stack();
+    }
+    return 0;
+}
+
+#endif
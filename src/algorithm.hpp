@@ -2,7 +2,11 @@
 #define TSTL_SRC_ALGORITHM_HPP
 
 #include "iterator.hpp"
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <utility>
 
 namespace tstl {
 
@@ -194,31 +198,246 @@ BidirIt2 copy_backward(BidirIt1 first, BidirIt1 last, BidirIt2 d_last) {
     return d_last;
 }
 
-// 快速排序
+// 插入排序，用于快速排序中的短区间
 template <typename RandomIt, typename Compare>
-void quick_sort(RandomIt first, RandomIt last, Compare cmp) {
-    if (first < last) {
-        typename tstl::iterator_traits<RandomIt>::value_type basic = *first;
-        RandomIt l = first;
-        RandomIt r = last - 1;
-        while (l < r) {
-            while (cmp(basic, *r) && l < r)
-                --r;
-            if (l < r) {
-                *l = *r;
-                ++l;
-            }
-            while (cmp(*l, basic) && l < r)
-                ++l;
-            if (l < r) {
-                *r = *l;
-                --r;
-            }
+void _insertion_sort(RandomIt first, RandomIt last, Compare cmp) {
+    if (first == last)
+        return;
+    for (RandomIt i = first + 1; i < last; ++i) {
+        typename tstl::iterator_traits<RandomIt>::value_type value = std::move(*i);
+        RandomIt j = i;
+        for (; j > first && cmp(value, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(value);
+    }
+}
+
+// 把 a、b、c 三者的中位数交换到 result
+template <typename RandomIt, typename Compare>
+void _median_to_first(RandomIt result, RandomIt a, RandomIt b, RandomIt c, Compare cmp) {
+    if (cmp(*a, *b)) {
+        if (cmp(*b, *c))
+            tstl::iter_swap(result, b);
+        else if (cmp(*a, *c))
+            tstl::iter_swap(result, c);
+        else
+            tstl::iter_swap(result, a);
+    } else if (cmp(*a, *c)) {
+        tstl::iter_swap(result, a);
+    } else if (cmp(*b, *c)) {
+        tstl::iter_swap(result, c);
+    } else {
+        tstl::iter_swap(result, b);
+    }
+}
+
+// 以 *pivot 为基准划分 [first, last)，返回右半部分的起点；两侧的扫描都会在基准或越过的元素处停下，
+// 无需检查边界。与基准相等的元素交替落在两侧，大量重复元素时划分仍然均衡
+template <typename RandomIt, typename Compare>
+RandomIt _unguarded_partition(RandomIt first, RandomIt last, RandomIt pivot, Compare cmp) {
+    while (true) {
+        while (cmp(*first, *pivot))
+            ++first;
+        --last;
+        while (cmp(*pivot, *last))
+            --last;
+        if (!(first < last))
+            return first;
+        tstl::iter_swap(first, last);
+        ++first;
+    }
+}
+
+// 堆算法
+// [first, last) 按 cmp 构成大顶堆：cmp(*first, x) 对任意元素 x 都不成立
+// 带 Arity 参数的版本为 d 叉堆，结点 i 的子结点为 Arity * i + 1 到 Arity * i + Arity；
+// 4 叉堆的高度只有二叉堆的一半，一组兄弟结点常位于同一缓存行，下沉时的缓存缺失更少
+// 上浮与下沉都先空出一个位置，沿路径移动元素，最后才把值放入，不逐层交换
+
+// 把 value 从 hole 处向上移动，不超过 top
+template <std::size_t Arity, class RandomIt, class Distance, class T, class Compare>
+void _heap_sift_up(RandomIt first, Distance hole, Distance top, T value, Compare &cmp) {
+    while (hole > top) {
+        Distance parent = (hole - 1) / static_cast<Distance>(Arity);
+        if (!cmp(first[parent], value)) {
+            break;
+        }
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+    }
+    first[hole] = std::move(value);
+}
+
+// 把 value 从 hole 处向下移动，堆的长度为 len
+template <std::size_t Arity, class RandomIt, class Distance, class T, class Compare>
+void _heap_sift_down(RandomIt first, Distance hole, Distance len, T value, Compare &cmp) {
+    const Distance arity = static_cast<Distance>(Arity);
+    while (true) {
+        const Distance child = arity * hole + 1;
+        if (child >= len) {
+            break;
+        }
+        const Distance end = len - child < arity ? len : child + arity;
+        Distance best = child;
+        for (Distance c = child + 1; c < end; ++c) {
+            best = cmp(first[best], first[c]) ? c : best;
+        }
+        if (!cmp(value, first[best])) {
+            break;
+        }
+        first[hole] = std::move(first[best]);
+        hole = best;
+    }
+    first[hole] = std::move(value);
+}
+
+// 把 *(last - 1) 加入堆 [first, last - 1)
+template <std::size_t Arity, class RandomIt, class Compare>
+void _dary_push_heap(RandomIt first, RandomIt last, Compare cmp) {
+    using distance = typename tstl::iterator_traits<RandomIt>::difference_type;
+    const distance len = last - first;
+    if (len > 1) {
+        typename tstl::iterator_traits<RandomIt>::value_type value = std::move(*(last - 1));
+        tstl::_heap_sift_up<Arity>(first, len - 1, distance(0), std::move(value), cmp);
+    }
+}
+
+// 把堆顶移到 *(last - 1)，[first, last - 1) 仍为堆
+template <std::size_t Arity, class RandomIt, class Compare>
+void _dary_pop_heap(RandomIt first, RandomIt last, Compare cmp) {
+    using distance = typename tstl::iterator_traits<RandomIt>::difference_type;
+    const distance len = last - first;
+    if (len > 1) {
+        typename tstl::iterator_traits<RandomIt>::value_type value = std::move(*(last - 1));
+        *(last - 1) = std::move(*first);
+        tstl::_heap_sift_down<Arity>(first, distance(0), len - 1, std::move(value), cmp);
+    }
+}
+
+// 自底向上建堆，O(n)
+template <std::size_t Arity, class RandomIt, class Compare>
+void _dary_make_heap(RandomIt first, RandomIt last, Compare cmp) {
+    using distance = typename tstl::iterator_traits<RandomIt>::difference_type;
+    const distance len = last - first;
+    if (len < 2) {
+        return;
+    }
+    for (distance i = (len - 2) / static_cast<distance>(Arity) + 1; i-- > 0;) {
+        typename tstl::iterator_traits<RandomIt>::value_type value = std::move(first[i]);
+        tstl::_heap_sift_down<Arity>(first, i, len, std::move(value), cmp);
+    }
+}
+
+template <std::size_t Arity, class RandomIt, class Compare>
+RandomIt _dary_is_heap_until(RandomIt first, RandomIt last, Compare cmp) {
+    using distance = typename tstl::iterator_traits<RandomIt>::difference_type;
+    const distance len = last - first;
+    for (distance i = 1; i < len; ++i) {
+        if (cmp(first[(i - 1) / static_cast<distance>(Arity)], first[i])) {
+            return first + i;
+        }
+    }
+    return last;
+}
+
+template <class RandomIt, class Compare>
+void push_heap(RandomIt first, RandomIt last, Compare cmp) {
+    tstl::_dary_push_heap<2>(first, last, cmp);
+}
+
+template <class RandomIt>
+void push_heap(RandomIt first, RandomIt last) {
+    tstl::push_heap(first, last, std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <class RandomIt, class Compare>
+void pop_heap(RandomIt first, RandomIt last, Compare cmp) {
+    tstl::_dary_pop_heap<2>(first, last, cmp);
+}
+
+template <class RandomIt>
+void pop_heap(RandomIt first, RandomIt last) {
+    tstl::pop_heap(first, last, std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <class RandomIt, class Compare>
+void make_heap(RandomIt first, RandomIt last, Compare cmp) {
+    tstl::_dary_make_heap<2>(first, last, cmp);
+}
+
+template <class RandomIt>
+void make_heap(RandomIt first, RandomIt last) {
+    tstl::make_heap(first, last, std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+// 反复弹出堆顶，得到按 cmp 升序排列的区间
+template <class RandomIt, class Compare>
+void sort_heap(RandomIt first, RandomIt last, Compare cmp) {
+    for (; last - first > 1; --last) {
+        tstl::_dary_pop_heap<2>(first, last, cmp);
+    }
+}
+
+template <class RandomIt>
+void sort_heap(RandomIt first, RandomIt last) {
+    tstl::sort_heap(first, last, std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <class RandomIt, class Compare>
+RandomIt is_heap_until(RandomIt first, RandomIt last, Compare cmp) {
+    return tstl::_dary_is_heap_until<2>(first, last, cmp);
+}
+
+template <class RandomIt>
+RandomIt is_heap_until(RandomIt first, RandomIt last) {
+    return tstl::is_heap_until(first, last,
+                               std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <class RandomIt, class Compare>
+bool is_heap(RandomIt first, RandomIt last, Compare cmp) {
+    return tstl::is_heap_until(first, last, cmp) == last;
+}
+
+template <class RandomIt>
+bool is_heap(RandomIt first, RandomIt last) {
+    return tstl::is_heap_until(first, last) == last;
+}
+
+// 快速排序（内省排序）
+// 以第二个、中间与末尾三者的中位数为基准，有序或逆序的输入不再退化为 O(n^2)；
+// 只递归处理较短的一侧，较长的一侧继续循环，栈深度为 O(log n)；短区间改用插入排序
+// 划分的轮数超过 2log(n) 时说明基准选得不好，剩余区间改用堆排序，最坏情况仍为 O(n log n)
+template <typename RandomIt, typename Size, typename Compare>
+void _quick_sort_loop(RandomIt first, RandomIt last, Size depth_limit, Compare cmp) {
+    while (last - first > 16) {
+        if (depth_limit == 0) {
+            tstl::make_heap(first, last, cmp);
+            tstl::sort_heap(first, last, cmp);
+            return;
+        }
+        --depth_limit;
+        tstl::_median_to_first(first, first + 1, first + (last - first) / 2, last - 1, cmp);
+        RandomIt cut = tstl::_unguarded_partition(first + 1, last, first, cmp);
+        if (cut - first < last - cut) {
+            tstl::_quick_sort_loop(first, cut, depth_limit, cmp);
+            first = cut;
+        } else {
+            tstl::_quick_sort_loop(cut, last, depth_limit, cmp);
+            last = cut;
         }
-        *l = basic;
-        quick_sort(first, l, cmp);
-        quick_sort(l + 1, last, cmp);
     }
+    tstl::_insertion_sort(first, last, cmp);
+}
+
+template <typename RandomIt, typename Compare>
+void quick_sort(RandomIt first, RandomIt last, Compare cmp) {
+    typename iterator_traits<RandomIt>::difference_type depth_limit = 0;
+    for (auto n = last - first; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    tstl::_quick_sort_loop(first, last, depth_limit, cmp);
 }
 
 // sort()接口
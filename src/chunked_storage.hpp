@@ -0,0 +1,542 @@
+#ifndef TSTL_SRC_CHUNKED_STORAGE_HPP
+#define TSTL_SRC_CHUNKED_STORAGE_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm.hpp"
+#include "iterator.hpp"
+#include "packed_vector.hpp"
+#include "vector.hpp"
+#include "memory/construct.hpp"
+#include "memory/memory_usage.hpp"
+
+namespace tstl {
+
+/**
+ * @brief 只在末尾增删元素的分块存储，作为 stack 的默认容器。
+ *
+ * 第 k 块可以容纳 first_chunk_size << k 个元素，块内连续。容量不足时分配下一块，
+ * 已有元素从不搬移，指向元素的引用与指针在元素被移除之前一直有效，也不会出现 vector
+ * 扩容时的复制与峰值内存。移除元素后块仍然保留，再次增长时直接复用，shrink_to_fit 释放空闲的块。
+ */
+template <class T, class Allocator = std::allocator<T>>
+class chunked_storage {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using chunk_alloc = typename alloc_traits::template rebind_alloc<T *>;
+
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+
+    // 第一块约占 512 字节
+    static constexpr size_type first_chunk_size = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+
+    chunked_storage() : chunked_storage(Allocator()) {
+    }
+
+    explicit chunked_storage(const Allocator &alloc)
+        : m_alloc(alloc), m_chunks(chunk_alloc(alloc)), m_size(0), m_chunk(0), m_begin(nullptr),
+          m_cur(nullptr), m_end(nullptr) {
+    }
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    chunked_storage(InputIt first, InputIt last, const Allocator &alloc = Allocator())
+        : chunked_storage(alloc) {
+        push_range(first, last);
+    }
+
+    chunked_storage(std::initializer_list<T> ilist, const Allocator &alloc = Allocator())
+        : chunked_storage(ilist.begin(), ilist.end(), alloc) {
+    }
+
+    chunked_storage(const chunked_storage &other)
+        : chunked_storage(other, alloc_traits::select_on_container_copy_construction(
+                                     other.m_alloc)) {
+    }
+
+    chunked_storage(const chunked_storage &other, const Allocator &alloc)
+        : chunked_storage(alloc) {
+        reserve(other.m_size);
+        other.m_for_each_segment([this](const T *p, size_type n) { push_range(p, p + n); });
+    }
+
+    chunked_storage(chunked_storage &&other) noexcept
+        : m_alloc(std::move(other.m_alloc)), m_chunks(std::move(other.m_chunks)),
+          m_size(other.m_size), m_chunk(other.m_chunk), m_begin(other.m_begin),
+          m_cur(other.m_cur), m_end(other.m_end) {
+        other.m_reset();
+    }
+
+    /**
+     * @brief 分配器与 other 的相等时接管 other 的块，否则逐个移动元素。
+     */
+    chunked_storage(chunked_storage &&other, const Allocator &alloc) : chunked_storage(alloc) {
+        if (m_alloc == other.m_alloc) {
+            m_steal(other);
+        } else {
+            m_move_elements(other);
+        }
+    }
+
+    // 分配器不随复制传播时保留自己的分配器，已分配的块直接复用
+    chunked_storage &operator=(const chunked_storage &other) {
+        if (this != &other) {
+            clear();
+            m_copy_assign_alloc(other,
+                                typename alloc_traits::propagate_on_container_copy_assignment());
+            reserve(other.m_size);
+            other.m_for_each_segment([this](const T *p, size_type n) { push_range(p, p + n); });
+        }
+        return *this;
+    }
+
+    chunked_storage &operator=(chunked_storage &&other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
+        if (this != &other) {
+            m_move_assign(other, typename alloc_traits::propagate_on_container_move_assignment());
+        }
+        return *this;
+    }
+
+    ~chunked_storage() {
+        clear();
+        m_release_chunks(0);
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return m_alloc;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * @brief 返回已分配的块能容纳的元素个数。
+     */
+    size_type capacity() const noexcept {
+        return m_chunks.empty() ? 0 : m_prefix(m_chunks.size());
+    }
+
+    /**
+     * @brief 预先分配足够容纳 n 个元素的块。
+     */
+    void reserve(size_type n) {
+        while (capacity() < n) {
+            m_allocate_chunk();
+        }
+    }
+
+    /**
+     * @brief 释放当前块之后的空闲块；没有元素时释放全部块。
+     */
+    void shrink_to_fit() noexcept {
+        if (m_size == 0) {
+            m_release_chunks(0);
+            m_reset();
+        } else {
+            m_release_chunks(m_chunk + 1);
+        }
+    }
+
+    /**
+     * @brief 返回自底向上第 pos 个元素，不进行边界检查。
+     */
+    reference operator[](size_type pos) noexcept {
+        const size_type k = m_chunk_of(pos);
+        return m_chunks[k][pos - m_prefix(k)];
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        const size_type k = m_chunk_of(pos);
+        return m_chunks[k][pos - m_prefix(k)];
+    }
+
+    reference at(size_type pos) {
+        if (pos >= m_size) {
+            throw std::out_of_range("chunked_storage::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= m_size) {
+            throw std::out_of_range("chunked_storage::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    reference front() noexcept {
+        return m_chunks[0][0];
+    }
+
+    const_reference front() const noexcept {
+        return m_chunks[0][0];
+    }
+
+    // 非空时 m_cur 一定不在块首，末尾元素总是 m_cur[-1]
+    reference back() noexcept {
+        return m_cur[-1];
+    }
+
+    const_reference back() const noexcept {
+        return m_cur[-1];
+    }
+
+    void push_back(const value_type &value) {
+        emplace_back(value);
+    }
+
+    void push_back(value_type &&value) {
+        emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        if (m_cur == m_end) {
+            return m_emplace_back_aux(std::forward<Args>(args)...);
+        }
+        alloc_traits::construct(m_alloc, m_cur, std::forward<Args>(args)...);
+        ++m_size;
+        return *m_cur++;
+    }
+
+    /**
+     * @brief 在末尾依次加入 [first, last) 中的元素。
+     *
+     * 前向迭代器按块批量构造，每块只检查一次剩余空间。
+     */
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    void push_range(InputIt first, InputIt last) {
+        m_push_range(first, last, tstl::_iterator_category(first));
+    }
+
+    void pop_back() noexcept {
+        alloc_traits::destroy(m_alloc, --m_cur);
+        --m_size;
+        m_leave_empty_chunk();
+    }
+
+    /**
+     * @brief 移除末尾的 n 个元素，n 不能超过 size()。
+     */
+    void pop_n(size_type n) noexcept {
+        while (n != 0) {
+            const size_type avail = static_cast<size_type>(m_cur - m_begin);
+            const size_type take = n < avail ? n : avail;
+            tstl::_destroy_a(m_cur - take, m_cur, m_alloc);
+            m_cur -= take;
+            m_size -= take;
+            n -= take;
+            m_leave_empty_chunk();
+        }
+    }
+
+    /**
+     * @brief 移除全部元素，已分配的块保留。
+     */
+    void clear() noexcept {
+        pop_n(m_size);
+    }
+
+    /**
+     * @brief 自底向上对每个元素调用 fn。
+     */
+    template <class Fn>
+    void for_each(Fn fn) const {
+        m_for_each_segment([&fn](const T *p, size_type n) {
+            for (size_type i = 0; i < n; ++i) {
+                fn(p[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief 返回占用的内存；已分配但未使用的槽位与块指针表计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = m_size * sizeof(T);
+        usage.overhead = sizeof(*this) + (capacity() - m_size) * sizeof(T) +
+                         m_chunks.capacity() * sizeof(T *);
+        return usage;
+    }
+
+    // 分配器不随交换传播时，要求两者相等
+    void swap(chunked_storage &other) noexcept {
+        m_swap_alloc(other, typename alloc_traits::propagate_on_container_swap());
+        m_chunks.swap(other.m_chunks);
+        tstl::swap(m_size, other.m_size);
+        tstl::swap(m_chunk, other.m_chunk);
+        tstl::swap(m_begin, other.m_begin);
+        tstl::swap(m_cur, other.m_cur);
+        tstl::swap(m_end, other.m_end);
+    }
+
+    friend void swap(chunked_storage &lhs, chunked_storage &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    // 元素个数相同的两个存储分块方式相同，可以逐块比较
+    friend bool operator==(const chunked_storage &lhs, const chunked_storage &rhs) {
+        if (lhs.m_size != rhs.m_size) {
+            return false;
+        }
+        for (size_type k = 0; lhs.m_prefix(k) < lhs.m_size; ++k) {
+            const T *a = lhs.m_chunks[k];
+            const T *b = rhs.m_chunks[k];
+            const size_type n = lhs.m_segment_size(k, lhs.m_size);
+            for (size_type i = 0; i < n; ++i) {
+                if (!(a[i] == b[i])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const chunked_storage &lhs, const chunked_storage &rhs) {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const chunked_storage &lhs, const chunked_storage &rhs) {
+        const size_type common = lhs.m_size < rhs.m_size ? lhs.m_size : rhs.m_size;
+        for (size_type k = 0; lhs.m_prefix(k) < common; ++k) {
+            const T *a = lhs.m_chunks[k];
+            const T *b = rhs.m_chunks[k];
+            const size_type n = lhs.m_segment_size(k, common);
+            for (size_type i = 0; i < n; ++i) {
+                if (a[i] < b[i]) {
+                    return true;
+                }
+                if (b[i] < a[i]) {
+                    return false;
+                }
+            }
+        }
+        return lhs.m_size < rhs.m_size;
+    }
+
+    friend bool operator>(const chunked_storage &lhs, const chunked_storage &rhs) {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(const chunked_storage &lhs, const chunked_storage &rhs) {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const chunked_storage &lhs, const chunked_storage &rhs) {
+        return !(lhs < rhs);
+    }
+
+  private:
+    Allocator m_alloc;
+    tstl::vector<T *, chunk_alloc> m_chunks; // 已分配的块，第 k 个元素指向第 k 块
+    size_type m_size;
+    size_type m_chunk; // 当前块的下标
+    // 当前块的起点、下一个空闲槽位与终点，尚未分配任何块时均为空
+    T *m_begin;
+    T *m_cur;
+    T *m_end;
+
+    static size_type m_chunk_capacity(size_type k) noexcept {
+        return first_chunk_size << k;
+    }
+
+    // 前 k 块的总容量
+    static size_type m_prefix(size_type k) noexcept {
+        return first_chunk_size * ((size_type(1) << k) - 1);
+    }
+
+    // 第 pos 个元素所在的块：pos / first_chunk_size + 1 的最高位
+    static size_type m_chunk_of(size_type pos) noexcept {
+        return static_cast<size_type>(_bit_width(pos / first_chunk_size + 1) - 1);
+    }
+
+    // 共有 n 个元素时第 k 块中的元素个数
+    static size_type m_segment_size(size_type k, size_type n) noexcept {
+        const size_type rest = n - m_prefix(k);
+        return rest < m_chunk_capacity(k) ? rest : m_chunk_capacity(k);
+    }
+
+    void m_reset() noexcept {
+        m_size = 0;
+        m_chunk = 0;
+        m_begin = m_cur = m_end = nullptr;
+    }
+
+    // 接管 other 的全部块，要求本存储没有块，且两者的分配器相等或已换用 other 的分配器
+    void m_steal(chunked_storage &other) noexcept {
+        m_chunks = std::move(other.m_chunks);
+        m_size = other.m_size;
+        m_chunk = other.m_chunk;
+        m_begin = other.m_begin;
+        m_cur = other.m_cur;
+        m_end = other.m_end;
+        other.m_reset();
+    }
+
+    // 要求本存储为空，逐个移动 other 的元素后清空 other
+    void m_move_elements(chunked_storage &other) {
+        reserve(other.m_size);
+        other.m_for_each_segment([this](T *p, size_type n) {
+            for (size_type i = 0; i < n; ++i) {
+                emplace_back(std::move(p[i]));
+            }
+        });
+        other.clear();
+    }
+
+    // 要求本存储为空；分配器不同时已有的块由旧分配器释放，块指针表随分配器一起更换
+    void m_copy_assign_alloc(const chunked_storage &other, std::true_type) {
+        if (m_alloc != other.m_alloc) {
+            m_release_chunks(0);
+            m_reset();
+            m_chunks = tstl::vector<T *, chunk_alloc>(chunk_alloc(other.m_alloc));
+        }
+        m_alloc = other.m_alloc;
+    }
+    void m_copy_assign_alloc(const chunked_storage &, std::false_type) {
+    }
+
+    void m_move_assign(chunked_storage &other, std::true_type) {
+        clear();
+        m_release_chunks(0);
+        m_alloc = other.m_alloc;
+        m_steal(other);
+    }
+
+    // 分配器不随移动转移时，只有两者相等才能直接接管块，否则逐个移动到自己的块中
+    void m_move_assign(chunked_storage &other, std::false_type) {
+        clear();
+        if (m_alloc == other.m_alloc) {
+            m_release_chunks(0);
+            m_steal(other);
+        } else {
+            m_move_elements(other);
+        }
+    }
+
+    void m_swap_alloc(chunked_storage &other, std::true_type) noexcept {
+        tstl::swap(m_alloc, other.m_alloc);
+    }
+    void m_swap_alloc(chunked_storage &, std::false_type) noexcept {
+    }
+
+    // 进入已分配的第 k 块，k 之前的块均已填满，因此 m_cur 位于块尾
+    void m_enter_chunk(size_type k) noexcept {
+        m_chunk = k;
+        m_begin = m_chunks[k];
+        m_end = m_begin + m_chunk_capacity(k);
+        m_cur = m_end;
+    }
+
+    void m_allocate_chunk() {
+        T *p = alloc_traits::allocate(m_alloc, m_chunk_capacity(m_chunks.size()));
+        try {
+            m_chunks.push_back(p);
+        } catch (...) {
+            alloc_traits::deallocate(m_alloc, p, m_chunk_capacity(m_chunks.size()));
+            throw;
+        }
+    }
+
+    // 释放下标不小于 k 的块，这些块中不能有元素
+    void m_release_chunks(size_type k) noexcept {
+        while (m_chunks.size() > k) {
+            const size_type last = m_chunks.size() - 1;
+            alloc_traits::deallocate(m_alloc, m_chunks[last], m_chunk_capacity(last));
+            m_chunks.pop_back();
+        }
+    }
+
+    // 当前块已满，移到下一块（必要时分配），此时 m_cur 位于块首
+    void m_next_chunk() {
+        const size_type next = m_begin == nullptr ? 0 : m_chunk + 1;
+        if (next == m_chunks.size()) {
+            m_allocate_chunk();
+        }
+        m_enter_chunk(next);
+        m_cur = m_begin;
+    }
+
+    // 当前块中没有元素时回到上一块，维持非空时 m_cur 不在块首
+    void m_leave_empty_chunk() noexcept {
+        if (m_cur == m_begin && m_chunk != 0) {
+            m_enter_chunk(m_chunk - 1);
+        }
+    }
+
+    template <class... Args>
+    reference m_emplace_back_aux(Args &&...args) {
+        m_next_chunk();
+        try {
+            alloc_traits::construct(m_alloc, m_cur, std::forward<Args>(args)...);
+        } catch (...) {
+            m_leave_empty_chunk();
+            throw;
+        }
+        ++m_size;
+        return *m_cur++;
+    }
+
+    template <class InputIt>
+    void m_push_range(InputIt first, InputIt last, tstl::input_iterator_tag) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    template <class ForwardIt>
+    void m_push_range(ForwardIt first, ForwardIt last, tstl::forward_iterator_tag) {
+        size_type n = static_cast<size_type>(tstl::distance(first, last));
+        while (n != 0) {
+            if (m_cur == m_end) {
+                m_next_chunk();
+            }
+            const size_type room = static_cast<size_type>(m_end - m_cur);
+            const size_type take = n < room ? n : room;
+            T *dest = m_cur;
+            try {
+                for (size_type i = 0; i < take; ++i, ++first) {
+                    alloc_traits::construct(m_alloc, dest, *first);
+                    ++dest;
+                }
+            } catch (...) {
+                tstl::_destroy_a(m_cur, dest, m_alloc);
+                m_leave_empty_chunk();
+                throw;
+            }
+            m_size += take;
+            m_cur = dest;
+            n -= take;
+        }
+    }
+
+    // 自底向上对每一段连续的元素调用 fn(p, n)
+    template <class Fn>
+    void m_for_each_segment(Fn fn) const {
+        for (size_type k = 0; m_prefix(k) < m_size; ++k) {
+            fn(m_chunks[k], m_segment_size(k, m_size));
+        }
+    }
+};
+
+} // namespace tstl
+
+#endif
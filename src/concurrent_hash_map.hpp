@@ -0,0 +1,337 @@
+#ifndef TSTL_SRC_CONCURRENT_HASH_MAP_HPP
+#define TSTL_SRC_CONCURRENT_HASH_MAP_HPP
+
+// 多线程共享的哈希映射，键值按哈希值的高位分到若干互相独立的分片，每个分片是一张开放寻址表，
+// 控制字节与探测方式与 hashtable 相同
+// 每个分片有一把读写锁：find、contains 取共享锁，不同的读者可以同时读取同一个分片；
+// 写操作只对所在的分片取独占锁，分片数远多于线程数时写者之间也很少竞争
+// 所有访问都在锁内进行，扩容后旧的槽位数组可以立即释放
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "hashtable.hpp"
+
+namespace tstl {
+
+template <class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class concurrent_hash_map {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+  private:
+    using ctrl_t = hashtable_ctrl_t;
+    using group = hashtable_group;
+
+    struct slot_type {
+        Key key;
+        T value;
+    };
+
+    // 与 hashtable 相同：计算哈希值与移动构造都不会抛出异常时扩容才移动元素，元素不能复制时只能移动
+    using relocate_by_move = std::integral_constant<
+        bool, (noexcept(std::declval<const Hash &>()(std::declval<const Key &>())) &&
+               std::is_nothrow_move_constructible<slot_type>::value) ||
+                  !std::is_copy_constructible<slot_type>::value>;
+
+    // 一个槽位数组，布局与 hashtable 相同
+    struct table {
+        ctrl_t *ctrl;
+        slot_type *slots;
+        size_type capacity;
+    };
+
+    // 分片按缓存行对齐，避免不同分片的锁之间的伪共享
+    // tab 与 growth_left 只在持有锁时访问；size 另外供 size() 不加锁地读取近似值
+    struct alignas(64) shard {
+        table *tab = nullptr;
+        std::atomic<size_type> size{0};
+        size_type growth_left = 0;
+        mutable std::shared_mutex lock;
+    };
+
+    using read_lock = std::shared_lock<std::shared_mutex>;
+    using write_lock = std::lock_guard<std::shared_mutex>;
+
+    std::unique_ptr<shard[]> m_shards;
+    size_type m_shard_count;
+    int m_shard_shift; // 哈希值右移 m_shard_shift 位得到分片编号
+    table m_empty;     // 所有分片共用的空数组，不会被写入
+    Hash m_hash;
+    KeyEqual m_equal;
+
+  public:
+    // 分片数向上取为 2 的幂，默认为硬件线程数的 4 倍
+    explicit concurrent_hash_map(size_type shard_count = default_shard_count(),
+                                 const Hash &hash = Hash(),
+                                 const KeyEqual &equal = KeyEqual())
+        : m_hash(hash), m_equal(equal) {
+        m_shard_count = 1;
+        int bits = 0;
+        while (m_shard_count < shard_count) {
+            m_shard_count <<= 1;
+            ++bits;
+        }
+        m_shard_shift = bits == 0 ? 0 : static_cast<int>(sizeof(size_type) * 8) - bits;
+        m_empty = table{hashtable_empty_group(), nullptr, 0};
+        m_shards.reset(new shard[m_shard_count]);
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            m_shards[i].tab = &m_empty;
+        }
+    }
+
+    concurrent_hash_map(const concurrent_hash_map &) = delete;
+    concurrent_hash_map &operator=(const concurrent_hash_map &) = delete;
+
+    ~concurrent_hash_map() {
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            auto t = m_shards[i].tab;
+            destroy_elements(t);
+            if (t != &m_empty) {
+                free_table(t);
+            }
+        }
+    }
+
+    static size_type default_shard_count() noexcept {
+        auto n = std::thread::hardware_concurrency();
+        return n == 0 ? 16 : n * 4;
+    }
+
+    size_type shard_count() const noexcept {
+        return m_shard_count;
+    }
+
+    // 各分片元素个数之和，有并发修改时只是近似值
+    size_type size() const noexcept {
+        size_type n = 0;
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            n += m_shards[i].size.load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // 查找 key，找到时把映射值复制到 out 并返回 true
+    bool find(const key_type &key, mapped_type &out) const {
+        auto hash = hashtable_mix(m_hash(key));
+        auto &s = shard_of(hash);
+        read_lock guard(s.lock);
+        auto i = find_index(s.tab, key, hash);
+        if (i == s.tab->capacity) {
+            return false;
+        }
+        out = s.tab->slots[i].value;
+        return true;
+    }
+
+    bool contains(const key_type &key) const {
+        auto hash = hashtable_mix(m_hash(key));
+        auto &s = shard_of(hash);
+        read_lock guard(s.lock);
+        return find_index(s.tab, key, hash) != s.tab->capacity;
+    }
+
+    // 插入或覆盖，返回是否插入了新元素
+    template <class M>
+    bool insert_or_assign(const key_type &key, M &&obj) {
+        auto hash = hashtable_mix(m_hash(key));
+        auto &s = shard_of(hash);
+        write_lock guard(s.lock);
+        auto t = s.tab;
+        auto i = find_index(t, key, hash);
+        if (i != t->capacity) {
+            t->slots[i].value = std::forward<M>(obj);
+            return false;
+        }
+        i = hashtable_find_first_non_full(t->ctrl, t->capacity, hash);
+        if (s.growth_left == 0 && t->ctrl[i] != hashtable_deleted) {
+            t = rehash_and_grow(s);
+            i = hashtable_find_first_non_full(t->ctrl, t->capacity, hash);
+        }
+        ::new (static_cast<void *>(t->slots + i)) slot_type{key, std::forward<M>(obj)};
+        s.growth_left -= t->ctrl[i] == hashtable_empty ? 1 : 0;
+        hashtable_set_ctrl(t->ctrl, t->capacity, i, hashtable_h2(hash));
+        s.size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 删除 key，返回是否存在
+    bool erase(const key_type &key) {
+        auto hash = hashtable_mix(m_hash(key));
+        auto &s = shard_of(hash);
+        write_lock guard(s.lock);
+        auto t = s.tab;
+        auto i = find_index(t, key, hash);
+        if (i == t->capacity) {
+            return false;
+        }
+        t->slots[i].~slot_type();
+        s.growth_left += hashtable_erase_ctrl(t->ctrl, t->capacity, i) ? 1 : 0;
+        s.size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 持有分片的独占锁对 key 的映射值调用 fn(mapped_type &)，可以就地修改，返回是否存在
+    // fn 中不能再访问同一个 concurrent_hash_map
+    template <class Fn>
+    bool visit(const key_type &key, Fn fn) {
+        auto hash = hashtable_mix(m_hash(key));
+        auto &s = shard_of(hash);
+        write_lock guard(s.lock);
+        auto t = s.tab;
+        auto i = find_index(t, key, hash);
+        if (i == t->capacity) {
+            return false;
+        }
+        fn(t->slots[i].value);
+        return true;
+    }
+
+    // 清空元素，各分片保留槽位数组
+    void clear() {
+        for (size_type k = 0; k < m_shard_count; ++k) {
+            auto &s = m_shards[k];
+            write_lock guard(s.lock);
+            auto t = s.tab;
+            if (t->capacity == 0) {
+                continue;
+            }
+            destroy_elements(t);
+            reset_ctrl(t);
+            s.growth_left = hashtable_capacity_to_growth(t->capacity);
+            s.size.store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    // 分片编号取哈希值的最高几位，与分片内部使用的低位互不相关
+    shard &shard_of(size_type hash) const noexcept {
+        return m_shards[m_shard_shift == 0 ? 0 : hash >> m_shard_shift];
+    }
+
+    // 持有锁时的查找，返回槽位下标，不存在时返回 capacity
+    size_type find_index(const table *t, const key_type &key, size_type hash) const {
+        hashtable_probe_seq seq(hashtable_h1(hash), t->capacity);
+        const ctrl_t h = hashtable_h2(hash);
+        while (true) {
+            group g(t->ctrl + seq.offset());
+            for (auto match = g.match(h); match; ++match) {
+                auto i = seq.offset(match.lowest());
+                if (m_equal(t->slots[i].key, key)) {
+                    return i;
+                }
+            }
+            if (g.match_empty()) {
+                return t->capacity;
+            }
+            seq.next();
+        }
+    }
+
+    // 分片中没有可用空槽位时调用，返回之后使用的数组
+    table *rehash_and_grow(shard &s) {
+        auto t = s.tab;
+        auto size = s.size.load(std::memory_order_relaxed);
+        if (t->capacity == 0) {
+            return grow(s, 1);
+        }
+        // 墓碑过多时以相同的容量重建
+        if (t->capacity > group::width && size * 32 <= t->capacity * 25) {
+            return grow(s, t->capacity);
+        }
+        return grow(s, t->capacity * 2 + 1);
+    }
+
+    // 换用新数组，元素复制或移动过去后释放旧数组；复制失败时旧数组保持不变
+    // 只有放置过程不会失败（或元素只能移动）时才移动元素，见 relocate_by_move
+    table *grow(shard &s, size_type capacity) {
+        auto old = s.tab;
+        auto t = allocate_table(capacity);
+        size_type i = 0;
+        try {
+            for (; i < old->capacity; ++i) {
+                if (hashtable_is_full(old->ctrl[i])) {
+                    auto &src = old->slots[i];
+                    auto hash = hashtable_mix(m_hash(src.key));
+                    auto j = hashtable_find_first_non_full(t->ctrl, capacity, hash);
+                    ::new (static_cast<void *>(t->slots + j))
+                        slot_type(relocate_arg(src, relocate_by_move()));
+                    hashtable_set_ctrl(t->ctrl, capacity, j, hashtable_h2(hash));
+                }
+            }
+        } catch (...) {
+            destroy_elements(t);
+            free_table(t);
+            throw;
+        }
+        s.growth_left =
+            hashtable_capacity_to_growth(capacity) - s.size.load(std::memory_order_relaxed);
+        s.tab = t;
+        destroy_elements(old);
+        if (old != &m_empty) {
+            free_table(old);
+        }
+        return t;
+    }
+
+    static slot_type &&relocate_arg(slot_type &slot, std::true_type) noexcept {
+        return std::move(slot);
+    }
+    static const slot_type &relocate_arg(slot_type &slot, std::false_type) noexcept {
+        return slot;
+    }
+
+    table *allocate_table(size_type capacity) {
+        std::unique_ptr<table> t(new table{nullptr, nullptr, capacity});
+        std::allocator<ctrl_t> ctrl_alloc;
+        std::allocator<slot_type> slot_alloc;
+        t->ctrl = ctrl_alloc.allocate(capacity + group::width);
+        try {
+            t->slots = slot_alloc.allocate(capacity);
+        } catch (...) {
+            ctrl_alloc.deallocate(t->ctrl, capacity + group::width);
+            throw;
+        }
+        reset_ctrl(t.get());
+        return t.release();
+    }
+
+    static void free_table(table *t) noexcept {
+        std::allocator<ctrl_t>().deallocate(t->ctrl, t->capacity + group::width);
+        std::allocator<slot_type>().deallocate(t->slots, t->capacity);
+        delete t;
+    }
+
+    static void reset_ctrl(table *t) noexcept {
+        std::memset(t->ctrl, static_cast<unsigned char>(hashtable_empty),
+                    t->capacity + group::width);
+        t->ctrl[t->capacity] = hashtable_sentinel;
+    }
+
+    static void destroy_elements(table *t) noexcept {
+        for (size_type i = 0; i < t->capacity; ++i) {
+            if (hashtable_is_full(t->ctrl[i])) {
+                t->slots[i].~slot_type();
+            }
+        }
+    }
+};
+
+} // namespace tstl
+
+#endif
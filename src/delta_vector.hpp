@@ -0,0 +1,331 @@
+#ifndef TSTL_SRC_DELTA_VECTOR_HPP
+#define TSTL_SRC_DELTA_VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "iterator.hpp"
+#include "memory/memory_usage.hpp"
+#include "packed_vector.hpp"
+#include "vector.hpp"
+
+namespace tstl {
+
+/**
+ * @brief 非递减无符号整数序列的压缩存储，适合倒排表、时间戳列等有序数据。
+ *
+ * 元素每 128 个分为一块，块内保存相邻元素之差，按块内最大差值的位宽整块位压缩；
+ * 每块的首元素与数据位置另存为跳表，lower_bound 先在跳表上二分，再只解压一块。
+ * 末尾不满一块的元素不压缩。随机访问需要解压所在的块；顺序遍历时迭代器每步只取出一个差值。
+ * 追加小于末元素的值时抛出 std::invalid_argument。
+ */
+class delta_vector {
+  public:
+    using value_type = std::uint64_t;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static constexpr size_type block_size = 128;
+
+    // 只读的前向迭代器，只保存下标与当前元素的值，前进时加上下一个差值
+    class const_iterator {
+      public:
+        using iterator_category = tstl::forward_iterator_tag;
+        using value_type = std::uint64_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::uint64_t *;
+        using reference = const std::uint64_t &;
+
+        const_iterator() noexcept : m_vec(nullptr), m_pos(0), m_value(0) {
+        }
+
+        reference operator*() const noexcept {
+            return m_value;
+        }
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        const_iterator &operator++() noexcept {
+            if (++m_pos < m_vec->m_size) {
+                m_value = m_vec->m_next_value(m_pos, m_value);
+            }
+            return *this;
+        }
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        // 在容器中的下标
+        size_type index() const noexcept {
+            return m_pos;
+        }
+
+        bool operator==(const const_iterator &rhs) const noexcept {
+            return m_pos == rhs.m_pos;
+        }
+        bool operator!=(const const_iterator &rhs) const noexcept {
+            return m_pos != rhs.m_pos;
+        }
+
+      private:
+        friend class delta_vector;
+
+        const delta_vector *m_vec;
+        size_type m_pos;
+        value_type m_value; // 位于 m_pos 的元素，m_pos 为 size() 时无意义
+
+        const_iterator(const delta_vector *vec, size_type pos, value_type value) noexcept
+            : m_vec(vec), m_pos(pos), m_value(value) {
+        }
+    };
+    using iterator = const_iterator;
+
+    delta_vector() noexcept : m_size(0) {
+    }
+
+    /**
+     * @brief 由非递减的 [first, last) 构造。
+     */
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    delta_vector(InputIt first, InputIt last) : m_size(0) {
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief 返回位于 pos 的元素，需要解压其所在的块，不进行边界检查。
+     */
+    value_type operator[](size_type pos) const noexcept {
+        const size_type b = pos / block_size;
+        if (b == m_blocks.size()) {
+            return m_tail[pos % block_size];
+        }
+        value_type buf[block_size];
+        m_decode_block(b, buf);
+        return buf[pos % block_size];
+    }
+
+    /**
+     * @brief 返回位于 pos 的元素，越界时抛出 std::out_of_range。
+     */
+    value_type at(size_type pos) const {
+        if (pos >= m_size) {
+            throw std::out_of_range("delta_vector::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    value_type front() const noexcept {
+        return m_blocks.empty() ? m_tail[0] : m_blocks[0].first;
+    }
+
+    value_type back() const noexcept {
+        return m_last;
+    }
+
+    /**
+     * @brief 追加 value，要求不小于末元素。
+     */
+    void push_back(value_type value) {
+        if (m_size != 0 && value < m_last) {
+            throw std::invalid_argument("delta_vector::push_back: values must be non-decreasing");
+        }
+        m_tail.push_back(value);
+        m_last = value;
+        ++m_size;
+        if (m_tail.size() == block_size) {
+            m_seal_tail();
+        }
+    }
+
+    void clear() noexcept {
+        m_blocks.clear();
+        m_words.clear();
+        m_tail.clear();
+        m_size = 0;
+    }
+
+    /**
+     * @brief 返回指向首个不小于 value 的元素的迭代器，O(log n) 次比较加至多一块的解压。
+     */
+    const_iterator lower_bound(value_type value) const noexcept {
+        // 跳表中首个首元素不小于 value 的块，答案位于它的前一块中或就是它的首元素
+        size_type lo = 0;
+        size_type hi = m_blocks.size();
+        while (lo < hi) {
+            size_type mid = lo + (hi - lo) / 2;
+            if (m_blocks[mid].first < value) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > 0) {
+            value_type buf[block_size];
+            m_decode_block(lo - 1, buf);
+            for (size_type i = 1; i < block_size; ++i) {
+                if (buf[i] >= value) {
+                    return const_iterator(this, (lo - 1) * block_size + i, buf[i]);
+                }
+            }
+        }
+        if (lo < m_blocks.size()) {
+            return const_iterator(this, lo * block_size, m_blocks[lo].first);
+        }
+        size_type i = 0;
+        while (i < m_tail.size() && m_tail[i] < value) {
+            ++i;
+        }
+        return const_iterator(this, lo * block_size + i, i < m_tail.size() ? m_tail[i] : 0);
+    }
+
+    bool contains(value_type value) const noexcept {
+        const_iterator it = lower_bound(value);
+        return it != end() && *it == value;
+    }
+
+    /**
+     * @brief 按顺序把全部元素解压到 out。
+     */
+    template <class OutputIt>
+    OutputIt decode(OutputIt out) const {
+        value_type buf[block_size];
+        for (size_type b = 0; b < m_blocks.size(); ++b) {
+            m_decode_block(b, buf);
+            for (size_type i = 0; i < block_size; ++i) {
+                *out = buf[i];
+                ++out;
+            }
+        }
+        for (size_type i = 0; i < m_tail.size(); ++i) {
+            *out = m_tail[i];
+            ++out;
+        }
+        return out;
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0, m_size == 0 ? 0 : front());
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, m_size, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * @brief 返回占用的内存；payload 为压缩后的数据与未压缩的末尾元素，跳表计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = m_words.size() * sizeof(std::uint64_t) + m_tail.size() * sizeof(value_type);
+        usage.overhead = sizeof(*this) + m_blocks.capacity() * sizeof(block) +
+                         m_words.capacity() * sizeof(std::uint64_t) +
+                         m_tail.capacity() * sizeof(value_type) - usage.payload;
+        return usage;
+    }
+
+    friend bool operator==(const delta_vector &lhs, const delta_vector &rhs) {
+        if (lhs.m_size != rhs.m_size) {
+            return false;
+        }
+        for (auto l = lhs.begin(), r = rhs.begin(); l != lhs.end(); ++l, ++r) {
+            if (*l != *r) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const delta_vector &lhs, const delta_vector &rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    // 跳表项：块的首元素、块数据在 m_words 中的位置与差值的位宽
+    // 块内第 0 个差值恒为 0，128 个差值恰好占据 2 * width 个字，可以整组解压
+    struct block {
+        value_type first;
+        size_type word;
+        unsigned width;
+    };
+
+    tstl::vector<block> m_blocks;
+    tstl::vector<std::uint64_t> m_words;
+    tstl::vector<value_type> m_tail; // 末尾不满一块的元素
+    value_type m_last = 0;
+    size_type m_size;
+
+    void m_seal_tail() {
+        value_type max_delta = 0;
+        for (size_type i = 1; i < block_size; ++i) {
+            value_type d = m_tail[i] - m_tail[i - 1];
+            max_delta = d > max_delta ? d : max_delta;
+        }
+        const unsigned width = _bit_width(max_delta);
+        m_blocks.push_back(block{m_tail[0], m_words.size(), width});
+        m_words.resize(m_words.size() + 2 * width);
+        std::uint64_t *words = m_words.data() + m_blocks.back().word;
+        for (size_type i = 1; i < block_size; ++i) {
+            _bitpack_set(words, width, i, m_tail[i] - m_tail[i - 1]);
+        }
+        m_tail.clear();
+    }
+
+    // 位于 pos 的元素，prev 为位于 pos - 1 的元素：块首取跳表，块内加上一个差值
+    value_type m_next_value(size_type pos, value_type prev) const noexcept {
+        const size_type b = pos / block_size;
+        const size_type i = pos % block_size;
+        if (b == m_blocks.size()) {
+            return m_tail[i];
+        }
+        const block &blk = m_blocks[b];
+        if (i == 0) {
+            return blk.first;
+        }
+        return prev + _bitpack_get(m_words.data() + blk.word, blk.width, i);
+    }
+
+    // 解压第 b 块：整组解压差值后求前缀和
+    void m_decode_block(size_type b, value_type *out) const noexcept {
+        if (b == m_blocks.size()) {
+            for (size_type i = 0; i < m_tail.size(); ++i) {
+                out[i] = m_tail[i];
+            }
+            return;
+        }
+        const block &blk = m_blocks[b];
+        const std::uint64_t *words = m_words.data() + blk.word;
+        _bitunpack64(words, blk.width, out);
+        _bitunpack64(words + blk.width, blk.width, out + 64);
+        value_type v = blk.first;
+        for (size_type i = 0; i < block_size; ++i) {
+            v += out[i];
+            out[i] = v;
+        }
+    }
+};
+
+} // namespace tstl
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "iterator.hpp"
 #include "memory/uninitialized.hpp"
+#include "memory/memory_usage.hpp"
+#include "memory/memory_resource.hpp"
 #include "algorithm.hpp"
 #include <limits>
 #include <stdexcept>
@@ -232,7 +234,21 @@ class deque {
         m_swap_data(other);
     }
 
-    deque(deque &&other, const Allocator &alloc) : deque(std::move(other), Allocator(alloc)) {
+    // 分配器不同时无法接管 other 的缓冲区，只能逐个移动元素
+    deque(deque &&other, const Allocator &alloc) : m_alloc(alloc), m_map_alloc(m_alloc) {
+        if (m_alloc == other.m_alloc) {
+            m_init_map(0);
+            m_swap_data(other);
+        } else {
+            m_init_map(other.size());
+            try {
+                tstl::_uninitialized_move_a(other.begin(), other.end(), m_start, m_alloc);
+            } catch (...) {
+                m_destroy_nodes(m_start.m_node, m_finish.m_node + 1);
+                m_deallocate_map(m_map, m_map_size);
+                throw;
+            }
+        }
     }
 
     deque(std::initializer_list<T> init, const Allocator &alloc = Allocator())
@@ -242,6 +258,7 @@ class deque {
 
     ~deque() {
         if (m_start.m_node != nullptr) {
+            tstl::_destroy_a(m_start, m_finish, m_alloc);
             m_destroy_nodes(m_start.m_node, m_finish.m_node + 1);
             m_deallocate_map(m_map, m_map_size);
         }
@@ -262,8 +279,10 @@ class deque {
         return *this;
     }
 
-    deque &operator=(deque &&other) noexcept {
-        m_swap_data(other);
+    deque &operator=(deque &&other) {
+        if (this != &other) {
+            m_move_assign(other, typename alloc_traits::propagate_on_container_move_assignment());
+        }
         return *this;
     }
 
@@ -374,9 +393,19 @@ class deque {
         return tstl::distance(begin(), end());
     }
 
+    // 已分配的缓冲区中未使用的部分与中控器计入额外开销
+    container_memory memory_usage() const noexcept {
+        const size_type buffers = static_cast<size_type>(m_finish.m_node - m_start.m_node) + 1;
+        container_memory usage;
+        usage.payload = size() * sizeof(T);
+        usage.overhead = sizeof(*this) + buffers * m_buffer_size * sizeof(T) - usage.payload +
+                         m_map_size * sizeof(pointer);
+        return usage;
+    }
+
     size_type max_size() const {
         size_type diff_max = std::numeric_limits<difference_type>::max();
-        size_type alloc_max = alloc_traits::max_size();
+        size_type alloc_max = alloc_traits::max_size(m_alloc);
         return tstl::min(diff_max, alloc_max);
     }
 
@@ -560,6 +589,28 @@ class deque {
     iterator m_start;
     iterator m_finish;
 
+    // 分配器随移动转移：tmp 接管 other 后与 *this 整体交换，原有元素由 tmp 以原分配器释放
+    void m_move_assign(deque &other, std::true_type) {
+        deque tmp(std::move(other));
+        m_swap_data(tmp);
+        tstl::swap(m_alloc, tmp.m_alloc);
+        tstl::swap(m_map_alloc, tmp.m_map_alloc);
+    }
+
+    // 分配器不随移动转移时，只有两者相等才能直接接管缓冲区，否则逐个移动到自己的缓冲区中
+    void m_move_assign(deque &other, std::false_type) {
+        if (m_alloc == other.m_alloc) {
+            deque tmp(std::move(other));
+            m_swap_data(tmp);
+        } else {
+            clear();
+            for (T &value : other) {
+                emplace_back(std::move(value));
+            }
+            other.clear();
+        }
+    }
+
     void m_swap_data(deque &other) {
         tstl::swap(m_map, other.m_map);
         tstl::swap(m_map_size, other.m_map_size);
@@ -1124,6 +1175,11 @@ void swap(deque<T, Alloc> &lhs, deque<T, Alloc> &rhs) {
     lhs.swap(rhs);
 }
 
+namespace pmr {
+template <class T>
+using deque = tstl::deque<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstl
 
 #endif
@@ -0,0 +1,644 @@
+#ifndef TSTL_SRC_DYNAMIC_BITSET_HPP
+#define TSTL_SRC_DYNAMIC_BITSET_HPP
+
+// 长度在运行时确定的位集合，每个 64 位字存放 64 位，末尾字中超出 size() 的位恒为 0
+// 集合运算与计数逐字并行进行；以 -mavx2 编译时一次处理 4 个字，
+// 计数使用按半字节查表的 AVX2 popcount，否则交给编译器自动向量化的逐字循环
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#if defined(__AVX2__) && !defined(TSTL_BITSET_NO_SIMD)
+#include <immintrin.h>
+#define TSTL_BITSET_AVX2 1
+#endif
+
+#include "iterator.hpp"
+#include "memory/memory_usage.hpp"
+#include "vector.hpp"
+
+namespace tstl {
+
+inline unsigned _bitset_popcount(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+inline unsigned _bitset_countr_zero(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    for (; (x & 1) == 0; x >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// 逐字运算，AVX2 下另有一次处理 4 个字的版本
+struct _bitset_and {
+    static std::uint64_t word(std::uint64_t a, std::uint64_t b) noexcept {
+        return a & b;
+    }
+#ifdef TSTL_BITSET_AVX2
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_and_si256(a, b);
+    }
+#endif
+};
+
+struct _bitset_or {
+    static std::uint64_t word(std::uint64_t a, std::uint64_t b) noexcept {
+        return a | b;
+    }
+#ifdef TSTL_BITSET_AVX2
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_or_si256(a, b);
+    }
+#endif
+};
+
+struct _bitset_xor {
+    static std::uint64_t word(std::uint64_t a, std::uint64_t b) noexcept {
+        return a ^ b;
+    }
+#ifdef TSTL_BITSET_AVX2
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+#endif
+};
+
+// a & ~b
+struct _bitset_andnot {
+    static std::uint64_t word(std::uint64_t a, std::uint64_t b) noexcept {
+        return a & ~b;
+    }
+#ifdef TSTL_BITSET_AVX2
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_andnot_si256(b, a);
+    }
+#endif
+};
+
+// 只取左操作数，用于单个位集合的计数
+struct _bitset_lhs {
+    static std::uint64_t word(std::uint64_t a, std::uint64_t) noexcept {
+        return a;
+    }
+#ifdef TSTL_BITSET_AVX2
+    static __m256i vec(__m256i a, __m256i) noexcept {
+        return a;
+    }
+#endif
+};
+
+#ifdef TSTL_BITSET_AVX2
+inline __m256i _bitset_load(const std::uint64_t *p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+// 每个字节的 1 的个数由高低两个半字节查表相加，再按 64 位求和
+inline __m256i _bitset_popcount256(__m256i v) noexcept {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                                            1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_and_si256(v, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    const __m256i cnt =
+        _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+#endif
+
+// dst[i] = Op(a[i], b[i])，dst 可以与 a 或 b 相同
+template <class Op>
+void _bitset_apply(std::uint64_t *dst, const std::uint64_t *a, const std::uint64_t *b,
+                   std::size_t n) noexcept {
+    std::size_t i = 0;
+#ifdef TSTL_BITSET_AVX2
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v = Op::vec(_bitset_load(a + i), _bitset_load(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+    }
+#endif
+    for (; i < n; ++i) {
+        dst[i] = Op::word(a[i], b[i]);
+    }
+}
+
+// 统计 Op(a[i], b[i]) 中 1 的个数，不生成中间结果
+template <class Op>
+std::size_t _bitset_count(const std::uint64_t *a, const std::uint64_t *b,
+                          std::size_t n) noexcept {
+    std::size_t i = 0;
+    std::size_t count = 0;
+#ifdef TSTL_BITSET_AVX2
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_epi64(
+            acc, _bitset_popcount256(Op::vec(_bitset_load(a + i), _bitset_load(b + i))));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    count = static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+    for (; i < n; ++i) {
+        count += _bitset_popcount(Op::word(a[i], b[i]));
+    }
+    return count;
+}
+
+/**
+ * @brief 长度可变的位集合，每位只占 1 bit。
+ *
+ * 提供逐字并行的与、或、异或、差集（andnot）运算，包括原地修改的形式、写入已有对象的 assign_*
+ * 形式与不生成中间结果的 *_count 计数；find_first、find_next 与 ones() 借助 ctz 跳过为 0 的位。
+ * 二元运算要求两个操作数长度相同，否则抛出 std::invalid_argument。
+ */
+class dynamic_bitset {
+  public:
+    using block_type = std::uint64_t;
+    using size_type = std::size_t;
+
+    static constexpr size_type bits_per_block = 64;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // 依次给出为 1 的位的下标的前向迭代器，每次前进用 ctz 定位下一个 1
+    class one_iterator {
+      public:
+        using iterator_category = tstl::forward_iterator_tag;
+        using value_type = size_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_type *;
+        using reference = size_type;
+
+        one_iterator() noexcept : m_blocks(nullptr), m_count(0), m_block(0), m_word(0) {
+        }
+
+        size_type operator*() const noexcept {
+            return m_block * bits_per_block + _bitset_countr_zero(m_word);
+        }
+
+        one_iterator &operator++() noexcept {
+            m_word &= m_word - 1;
+            m_skip_zero();
+            return *this;
+        }
+        one_iterator operator++(int) noexcept {
+            one_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const one_iterator &rhs) const noexcept {
+            return m_block == rhs.m_block && m_word == rhs.m_word;
+        }
+        bool operator!=(const one_iterator &rhs) const noexcept {
+            return !(*this == rhs);
+        }
+
+      private:
+        friend class dynamic_bitset;
+
+        const block_type *m_blocks;
+        size_type m_count;
+        size_type m_block;
+        block_type m_word;
+
+        one_iterator(const block_type *blocks, size_type count, size_type block) noexcept
+            : m_blocks(blocks), m_count(count), m_block(block),
+              m_word(block < count ? blocks[block] : 0) {
+            m_skip_zero();
+        }
+
+        void m_skip_zero() noexcept {
+            while (m_word == 0 && m_block < m_count) {
+                if (++m_block < m_count) {
+                    m_word = m_blocks[m_block];
+                }
+            }
+        }
+    };
+
+    // ones() 返回的范围
+    class one_range {
+      public:
+        one_iterator begin() const noexcept {
+            return m_begin;
+        }
+        one_iterator end() const noexcept {
+            return m_end;
+        }
+
+      private:
+        friend class dynamic_bitset;
+
+        one_iterator m_begin;
+        one_iterator m_end;
+
+        one_range(const one_iterator &first, const one_iterator &last) noexcept
+            : m_begin(first), m_end(last) {
+        }
+    };
+
+    dynamic_bitset() noexcept : m_size(0) {
+    }
+
+    /**
+     * @brief 构造拥有 count 位、每位均为 value 的位集合。
+     */
+    explicit dynamic_bitset(size_type count, bool value = false)
+        : m_blocks(m_block_count(count), value ? ~block_type(0) : 0), m_size(count) {
+        m_trim();
+    }
+
+    /**
+     * @brief 由 '0'、'1' 组成的字符串构造，str[i] 对应第 i 位。
+     */
+    explicit dynamic_bitset(const std::string &str) : dynamic_bitset(str.size()) {
+        for (size_type i = 0; i < str.size(); ++i) {
+            if (str[i] == '1') {
+                set(i);
+            } else if (str[i] != '0') {
+                throw std::invalid_argument("dynamic_bitset: invalid character");
+            }
+        }
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type num_blocks() const noexcept {
+        return m_blocks.size();
+    }
+
+    /**
+     * @brief 返回底层的字，第 i 位位于第 i / 64 个字的第 i % 64 位。
+     */
+    const block_type *data() const noexcept {
+        return m_blocks.data();
+    }
+
+    /**
+     * @brief 改变位数，新增的位为 value。
+     */
+    void resize(size_type count, bool value = false) {
+        const size_type old = m_size;
+        m_blocks.resize(m_block_count(count), value ? ~block_type(0) : 0);
+        if (value && count > old && old % bits_per_block != 0) {
+            m_blocks[old / bits_per_block] |= ~block_type(0) << (old % bits_per_block);
+        }
+        m_size = count;
+        m_trim();
+    }
+
+    void push_back(bool value) {
+        if (m_size % bits_per_block == 0) {
+            m_blocks.push_back(0);
+        }
+        ++m_size;
+        set(m_size - 1, value);
+    }
+
+    void clear() noexcept {
+        m_blocks.clear();
+        m_size = 0;
+    }
+
+    /**
+     * @brief 返回第 pos 位，不进行边界检查。
+     */
+    bool operator[](size_type pos) const noexcept {
+        return (m_blocks[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
+    }
+
+    /**
+     * @brief 返回第 pos 位，越界时抛出 std::out_of_range。
+     */
+    bool test(size_type pos) const {
+        if (pos >= m_size) {
+            throw std::out_of_range("dynamic_bitset::test: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    dynamic_bitset &set(size_type pos, bool value = true) noexcept {
+        const block_type bit = block_type(1) << (pos % bits_per_block);
+        block_type &word = m_blocks[pos / bits_per_block];
+        word = value ? (word | bit) : (word & ~bit);
+        return *this;
+    }
+
+    dynamic_bitset &reset(size_type pos) noexcept {
+        return set(pos, false);
+    }
+
+    dynamic_bitset &flip(size_type pos) noexcept {
+        m_blocks[pos / bits_per_block] ^= block_type(1) << (pos % bits_per_block);
+        return *this;
+    }
+
+    /**
+     * @brief 把所有位置为 1。
+     */
+    dynamic_bitset &set() noexcept {
+        tstl::fill(m_blocks.begin(), m_blocks.end(), ~block_type(0));
+        m_trim();
+        return *this;
+    }
+
+    dynamic_bitset &reset() noexcept {
+        tstl::fill(m_blocks.begin(), m_blocks.end(), block_type(0));
+        return *this;
+    }
+
+    dynamic_bitset &flip() noexcept {
+        for (size_type i = 0; i < m_blocks.size(); ++i) {
+            m_blocks[i] = ~m_blocks[i];
+        }
+        m_trim();
+        return *this;
+    }
+
+    /**
+     * @brief 返回为 1 的位数。
+     */
+    size_type count() const noexcept {
+        return _bitset_count<_bitset_lhs>(m_blocks.data(), m_blocks.data(), m_blocks.size());
+    }
+
+    bool any() const noexcept {
+        for (size_type i = 0; i < m_blocks.size(); ++i) {
+            if (m_blocks[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool none() const noexcept {
+        return !any();
+    }
+
+    bool all() const noexcept {
+        return count() == m_size;
+    }
+
+    /**
+     * @brief 判断与 other 是否有共同的 1，找到第一个即返回。
+     */
+    bool intersects(const dynamic_bitset &other) const {
+        m_check_size(other);
+        for (size_type i = 0; i < m_blocks.size(); ++i) {
+            if ((m_blocks[i] & other.m_blocks[i]) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 返回第一个为 1 的位的下标，不存在时返回 npos。
+     */
+    size_type find_first() const noexcept {
+        return m_find_from_block(0);
+    }
+
+    /**
+     * @brief 返回 pos 之后第一个为 1 的位的下标，不存在时返回 npos。
+     */
+    size_type find_next(size_type pos) const noexcept {
+        if (pos >= m_size || ++pos >= m_size) {
+            return npos;
+        }
+        const size_type b = pos / bits_per_block;
+        const block_type word = m_blocks[b] & (~block_type(0) << (pos % bits_per_block));
+        if (word != 0) {
+            return b * bits_per_block + _bitset_countr_zero(word);
+        }
+        return m_find_from_block(b + 1);
+    }
+
+    /**
+     * @brief 返回遍历所有为 1 的位的下标的范围。
+     */
+    one_range ones() const noexcept {
+        return one_range(one_iterator(m_blocks.data(), m_blocks.size(), 0),
+                         one_iterator(m_blocks.data(), m_blocks.size(), m_blocks.size()));
+    }
+
+    /**
+     * @brief 对每个为 1 的位的下标调用 fn，比 ones() 少一次迭代器比较。
+     */
+    template <class Fn>
+    void for_each_one(Fn fn) const {
+        for (size_type b = 0; b < m_blocks.size(); ++b) {
+            for (block_type word = m_blocks[b]; word != 0; word &= word - 1) {
+                fn(b * bits_per_block + _bitset_countr_zero(word));
+            }
+        }
+    }
+
+    dynamic_bitset &operator&=(const dynamic_bitset &other) {
+        return m_apply_in_place<_bitset_and>(other);
+    }
+
+    dynamic_bitset &operator|=(const dynamic_bitset &other) {
+        return m_apply_in_place<_bitset_or>(other);
+    }
+
+    dynamic_bitset &operator^=(const dynamic_bitset &other) {
+        return m_apply_in_place<_bitset_xor>(other);
+    }
+
+    /**
+     * @brief 清除 other 中为 1 的位，即 *this &= ~other。
+     */
+    dynamic_bitset &andnot(const dynamic_bitset &other) {
+        return m_apply_in_place<_bitset_andnot>(other);
+    }
+
+    /**
+     * @brief *this = a & b，复用已有的存储，不分配临时对象。
+     */
+    dynamic_bitset &assign_and(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return m_assign<_bitset_and>(a, b);
+    }
+
+    dynamic_bitset &assign_or(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return m_assign<_bitset_or>(a, b);
+    }
+
+    dynamic_bitset &assign_xor(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return m_assign<_bitset_xor>(a, b);
+    }
+
+    dynamic_bitset &assign_andnot(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return m_assign<_bitset_andnot>(a, b);
+    }
+
+    /**
+     * @brief 返回 (a & b).count()，不生成中间结果。
+     */
+    friend size_type and_count(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return a.m_count_with<_bitset_and>(b);
+    }
+
+    friend size_type or_count(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return a.m_count_with<_bitset_or>(b);
+    }
+
+    friend size_type xor_count(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return a.m_count_with<_bitset_xor>(b);
+    }
+
+    friend size_type andnot_count(const dynamic_bitset &a, const dynamic_bitset &b) {
+        return a.m_count_with<_bitset_andnot>(b);
+    }
+
+    dynamic_bitset operator~() const {
+        dynamic_bitset result(*this);
+        result.flip();
+        return result;
+    }
+
+    friend dynamic_bitset operator&(const dynamic_bitset &a, const dynamic_bitset &b) {
+        dynamic_bitset result;
+        result.assign_and(a, b);
+        return result;
+    }
+
+    friend dynamic_bitset operator|(const dynamic_bitset &a, const dynamic_bitset &b) {
+        dynamic_bitset result;
+        result.assign_or(a, b);
+        return result;
+    }
+
+    friend dynamic_bitset operator^(const dynamic_bitset &a, const dynamic_bitset &b) {
+        dynamic_bitset result;
+        result.assign_xor(a, b);
+        return result;
+    }
+
+    friend dynamic_bitset andnot(const dynamic_bitset &a, const dynamic_bitset &b) {
+        dynamic_bitset result;
+        result.assign_andnot(a, b);
+        return result;
+    }
+
+    /**
+     * @brief 返回由 '0'、'1' 组成的字符串，第 i 个字符对应第 i 位。
+     */
+    std::string to_string() const {
+        std::string str(m_size, '0');
+        for_each_one([&str](size_type i) { str[i] = '1'; });
+        return str;
+    }
+
+    /**
+     * @brief 返回占用的内存；payload 为存放各位的字。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage = m_blocks.memory_usage();
+        usage.overhead += sizeof(*this) - sizeof(m_blocks);
+        return usage;
+    }
+
+    void swap(dynamic_bitset &other) noexcept {
+        m_blocks.swap(other.m_blocks);
+        tstl::swap(m_size, other.m_size);
+    }
+
+    friend bool operator==(const dynamic_bitset &lhs, const dynamic_bitset &rhs) noexcept {
+        if (lhs.m_size != rhs.m_size) {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.m_blocks.size(); ++i) {
+            if (lhs.m_blocks[i] != rhs.m_blocks[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const dynamic_bitset &lhs, const dynamic_bitset &rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+  private:
+    tstl::vector<block_type> m_blocks;
+    size_type m_size;
+
+    static size_type m_block_count(size_type bits) noexcept {
+        return (bits + bits_per_block - 1) / bits_per_block;
+    }
+
+    // 清除末尾字中超出 size() 的位
+    void m_trim() noexcept {
+        if (m_size % bits_per_block != 0) {
+            m_blocks.back() &= (block_type(1) << (m_size % bits_per_block)) - 1;
+        }
+    }
+
+    void m_check_size(const dynamic_bitset &other) const {
+        if (m_size != other.m_size) {
+            throw std::invalid_argument("dynamic_bitset: operands have different sizes");
+        }
+    }
+
+    size_type m_find_from_block(size_type b) const noexcept {
+        for (; b < m_blocks.size(); ++b) {
+            if (m_blocks[b] != 0) {
+                return b * bits_per_block + _bitset_countr_zero(m_blocks[b]);
+            }
+        }
+        return npos;
+    }
+
+    template <class Op>
+    dynamic_bitset &m_apply_in_place(const dynamic_bitset &other) {
+        m_check_size(other);
+        _bitset_apply<Op>(m_blocks.data(), m_blocks.data(), other.m_blocks.data(),
+                          m_blocks.size());
+        return *this;
+    }
+
+    template <class Op>
+    dynamic_bitset &m_assign(const dynamic_bitset &a, const dynamic_bitset &b) {
+        a.m_check_size(b);
+        m_blocks.resize(a.m_blocks.size());
+        m_size = a.m_size;
+        _bitset_apply<Op>(m_blocks.data(), a.m_blocks.data(), b.m_blocks.data(),
+                          m_blocks.size());
+        return *this;
+    }
+
+    template <class Op>
+    size_type m_count_with(const dynamic_bitset &other) const {
+        m_check_size(other);
+        return _bitset_count<Op>(m_blocks.data(), other.m_blocks.data(), m_blocks.size());
+    }
+};
+
+inline void swap(dynamic_bitset &lhs, dynamic_bitset &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,485 @@
+#ifndef TSTL_SRC_EXTERNAL_SORT_HPP
+#define TSTL_SRC_EXTERNAL_SORT_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "algorithm.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+// 外部排序默认可用的内存字节数，决定每个有序段的长度
+#ifndef TSTL_EXTERNAL_SORT_MEMORY
+#define TSTL_EXTERNAL_SORT_MEMORY (std::size_t(256) << 20)
+#endif
+
+// 归并时每个有序段读缓冲区的最小字节数；段数多到缓冲区小于它时先分轮归并
+#ifndef TSTL_EXTERNAL_SORT_MIN_BLOCK
+#define TSTL_EXTERNAL_SORT_MIN_BLOCK (std::size_t(1) << 20)
+#endif
+
+// 写入中间文件与输出文件时的缓冲区字节数
+#ifndef TSTL_EXTERNAL_SORT_WRITE_BUFFER
+#define TSTL_EXTERNAL_SORT_WRITE_BUFFER (std::size_t(1) << 20)
+#endif
+
+namespace tstl {
+
+[[noreturn]] inline void _external_sort_throw(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline void _external_sort_write(int fd, const void *p, std::size_t bytes) {
+    const char *c = static_cast<const char *>(p);
+    while (bytes != 0) {
+        ssize_t n = ::write(fd, c, bytes);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _external_sort_throw("tstl::external_sort: write");
+        }
+        c += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+}
+
+// 读满 bytes 个字节，返回实际读到的字节数，只有到达文件末尾时才会少于 bytes
+inline std::size_t _external_sort_read(int fd, void *p, std::size_t bytes) {
+    char *c = static_cast<char *>(p);
+    std::size_t done = 0;
+    while (done < bytes) {
+        ssize_t n = ::read(fd, c + done, bytes - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _external_sort_throw("tstl::external_sort: read");
+        }
+        if (n == 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    return done;
+}
+
+inline void _external_sort_pread(int fd, void *p, std::size_t bytes, off_t offset) {
+    char *c = static_cast<char *>(p);
+    while (bytes != 0) {
+        ssize_t n = ::pread(fd, c, bytes, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _external_sort_throw("tstl::external_sort: pread");
+        }
+        if (n == 0) {
+            throw std::runtime_error("tstl::external_sort: spill file truncated");
+        }
+        c += n;
+        bytes -= static_cast<std::size_t>(n);
+        offset += n;
+    }
+}
+
+// 创建后立即删除的临时文件，关闭描述符后空间即被回收
+class _external_sort_file {
+  public:
+    explicit _external_sort_file(const std::string &dir) {
+        std::string path = dir + "/tstl_external_sort_XXXXXX";
+        m_fd = ::mkstemp(&path[0]);
+        if (m_fd < 0) {
+            _external_sort_throw("tstl::external_sort: mkstemp");
+        }
+        ::unlink(path.c_str());
+    }
+
+    _external_sort_file(const _external_sort_file &) = delete;
+    _external_sort_file &operator=(const _external_sort_file &) = delete;
+
+    ~_external_sort_file() {
+        ::close(m_fd);
+    }
+
+    int fd() const noexcept {
+        return m_fd;
+    }
+
+  private:
+    int m_fd;
+};
+
+// 带缓冲区的顺序写入
+template <class T>
+class _external_sort_writer {
+  public:
+    explicit _external_sort_writer(int fd)
+        : m_fd(fd), m_buf(TSTL_EXTERNAL_SORT_WRITE_BUFFER / sizeof(T) + 1), m_count(0) {
+    }
+
+    void operator()(const T &value) {
+        m_buf[m_count++] = value;
+        if (m_count == m_buf.size()) {
+            flush();
+        }
+    }
+
+    void flush() {
+        _external_sort_write(m_fd, m_buf.data(), m_count * sizeof(T));
+        m_count = 0;
+    }
+
+  private:
+    int m_fd;
+    tstl::vector<T> m_buf;
+    std::size_t m_count;
+};
+
+// 外部排序的实现：输入先填入内存缓冲区，满后排序并作为一个有序段写入临时文件；
+// 输入结束后用败者树对全部有序段做多路归并。每个有序段有两个读缓冲区，
+// 消费一个缓冲区的同时在后台异步读取下一块，磁盘读取与比较相互重叠
+template <class T, class Compare>
+class _external_sorter {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "tstl::external_sort requires trivially copyable elements");
+
+  public:
+    _external_sorter(Compare cmp, std::size_t memory_bytes, const char *tmp_dir)
+        : m_cmp(cmp), m_memory(memory_bytes < 4 * sizeof(T) ? 4 * sizeof(T) : memory_bytes),
+          m_count(0) {
+        if (tmp_dir != nullptr) {
+            m_dir = tmp_dir;
+        } else {
+            const char *env = std::getenv("TMPDIR");
+            m_dir = env != nullptr && *env != '\0' ? env : "/tmp";
+        }
+        m_capacity = m_memory / sizeof(T);
+    }
+
+    void push(const T &value) {
+        if (m_count == m_buf.size()) {
+            make_room();
+        }
+        m_buf[m_count++] = value;
+    }
+
+    // 从 fd 顺序读入直到文件末尾，每次直接读满内存缓冲区的剩余部分
+    void read_from(int fd) {
+        for (;;) {
+            if (m_count == m_buf.size()) {
+                make_room();
+            }
+            const std::size_t want = (m_buf.size() - m_count) * sizeof(T);
+            const std::size_t got = _external_sort_read(fd, m_buf.data() + m_count, want);
+            if (got % sizeof(T) != 0) {
+                throw std::runtime_error("tstl::external_sort: input size is not a multiple "
+                                         "of the element size");
+            }
+            m_count += got / sizeof(T);
+            if (got < want) {
+                return;
+            }
+        }
+    }
+
+    // 按顺序把全部元素交给 sink(const T &)
+    template <class Sink>
+    void finish(Sink &sink) {
+        if (m_runs.empty()) {
+            // 全部输入都在内存中，无需写入临时文件
+            tstl::sort(m_buf.begin(), m_buf.begin() + m_count, m_cmp);
+            for (std::size_t i = 0; i < m_count; ++i) {
+                sink(m_buf[i]);
+            }
+            return;
+        }
+        if (m_count != 0) {
+            spill();
+        }
+        tstl::vector<T>().swap(m_buf);
+
+        // 段数过多时每轮把 fan_in 个有序段归并为一个，写入新的临时文件
+        const std::size_t fan_in = max_fan_in();
+        while (m_runs.size() > fan_in) {
+            std::unique_ptr<_external_sort_file> next(new _external_sort_file(m_dir));
+            tstl::vector<run> next_runs;
+            off_t offset = 0;
+            for (std::size_t i = 0; i < m_runs.size(); i += fan_in) {
+                std::size_t last = i + fan_in < m_runs.size() ? i + fan_in : m_runs.size();
+                _external_sort_writer<T> writer(next->fd());
+                std::size_t count = merge(i, last, writer);
+                writer.flush();
+                next_runs.push_back(run{offset, count});
+                offset += static_cast<off_t>(count * sizeof(T));
+            }
+            m_file = std::move(next);
+            m_runs.swap(next_runs);
+        }
+        merge(0, m_runs.size(), sink);
+    }
+
+  private:
+    // 临时文件中的一个有序段
+    struct run {
+        off_t offset;
+        std::size_t count;
+    };
+
+    // 有序段的读取端：cur 供归并消费，next 由后台任务读入下一块
+    struct reader {
+        int fd = -1;
+        off_t offset = 0;          // 下一块在文件中的位置
+        std::size_t remaining = 0; // 尚未请求读取的元素个数
+        std::size_t block = 0;
+        tstl::vector<T> cur;
+        tstl::vector<T> next;
+        std::size_t pos = 0;
+        std::size_t len = 0;
+        std::future<std::size_t> pending; // 最后声明，析构时先等待后台读取结束
+
+        void open(int file, const run &r, std::size_t block_len) {
+            fd = file;
+            offset = r.offset;
+            remaining = r.count;
+            block = block_len;
+            cur.resize(block);
+            next.resize(block);
+            len = take();
+            _external_sort_pread(fd, cur.data(), len * sizeof(T),
+                                 offset - static_cast<off_t>(len * sizeof(T)));
+            prefetch();
+        }
+
+        bool empty() const noexcept {
+            return pos == len;
+        }
+
+        const T &head() const noexcept {
+            return cur[pos];
+        }
+
+        void pop() {
+            if (++pos == len) {
+                pos = 0;
+                len = 0;
+                if (pending.valid()) {
+                    len = pending.get();
+                    cur.swap(next);
+                    prefetch();
+                }
+            }
+        }
+
+        // 从文件中划出下一块，返回其元素个数
+        std::size_t take() noexcept {
+            std::size_t n = remaining < block ? remaining : block;
+            remaining -= n;
+            offset += static_cast<off_t>(n * sizeof(T));
+            return n;
+        }
+
+        void prefetch() {
+            if (remaining == 0) {
+                return;
+            }
+            std::size_t n = take();
+            T *p = next.data();
+            int f = fd;
+            off_t at = offset - static_cast<off_t>(n * sizeof(T));
+            pending = std::async(std::launch::async, [p, n, f, at] {
+                _external_sort_pread(f, p, n * sizeof(T), at);
+                return n;
+            });
+        }
+    };
+
+    Compare m_cmp;
+    std::size_t m_memory;
+    std::string m_dir;
+    tstl::vector<T> m_buf;
+    std::size_t m_capacity; // 内存缓冲区最多容纳的元素个数
+    std::size_t m_count;
+    std::unique_ptr<_external_sort_file> m_file;
+    tstl::vector<run> m_runs;
+
+    std::size_t max_fan_in() const noexcept {
+        std::size_t block = TSTL_EXTERNAL_SORT_MIN_BLOCK < sizeof(T) ? sizeof(T)
+                                                                     : TSTL_EXTERNAL_SORT_MIN_BLOCK;
+        std::size_t n = m_memory / (2 * block);
+        return n < 2 ? 2 : n;
+    }
+
+    // 缓冲区按需倍增直到 m_capacity，输入较少时不会一开始就占满全部内存；已满则写出有序段
+    void make_room() {
+        if (m_buf.size() < m_capacity) {
+            std::size_t len = m_buf.size() * 2;
+            if (len < 1024) {
+                len = 1024;
+            }
+            m_buf.resize(len < m_capacity ? len : m_capacity);
+        } else {
+            spill();
+        }
+    }
+
+    // 排序内存缓冲区中的元素，作为新的有序段一次写入临时文件末尾
+    void spill() {
+        if (m_file == nullptr) {
+            m_file.reset(new _external_sort_file(m_dir));
+        }
+        tstl::sort(m_buf.begin(), m_buf.begin() + m_count, m_cmp);
+        off_t offset = 0;
+        if (!m_runs.empty()) {
+            const run &last = m_runs.back();
+            offset = last.offset + static_cast<off_t>(last.count * sizeof(T));
+        }
+        _external_sort_write(m_file->fd(), m_buf.data(), m_count * sizeof(T));
+        m_runs.push_back(run{offset, m_count});
+        m_count = 0;
+    }
+
+    // 用败者树归并 m_runs[first, last)，返回输出的元素个数
+    // tree[0] 为胜者，tree[1, k) 存放各内部结点上的败者，叶结点 k + i 对应第 i 个有序段
+    template <class Sink>
+    std::size_t merge(std::size_t first, std::size_t last, Sink &sink) {
+        const std::size_t k = last - first;
+        std::size_t block = m_memory / (2 * k * sizeof(T));
+        if (block == 0) {
+            block = 1;
+        }
+        std::unique_ptr<reader[]> readers(new reader[k]);
+        for (std::size_t i = 0; i < k; ++i) {
+            readers[i].open(m_file->fd(), m_runs[first + i], block);
+        }
+
+        // a 是否先于 b 输出，已耗尽的有序段排在最后
+        auto beats = [&readers, this](std::size_t a, std::size_t b) {
+            if (readers[a].empty()) {
+                return false;
+            }
+            return readers[b].empty() || m_cmp(readers[a].head(), readers[b].head());
+        };
+
+        tstl::vector<std::size_t> tree(k < 2 ? 2 : k);
+        tree[0] = build(tree, 1, k, beats);
+
+        std::size_t count = 0;
+        for (;;) {
+            std::size_t w = tree[0];
+            if (readers[w].empty()) {
+                break;
+            }
+            sink(readers[w].head());
+            ++count;
+            readers[w].pop();
+            // 沿叶结点到根的路径重赛
+            for (std::size_t node = (w + k) / 2; node != 0; node /= 2) {
+                if (beats(tree[node], w)) {
+                    tstl::swap(tree[node], w);
+                }
+            }
+            tree[0] = w;
+        }
+        return count;
+    }
+
+    // 自底向上比赛，内部结点记录败者，返回子树的胜者
+    template <class Beats>
+    static std::size_t build(tstl::vector<std::size_t> &tree, std::size_t node, std::size_t k,
+                             Beats &beats) {
+        if (node >= k) {
+            return node - k;
+        }
+        std::size_t l = build(tree, 2 * node, k, beats);
+        std::size_t r = build(tree, 2 * node + 1, k, beats);
+        if (beats(l, r)) {
+            tree[node] = r;
+            return l;
+        }
+        tree[node] = l;
+        return r;
+    }
+};
+
+/**
+ * @brief 对超出内存的数据排序：[first, last) 中的元素按 cmp 排序后依次写入 out。
+ *
+ * 元素须可平凡复制。内存中至多保留 memory_bytes 字节的元素，每填满一次就排序并写入
+ * tmp_dir（缺省为 $TMPDIR 或 /tmp）下的临时文件，最后用败者树多路归并，
+ * 每个有序段双缓冲异步读取。排序不稳定。I/O 失败时抛出 std::system_error。
+ */
+template <class InputIt, class OutputIt, class Compare>
+OutputIt external_sort(InputIt first, InputIt last, OutputIt out, Compare cmp,
+                       std::size_t memory_bytes = TSTL_EXTERNAL_SORT_MEMORY,
+                       const char *tmp_dir = nullptr) {
+    using value_type = typename tstl::iterator_traits<InputIt>::value_type;
+    _external_sorter<value_type, Compare> sorter(cmp, memory_bytes, tmp_dir);
+    for (; first != last; ++first) {
+        sorter.push(*first);
+    }
+    auto sink = [&out](const value_type &value) {
+        *out = value;
+        ++out;
+    };
+    sorter.finish(sink);
+    return out;
+}
+
+template <class InputIt, class OutputIt>
+OutputIt external_sort(InputIt first, InputIt last, OutputIt out) {
+    using value_type = typename tstl::iterator_traits<InputIt>::value_type;
+    return tstl::external_sort(first, last, out, std::less<value_type>());
+}
+
+/**
+ * @brief 对文件排序：input 由连续存放的 T 组成，排序结果写入 output（不存在时创建）。
+ *
+ * 输入按大块直接读入排序缓冲区，其余与迭代器版本相同。input 与 output 可以是同一文件。
+ */
+template <class T, class Compare = std::less<T>>
+void external_sort_file(const char *input, const char *output, Compare cmp = Compare(),
+                        std::size_t memory_bytes = TSTL_EXTERNAL_SORT_MEMORY,
+                        const char *tmp_dir = nullptr) {
+    _external_sorter<T, Compare> sorter(cmp, memory_bytes, tmp_dir);
+    int in = ::open(input, O_RDONLY);
+    if (in < 0) {
+        _external_sort_throw("tstl::external_sort_file: open input");
+    }
+    try {
+        sorter.read_from(in);
+    } catch (...) {
+        ::close(in);
+        throw;
+    }
+    ::close(in);
+
+    int out = ::open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        _external_sort_throw("tstl::external_sort_file: open output");
+    }
+    try {
+        _external_sort_writer<T> writer(out);
+        sorter.finish(writer);
+        writer.flush();
+    } catch (...) {
+        ::close(out);
+        throw;
+    }
+    ::close(out);
+}
+
+} // namespace tstl
+
+#endif
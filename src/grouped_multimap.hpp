@@ -0,0 +1,197 @@
+#ifndef TSTL_SRC_GROUPED_MULTIMAP_HPP
+#define TSTL_SRC_GROUPED_MULTIMAP_HPP
+
+// 键值大量重复时使用的 multimap：每个键值只占一个树结点，结点中保存该键值的全部元素
+// 相同键值的元素按插入顺序连续存放，equal_range 直接返回一段连续的 span，count 为 O(log n)
+// 插入已有键值只需一次查找与一次 push_back，不再分配树结点，也不触发红黑树的平衡调整
+
+#include "rbtree.hpp"
+#include "span.hpp"
+#include "vector.hpp"
+
+namespace tstl {
+
+template <class Key, class T, class Compare = std::less<Key>>
+class grouped_multimap {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+
+    // 同一键值的全部元素
+    using group_type = tstl::vector<T>;
+    using group_value_type = std::pair<const Key, group_type>;
+
+  private:
+    using base_type = tstl::rb_tree<group_value_type, key_compare>;
+    base_type m_tree;
+    std::size_t m_size = 0; // 元素总数
+
+  public:
+    // 迭代器按键值顺序遍历各组，*it 为 (键值, 该键值的全部元素)
+    using iterator = typename base_type::const_iterator;
+    using const_iterator = typename base_type::const_iterator;
+    using size_type = typename base_type::size_type;
+    using difference_type = typename base_type::difference_type;
+
+    // 构造、复制、移动函数
+    grouped_multimap() = default;
+
+    ~grouped_multimap() = default;
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    grouped_multimap(InputIt first, InputIt last) {
+        insert(first, last);
+    }
+
+    grouped_multimap(std::initializer_list<value_type> ilist) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    grouped_multimap(const grouped_multimap &other) = default;
+
+    grouped_multimap(grouped_multimap &&other) noexcept
+        : m_tree(std::move(other.m_tree)), m_size(other.m_size) {
+        other.m_size = 0;
+    }
+
+    grouped_multimap &operator=(const grouped_multimap &rhs) = default;
+
+    grouped_multimap &operator=(grouped_multimap &&rhs) noexcept {
+        if (this != &rhs) {
+            m_tree = std::move(rhs.m_tree);
+            m_size = rhs.m_size;
+            rhs.m_size = 0;
+        }
+        return *this;
+    }
+
+    // 接口
+    key_compare key_comp() const {
+        return m_tree.key_comp();
+    }
+
+    const_iterator begin() const noexcept {
+        return m_tree.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return m_tree.end();
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    // 元素总数
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    // 不同键值的个数，即树结点数
+    size_type group_count() const noexcept {
+        return m_tree.size();
+    }
+
+    // 插入一个元素，排在已有的同键值元素之后
+    template <class... Args>
+    void emplace(const key_type &key, Args &&...args) {
+        auto hint = m_tree.lower_bound(key);
+        if (hint != m_tree.end() && !m_tree.key_comp()(key, hint->first)) {
+            hint->second.emplace_back(std::forward<Args>(args)...);
+        } else {
+            // 新的键值：先构造只含一个元素的组，再插入到 hint 之前
+            group_type group;
+            group.emplace_back(std::forward<Args>(args)...);
+            m_tree.emplace_unique_use_hint(hint, key, std::move(group));
+        }
+        ++m_size;
+    }
+
+    void insert(const value_type &value) {
+        emplace(value.first, value.second);
+    }
+
+    void insert(value_type &&value) {
+        emplace(value.first, std::move(value.second));
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    // 删除键值为 key 的全部元素，返回删除的个数
+    size_type erase(const key_type &key) {
+        auto it = m_tree.find(key);
+        if (it == m_tree.end()) {
+            return 0;
+        }
+        size_type n = it->second.size();
+        m_tree.erase(it);
+        m_size -= n;
+        return n;
+    }
+
+    void clear() {
+        m_tree.clear();
+        m_size = 0;
+    }
+
+    void swap(grouped_multimap &other) noexcept {
+        m_tree.swap(other.m_tree);
+        tstl::swap(m_size, other.m_size);
+    }
+
+    // 查找键值为 key 的组
+    const_iterator find(const key_type &key) const {
+        return m_tree.find(key);
+    }
+
+    bool contains(const key_type &key) const {
+        return find(key) != end();
+    }
+
+    // 键值为 key 的元素个数，O(log n)
+    size_type count(const key_type &key) const {
+        auto it = m_tree.find(key);
+        return it == m_tree.end() ? 0 : it->second.size();
+    }
+
+    // 键值为 key 的全部元素，按插入顺序连续存放
+    // 返回的 span 在插入同键值的元素或删除该键值前有效
+    span<T> equal_range(const key_type &key) {
+        auto it = m_tree.find(key);
+        if (it == m_tree.end()) {
+            return span<T>();
+        }
+        return span<T>(it->second.data(), it->second.size());
+    }
+
+    span<const T> equal_range(const key_type &key) const {
+        auto it = m_tree.find(key);
+        if (it == m_tree.end()) {
+            return span<const T>();
+        }
+        return span<const T>(it->second.data(), it->second.size());
+    }
+
+    // 释放各组多余的容量
+    void shrink_to_fit() {
+        for (auto it = m_tree.begin(); it != m_tree.end(); ++it) {
+            it->second.shrink_to_fit();
+        }
+    }
+};
+
+template <class Key, class T, class Compare>
+void swap(grouped_multimap<Key, T, Compare> &lhs, grouped_multimap<Key, T, Compare> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
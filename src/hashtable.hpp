@@ -0,0 +1,836 @@
+#ifndef TSTL_SRC_HASHTABLE_HPP
+#define TSTL_SRC_HASHTABLE_HPP
+
+// 开放寻址的哈希表，unordered_map、unordered_set 的底层
+// 元素按值连续存放在槽位数组中，不为每个元素单独分配结点；每个槽位另有一个控制字节，
+// 记录该槽位为空、已删除，或所存元素哈希值的低 7 位
+// 查找时一次读入一组控制字节（SSE2 下 16 个，否则用 64 位整数按字节并行处理 8 个），
+// 与哈希值的低 7 位整组比较，只有匹配的槽位才需要调用 key_equal，
+// 组内出现空槽位即可断定查找失败
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(TSTL_HASHTABLE_NO_SIMD)
+#include <emmintrin.h>
+#define TSTL_HASHTABLE_SSE2 1
+#endif
+
+#include "algorithm.hpp"
+#include "iterator.hpp"
+#include "type_traits.hpp"
+
+namespace tstl {
+
+// 控制字节：空、已删除、哨兵均为负数，存有元素时为哈希值的低 7 位
+using hashtable_ctrl_t = signed char;
+
+static constexpr hashtable_ctrl_t hashtable_empty = -128;   // 0b10000000
+static constexpr hashtable_ctrl_t hashtable_deleted = -2;   // 0b11111110
+static constexpr hashtable_ctrl_t hashtable_sentinel = -1;  // 0b11111111，位于槽位数组末尾
+
+inline bool hashtable_is_full(hashtable_ctrl_t c) noexcept {
+    return c >= 0;
+}
+inline bool hashtable_is_empty_or_deleted(hashtable_ctrl_t c) noexcept {
+    return c < hashtable_sentinel;
+}
+
+inline int hashtable_countr_zero(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    for (; (x & 1) == 0; x >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+inline int hashtable_countl_zero(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for (; (x & (std::uint64_t(1) << 63)) == 0; x <<= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// 一组控制字节的匹配结果，每个匹配的槽位对应 2^Shift 位中的最高位，可以依次取出最低的匹配位置
+template <class U, int Width, int Shift>
+class hashtable_bitmask {
+  private:
+    U m_mask;
+
+  public:
+    explicit hashtable_bitmask(U mask) noexcept : m_mask(mask) {
+    }
+
+    explicit operator bool() const noexcept {
+        return m_mask != 0;
+    }
+
+    // 最低的匹配位置，要求至少有一个匹配
+    int lowest() const noexcept {
+        return hashtable_countr_zero(m_mask) >> Shift;
+    }
+
+    // 组首、组尾连续不匹配的槽位数
+    int trailing_zeros() const noexcept {
+        return m_mask == 0 ? Width : lowest();
+    }
+    int leading_zeros() const noexcept {
+        constexpr int unused = 64 - (Width << Shift);
+        return m_mask == 0 ? Width : (hashtable_countl_zero(m_mask) - unused) >> Shift;
+    }
+
+    // 去掉最低的匹配位置
+    hashtable_bitmask &operator++() noexcept {
+        m_mask &= m_mask - 1;
+        return *this;
+    }
+};
+
+#ifdef TSTL_HASHTABLE_SSE2
+
+// 一组 16 个控制字节，每次比较只需一条 SSE2 指令
+struct hashtable_group {
+    static constexpr std::size_t width = 16;
+    using bitmask = hashtable_bitmask<std::uint32_t, 16, 0>;
+
+    __m128i ctrl;
+
+    explicit hashtable_group(const hashtable_ctrl_t *pos) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {
+    }
+
+    bitmask match(hashtable_ctrl_t h2) const noexcept {
+        return bitmask(static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+    }
+    bitmask match_empty() const noexcept {
+        return match(hashtable_empty);
+    }
+    // 空与已删除都小于哨兵
+    bitmask match_empty_or_deleted() const noexcept {
+        return bitmask(static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(hashtable_sentinel), ctrl))));
+    }
+};
+
+#else
+
+// 一组 8 个控制字节，装入一个 64 位整数后按字节并行比较，匹配结果为各字节的最高位
+struct hashtable_group {
+    static constexpr std::size_t width = 8;
+    using bitmask = hashtable_bitmask<std::uint64_t, 8, 3>;
+
+    std::uint64_t ctrl;
+
+    explicit hashtable_group(const hashtable_ctrl_t *pos) noexcept {
+        std::memcpy(&ctrl, pos, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        ctrl = __builtin_bswap64(ctrl); // 保证第 i 个控制字节位于第 i 个低位字节
+#endif
+    }
+
+    // 可能把紧跟在真正匹配之后、值为 h2 ^ 1 的字节误报为匹配，调用者总会再比较键值，不影响结果
+    bitmask match(hashtable_ctrl_t h2) const noexcept {
+        constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+        constexpr std::uint64_t msbs = 0x8080808080808080ull;
+        auto x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+        return bitmask((x - lsbs) & ~x & msbs);
+    }
+    // 空为 0b10000000：最高位为 1 且第 1 位为 0
+    bitmask match_empty() const noexcept {
+        constexpr std::uint64_t msbs = 0x8080808080808080ull;
+        return bitmask(ctrl & ~(ctrl << 6) & msbs);
+    }
+    // 空与已删除：最高位为 1 且第 0 位为 0
+    bitmask match_empty_or_deleted() const noexcept {
+        constexpr std::uint64_t msbs = 0x8080808080808080ull;
+        return bitmask(ctrl & ~(ctrl << 7) & msbs);
+    }
+};
+
+#endif
+
+// 空表共用的一组控制字节，使空表的查找不必特殊处理，空表不会写入它
+inline hashtable_ctrl_t *hashtable_empty_group() noexcept {
+    alignas(16) static hashtable_ctrl_t group[16] = {
+        hashtable_sentinel, hashtable_empty, hashtable_empty, hashtable_empty,
+        hashtable_empty,    hashtable_empty, hashtable_empty, hashtable_empty,
+        hashtable_empty,    hashtable_empty, hashtable_empty, hashtable_empty,
+        hashtable_empty,    hashtable_empty, hashtable_empty, hashtable_empty};
+    return group;
+}
+
+// 哈希值的高位用于选择探测起点，低 7 位存入控制字节
+// 先做一次乘法混合，避免 std::hash 对整数为恒等映射时低位分布过差
+inline std::size_t hashtable_mix(std::size_t hash) noexcept {
+    std::uint64_t h = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+}
+inline std::size_t hashtable_h1(std::size_t hash) noexcept {
+    return hash >> 7;
+}
+inline hashtable_ctrl_t hashtable_h2(std::size_t hash) noexcept {
+    return static_cast<hashtable_ctrl_t>(hash & 0x7F);
+}
+
+// 不小于 n 的最小的 2^k - 1
+inline std::size_t hashtable_normalize_capacity(std::size_t n) noexcept {
+    return n == 0 ? 1 : ~std::size_t(0) >> hashtable_countl_zero(n);
+}
+// 容量为 capacity 时最多容纳的元素个数
+inline std::size_t hashtable_capacity_to_growth(std::size_t capacity) noexcept {
+    if (hashtable_group::width == 8 && capacity == 7) {
+        return 6; // 8 个字节的组中必须留一个空槽位
+    }
+    return capacity - capacity / 8;
+}
+// 容纳 growth 个元素所需的最小容量（未规整）
+inline std::size_t hashtable_growth_to_lower_bound_capacity(std::size_t growth) noexcept {
+    if (hashtable_group::width == 8 && growth == 7) {
+        return 8;
+    }
+    return growth == 0 ? 0 : growth + (growth - 1) / 7;
+}
+
+// 设置槽位 i 的控制字节，同时更新位于哨兵之后的副本
+inline void hashtable_set_ctrl(hashtable_ctrl_t *ctrl, std::size_t capacity, std::size_t i,
+                               hashtable_ctrl_t h) noexcept {
+    constexpr std::size_t cloned = hashtable_group::width - 1;
+    ctrl[i] = h;
+    ctrl[((i - cloned) & capacity) + (cloned & capacity)] = h;
+}
+
+// 探测序列，以组为单位按三角数步长前进，容量为 2^k - 1 时每个组都会被探测到
+class hashtable_probe_seq {
+  private:
+    std::size_t m_mask;
+    std::size_t m_offset;
+    std::size_t m_index = 0;
+
+  public:
+    hashtable_probe_seq(std::size_t hash, std::size_t mask) noexcept
+        : m_mask(mask), m_offset(hash & mask) {
+    }
+
+    std::size_t offset() const noexcept {
+        return m_offset;
+    }
+    std::size_t offset(std::size_t i) const noexcept {
+        return (m_offset + i) & m_mask;
+    }
+
+    void next() noexcept {
+        m_index += hashtable_group::width;
+        m_offset = (m_offset + m_index) & m_mask;
+    }
+};
+
+// 探测序列上第一个空或已删除的槽位，要求表中存在这样的槽位
+inline std::size_t hashtable_find_first_non_full(const hashtable_ctrl_t *ctrl,
+                                                 std::size_t capacity,
+                                                 std::size_t hash) noexcept {
+    hashtable_probe_seq seq(hashtable_h1(hash), capacity);
+    while (true) {
+        auto match = hashtable_group(ctrl + seq.offset()).match_empty_or_deleted();
+        if (match) {
+            return seq.offset(match.lowest());
+        }
+        seq.next();
+    }
+}
+
+// 标记槽位 i 的元素已删除，返回该槽位是否被直接置空（置空的槽位可重新计入可用空间）
+// 若包含槽位 i 的每个组窗口中都有空槽位，则没有查找曾因遇到满组而越过 i，可以直接置空，
+// 否则需要留下墓碑，以免截断经过它的探测序列
+inline bool hashtable_erase_ctrl(hashtable_ctrl_t *ctrl, std::size_t capacity,
+                                 std::size_t i) noexcept {
+    constexpr std::size_t width = hashtable_group::width;
+    auto before = (i - width) & capacity;
+    auto empty_after = hashtable_group(ctrl + i).match_empty();
+    auto empty_before = hashtable_group(ctrl + before).match_empty();
+    bool never_full = empty_before && empty_after &&
+                      static_cast<std::size_t>(empty_after.trailing_zeros() +
+                                               empty_before.leading_zeros()) < width;
+    hashtable_set_ctrl(ctrl, capacity, i, never_full ? hashtable_empty : hashtable_deleted);
+    return never_full;
+}
+
+// 哈希表类型萃取，std::pair<const K, V> 以 first 为键值，其余类型以自身为键值
+
+template <class T>
+struct hashtable_value_traits {
+    using key_type = T;
+    using mapped_type = T;
+    using value_type = T;
+
+    static const key_type &get_key(const value_type &value) noexcept {
+        return value;
+    }
+};
+
+template <class K, class V>
+struct hashtable_value_traits<std::pair<const K, V>> {
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+
+    static const key_type &get_key(const value_type &value) noexcept {
+        return value.first;
+    }
+};
+
+// 迭代器，由控制字节与槽位两个指针组成，末尾的哨兵使遍历无需检查边界
+
+template <class T>
+struct hashtable_iterator_base : public tstl::iterator<tstl::forward_iterator_tag, T> {
+    hashtable_ctrl_t *ctrl = nullptr;
+    T *slot = nullptr;
+
+    hashtable_iterator_base() = default;
+    hashtable_iterator_base(hashtable_ctrl_t *c, T *s) noexcept : ctrl(c), slot(s) {
+    }
+
+    // 跳过空槽位与已删除的槽位，停在下一个元素或哨兵处
+    void skip_empty_or_deleted() noexcept {
+        while (hashtable_is_empty_or_deleted(*ctrl)) {
+            ++ctrl;
+            ++slot;
+        }
+    }
+
+    void incr() noexcept {
+        ++ctrl;
+        ++slot;
+        skip_empty_or_deleted();
+    }
+
+    bool operator==(const hashtable_iterator_base &rhs) const noexcept {
+        return ctrl == rhs.ctrl;
+    }
+    bool operator!=(const hashtable_iterator_base &rhs) const noexcept {
+        return ctrl != rhs.ctrl;
+    }
+};
+
+template <class T>
+struct hashtable_iterator : public hashtable_iterator_base<T> {
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = tstl::forward_iterator_tag;
+
+    hashtable_iterator() = default;
+    hashtable_iterator(hashtable_ctrl_t *c, T *s) noexcept : hashtable_iterator_base<T>(c, s) {
+    }
+
+    reference operator*() const noexcept {
+        return *this->slot;
+    }
+    pointer operator->() const noexcept {
+        return this->slot;
+    }
+
+    hashtable_iterator &operator++() noexcept {
+        this->incr();
+        return *this;
+    }
+    hashtable_iterator operator++(int) noexcept {
+        hashtable_iterator tmp = *this;
+        this->incr();
+        return tmp;
+    }
+};
+
+template <class T>
+struct hashtable_const_iterator : public hashtable_iterator_base<T> {
+    using value_type = T;
+    using pointer = const T *;
+    using reference = const T &;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = tstl::forward_iterator_tag;
+
+    hashtable_const_iterator() = default;
+    hashtable_const_iterator(hashtable_ctrl_t *c, T *s) noexcept
+        : hashtable_iterator_base<T>(c, s) {
+    }
+    hashtable_const_iterator(const hashtable_iterator<T> &rhs) noexcept
+        : hashtable_iterator_base<T>(rhs.ctrl, rhs.slot) {
+    }
+
+    reference operator*() const noexcept {
+        return *this->slot;
+    }
+    pointer operator->() const noexcept {
+        return this->slot;
+    }
+
+    hashtable_const_iterator &operator++() noexcept {
+        this->incr();
+        return *this;
+    }
+    hashtable_const_iterator operator++(int) noexcept {
+        hashtable_const_iterator tmp = *this;
+        this->incr();
+        return tmp;
+    }
+};
+
+// 哈希表，键值唯一
+// 槽位数（容量）为 0 或 2^k - 1，控制字节数组长为容量 + 组宽：
+// 槽位对应的控制字节之后是一个哨兵，再之后是前 组宽 - 1 个控制字节的副本，
+// 因此从任意槽位开始读入一整组都不会越界，也不必处理回绕
+// 元素个数达到容量的 7/8 时扩容；删除元素时尽量直接置空，只有可能截断其他探测序列时才留下墓碑
+template <class T, class Hash, class KeyEqual, class Allocator = std::allocator<T>>
+class hashtable {
+  public:
+    using value_traits = hashtable_value_traits<T>;
+    using key_type = typename value_traits::key_type;
+    using mapped_type = typename value_traits::mapped_type;
+    using value_type = T;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+
+    using iterator = hashtable_iterator<T>;
+    using const_iterator = hashtable_const_iterator<T>;
+
+  private:
+    using ctrl_t = hashtable_ctrl_t;
+    using group = hashtable_group;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using ctrl_allocator = typename alloc_traits::template rebind_alloc<ctrl_t>;
+    using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+    // 重新放置元素时是否移动：计算哈希值与移动构造都不会抛出异常时，放置过程不会中途失败；
+    // 元素不能复制时只能移动
+    using relocate_by_move = std::integral_constant<
+        bool, (noexcept(std::declval<const Hash &>()(std::declval<const key_type &>())) &&
+               std::is_nothrow_move_constructible<T>::value) ||
+                  !std::is_copy_constructible<T>::value>;
+
+    ctrl_t *m_ctrl = hashtable_empty_group();
+    T *m_slots = nullptr;
+    size_type m_capacity = 0;    // 槽位数
+    size_type m_size = 0;        // 元素个数
+    size_type m_growth_left = 0; // 扩容前还可以占用的空槽位数，已删除的槽位不计入
+    Hash m_hash;
+    KeyEqual m_equal;
+    Allocator m_alloc;
+
+  public:
+    // 构造、复制、移动、析构函数
+    hashtable() = default;
+
+    explicit hashtable(size_type bucket_count,
+                       const Hash &hash = Hash(),
+                       const KeyEqual &equal = KeyEqual(),
+                       const Allocator &alloc = Allocator())
+        : m_hash(hash), m_equal(equal), m_alloc(alloc) {
+        if (bucket_count != 0) {
+            initialize(hashtable_normalize_capacity(bucket_count));
+        }
+    }
+
+    hashtable(const hashtable &other)
+        : m_hash(other.m_hash), m_equal(other.m_equal),
+          m_alloc(alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
+        reserve(other.size());
+        try {
+            // 键值已知互不相同，直接找空槽位放入，不需要比较
+            for (auto &value : other) {
+                auto hash = hash_of(value_traits::get_key(value));
+                auto i = find_first_non_full(hash);
+                alloc_traits::construct(m_alloc, m_slots + i, value);
+                commit_insert(i, hash);
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    hashtable(hashtable &&other) noexcept
+        : m_ctrl(other.m_ctrl), m_slots(other.m_slots), m_capacity(other.m_capacity),
+          m_size(other.m_size), m_growth_left(other.m_growth_left),
+          m_hash(std::move(other.m_hash)), m_equal(std::move(other.m_equal)),
+          m_alloc(std::move(other.m_alloc)) {
+        other.reset_empty();
+    }
+
+    hashtable &operator=(const hashtable &rhs) {
+        if (this != &rhs) {
+            hashtable tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    hashtable &operator=(hashtable &&rhs) noexcept {
+        if (this != &rhs) {
+            hashtable tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~hashtable() {
+        release();
+    }
+
+  public:
+    // 迭代器相关操作
+    iterator begin() noexcept {
+        iterator it(m_ctrl, m_slots);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator begin() const noexcept {
+        return const_cast<hashtable *>(this)->begin();
+    }
+    iterator end() noexcept {
+        return iterator(m_ctrl + m_capacity, m_slots + m_capacity);
+    }
+    const_iterator end() const noexcept {
+        return const_cast<hashtable *>(this)->end();
+    }
+
+    // 容量相关操作
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+    size_type size() const noexcept {
+        return m_size;
+    }
+    size_type max_size() const noexcept {
+        return std::numeric_limits<difference_type>::max() / sizeof(T);
+    }
+
+    size_type bucket_count() const noexcept {
+        return m_capacity;
+    }
+    float load_factor() const noexcept {
+        return m_capacity == 0 ? 0.0f : static_cast<float>(m_size) / m_capacity;
+    }
+    // 最大负载因子固定为 7/8
+    float max_load_factor() const noexcept {
+        return 0.875f;
+    }
+
+    // 预留空间，使插入 count 个元素前不再扩容
+    void reserve(size_type count) {
+        if (count > m_size + m_growth_left) {
+            resize(hashtable_normalize_capacity(hashtable_growth_to_lower_bound_capacity(count)));
+        }
+    }
+
+    // 重建哈希表，槽位数不少于 count 且足以容纳现有元素，count 为 0 且表为空时释放空间
+    void rehash(size_type count) {
+        if (count == 0 && m_size == 0) {
+            release();
+            reset_empty();
+            return;
+        }
+        auto need = hashtable_growth_to_lower_bound_capacity(m_size);
+        auto capacity = hashtable_normalize_capacity(count > need ? count : need);
+        if (m_capacity == 0 || capacity != m_capacity) {
+            resize(capacity);
+        }
+    }
+
+    hasher hash_function() const {
+        return m_hash;
+    }
+    key_equal key_eq() const {
+        return m_equal;
+    }
+    allocator_type get_allocator() const {
+        return m_alloc;
+    }
+
+    // 查找
+    iterator find(const key_type &key) {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+    const_iterator find(const key_type &key) const {
+        return const_cast<hashtable *>(this)->find(key);
+    }
+
+    bool contains(const key_type &key) const {
+        return find_index(key, hash_of(key)) != m_capacity;
+    }
+    size_type count(const key_type &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // 插入
+    // 键值不存在时以 args 构造新元素，已存在时不构造任何对象
+    template <class K, class... Args>
+    std::pair<iterator, bool> emplace_key(const K &key, Args &&...args) {
+        auto hash = hash_of(key);
+        auto i = find_index(key, hash);
+        if (i != m_capacity) {
+            return {iterator_at(i), false};
+        }
+        i = prepare_insert(hash);
+        alloc_traits::construct(m_alloc, m_slots + i, std::forward<Args>(args)...);
+        commit_insert(i, hash);
+        return {iterator_at(i), true};
+    }
+
+    std::pair<iterator, bool> insert_unique(const value_type &value) {
+        return emplace_key(value_traits::get_key(value), value);
+    }
+    std::pair<iterator, bool> insert_unique(value_type &&value) {
+        return emplace_key(value_traits::get_key(value), std::move(value));
+    }
+
+    // 需要先构造出元素才能得到键值
+    template <class... Args>
+    std::pair<iterator, bool> emplace_unique(Args &&...args) {
+        value_type value(std::forward<Args>(args)...);
+        return emplace_key(value_traits::get_key(value), std::move(value));
+    }
+
+    template <class InputIt>
+    void insert_unique(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert_unique(*first);
+        }
+    }
+
+    // 删除
+    iterator erase(const_iterator pos) {
+        auto i = static_cast<size_type>(pos.slot - m_slots);
+        erase_at(i);
+        iterator it(m_ctrl + i, m_slots + i);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(last.ctrl, last.slot);
+    }
+
+    size_type erase(const key_type &key) {
+        auto i = find_index(key, hash_of(key));
+        if (i == m_capacity) {
+            return 0;
+        }
+        erase_at(i);
+        return 1;
+    }
+
+    // 清空元素，保留槽位
+    void clear() noexcept {
+        if (m_capacity == 0) {
+            return;
+        }
+        for (size_type i = 0; i < m_capacity; ++i) {
+            if (hashtable_is_full(m_ctrl[i])) {
+                alloc_traits::destroy(m_alloc, m_slots + i);
+            }
+        }
+        reset_ctrl();
+        m_size = 0;
+        m_growth_left = hashtable_capacity_to_growth(m_capacity);
+    }
+
+    void swap(hashtable &rhs) noexcept {
+        tstl::swap(m_ctrl, rhs.m_ctrl);
+        tstl::swap(m_slots, rhs.m_slots);
+        tstl::swap(m_capacity, rhs.m_capacity);
+        tstl::swap(m_size, rhs.m_size);
+        tstl::swap(m_growth_left, rhs.m_growth_left);
+        tstl::swap(m_hash, rhs.m_hash);
+        tstl::swap(m_equal, rhs.m_equal);
+        tstl::swap(m_alloc, rhs.m_alloc);
+    }
+
+  private:
+    template <class K>
+    size_type hash_of(const K &key) const {
+        return hashtable_mix(m_hash(key));
+    }
+
+    iterator iterator_at(size_type i) noexcept {
+        return iterator(m_ctrl + i, m_slots + i);
+    }
+
+    void set_ctrl(size_type i, ctrl_t h) noexcept {
+        hashtable_set_ctrl(m_ctrl, m_capacity, i, h);
+    }
+
+    // 查找键值所在的槽位，不存在时返回 m_capacity
+    template <class K>
+    size_type find_index(const K &key, size_type hash) const {
+        hashtable_probe_seq seq(hashtable_h1(hash), m_capacity);
+        const ctrl_t h = hashtable_h2(hash);
+        while (true) {
+            group g(m_ctrl + seq.offset());
+            for (auto match = g.match(h); match; ++match) {
+                auto i = seq.offset(match.lowest());
+                if (m_equal(value_traits::get_key(m_slots[i]), key)) {
+                    return i;
+                }
+            }
+            if (g.match_empty()) {
+                return m_capacity;
+            }
+            seq.next();
+        }
+    }
+
+    size_type find_first_non_full(size_type hash) const noexcept {
+        return hashtable_find_first_non_full(m_ctrl, m_capacity, hash);
+    }
+
+    // 为新元素选择槽位，必要时先扩容；此时还未修改表的状态，构造元素失败时无需回滚
+    size_type prepare_insert(size_type hash) {
+        auto i = find_first_non_full(hash);
+        if (m_growth_left == 0 && m_ctrl[i] != hashtable_deleted) {
+            rehash_and_grow();
+            i = find_first_non_full(hash);
+        }
+        return i;
+    }
+
+    // 元素已构造在槽位 i 中，登记控制字节
+    void commit_insert(size_type i, size_type hash) noexcept {
+        ++m_size;
+        m_growth_left -= m_ctrl[i] == hashtable_empty ? 1 : 0;
+        set_ctrl(i, hashtable_h2(hash));
+    }
+
+    // 墓碑较多时按原容量重建即可回收，否则容量翻倍
+    void rehash_and_grow() {
+        if (m_capacity == 0) {
+            resize(1);
+        } else if (m_capacity > group::width && m_size * 32 <= m_capacity * 25) {
+            resize(m_capacity);
+        } else {
+            resize(m_capacity * 2 + 1);
+        }
+    }
+
+    void erase_at(size_type i) noexcept {
+        alloc_traits::destroy(m_alloc, m_slots + i);
+        --m_size;
+        m_growth_left += hashtable_erase_ctrl(m_ctrl, m_capacity, i) ? 1 : 0;
+    }
+
+    // 分配 capacity 个槽位，所有控制字节置空
+    void initialize(size_type capacity) {
+        ctrl_allocator ctrl_alloc(m_alloc);
+        auto ctrl = ctrl_traits::allocate(ctrl_alloc, capacity + group::width);
+        try {
+            m_slots = alloc_traits::allocate(m_alloc, capacity);
+        } catch (...) {
+            ctrl_traits::deallocate(ctrl_alloc, ctrl, capacity + group::width);
+            throw;
+        }
+        m_ctrl = ctrl;
+        m_capacity = capacity;
+        reset_ctrl();
+        m_growth_left = hashtable_capacity_to_growth(capacity) - m_size;
+    }
+
+    void reset_ctrl() noexcept {
+        std::memset(m_ctrl, static_cast<unsigned char>(hashtable_empty),
+                    m_capacity + group::width);
+        m_ctrl[m_capacity] = hashtable_sentinel;
+    }
+
+    // 换用 capacity 个槽位重新放置全部元素
+    // 放置过程可能抛出异常（哈希函数或移动构造可能抛出）时复制元素，失败则恢复原表，保证强异常安全；
+    // 元素只能移动且可能失败时只保证基本异常安全：恢复的原表中已移走的元素处于有效但未指定的状态
+    void resize(size_type capacity) {
+        auto old_ctrl = m_ctrl;
+        auto old_slots = m_slots;
+        auto old_capacity = m_capacity;
+        auto old_growth_left = m_growth_left;
+        initialize(capacity);
+        try {
+            for (size_type i = 0; i < old_capacity; ++i) {
+                if (hashtable_is_full(old_ctrl[i])) {
+                    auto hash = hash_of(value_traits::get_key(old_slots[i]));
+                    auto j = find_first_non_full(hash);
+                    alloc_traits::construct(m_alloc, m_slots + j,
+                                            relocate_arg(old_slots[i], relocate_by_move()));
+                    set_ctrl(j, hashtable_h2(hash));
+                }
+            }
+        } catch (...) {
+            release(m_ctrl, m_slots, m_capacity);
+            m_ctrl = old_ctrl;
+            m_slots = old_slots;
+            m_capacity = old_capacity;
+            m_growth_left = old_growth_left;
+            throw;
+        }
+        release(old_ctrl, old_slots, old_capacity);
+    }
+
+    static T &&relocate_arg(T &value, std::true_type) noexcept {
+        return std::move(value);
+    }
+    static const T &relocate_arg(T &value, std::false_type) noexcept {
+        return value;
+    }
+
+    // 销毁一组槽位中的全部元素并释放空间
+    void release(ctrl_t *ctrl, T *slots, size_type capacity) noexcept {
+        if (capacity == 0) {
+            return;
+        }
+        for (size_type i = 0; i < capacity; ++i) {
+            if (hashtable_is_full(ctrl[i])) {
+                alloc_traits::destroy(m_alloc, slots + i);
+            }
+        }
+        ctrl_allocator ctrl_alloc(m_alloc);
+        ctrl_traits::deallocate(ctrl_alloc, ctrl, capacity + group::width);
+        alloc_traits::deallocate(m_alloc, slots, capacity);
+    }
+
+    // 销毁全部元素并释放空间，之后需调用 reset_empty 或 initialize
+    void release() noexcept {
+        release(m_ctrl, m_slots, m_capacity);
+    }
+
+    void reset_empty() noexcept {
+        m_ctrl = hashtable_empty_group();
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+    }
+};
+
+} // namespace tstl
+
+#endif
@@ -79,7 +79,7 @@ class _normal_iterator {
 
     _normal_iterator &operator=(const _normal_iterator &) = default;
 
-    _normal_iterator &operator[](difference_type n) const {
+    reference operator[](difference_type n) const {
         return current[n];
     }
 
@@ -2,6 +2,8 @@
 #define TSTL_SRC_LIST_HPP
 
 #include "memory/construct.hpp"
+#include "memory/memory_usage.hpp"
+#include "memory/memory_resource.hpp"
 #include "iterator.hpp"
 #include "algorithm.hpp"
 
@@ -210,6 +212,7 @@ class list {
 
   public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = value_type *;
     using const_pointer = const value_type *;
     using reference = value_type &;
@@ -244,39 +247,71 @@ class list {
         empty_initialized();
     }
 
+    explicit list(const Allocator &alloc) : m_bnode_alloc(alloc), m_node_alloc(alloc) {
+        empty_initialized();
+    }
+
     explicit list(size_type n, const value_type &value = value_type()) : list() {
         fill_insert(begin(), n, value);
     }
 
+    list(size_type n, const value_type &value, const Allocator &alloc) : list(alloc) {
+        fill_insert(begin(), n, value);
+    }
+
     template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
     list(InputIt first, InputIt last) : list() {
         list_insert(begin(), first, last);
     }
 
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    list(InputIt first, InputIt last, const Allocator &alloc) : list(alloc) {
+        list_insert(begin(), first, last);
+    }
+
     list(std::initializer_list<T> init): list() {
         list_insert(begin(), init.begin(), init.end());
     }
 
-    list(const list &l) : list() {
+    list(std::initializer_list<T> init, const Allocator &alloc) : list(alloc) {
+        list_insert(begin(), init.begin(), init.end());
+    }
+
+    list(const list &l)
+        : list(alloc_traits::select_on_container_copy_construction(l.get_allocator())) {
+        list_insert(begin(), l.begin(), l.end());
+    }
+
+    list(const list &l, const Allocator &alloc) : list(alloc) {
         list_insert(begin(), l.begin(), l.end());
     }
 
-    list &operator=(const list &l) noexcept {
-        list temp(l);
-        swap(temp);
+    list &operator=(const list &l) {
+        if (this != &l) {
+            clear();
+            assign_alloc(l, typename alloc_traits::propagate_on_container_copy_assignment());
+            list_insert(begin(), l.begin(), l.end());
+        }
         return *this;
     }
 
-    list(list &&rhs) noexcept { // 右值引用
+    // 末尾结点由 rhs 的分配器分配，复制分配器以便交换后各自释放
+    list(list &&rhs) noexcept : m_bnode_alloc(rhs.m_bnode_alloc), m_node_alloc(rhs.m_node_alloc) {
         empty_initialized();
-        swap(rhs);
-        tstl::distance(begin(), end());
+        swap_nodes(rhs);
     }
 
-    list &operator=(list &&rhs) noexcept {
-        clear();
-        swap(rhs);
-        m_size = tstl::distance(begin(), end());
+    list(list &&rhs, const Allocator &alloc) : list(alloc) {
+        move_assign(rhs, std::false_type());
+    }
+
+    list &operator=(list &&rhs) noexcept(
+        node_alloc_traits::propagate_on_container_move_assignment::value ||
+        node_alloc_traits::is_always_equal::value) {
+        if (this != &rhs) {
+            clear();
+            move_assign(rhs, typename alloc_traits::propagate_on_container_move_assignment());
+        }
         return *this;
     }
 
@@ -318,13 +353,30 @@ class list {
         return m_size;
     }
 
+    size_type max_size() const noexcept {
+        return node_alloc_traits::max_size(m_node_alloc);
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(m_node_alloc);
+    }
+
+    // 每个结点的前后指针与末尾结点计入额外开销
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = m_size * sizeof(T);
+        usage.overhead = sizeof(*this) + (m_size + 1) * sizeof(Lnode) - usage.payload;
+        return usage;
+    }
+
     bool empty() const noexcept {
         return begin() == end();
     }
 
+    // 分配器不随交换传播时，要求两者相等
     void swap(list &rhs) noexcept {
-        tstl::swap(m_node, rhs.m_node);
-        tstl::swap(m_size, rhs.m_size);
+        swap_nodes(rhs);
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
     }
 
     void assign(size_type n, const value_type &val = value_type()) {
@@ -504,61 +556,54 @@ class list {
 
     // 归并排序
     void sort() {
-        if (m_node->next == m_node || m_node->next->next == m_node) {
-            return;
-        }
-        // 数据缓存区
-        // _tmp[n]中最多存放2^(n+1)个元素，若大于则与_tmp[n+1]作归并
-        list carry;
-        list counter[64];
-        int fill = 0, size = m_size;
-        while (!empty()) {
-            carry.splice(carry.begin(), *this, begin());
-            int i = 0;
-            while (i < fill && !counter[i].empty()) {
-                counter[i].merge(carry);
-                carry.swap(counter[i++]);
-            }
-            carry.swap(counter[i]);
-            if (i == fill) {
-                ++fill;
-            }
-        }
-        for (int i = 1; i < fill; ++i) {
-            counter[i].merge(counter[i - 1]);
-        }
-        swap(counter[fill - 1]);
-        m_size = size;
+        sort(std::less<T>());
     }
 
-    // 支持仿函数的排序
+    // 支持仿函数的排序，稳定
+    // 自底向上归并：结点经 next 串成以 nullptr 结尾的有序段，counter[i] 为至多 2^i 个结点的有序段，
+    // 只重排已有结点，不创建临时链表，因此不要求分配器可以默认构造
+    // cmp 抛出异常时全部结点仍留在本链表中，顺序不确定
     template <class Compare>
     void sort(Compare cmp) {
-        if (m_node->next == m_node || m_node->next->next == m_node) {
+        if (m_size < 2) {
             return;
         }
-        // 数据缓存区
-        // _tmp[n]中最多存放2^(n+1)个元素，若大于则与_tmp[n+1]作归并
-        list carry;
-        list counter[64];
-        int fill = 0, size = m_size;
-        while (!empty()) {
-            carry.splice(carry.begin(), *this, begin());
-            int i = 0;
-            while (i < fill && !counter[i].empty()) {
-                counter[i].merge(carry, cmp);
-                carry.swap(counter[i++]);
+        base_ptr counter[64] = {};
+        int fill = 0;
+        base_ptr rest = m_node->next;
+        base_ptr carry = nullptr;
+        m_node->prev->next = nullptr;
+        try {
+            while (rest != nullptr) {
+                carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+                carry->prev = carry;
+                int i = 0;
+                for (; i < fill && counter[i] != nullptr; ++i) {
+                    carry = merge_runs(counter[i], carry, cmp);
+                }
+                counter[i] = carry;
+                carry = nullptr;
+                if (i == fill) {
+                    ++fill;
+                }
             }
-            carry.swap(counter[i]);
-            if (i == fill) {
-                ++fill;
+            for (int i = 0; i < fill; ++i) {
+                carry = merge_runs(counter[i], carry, cmp);
             }
+        } catch (...) {
+            for (int i = 0; i < fill; ++i) {
+                carry = concat_runs(counter[i], carry);
+            }
+            relink_run(concat_runs(carry, rest));
+            throw;
         }
-        for (int i = 1; i < fill; ++i) {
-            counter[i].merge(counter[i - 1], cmp);
-        }
-        swap(counter[fill - 1]);
-        m_size = size;
+        base_ptr last = carry->prev;
+        m_node->next = carry;
+        carry->prev = m_node;
+        last->next = m_node;
+        m_node->prev = last;
     }
 
     // 从 list 种移除 value 元素
@@ -647,7 +692,7 @@ class list {
     node_ptr create_node(const value_type &value) {
         node_ptr p = m_node_allocate(1);
         try {
-            node_alloc_traits::construct(m_node_alloc, p, value);
+            node_alloc_traits::construct(m_node_alloc, std::addressof(p->data), value);
         } catch (...) {
             m_deallocate(p);
             throw;
@@ -669,10 +714,51 @@ class list {
     }
 
     void destroy_node(node_ptr p) {
-        m_node_alloc.destroy(&p->data);
+        node_alloc_traits::destroy(m_node_alloc, std::addressof(p->data));
         m_deallocate(p);
     }
 
+    // 分配器相关的赋值与交换，按 propagate_on_container_* 决定是否随元素一起转移
+    void swap_nodes(list &rhs) noexcept {
+        tstl::swap(m_node, rhs.m_node);
+        tstl::swap(m_size, rhs.m_size);
+    }
+
+    void swap_alloc(list &rhs, std::true_type) noexcept {
+        tstl::swap(m_bnode_alloc, rhs.m_bnode_alloc);
+        tstl::swap(m_node_alloc, rhs.m_node_alloc);
+    }
+    void swap_alloc(list &, std::false_type) noexcept {
+    }
+
+    // 要求本链表为空，末尾结点需用新的分配器重新分配
+    void assign_alloc(const list &rhs, std::true_type) {
+        if (m_node_alloc != rhs.m_node_alloc) {
+            m_deallocate(m_node->as_node());
+            m_bnode_alloc = rhs.m_bnode_alloc;
+            m_node_alloc = rhs.m_node_alloc;
+            empty_initialized();
+        }
+    }
+    void assign_alloc(const list &, std::false_type) {
+    }
+
+    void move_assign(list &rhs, std::true_type) {
+        assign_alloc(rhs, std::true_type());
+        swap_nodes(rhs);
+    }
+    // 分配器不随移动转移时，只有两者相等才能直接接管结点，否则逐个移动
+    void move_assign(list &rhs, std::false_type) {
+        if (m_node_alloc == rhs.m_node_alloc) {
+            swap_nodes(rhs);
+        } else {
+            for (auto &value : rhs) {
+                insert(end(), std::move(value));
+            }
+            rhs.clear();
+        }
+    }
+
     // 链表为空的初始化
     void empty_initialized() {
         m_node = m_node_allocate(1); // 链表的末尾结点
@@ -725,6 +811,72 @@ class list {
         return size;
     }
 
+    // 以下为 sort 使用的有序段操作：段内结点经 next 串接，以 nullptr 结尾，
+    // 合并时顺带维护 prev，段首结点的 prev 指向段尾结点，排序结束时无需再遍历一遍
+    // 合并有序段 a 与 b，a 中的结点在前，相等时 a 的结点排在前面；
+    // cmp 抛出异常时把已合并的部分与 a、b 的剩余部分串成一段放入 a，b 置空，prev 不再有效
+    template <class Compare>
+    static base_ptr merge_runs(base_ptr &a, base_ptr &b, Compare &cmp) {
+        base_ptr x = a;
+        base_ptr y = b;
+        a = b = nullptr;
+        if (x == nullptr || y == nullptr) {
+            return x != nullptr ? x : y;
+        }
+        base_ptr x_tail = x->prev;
+        base_ptr y_tail = y->prev;
+        list_node_base<T> head;
+        base_ptr last = &head;
+        try {
+            while (x != nullptr && y != nullptr) {
+                if (cmp(y->as_node()->data, x->as_node()->data)) {
+                    last->next = y;
+                    y->prev = last;
+                    last = y;
+                    y = y->next;
+                } else {
+                    last->next = x;
+                    x->prev = last;
+                    last = x;
+                    x = x->next;
+                }
+            }
+        } catch (...) {
+            last->next = concat_runs(x, y);
+            a = head.next;
+            throw;
+        }
+        base_ptr rem = x != nullptr ? x : y;
+        last->next = rem;
+        rem->prev = last;
+        head.next->prev = x != nullptr ? x_tail : y_tail;
+        return head.next;
+    }
+
+    static base_ptr concat_runs(base_ptr a, base_ptr b) noexcept {
+        if (a == nullptr) {
+            return b;
+        }
+        base_ptr last = a;
+        while (last->next != nullptr) {
+            last = last->next;
+        }
+        last->next = b;
+        return a;
+    }
+
+    // 把单链表 first 的全部结点按顺序重新挂到末尾结点上，恢复双向链接
+    void relink_run(base_ptr first) noexcept {
+        base_ptr prev = m_node;
+        for (; first != nullptr; first = first->next) {
+            prev->next = first;
+            first->prev = prev;
+            prev = first;
+        }
+        prev->next = m_node;
+        m_node->prev = prev;
+    }
+
     // 在position 前面插入 [first, last)
     void transfer(iterator position, iterator first, iterator last) {
         if (position == last) {
@@ -750,8 +902,8 @@ inline bool operator!=(const list<int>::iterator &lhs, const list<int>::iterator
     return lhs != rhs;
 }
 
-template <class T>
-bool operator==(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+bool operator==(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
     auto it1 = lhs.begin(), it2 = rhs.begin(); // same as cbegin()
     for (; it1 != lhs.end() && it2 != rhs.end(); ++it1, ++it2) {
         if (*it1 != *it2) {
@@ -761,11 +913,16 @@ bool operator==(const list<T> &lhs, const list<T> &rhs) {
     return it1 == lhs.end() && it2 == rhs.end();
 }
 
-template <class T>
-inline bool operator!=(const list<T> &lhs, const list<T> &rhs) {
+template <class T, class Alloc>
+inline bool operator!=(const list<T, Alloc> &lhs, const list<T, Alloc> &rhs) {
     return !(lhs == rhs);
 }
 
+namespace pmr {
+template <class T>
+using list = tstl::list<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstl
 
 #endif
\ No newline at end of file
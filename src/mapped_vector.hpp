@@ -0,0 +1,501 @@
+#ifndef TSTL_SRC_MAPPED_VECTOR_HPP
+#define TSTL_SRC_MAPPED_VECTOR_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "algorithm.hpp"
+#include "iterator.hpp"
+
+namespace tstl {
+
+// mapped_vector 文件的头部，元素数据从 data_offset 开始
+struct _mapped_vector_header {
+    static constexpr std::size_t data_offset = 64;
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t elem_size;
+    std::uint64_t size;
+
+    static const char *expected_magic() noexcept {
+        return "TSTLMVEC";
+    }
+};
+
+/**
+ * @brief 以文件为存储、通过 mmap 访问的 vector，只接受可平凡复制的元素。
+ *
+ * 打开文件即可访问全部元素，无需逐个反序列化；多个进程以只读方式打开同一文件时共享页缓存。
+ * 只读模式提供 vector 的全部访问接口，文件以写时复制的私有方式映射，对元素的修改只有本对象可见，
+ * 不会写回文件；读写模式额外支持追加与调整大小，
+ * 容量不足时用 ftruncate 扩大文件并用 mremap 调整映射。
+ * 文件由 64 字节的头部和紧随其后的元素组成，元素按机器的字节序存放，不能跨平台使用。
+ * 读写模式的 close() 会截断文件，不要在其他进程映射着同一文件时以读写模式打开它。
+ */
+template <class T>
+class mapped_vector {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_vector requires trivially copyable elements");
+    static_assert(alignof(T) <= _mapped_vector_header::data_offset,
+                  "mapped_vector element alignment is too large");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using iterator = tstl::_normal_iterator<T *, mapped_vector>;
+    using const_iterator = tstl::_normal_iterator<const T *, mapped_vector>;
+    using reverse_iterator = tstl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tstl::reverse_iterator<const_iterator>;
+
+    enum open_mode {
+        read_only,  // 文件必须存在，映射为只读
+        read_write, // 文件不存在时创建，可以修改与追加
+    };
+
+    mapped_vector() noexcept = default;
+
+    /**
+     * @brief 打开 path 对应的文件，失败时抛出 std::system_error，文件格式不符时抛出
+     * std::runtime_error。
+     */
+    explicit mapped_vector(const char *path, open_mode mode = read_only) {
+        open(path, mode);
+    }
+
+    mapped_vector(const mapped_vector &) = delete;
+    mapped_vector &operator=(const mapped_vector &) = delete;
+
+    mapped_vector(mapped_vector &&other) noexcept {
+        m_swap_data(other);
+    }
+
+    mapped_vector &operator=(mapped_vector &&other) noexcept {
+        if (this != &other) {
+            close();
+            m_swap_data(other);
+        }
+        return *this;
+    }
+
+    ~mapped_vector() {
+        close();
+    }
+
+    /**
+     * @brief 打开 path 对应的文件，已打开的文件先被关闭。
+     */
+    void open(const char *path, open_mode mode = read_only) {
+        close();
+        const bool writable = mode == read_write;
+        int fd = ::open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd < 0) {
+            m_throw_errno("mapped_vector::open");
+        }
+        try {
+            m_map_file(fd, writable);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    /**
+     * @brief 写回头部并解除映射；读写模式下文件被截断到恰好容纳 size() 个元素。
+     */
+    void close() noexcept {
+        if (m_fd < 0) {
+            return;
+        }
+        if (m_writable) {
+            m_header()->size = m_size;
+            ::munmap(m_map, m_map_len);
+            int ret = ::ftruncate(m_fd, static_cast<off_t>(m_bytes_for(m_size)));
+            (void)ret;
+        } else {
+            ::munmap(m_map, m_map_len);
+        }
+        ::close(m_fd);
+        m_fd = -1;
+        m_map = nullptr;
+        m_map_len = 0;
+        m_size = 0;
+        m_capacity = 0;
+        m_writable = false;
+    }
+
+    /**
+     * @brief 把已修改的页与头部同步写回文件。
+     */
+    void flush() {
+        if (m_fd < 0 || !m_writable) {
+            return;
+        }
+        m_header()->size = m_size;
+        if (::msync(m_map, m_map_len, MS_SYNC) != 0) {
+            m_throw_errno("mapped_vector::flush");
+        }
+    }
+
+    bool is_open() const noexcept {
+        return m_fd >= 0;
+    }
+
+    bool writable() const noexcept {
+        return m_writable;
+    }
+
+    /**
+     * @brief 返回位于指定位置 pos 的元素的引用，有边界检查。
+     *
+     * 若 pos 不在容器范围内，则抛出 std::out_of_range 类型的异常。
+     */
+    reference at(size_type pos) {
+        m_range_check(pos);
+        return data()[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        m_range_check(pos);
+        return data()[pos];
+    }
+
+    /**
+     * @brief 返回位于指定位置 pos 的元素的引用，不进行边界检查。
+     */
+    reference operator[](size_type pos) {
+        return data()[pos];
+    }
+
+    const_reference operator[](size_type pos) const {
+        return data()[pos];
+    }
+
+    reference front() {
+        return data()[0];
+    }
+
+    const_reference front() const {
+        return data()[0];
+    }
+
+    reference back() {
+        return data()[m_size - 1];
+    }
+
+    const_reference back() const {
+        return data()[m_size - 1];
+    }
+
+    /**
+     * @brief 返回指向映射中首元素的指针，未打开文件时为 nullptr。
+     */
+    T *data() noexcept {
+        return m_map == nullptr ? nullptr : reinterpret_cast<T *>(m_map + m_data_offset());
+    }
+
+    const T *data() const noexcept {
+        return m_map == nullptr ? nullptr : reinterpret_cast<const T *>(m_map + m_data_offset());
+    }
+
+    iterator begin() noexcept {
+        return iterator(data());
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(data());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(data() + m_size);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(data() + m_size);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * @brief 返回文件当前能容纳的元素数。
+     */
+    size_type capacity() const noexcept {
+        return m_capacity;
+    }
+
+    /**
+     * @brief 扩大文件使其至少能容纳 new_cap 个元素，只能在读写模式下调用。
+     *
+     * 映射可能被移动，所有迭代器和到元素的引用都被非法化。
+     */
+    void reserve(size_type new_cap) {
+        m_check_writable();
+        if (new_cap > m_capacity) {
+            m_grow_to(new_cap);
+        }
+    }
+
+    /**
+     * @brief 改变元素个数，新增的元素被值初始化，只能在读写模式下调用。
+     */
+    void resize(size_type count) {
+        m_check_writable();
+        if (count > m_capacity) {
+            m_grow_to(count);
+        }
+        if (count > m_size) {
+            tstl::fill(data() + m_size, data() + count, T());
+        }
+        m_size = count;
+    }
+
+    void clear() {
+        m_check_writable();
+        m_size = 0;
+    }
+
+    /**
+     * @brief 添加元素到末尾，只能在读写模式下调用。
+     */
+    void push_back(const T &value) {
+        m_check_writable();
+        if (m_size == m_capacity) {
+            // value 可能引用映射中的元素，在映射被移动之前先复制下来
+            T tmp = value;
+            m_grow_to(m_check_len(1));
+            data()[m_size++] = tmp;
+        } else {
+            data()[m_size++] = value;
+        }
+    }
+
+    template <class... Args>
+    void emplace_back(Args &&...args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    void pop_back() {
+        m_check_writable();
+        --m_size;
+    }
+
+    /**
+     * @brief 把 [first, last) 追加到末尾，只能在读写模式下调用。
+     */
+    template <class InputIt>
+    void append(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void append(const T *first, const T *last) {
+        m_check_writable();
+        const size_type count = static_cast<size_type>(last - first);
+        if (m_capacity - m_size < count) {
+            // [first, last) 可能位于映射之中
+            T *old_data = data();
+            const bool inside = first >= old_data && first < old_data + m_size;
+            const size_type offset = inside ? static_cast<size_type>(first - old_data) : 0;
+            m_grow_to(m_check_len(count));
+            if (inside) {
+                first = data() + offset;
+            }
+        }
+        if (count != 0) {
+            std::memmove(static_cast<void *>(data() + m_size), first, count * sizeof(T));
+        }
+        m_size += count;
+    }
+
+    void swap(mapped_vector &other) noexcept {
+        m_swap_data(other);
+    }
+
+  private:
+    unsigned char *m_map = nullptr;
+    std::size_t m_map_len = 0;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+    int m_fd = -1;
+    bool m_writable = false;
+
+    static constexpr std::size_t m_data_offset() noexcept {
+        return _mapped_vector_header::data_offset;
+    }
+
+    static std::size_t m_bytes_for(size_type count) noexcept {
+        return m_data_offset() + count * sizeof(T);
+    }
+
+    _mapped_vector_header *m_header() noexcept {
+        return reinterpret_cast<_mapped_vector_header *>(m_map);
+    }
+
+    [[noreturn]] static void m_throw_errno(const char *what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void m_range_check(size_type pos) const {
+        if (pos >= m_size) {
+            throw std::out_of_range("mapped_vector::m_range_check: out of range");
+        }
+    }
+
+    void m_check_writable() const {
+        if (!m_writable) {
+            throw std::logic_error("mapped_vector: not opened in read_write mode");
+        }
+    }
+
+    size_type m_check_len(size_type n) const {
+        const size_type max_count = (static_cast<size_type>(-1) - m_data_offset()) / sizeof(T);
+        if (max_count - m_size < n) {
+            throw std::length_error("mapped_vector::m_check_len");
+        }
+        size_type len = m_size + (m_size > n ? m_size : n);
+        return len < m_size || len > max_count ? max_count : len;
+    }
+
+    // 新建的文件写入头部；已有文件检查头部后映射全部内容
+    void m_map_file(int fd, bool writable) {
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            m_throw_errno("mapped_vector::open");
+        }
+        std::size_t len = static_cast<std::size_t>(st.st_size);
+        if (len == 0 && writable) {
+            len = m_data_offset();
+            if (::ftruncate(fd, static_cast<off_t>(len)) != 0) {
+                m_throw_errno("mapped_vector::open");
+            }
+            m_init_header(fd);
+        }
+        if (len < m_data_offset()) {
+            throw std::runtime_error("mapped_vector::open: file too short");
+        }
+        // 只读模式的页在被写入之前仍与页缓存共享
+        void *p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                         writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            m_throw_errno("mapped_vector::open");
+        }
+        const _mapped_vector_header *header = static_cast<const _mapped_vector_header *>(p);
+        const size_type capacity = (len - m_data_offset()) / sizeof(T);
+        if (std::memcmp(header->magic, _mapped_vector_header::expected_magic(), 8) != 0 ||
+            header->version != _mapped_vector_header::current_version ||
+            header->elem_size != sizeof(T) || header->size > capacity) {
+            ::munmap(p, len);
+            throw std::runtime_error("mapped_vector::open: invalid file header");
+        }
+        m_map = static_cast<unsigned char *>(p);
+        m_map_len = len;
+        m_size = static_cast<size_type>(header->size);
+        m_capacity = capacity;
+        m_fd = fd;
+        m_writable = writable;
+    }
+
+    static void m_init_header(int fd) {
+        _mapped_vector_header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, _mapped_vector_header::expected_magic(), 8);
+        header.version = _mapped_vector_header::current_version;
+        header.elem_size = static_cast<std::uint32_t>(sizeof(T));
+        header.size = 0;
+        if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            m_throw_errno("mapped_vector::open");
+        }
+    }
+
+    // 先扩大文件，再用 mremap 扩大映射，内核可能把映射移动到新的地址
+    void m_grow_to(size_type new_cap) {
+        const std::size_t len = m_bytes_for(new_cap);
+        if (::ftruncate(m_fd, static_cast<off_t>(len)) != 0) {
+            m_throw_errno("mapped_vector::reserve");
+        }
+        void *p = ::mremap(m_map, m_map_len, len, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            int ret = ::ftruncate(m_fd, static_cast<off_t>(m_map_len));
+            (void)ret;
+            errno = err;
+            m_throw_errno("mapped_vector::reserve");
+        }
+        m_map = static_cast<unsigned char *>(p);
+        m_map_len = len;
+        m_capacity = new_cap;
+    }
+
+    void m_swap_data(mapped_vector &other) noexcept {
+        tstl::swap(m_map, other.m_map);
+        tstl::swap(m_map_len, other.m_map_len);
+        tstl::swap(m_size, other.m_size);
+        tstl::swap(m_capacity, other.m_capacity);
+        tstl::swap(m_fd, other.m_fd);
+        tstl::swap(m_writable, other.m_writable);
+    }
+};
+
+template <class T>
+void swap(mapped_vector<T> &lhs, mapped_vector<T> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
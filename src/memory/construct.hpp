@@ -32,6 +32,27 @@ void _destroy_a(ForwardIt first, ForwardIt last, Allocator &alloc) {
     }
 }
 
+// 分配器声明 trivially_deallocate 为 true_type 时，deallocate 为空操作
+// 容器据此可以跳过只为释放内存而进行的遍历
+template <class Allocator, class = void>
+struct _alloc_trivially_deallocate : std::false_type {};
+
+template <class Allocator>
+struct _alloc_trivially_deallocate<Allocator,
+                                   tstl::_void_t<typename Allocator::trivially_deallocate>>
+    : Allocator::trivially_deallocate {};
+
+// 分配器提供 reallocate(p, old_n, new_n) 时，可平凡复制的元素扩容可以交给分配器原地调整
+template <class Allocator, class = void>
+struct _alloc_has_reallocate : std::false_type {};
+
+template <class Allocator>
+struct _alloc_has_reallocate<
+    Allocator,
+    tstl::_void_t<decltype(std::declval<Allocator &>().reallocate(
+        std::declval<typename Allocator::value_type *>(), std::size_t(), std::size_t()))>>
+    : std::true_type {};
+
 } // namespace tstl
 
 #endif
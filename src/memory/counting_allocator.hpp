@@ -0,0 +1,149 @@
+#ifndef TSTL_SRC_COUNTING_ALLOCATOR_HPP
+#define TSTL_SRC_COUNTING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tstl {
+
+// counting_allocator 记录的分配统计，可由多个容器、多个分配器副本共享
+// 与容器一样不是线程安全的，跨线程共享时需由使用者同步
+struct allocation_stats {
+    // histogram[i] 统计字节数落在 [2^i, 2^(i+1)) 中的分配次数
+    static constexpr std::size_t histogram_buckets = 8 * sizeof(std::size_t);
+
+    std::size_t allocations = 0;     // 分配次数
+    std::size_t deallocations = 0;   // 释放次数
+    std::size_t bytes_allocated = 0; // 累计分配的字节数
+    std::size_t live_bytes = 0;      // 尚未释放的字节数
+    std::size_t peak_bytes = 0;      // live_bytes 的历史最大值
+    std::size_t histogram[histogram_buckets] = {};
+
+    void record_allocate(std::size_t bytes) noexcept {
+        ++allocations;
+        bytes_allocated += bytes;
+        live_bytes += bytes;
+        if (live_bytes > peak_bytes) {
+            peak_bytes = live_bytes;
+        }
+        ++histogram[bucket(bytes)];
+    }
+
+    void record_deallocate(std::size_t bytes) noexcept {
+        ++deallocations;
+        live_bytes -= bytes;
+    }
+
+    std::size_t live_allocations() const noexcept {
+        return allocations - deallocations;
+    }
+
+    // 清空统计，live_bytes 保留以便继续跟踪尚未释放的内存
+    void reset() noexcept {
+        std::size_t live = live_bytes;
+        *this = allocation_stats();
+        live_bytes = peak_bytes = live;
+    }
+
+    static std::size_t bucket(std::size_t bytes) noexcept {
+        std::size_t i = 0;
+        while (bytes > 1) {
+            bytes >>= 1;
+            ++i;
+        }
+        return i;
+    }
+};
+
+// 分配器适配器：把分配与释放转交给 Allocator，同时记录到 allocation_stats 中
+// rebind 与复制得到的分配器共享同一份统计，因此容器内部的结点、中控器等分配都计入其中
+template <class Allocator>
+class counting_allocator {
+    using base_traits = std::allocator_traits<Allocator>;
+
+  public:
+    using value_type = typename base_traits::value_type;
+    using pointer = typename base_traits::pointer;
+    using const_pointer = typename base_traits::const_pointer;
+    using size_type = typename base_traits::size_type;
+    using difference_type = typename base_traits::difference_type;
+
+    using propagate_on_container_copy_assignment =
+        typename base_traits::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment =
+        typename base_traits::propagate_on_container_move_assignment;
+    using propagate_on_container_swap = typename base_traits::propagate_on_container_swap;
+    using is_always_equal = std::false_type;
+
+    template <class U>
+    struct rebind {
+        using other = counting_allocator<typename base_traits::template rebind_alloc<U>>;
+    };
+
+    explicit counting_allocator(allocation_stats &stats, const Allocator &alloc = Allocator())
+        : m_alloc(alloc), m_stats(&stats) {
+    }
+
+    template <class Other>
+    counting_allocator(const counting_allocator<Other> &other) noexcept
+        : m_alloc(other.base()), m_stats(&other.stats()) {
+    }
+
+    pointer allocate(size_type n) {
+        pointer p = base_traits::allocate(m_alloc, n);
+        m_stats->record_allocate(n * sizeof(value_type));
+        return p;
+    }
+
+    void deallocate(pointer p, size_type n) noexcept {
+        m_stats->record_deallocate(n * sizeof(value_type));
+        base_traits::deallocate(m_alloc, p, n);
+    }
+
+    template <class U, class... Args>
+    void construct(U *p, Args &&...args) {
+        base_traits::construct(m_alloc, p, std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    void destroy(U *p) {
+        base_traits::destroy(m_alloc, p);
+    }
+
+    size_type max_size() const noexcept {
+        return base_traits::max_size(m_alloc);
+    }
+
+    counting_allocator select_on_container_copy_construction() const {
+        return counting_allocator(*m_stats,
+                                  base_traits::select_on_container_copy_construction(m_alloc));
+    }
+
+    const Allocator &base() const noexcept {
+        return m_alloc;
+    }
+
+    allocation_stats &stats() const noexcept {
+        return *m_stats;
+    }
+
+  private:
+    Allocator m_alloc;
+    allocation_stats *m_stats;
+};
+
+template <class A, class B>
+bool operator==(const counting_allocator<A> &lhs, const counting_allocator<B> &rhs) noexcept {
+    return &lhs.stats() == &rhs.stats() && lhs.base() == rhs.base();
+}
+
+template <class A, class B>
+bool operator!=(const counting_allocator<A> &lhs, const counting_allocator<B> &rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,602 @@
+#ifndef TSTL_SRC_MEMORY_RESOURCE_HPP
+#define TSTL_SRC_MEMORY_RESOURCE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tstl {
+namespace pmr {
+
+// 内存资源的抽象接口，容器通过 polymorphic_allocator 使用它
+// 持有不同资源的容器属于同一类型，可以在运行时按请求切换内存来源而不增加模板实例
+class memory_resource {
+  public:
+    virtual ~memory_resource() = default;
+
+    void *allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+        return do_allocate(bytes, align);
+    }
+
+    void deallocate(void *p, std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+        do_deallocate(p, bytes, align);
+    }
+
+    bool is_equal(const memory_resource &other) const noexcept {
+        return do_is_equal(other);
+    }
+
+  private:
+    virtual void *do_allocate(std::size_t bytes, std::size_t align) = 0;
+    virtual void do_deallocate(void *p, std::size_t bytes, std::size_t align) = 0;
+    virtual bool do_is_equal(const memory_resource &other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource &lhs, const memory_resource &rhs) noexcept {
+    return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+inline bool operator!=(const memory_resource &lhs, const memory_resource &rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+class _new_delete_resource : public memory_resource {
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t(align));
+        }
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void *p, std::size_t, std::size_t align) override {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, std::align_val_t(align));
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+class _null_memory_resource : public memory_resource {
+  private:
+    void *do_allocate(std::size_t, std::size_t) override {
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// 以下资源永不析构，静态对象析构时仍可安全使用
+inline memory_resource *new_delete_resource() noexcept {
+    static memory_resource *resource = new _new_delete_resource;
+    return resource;
+}
+
+// 任何分配都抛出 std::bad_alloc，可作为上游资源确保只使用给定的缓冲区
+inline memory_resource *null_memory_resource() noexcept {
+    static memory_resource *resource = new _null_memory_resource;
+    return resource;
+}
+
+inline std::atomic<memory_resource *> &_default_resource() noexcept {
+    static std::atomic<memory_resource *> resource(new_delete_resource());
+    return resource;
+}
+
+inline memory_resource *get_default_resource() noexcept {
+    return _default_resource().load(std::memory_order_acquire);
+}
+
+// 返回原先的默认资源，r 为空时恢复为 new_delete_resource()
+inline memory_resource *set_default_resource(memory_resource *r) noexcept {
+    if (r == nullptr) {
+        r = new_delete_resource();
+    }
+    return _default_resource().exchange(r, std::memory_order_acq_rel);
+}
+
+inline std::uintptr_t _align_up(std::uintptr_t p, std::size_t align) noexcept {
+    return (p + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+}
+
+// 单调增长的内存资源：分配只移动指针，释放为空操作，release() 时把内存块统一还给上游
+// 可以先使用给定的初始缓冲区，用尽后向上游申请按几何级数增长的内存块；非线程安全
+class monotonic_buffer_resource : public memory_resource {
+  public:
+    monotonic_buffer_resource() : monotonic_buffer_resource(get_default_resource()) {
+    }
+
+    explicit monotonic_buffer_resource(memory_resource *upstream)
+        : monotonic_buffer_resource(initial_size, upstream) {
+    }
+
+    explicit monotonic_buffer_resource(std::size_t initial_block_size,
+                                       memory_resource *upstream = get_default_resource())
+        : m_upstream(upstream), m_blocks(nullptr), m_buffer(nullptr), m_buffer_size(0),
+          m_cur(nullptr), m_end(nullptr),
+          m_initial_size(initial_block_size == 0 ? initial_size : initial_block_size),
+          m_next_size(m_initial_size) {
+    }
+
+    monotonic_buffer_resource(void *buffer, std::size_t size,
+                              memory_resource *upstream = get_default_resource())
+        : m_upstream(upstream), m_blocks(nullptr), m_buffer(static_cast<char *>(buffer)),
+          m_buffer_size(size), m_cur(m_buffer), m_end(m_buffer + size),
+          m_initial_size(size == 0 ? initial_size : grow_size(size)), m_next_size(m_initial_size) {
+    }
+
+    monotonic_buffer_resource(const monotonic_buffer_resource &) = delete;
+    monotonic_buffer_resource &operator=(const monotonic_buffer_resource &) = delete;
+
+    ~monotonic_buffer_resource() override {
+        release();
+    }
+
+    // 把向上游申请的内存块全部归还，回到构造时的状态
+    void release() noexcept {
+        while (m_blocks != nullptr) {
+            block *next = m_blocks->next;
+            m_upstream->deallocate(m_blocks, m_blocks->size, alignof(std::max_align_t));
+            m_blocks = next;
+        }
+        m_cur = m_buffer;
+        m_end = m_buffer + m_buffer_size;
+        m_next_size = m_initial_size;
+    }
+
+    memory_resource *upstream_resource() const noexcept {
+        return m_upstream;
+    }
+
+  private:
+    struct alignas(std::max_align_t) block {
+        block *next;
+        std::size_t size; // 含头部在内的字节数
+    };
+
+    static constexpr std::size_t initial_size = 1024;
+
+    // 块大小翻倍，翻倍会溢出时保持不变
+    static std::size_t grow_size(std::size_t size) noexcept {
+        return size > std::size_t(-1) / 2 ? size : size * 2;
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+        std::uintptr_t p = _align_up(reinterpret_cast<std::uintptr_t>(m_cur), align);
+        std::uintptr_t end = reinterpret_cast<std::uintptr_t>(m_end);
+        if (m_cur == nullptr || p > end || bytes > end - p) {
+            if (bytes > std::size_t(-1) - sizeof(block) - align) {
+                throw std::bad_alloc();
+            }
+            const std::size_t need = sizeof(block) + bytes + align;
+            std::size_t size = m_next_size;
+            while (size < need) {
+                if (size > std::size_t(-1) / 2) {
+                    throw std::bad_alloc();
+                }
+                size *= 2;
+            }
+            block *b = static_cast<block *>(m_upstream->allocate(size, alignof(std::max_align_t)));
+            b->next = m_blocks;
+            b->size = size;
+            m_blocks = b;
+            m_cur = reinterpret_cast<char *>(b + 1);
+            m_end = reinterpret_cast<char *>(b) + size;
+            m_next_size = grow_size(size);
+            p = _align_up(reinterpret_cast<std::uintptr_t>(m_cur), align);
+        }
+        m_cur = reinterpret_cast<char *>(p + bytes);
+        return reinterpret_cast<void *>(p);
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    memory_resource *m_upstream;
+    block *m_blocks;          // 向上游申请的内存块，新块在前
+    char *m_buffer;           // 构造时给定的初始缓冲区
+    std::size_t m_buffer_size;
+    char *m_cur;              // 当前块中下一次分配的起点
+    char *m_end;              // 当前块的末尾
+    std::size_t m_initial_size;
+    std::size_t m_next_size;  // 下一个内存块的大小
+};
+
+struct pool_options {
+    // 每次为一个池向上游申请的最多块数，0 表示使用默认值
+    std::size_t max_blocks_per_chunk = 0;
+    // 由池管理的最大块大小，更大的请求直接交给上游，0 表示使用默认值
+    std::size_t largest_required_pool_block = 0;
+};
+
+// 按 2 的幂分级的池化内存资源，每级维护一条空闲链表，块从向上游申请的大块（chunk）中切出
+// 释放的块回到所在级别的空闲链表，release() 或析构时才把内存归还上游；非线程安全
+class unsynchronized_pool_resource : public memory_resource {
+  public:
+    unsynchronized_pool_resource()
+        : unsynchronized_pool_resource(pool_options(), get_default_resource()) {
+    }
+
+    explicit unsynchronized_pool_resource(memory_resource *upstream)
+        : unsynchronized_pool_resource(pool_options(), upstream) {
+    }
+
+    explicit unsynchronized_pool_resource(const pool_options &opts)
+        : unsynchronized_pool_resource(opts, get_default_resource()) {
+    }
+
+    unsynchronized_pool_resource(const pool_options &opts, memory_resource *upstream)
+        : m_upstream(upstream), m_options(normalize(opts)), m_pool_count(0), m_oversized(nullptr) {
+        for (std::size_t size = min_block; size <= m_options.largest_required_pool_block;
+             size *= 2) {
+            ++m_pool_count;
+        }
+    }
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource &) = delete;
+    unsynchronized_pool_resource &operator=(const unsynchronized_pool_resource &) = delete;
+
+    ~unsynchronized_pool_resource() override {
+        release();
+    }
+
+    // 把全部内存归还上游，包括尚未释放的块
+    void release() noexcept {
+        for (std::size_t i = 0; i < m_pool_count; ++i) {
+            pool &pl = m_pools[i];
+            while (pl.chunks != nullptr) {
+                chunk *next = pl.chunks->next;
+                m_upstream->deallocate(pl.chunks, pl.chunks->size, alignof(std::max_align_t));
+                pl.chunks = next;
+            }
+            pl.free = nullptr;
+            pl.next_blocks = 0;
+        }
+        while (m_oversized != nullptr) {
+            oversized *next = m_oversized->next;
+            m_upstream->deallocate(m_oversized->base, m_oversized->size, m_oversized->align);
+            m_oversized = next;
+        }
+    }
+
+    memory_resource *upstream_resource() const noexcept {
+        return m_upstream;
+    }
+
+    pool_options options() const noexcept {
+        return m_options;
+    }
+
+  private:
+    struct free_block {
+        free_block *next;
+    };
+
+    struct alignas(std::max_align_t) chunk {
+        chunk *next;
+        std::size_t size; // 含头部在内的字节数
+    };
+
+    struct pool {
+        free_block *free = nullptr;
+        chunk *chunks = nullptr;
+        std::size_t next_blocks = 0; // 下一个 chunk 的块数
+    };
+
+    // 直接向上游申请的大块内存，头部放在返回给用户的地址之前，串成双向链表以便 O(1) 摘除
+    struct oversized {
+        oversized *prev;
+        oversized *next;
+        void *base;
+        std::size_t size;
+        std::size_t align;
+    };
+
+    static constexpr std::size_t min_block = 8;
+    static constexpr std::size_t max_pools = 8 * sizeof(std::size_t);
+    static constexpr std::size_t default_largest_block = 4096;
+    static constexpr std::size_t default_max_blocks = 256;
+    static constexpr std::size_t initial_blocks = 16;
+    // 池化块大小的上限，更大的选项被截断，使块大小的翻倍不会溢出
+    static constexpr std::size_t max_largest_block = std::size_t(1) << 30;
+
+    static pool_options normalize(pool_options opts) noexcept {
+        if (opts.max_blocks_per_chunk == 0) {
+            opts.max_blocks_per_chunk = default_max_blocks;
+        }
+        if (opts.largest_required_pool_block == 0) {
+            opts.largest_required_pool_block = default_largest_block;
+        }
+        if (opts.largest_required_pool_block > max_largest_block) {
+            opts.largest_required_pool_block = max_largest_block;
+        }
+        std::size_t largest = min_block;
+        while (largest < opts.largest_required_pool_block) {
+            largest *= 2;
+        }
+        opts.largest_required_pool_block = largest;
+        return opts;
+    }
+
+    // 块大小取 max(bytes, align) 向上取整到 2 的幂，块在 chunk 中按自身大小对齐
+    std::size_t pool_index(std::size_t bytes, std::size_t align) const noexcept {
+        std::size_t need = bytes > align ? bytes : align;
+        if (need > m_options.largest_required_pool_block ||
+            align > alignof(std::max_align_t)) {
+            return m_pool_count;
+        }
+        std::size_t i = 0;
+        for (std::size_t size = min_block; size < need; size *= 2) {
+            ++i;
+        }
+        return i;
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+        std::size_t i = pool_index(bytes, align);
+        if (i == m_pool_count) {
+            return allocate_oversized(bytes, align);
+        }
+        pool &pl = m_pools[i];
+        if (pl.free == nullptr) {
+            refill(pl, min_block << i);
+        }
+        free_block *b = pl.free;
+        pl.free = b->next;
+        return b;
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+        std::size_t i = pool_index(bytes, align);
+        if (i == m_pool_count) {
+            deallocate_oversized(p);
+            return;
+        }
+        free_block *b = static_cast<free_block *>(p);
+        b->next = m_pools[i].free;
+        m_pools[i].free = b;
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    // 申请一个 chunk 并切分为块挂入空闲链表，每次的块数翻倍直到 max_blocks_per_chunk
+    void refill(pool &pl, std::size_t block_size) {
+        std::size_t blocks = pl.next_blocks == 0 ? initial_blocks : pl.next_blocks;
+        if (blocks > m_options.max_blocks_per_chunk) {
+            blocks = m_options.max_blocks_per_chunk;
+        }
+        // 块数过大时截断，使 chunk 的字节数不溢出
+        if (blocks > (std::size_t(-1) - sizeof(chunk)) / block_size) {
+            blocks = (std::size_t(-1) - sizeof(chunk)) / block_size;
+        }
+        std::size_t size = sizeof(chunk) + blocks * block_size;
+        chunk *c = static_cast<chunk *>(m_upstream->allocate(size, alignof(std::max_align_t)));
+        c->next = pl.chunks;
+        c->size = size;
+        pl.chunks = c;
+        char *first = reinterpret_cast<char *>(c + 1);
+        for (std::size_t k = blocks; k != 0; --k) {
+            free_block *b = reinterpret_cast<free_block *>(first + (k - 1) * block_size);
+            b->next = pl.free;
+            pl.free = b;
+        }
+        pl.next_blocks = blocks * 2;
+    }
+
+    static std::size_t header_size(std::size_t align) noexcept {
+        return _align_up(sizeof(oversized), align);
+    }
+
+    void *allocate_oversized(std::size_t bytes, std::size_t align) {
+        if (align < alignof(oversized)) {
+            align = alignof(oversized);
+        }
+        if (bytes > std::size_t(-1) - header_size(align)) {
+            throw std::bad_alloc();
+        }
+        std::size_t size = header_size(align) + bytes;
+        void *base = m_upstream->allocate(size, align);
+        char *p = static_cast<char *>(base) + header_size(align);
+        oversized *h = reinterpret_cast<oversized *>(p) - 1;
+        h->base = base;
+        h->size = size;
+        h->align = align;
+        h->prev = nullptr;
+        h->next = m_oversized;
+        if (m_oversized != nullptr) {
+            m_oversized->prev = h;
+        }
+        m_oversized = h;
+        return p;
+    }
+
+    void deallocate_oversized(void *p) {
+        oversized *h = static_cast<oversized *>(p) - 1;
+        if (h->prev != nullptr) {
+            h->prev->next = h->next;
+        } else {
+            m_oversized = h->next;
+        }
+        if (h->next != nullptr) {
+            h->next->prev = h->prev;
+        }
+        m_upstream->deallocate(h->base, h->size, h->align);
+    }
+
+    memory_resource *m_upstream;
+    pool_options m_options;
+    std::size_t m_pool_count;
+    pool m_pools[max_pools];
+    oversized *m_oversized;
+};
+
+template <class T>
+struct _is_pair : std::false_type {};
+template <class T1, class T2>
+struct _is_pair<std::pair<T1, T2>> : std::true_type {};
+
+// 通过 memory_resource 分配内存的分配器，复制容器时不传播资源
+// construct 按 uses-allocator 约定把自身传给元素，嵌套的 pmr 容器因此使用同一个资源
+template <class T>
+class polymorphic_allocator {
+  public:
+    using value_type = T;
+
+    polymorphic_allocator() noexcept : m_resource(get_default_resource()) {
+    }
+
+    polymorphic_allocator(memory_resource *r) noexcept : m_resource(r) {
+    }
+
+    polymorphic_allocator(const polymorphic_allocator &other) = default;
+
+    template <class U>
+    polymorphic_allocator(const polymorphic_allocator<U> &other) noexcept
+        : m_resource(other.resource()) {
+    }
+
+    polymorphic_allocator &operator=(const polymorphic_allocator &) = delete;
+
+    T *allocate(std::size_t n) {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) {
+        m_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <class U, class... Args,
+              typename = typename std::enable_if<!_is_pair<U>::value>::type>
+    void construct(U *p, Args &&...args) {
+        construct_dispatch(p, uses_alloc_kind<U, Args...>(), std::forward<Args>(args)...);
+    }
+
+    // std::pair 的两个成员分别按 uses-allocator 约定构造
+    template <class T1, class T2, class... Args1, class... Args2>
+    void construct(std::pair<T1, T2> *p, std::piecewise_construct_t, std::tuple<Args1...> x,
+                   std::tuple<Args2...> y) {
+        ::new (static_cast<void *>(p))
+            std::pair<T1, T2>(std::piecewise_construct,
+                              alloc_args(uses_alloc_kind<T1, Args1...>(), std::move(x)),
+                              alloc_args(uses_alloc_kind<T2, Args2...>(), std::move(y)));
+    }
+
+    template <class T1, class T2>
+    void construct(std::pair<T1, T2> *p) {
+        construct(p, std::piecewise_construct, std::tuple<>(), std::tuple<>());
+    }
+
+    template <class T1, class T2, class U, class V>
+    void construct(std::pair<T1, T2> *p, U &&x, V &&y) {
+        construct(p, std::piecewise_construct, std::forward_as_tuple(std::forward<U>(x)),
+                  std::forward_as_tuple(std::forward<V>(y)));
+    }
+
+    template <class T1, class T2, class U, class V>
+    void construct(std::pair<T1, T2> *p, const std::pair<U, V> &pr) {
+        construct(p, std::piecewise_construct, std::forward_as_tuple(pr.first),
+                  std::forward_as_tuple(pr.second));
+    }
+
+    template <class T1, class T2, class U, class V>
+    void construct(std::pair<T1, T2> *p, std::pair<U, V> &&pr) {
+        construct(p, std::piecewise_construct, std::forward_as_tuple(std::forward<U>(pr.first)),
+                  std::forward_as_tuple(std::forward<V>(pr.second)));
+    }
+
+    template <class U>
+    void destroy(U *p) {
+        p->~U();
+    }
+
+    // 复制容器时使用默认资源，与 std::pmr 一致
+    polymorphic_allocator select_on_container_copy_construction() const {
+        return polymorphic_allocator();
+    }
+
+    memory_resource *resource() const noexcept {
+        return m_resource;
+    }
+
+  private:
+    // 0：不使用分配器；1：以 (allocator_arg, alloc, args...) 构造；2：以 (args..., alloc) 构造
+    template <class U, class... Args>
+    using uses_alloc_kind = std::integral_constant<
+        int, !std::uses_allocator<U, polymorphic_allocator>::value ? 0
+             : std::is_constructible<U, std::allocator_arg_t, const polymorphic_allocator &,
+                                     Args...>::value
+                 ? 1
+                 : 2>;
+
+    template <class U, class... Args>
+    void construct_dispatch(U *p, std::integral_constant<int, 0>, Args &&...args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+    template <class U, class... Args>
+    void construct_dispatch(U *p, std::integral_constant<int, 1>, Args &&...args) {
+        ::new (static_cast<void *>(p)) U(std::allocator_arg, *this, std::forward<Args>(args)...);
+    }
+    template <class U, class... Args>
+    void construct_dispatch(U *p, std::integral_constant<int, 2>, Args &&...args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)..., *this);
+    }
+
+    template <class... Args>
+    std::tuple<Args...> alloc_args(std::integral_constant<int, 0>, std::tuple<Args...> t) {
+        return t;
+    }
+    template <class... Args>
+    std::tuple<std::allocator_arg_t, const polymorphic_allocator &, Args...>
+    alloc_args(std::integral_constant<int, 1>, std::tuple<Args...> t) {
+        return std::tuple_cat(
+            std::tuple<std::allocator_arg_t, const polymorphic_allocator &>(std::allocator_arg,
+                                                                            *this),
+            std::move(t));
+    }
+    template <class... Args>
+    std::tuple<Args..., const polymorphic_allocator &>
+    alloc_args(std::integral_constant<int, 2>, std::tuple<Args...> t) {
+        return std::tuple_cat(std::move(t), std::tuple<const polymorphic_allocator &>(*this));
+    }
+
+    memory_resource *m_resource;
+};
+
+template <class T, class U>
+bool operator==(const polymorphic_allocator<T> &lhs, const polymorphic_allocator<U> &rhs) noexcept {
+    return *lhs.resource() == *rhs.resource();
+}
+
+template <class T, class U>
+bool operator!=(const polymorphic_allocator<T> &lhs, const polymorphic_allocator<U> &rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace pmr
+} // namespace tstl
+
+#endif
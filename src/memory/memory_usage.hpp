@@ -0,0 +1,23 @@
+#ifndef TSTL_SRC_MEMORY_USAGE_HPP
+#define TSTL_SRC_MEMORY_USAGE_HPP
+
+#include <cstddef>
+
+namespace tstl {
+
+// 容器占用内存的统计，由各容器的 memory_usage() 返回
+// 按向分配器请求的字节数计算，不含分配器自身的取整与簿记开销
+struct container_memory {
+    // 元素本身占用的字节数，即 size() * sizeof(value_type)
+    std::size_t payload = 0;
+    // 其余字节数：容器对象本身（含内嵌的树头结点）、未使用的容量、结点中的指针、deque 的中控器等
+    std::size_t overhead = 0;
+
+    std::size_t total() const noexcept {
+        return payload + overhead;
+    }
+};
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef TSTL_SRC_MMAP_ALLOCATOR_HPP
+#define TSTL_SRC_MMAP_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// 不小于该字节数的请求使用 mmap，更小的请求仍交给 operator new
+#ifndef TSTL_MMAP_THRESHOLD
+#define TSTL_MMAP_THRESHOLD (std::size_t(2) << 20)
+#endif
+
+// 透明大页的大小，映射的起始地址按它对齐
+#ifndef TSTL_HUGE_PAGE_SIZE
+#define TSTL_HUGE_PAGE_SIZE (std::size_t(2) << 20)
+#endif
+
+namespace tstl {
+
+// 匿名内存映射的分配、释放与调整，长度按页取整
+struct _mmap_region {
+    static std::size_t page_size() noexcept {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static std::size_t length(std::size_t bytes) noexcept {
+        const std::size_t page = page_size();
+        return (bytes + page - 1) / page * page;
+    }
+
+    // 多映射一个大页的长度再裁掉首尾，使起始地址按大页对齐，整段都能由大页承载
+    static void *map(std::size_t bytes, bool populate) {
+        const std::size_t huge = TSTL_HUGE_PAGE_SIZE;
+        const std::size_t len = length(bytes);
+        const std::size_t over = len + huge;
+        void *raw = ::mmap(nullptr, over, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                           -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        char *first = static_cast<char *>(raw);
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw);
+        char *p = first + (huge - addr % huge) % huge;
+        if (p != first) {
+            ::munmap(first, static_cast<std::size_t>(p - first));
+        }
+        if (p + len != first + over) {
+            ::munmap(p + len, static_cast<std::size_t>(first + over - (p + len)));
+        }
+        advise(p, len);
+        if (populate) {
+            prefault(p, len);
+        }
+        return p;
+    }
+
+    static void unmap(void *p, std::size_t bytes) noexcept {
+        ::munmap(p, length(bytes));
+    }
+
+    // mremap 只移动页表，不复制数据；原地放不下时由内核换到新的地址
+    static void *remap(void *p, std::size_t old_bytes, std::size_t new_bytes, bool populate) {
+        const std::size_t old_len = length(old_bytes);
+        const std::size_t new_len = length(new_bytes);
+        if (old_len == new_len) {
+            return p;
+        }
+        void *q = ::mremap(p, old_len, new_len, MREMAP_MAYMOVE);
+        if (q == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (new_len > old_len) {
+            advise(q, new_len);
+            if (populate) {
+                prefault(static_cast<char *>(q) + old_len, new_len - old_len);
+            }
+        }
+        return q;
+    }
+
+    // 建议内核使用透明大页，失败（如内核未开启）时忽略
+    static void advise(void *p, std::size_t len) noexcept {
+#ifdef MADV_HUGEPAGE
+        ::madvise(p, len, MADV_HUGEPAGE);
+#else
+        (void)p;
+        (void)len;
+#endif
+    }
+
+    // 提前建立页表，避免首次访问时集中触发缺页
+    static void prefault(void *p, std::size_t len) noexcept {
+#ifdef MADV_POPULATE_WRITE
+        if (::madvise(p, len, MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        volatile char *c = static_cast<volatile char *>(p);
+        for (std::size_t off = 0; off < len; off += page_size()) {
+            c[off] = 0;
+        }
+    }
+};
+
+// 为大块缓冲区设计的分配器：不小于 TSTL_MMAP_THRESHOLD 的请求直接使用匿名映射，
+// 起始地址按大页对齐并以 MADV_HUGEPAGE 建议内核使用透明大页，以减少 TLB 缺失；
+// Populate 为 true 时在分配时就建立全部页表
+// reallocate() 供 vector 扩容可平凡复制的元素时使用，两端都是映射时借助 mremap 调整而不复制数据
+template <class T, bool Populate = false>
+class mmap_allocator {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template <class U>
+    struct rebind {
+        using other = mmap_allocator<U, Populate>;
+    };
+
+    mmap_allocator() noexcept = default;
+
+    template <class U>
+    mmap_allocator(const mmap_allocator<U, Populate> &) noexcept {
+    }
+
+    T *allocate(size_type n) {
+        const std::size_t bytes = checked_bytes(n);
+        if (bytes >= TSTL_MMAP_THRESHOLD) {
+            return static_cast<T *>(_mmap_region::map(bytes, Populate));
+        }
+        return static_cast<T *>(::operator new(bytes));
+    }
+
+    void deallocate(T *p, size_type n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (bytes >= TSTL_MMAP_THRESHOLD) {
+            _mmap_region::unmap(p, bytes);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    // 把 [p, p + old_n) 的存储调整为 new_n 个元素，保留前 min(old_n, new_n) 个元素的字节
+    // 只适用于可平凡复制的元素；失败时抛出 std::bad_alloc，原存储保持不变
+    T *reallocate(T *p, size_type old_n, size_type new_n) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "mmap_allocator::reallocate requires trivially copyable elements");
+        if (p == nullptr) {
+            return allocate(new_n);
+        }
+        const std::size_t old_bytes = old_n * sizeof(T);
+        const std::size_t new_bytes = checked_bytes(new_n);
+        if (old_bytes >= TSTL_MMAP_THRESHOLD && new_bytes >= TSTL_MMAP_THRESHOLD) {
+            return static_cast<T *>(_mmap_region::remap(p, old_bytes, new_bytes, Populate));
+        }
+        T *q = allocate(new_n);
+        std::memcpy(static_cast<void *>(q), p, old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(p, old_n);
+        return q;
+    }
+
+  private:
+    static std::size_t checked_bytes(size_type n) {
+        if (n > static_cast<size_type>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return n * sizeof(T);
+    }
+};
+
+template <class T, class U, bool Populate>
+bool operator==(const mmap_allocator<T, Populate> &,
+                const mmap_allocator<U, Populate> &) noexcept {
+    return true;
+}
+
+template <class T, class U, bool Populate>
+bool operator!=(const mmap_allocator<T, Populate> &,
+                const mmap_allocator<U, Populate> &) noexcept {
+    return false;
+}
+
+} // namespace tstl
+
+#endif
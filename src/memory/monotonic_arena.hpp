@@ -0,0 +1,208 @@
+#ifndef TSTL_SRC_MONOTONIC_ARENA_HPP
+#define TSTL_SRC_MONOTONIC_ARENA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#ifndef TSTL_ARENA_INITIAL_BLOCK_SIZE
+#define TSTL_ARENA_INITIAL_BLOCK_SIZE 4096
+#endif
+
+#ifndef TSTL_ARENA_MAX_BLOCK_SIZE
+#define TSTL_ARENA_MAX_BLOCK_SIZE (std::size_t(1) << 26)
+#endif
+
+namespace tstl {
+
+// 单调增长的内存区域：分配只移动指针，释放为空操作，reset() 以 O(1) 回收全部内存
+// 内存块按几何级数增长并串成链表，reset() 后保留全部内存块供下一轮复用
+// 适合按请求构建、整体丢弃的临时容器；非线程安全，不可复制
+class monotonic_arena {
+  public:
+    explicit monotonic_arena(std::size_t initial_block_size = TSTL_ARENA_INITIAL_BLOCK_SIZE)
+        : m_head(nullptr), m_block(nullptr), m_cur(nullptr), m_end(nullptr),
+          m_next_block_size(initial_block_size < min_block_size ? min_block_size
+                                                                : initial_block_size) {
+    }
+
+    monotonic_arena(const monotonic_arena &) = delete;
+    monotonic_arena &operator=(const monotonic_arena &) = delete;
+
+    ~monotonic_arena() {
+        release();
+    }
+
+    // 分配 bytes 字节，按 align 对齐，align 须为 2 的幂
+    void *allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+        assert(align != 0 && (align & (align - 1)) == 0);
+        std::uintptr_t p = align_up(reinterpret_cast<std::uintptr_t>(m_cur), align);
+        std::uintptr_t end = reinterpret_cast<std::uintptr_t>(m_end);
+        if (m_cur != nullptr && p <= end && bytes <= end - p) {
+            m_cur = reinterpret_cast<char *>(p + bytes);
+            return reinterpret_cast<void *>(p);
+        }
+        return allocate_slow(bytes, align);
+    }
+
+    // 单个对象的内存随 reset() 或 release() 统一回收
+    void deallocate(void *, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {
+    }
+
+    // 回到第一个内存块的起点，保留全部内存块，O(1)
+    // 调用前须保证没有对象仍在使用 arena 中的内存
+    void reset() noexcept {
+        m_block = m_head;
+        if (m_head != nullptr) {
+            m_cur = m_head->data();
+            m_end = m_head->data() + m_head->size;
+        }
+    }
+
+    // 把全部内存块还给系统
+    void release() noexcept {
+        block *b = m_head;
+        while (b != nullptr) {
+            block *next = b->next;
+            ::operator delete(static_cast<void *>(b));
+            b = next;
+        }
+        m_head = m_block = nullptr;
+        m_cur = m_end = nullptr;
+    }
+
+    // 全部内存块的可用字节数
+    std::size_t capacity() const noexcept {
+        std::size_t total = 0;
+        for (block *b = m_head; b != nullptr; b = b->next) {
+            total += b->size;
+        }
+        return total;
+    }
+
+  private:
+    // 内存块头部，紧随其后的是可分配的区域
+    struct alignas(std::max_align_t) block {
+        block *next;
+        std::size_t size;
+
+        char *data() noexcept {
+            return reinterpret_cast<char *>(this + 1);
+        }
+    };
+
+    static constexpr std::size_t min_block_size = 256;
+
+    static std::uintptr_t align_up(std::uintptr_t p, std::size_t align) noexcept {
+        return (p + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+    }
+
+    // 当前块放不下时，先复用 reset() 前留下的后续块，都放不下再申请新块插在当前块之后
+    void *allocate_slow(std::size_t bytes, std::size_t align) {
+        block *b = m_block == nullptr ? m_head : m_block->next;
+        while (b != nullptr && !fits(b, bytes, align)) {
+            b = b->next;
+        }
+        if (b == nullptr) {
+            b = new_block(bytes + align);
+        }
+        m_block = b;
+        m_cur = b->data();
+        m_end = b->data() + b->size;
+        return allocate(bytes, align);
+    }
+
+    static bool fits(block *b, std::size_t bytes, std::size_t align) noexcept {
+        std::uintptr_t first = reinterpret_cast<std::uintptr_t>(b->data());
+        return align_up(first, align) - first + bytes <= b->size;
+    }
+
+    block *new_block(std::size_t min_size) {
+        std::size_t size = m_next_block_size;
+        while (size < min_size) {
+            size *= 2;
+        }
+        block *b = static_cast<block *>(::operator new(sizeof(block) + size));
+        b->size = size;
+        if (m_block == nullptr) {
+            b->next = m_head;
+            m_head = b;
+        } else {
+            b->next = m_block->next;
+            m_block->next = b;
+        }
+        if (m_next_block_size < TSTL_ARENA_MAX_BLOCK_SIZE) {
+            m_next_block_size *= 2;
+        }
+        return b;
+    }
+
+    block *m_head;  // 第一个内存块
+    block *m_block; // 正在分配的内存块
+    char *m_cur;    // 当前块中下一次分配的起点
+    char *m_end;    // 当前块的末尾
+    std::size_t m_next_block_size;
+};
+
+// 从 monotonic_arena 中分配内存的分配器，deallocate 为空操作
+// 分配器只持有 arena 的指针，复制开销与指针相同，容器间随元素一起传播
+template <class T>
+class arena_allocator {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+    // 容器据此在元素无需析构时跳过清空时的遍历
+    using trivially_deallocate = std::true_type;
+
+    template <class U>
+    struct rebind {
+        using other = arena_allocator<U>;
+    };
+
+    explicit arena_allocator(monotonic_arena &arena) noexcept : m_arena(&arena) {
+    }
+
+    template <class U>
+    arena_allocator(const arena_allocator<U> &other) noexcept : m_arena(other.arena()) {
+    }
+
+    T *allocate(size_type n) {
+        if (n > static_cast<size_type>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_type) noexcept {
+    }
+
+    monotonic_arena *arena() const noexcept {
+        return m_arena;
+    }
+
+  private:
+    monotonic_arena *m_arena;
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T> &lhs, const arena_allocator<U> &rhs) noexcept {
+    return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+bool operator!=(const arena_allocator<T> &lhs, const arena_allocator<U> &rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+} // namespace tstl
+
+#endif
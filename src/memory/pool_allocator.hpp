@@ -0,0 +1,273 @@
+#ifndef TSTL_SRC_POOL_ALLOCATOR_HPP
+#define TSTL_SRC_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+// 由内存池分配的最大字节数，更大的请求直接交给 operator new
+#ifndef TSTL_POOL_MAX_BYTES
+#define TSTL_POOL_MAX_BYTES 512
+#endif
+
+// 全局内存池每次向系统申请的大块内存的字节数
+#ifndef TSTL_POOL_SLAB_SIZE
+#define TSTL_POOL_SLAB_SIZE (64 * 1024)
+#endif
+
+// 线程缓存每次从全局内存池批量取出的对象个数
+#ifndef TSTL_POOL_BATCH
+#define TSTL_POOL_BATCH 32
+#endif
+
+namespace tstl {
+
+// 按大小分级的内存池，参考 SGI __pool_alloc：请求按 8 字节取整后落入对应的级别，
+// 每个级别维护一条空闲链表，对象从大块内存（slab）中切出，释放后只回到空闲链表，不还给系统
+// 每个线程有自己的缓存，分配与释放通常无需加锁；缓存为空时从全局内存池批量补充，
+// 缓存过多时批量归还。对象可以在一个线程分配、在另一个线程释放
+// 线程缓存析构之后（如其他 thread_local 对象的析构函数中）的分配与释放直接经过全局内存池
+// 不同级别的对象从同一个 slab 中依次切出，只保证 8 字节对齐
+class pool_alloc {
+  public:
+    static constexpr std::size_t align = 8;
+    static constexpr std::size_t max_bytes = TSTL_POOL_MAX_BYTES;
+    static constexpr std::size_t class_count = max_bytes / align;
+
+    static_assert(max_bytes % align == 0, "TSTL_POOL_MAX_BYTES must be a multiple of 8");
+
+    // bytes 须在 (0, max_bytes] 之间
+    static void *allocate(std::size_t bytes) {
+        std::size_t cls = class_index(bytes);
+        thread_cache *cache = local_cache();
+        if (cache == nullptr) {
+            free_node *p;
+            central().take(cls, 1, p);
+            return p;
+        }
+        free_node *p = cache->head[cls];
+        if (p == nullptr) {
+            p = cache->refill(cls);
+        }
+        cache->head[cls] = p->next;
+        --cache->count[cls];
+        return p;
+    }
+
+    static void deallocate(void *p, std::size_t bytes) noexcept {
+        std::size_t cls = class_index(bytes);
+        free_node *node = static_cast<free_node *>(p);
+        thread_cache *cache = local_cache();
+        if (cache == nullptr) {
+            central().give(cls, node, node);
+            return;
+        }
+        node->next = cache->head[cls];
+        cache->head[cls] = node;
+        if (++cache->count[cls] >= 2 * TSTL_POOL_BATCH) {
+            cache->flush(cls, TSTL_POOL_BATCH);
+        }
+    }
+
+  private:
+    struct free_node {
+        free_node *next;
+    };
+
+    static std::size_t class_index(std::size_t bytes) noexcept {
+        return (bytes - 1) / align;
+    }
+    static std::size_t class_size(std::size_t cls) noexcept {
+        return (cls + 1) * align;
+    }
+
+    // 全局内存池，所有线程共享，由互斥锁保护
+    struct central_pool {
+        std::mutex lock;
+        free_node *head[class_count] = {};
+        free_node *slabs = nullptr; // 全部 slab 串成的链表，首个字存放前一个 slab
+        char *slab_cur = nullptr;   // 当前 slab 中尚未切分的部分
+        char *slab_end = nullptr;
+
+        // 取出至多 n 个对象串成链表，返回实际个数；空闲链表不够时从 slab 中切分
+        std::size_t take(std::size_t cls, std::size_t n, free_node *&first) {
+            std::lock_guard<std::mutex> guard(lock);
+            std::size_t got = 0;
+            free_node *list = nullptr;
+            while (got < n && head[cls] != nullptr) {
+                free_node *p = head[cls];
+                head[cls] = p->next;
+                p->next = list;
+                list = p;
+                ++got;
+            }
+            const std::size_t size = class_size(cls);
+            while (got < n) {
+                if (static_cast<std::size_t>(slab_end - slab_cur) < size) {
+                    try {
+                        new_slab();
+                    } catch (...) {
+                        // 已取出的对象放回空闲链表
+                        while (list != nullptr) {
+                            free_node *next = list->next;
+                            list->next = head[cls];
+                            head[cls] = list;
+                            list = next;
+                        }
+                        throw;
+                    }
+                }
+                free_node *p = reinterpret_cast<free_node *>(slab_cur);
+                slab_cur += size;
+                p->next = list;
+                list = p;
+                ++got;
+            }
+            first = list;
+            return got;
+        }
+
+        void give(std::size_t cls, free_node *first, free_node *last) noexcept {
+            std::lock_guard<std::mutex> guard(lock);
+            last->next = head[cls];
+            head[cls] = first;
+        }
+
+        // slab 的剩余部分按能容纳的最大级别挂入空闲链表，再申请新的 slab
+        void new_slab() {
+            std::size_t rest = static_cast<std::size_t>(slab_end - slab_cur);
+            if (rest >= align) {
+                std::size_t cls = class_index(rest - rest % align);
+                free_node *p = reinterpret_cast<free_node *>(slab_cur);
+                p->next = head[cls];
+                head[cls] = p;
+            }
+            slab_cur = slab_end; // 申请失败时剩余部分不会被再次挂入
+            // slab 不会归还，由全局内存池一直持有
+            char *slab = static_cast<char *>(::operator new(TSTL_POOL_SLAB_SIZE));
+            free_node *header = reinterpret_cast<free_node *>(slab);
+            header->next = slabs;
+            slabs = header;
+            slab_cur = slab + align;
+            slab_end = slab + TSTL_POOL_SLAB_SIZE;
+        }
+    };
+
+    // 全局内存池永不析构，线程退出时归还的缓存总有去处
+    static central_pool &central() {
+        static central_pool *pool = new central_pool;
+        return *pool;
+    }
+
+    struct thread_cache {
+        free_node *head[class_count] = {};
+        std::size_t count[class_count] = {};
+
+        ~thread_cache() {
+            cache_destroyed() = true;
+            for (std::size_t cls = 0; cls < class_count; ++cls) {
+                flush(cls, count[cls]);
+            }
+        }
+
+        free_node *refill(std::size_t cls) {
+            count[cls] += central().take(cls, TSTL_POOL_BATCH, head[cls]);
+            return head[cls];
+        }
+
+        // 把链表头部的 n 个对象还给全局内存池
+        void flush(std::size_t cls, std::size_t n) noexcept {
+            if (n == 0) {
+                return;
+            }
+            free_node *first = head[cls];
+            free_node *last = first;
+            for (std::size_t i = 1; i < n; ++i) {
+                last = last->next;
+            }
+            head[cls] = last->next;
+            count[cls] -= n;
+            central().give(cls, first, last);
+        }
+    };
+
+    // 标记本线程的缓存已析构；bool 无需析构，缓存析构之后仍可读取
+    static bool &cache_destroyed() noexcept {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    // 本线程的缓存，已析构时返回 nullptr
+    static thread_cache *local_cache() {
+        if (cache_destroyed()) {
+            return nullptr;
+        }
+        static thread_local thread_cache cache;
+        return &cache;
+    }
+};
+
+// 从 pool_alloc 中分配内存的无状态分配器，适合 list、rb_tree 等逐个分配固定大小结点的容器
+// 超过 TSTL_POOL_MAX_BYTES 或对齐要求高于 8 字节的请求直接使用 operator new
+template <class T>
+class pool_allocator {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template <class U>
+    struct rebind {
+        using other = pool_allocator<U>;
+    };
+
+    pool_allocator() noexcept = default;
+
+    template <class U>
+    pool_allocator(const pool_allocator<U> &) noexcept {
+    }
+
+    T *allocate(size_type n) {
+        if (n > static_cast<size_type>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        const std::size_t bytes = n * sizeof(T);
+        if (use_pool(bytes)) {
+            return static_cast<T *>(pool_alloc::allocate(bytes));
+        }
+        return static_cast<T *>(::operator new(bytes));
+    }
+
+    void deallocate(T *p, size_type n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (use_pool(bytes)) {
+            pool_alloc::deallocate(p, bytes);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+  private:
+    static bool use_pool(std::size_t bytes) noexcept {
+        return bytes != 0 && bytes <= pool_alloc::max_bytes && alignof(T) <= pool_alloc::align;
+    }
+};
+
+template <class T, class U>
+bool operator==(const pool_allocator<T> &, const pool_allocator<U> &) noexcept {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const pool_allocator<T> &, const pool_allocator<U> &) noexcept {
+    return false;
+}
+
+} // namespace tstl
+
+#endif
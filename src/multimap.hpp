@@ -3,10 +3,14 @@
 
 // #include "rb_tree/rbTree.hpp"
 #include "rbtree.hpp"
+#include "memory/memory_resource.hpp"
 
 namespace tstl {
 
-template <class Key, class T, class Compare = std::less<Key>>
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T>>>
 class multimap {
   public:
     using key_type = Key;
@@ -16,7 +20,7 @@ class multimap {
 
     // 定义一个仿函数
     class value_compare : public std::binary_function<value_type, value_type, bool> {
-        friend class multimap<Key, T, Compare>;
+        friend class multimap<Key, T, Compare, Allocator>;
 
       private:
         Compare comp;
@@ -30,12 +34,12 @@ class multimap {
     };
 
   private:
-    using base_type = tstl::rb_tree<value_type, key_compare>;
+    using base_type = tstl::rb_tree<value_type, key_compare, Allocator>;
     base_type m_tree;
 
   public:
     // 红黑树的一些基本定义
-    using node_type = typename base_type::node_type;
+    using node_type = typename base_type::node_handle;
     using pointer = typename base_type::pointer;
     using const_pointer = typename base_type::const_pointer;
     using reference = typename base_type::reference;
@@ -63,18 +67,41 @@ class multimap {
         m_tree.insert_multi(ilist.begin(), ilist.end());
     }
 
+    explicit multimap(const Allocator &alloc) : m_tree(alloc) {
+    }
+
+    explicit multimap(const Compare &comp, const Allocator &alloc = Allocator())
+        : m_tree(comp, alloc) {
+    }
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    multimap(InputIt first, InputIt last, const Allocator &alloc) : m_tree(alloc) {
+        m_tree.insert_multi(first, last);
+    }
+
+    multimap(std::initializer_list<value_type> ilist, const Allocator &alloc) : m_tree(alloc) {
+        m_tree.insert_multi(ilist.begin(), ilist.end());
+    }
+
     multimap(const multimap &other) : m_tree(other.m_tree) {
     }
 
     multimap(multimap &&other) noexcept : m_tree(std::move(other.m_tree)) {
     }
 
+    multimap(const multimap &other, const Allocator &alloc) : m_tree(other.m_tree, alloc) {
+    }
+
+    multimap(multimap &&other, const Allocator &alloc) : m_tree(std::move(other.m_tree), alloc) {
+    }
+
     multimap &operator=(const multimap &rhs) {
         m_tree = rhs.m_tree;
         return *this;
     }
 
-    multimap &operator=(multimap &&rhs) noexcept {
+    multimap &operator=(multimap &&rhs) noexcept(
+        std::is_nothrow_move_assignable<base_type>::value) {
         m_tree = std::move(rhs.m_tree);
         return *this;
     }
@@ -158,6 +185,10 @@ class multimap {
         return m_tree.max_size();
     }
 
+    container_memory memory_usage() const noexcept {
+        return m_tree.memory_usage();
+    }
+
     template <class... Args>
     iterator emplace(Args &&...args) {
         return m_tree.emplace_multi(std::forward<Args>(args)...);
@@ -205,6 +236,69 @@ class multimap {
         m_tree.clear();
     }
 
+    // 用 n 个按键值有序的元素替换全部内容，gen() 依次返回各个元素，O(n)
+    template <class Generator>
+    void assign_sorted(size_type n, Generator gen) {
+        m_tree.assign_sorted(n, gen);
+    }
+
+    node_type extract(const_iterator position) {
+        return m_tree.extract(position);
+    }
+
+    node_type extract(const key_type &key) {
+        return m_tree.extract(key);
+    }
+
+    iterator insert(node_type &&nh) {
+        return m_tree.insert_node_multi(std::move(nh));
+    }
+
+    iterator insert(iterator hint, node_type &&nh) {
+        return m_tree.insert_node_multi(hint, std::move(nh));
+    }
+
+    void merge(multimap &source) {
+        m_tree.merge_multi(source.m_tree);
+    }
+
+    void merge(multimap &&source) {
+        m_tree.merge_multi(source.m_tree);
+    }
+
+    // 基于 join 的集合操作，均不重新分配结点，大树会在多个线程中并行处理
+    // 与 other 的分配器不相等时，merge、join 与 union_with 改为逐个复制元素
+    // 要求 other 中所有键值不小于本容器中的键值，other 随后为空
+    void join(multimap &other) {
+        m_tree.join(other.m_tree);
+    }
+
+    // 键值不小于 key 的元素移入返回的容器中
+    multimap split(const key_type &key) {
+        multimap result(key_comp(), get_allocator());
+        result.m_tree = m_tree.split(key);
+        return result;
+    }
+
+    // 并入 other 的全部元素，键值相等的元素排在已有元素之后，other 随后为空
+    void union_with(multimap &other) {
+        m_tree.union_multi(other.m_tree);
+    }
+
+    void union_with(multimap &&other) {
+        m_tree.union_multi(other.m_tree);
+    }
+
+    // 只保留键值在 other 中出现过的元素
+    void intersect_with(const multimap &other) {
+        m_tree.intersect(other.m_tree);
+    }
+
+    // 删除键值在 other 中出现过的元素
+    void subtract(const multimap &other) {
+        m_tree.subtract(other.m_tree);
+    }
+
     iterator find(const key_type &key) {
         return m_tree.find(key);
     }
@@ -213,6 +307,27 @@ class multimap {
         return m_tree.find(key);
     }
 
+    // 批量查找，对 [first, last) 中的每个键值向 out 写入一个迭代器，多个查找同时推进以重叠访存延迟
+    template <class ForwardIt, class OutputIt>
+    OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) {
+        return m_tree.find_batch(first, last, out);
+    }
+
+    template <class ForwardIt, class OutputIt>
+    OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+        return m_tree.find_batch(first, last, out);
+    }
+
+    template <class ForwardIt, class OutputIt>
+    OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) {
+        return m_tree.lower_bound_batch(first, last, out);
+    }
+
+    template <class ForwardIt, class OutputIt>
+    OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+        return m_tree.lower_bound_batch(first, last, out);
+    }
+
     size_type count(const key_type &key) const {
         return m_tree.count_multi(key);
     }
@@ -241,6 +356,52 @@ class multimap {
         return m_tree.equal_range_multi(key);
     }
 
+    // 异构查找，要求 Compare 声明 is_transparent，如 std::less<>
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    iterator find(const K &key) {
+        return m_tree.find(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    const_iterator find(const K &key) const {
+        return m_tree.find(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    size_type count(const K &key) const {
+        return m_tree.count_multi(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    iterator lower_bound(const K &key) {
+        return m_tree.lower_bound(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    const_iterator lower_bound(const K &key) const {
+        return m_tree.lower_bound(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    iterator upper_bound(const K &key) {
+        return m_tree.upper_bound(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    const_iterator upper_bound(const K &key) const {
+        return m_tree.upper_bound(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    std::pair<iterator, iterator> equal_range(const K &key) {
+        return m_tree.equal_range_multi(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+        return m_tree.equal_range_multi(key);
+    }
+
     void swap(multimap &other) noexcept {
         m_tree.swap(other.m_tree);
     }
@@ -255,36 +416,47 @@ class multimap {
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs) {
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const multimap<Key, T, Compare, Alloc> &lhs,
+                const multimap<Key, T, Compare, Alloc> &rhs) {
     return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs) {
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const multimap<Key, T, Compare, Alloc> &lhs,
+               const multimap<Key, T, Compare, Alloc> &rhs) {
     return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs) {
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const multimap<Key, T, Compare, Alloc> &lhs,
+                const multimap<Key, T, Compare, Alloc> &rhs) {
     return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs) {
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const multimap<Key, T, Compare, Alloc> &lhs,
+               const multimap<Key, T, Compare, Alloc> &rhs) {
     return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs) {
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const multimap<Key, T, Compare, Alloc> &lhs,
+                const multimap<Key, T, Compare, Alloc> &rhs) {
     return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const multimap<Key, T, Compare> &lhs, const multimap<Key, T, Compare> &rhs) {
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const multimap<Key, T, Compare, Alloc> &lhs,
+                const multimap<Key, T, Compare, Alloc> &rhs) {
     return !(lhs < rhs);
 }
 
+namespace pmr {
+template <class Key, class T, class Compare = std::less<Key>>
+using multimap = tstl::multimap<Key, T, Compare, polymorphic_allocator<std::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace tstl
 
 #endif
\ No newline at end of file
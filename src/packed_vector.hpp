@@ -0,0 +1,407 @@
+#ifndef TSTL_SRC_PACKED_VECTOR_HPP
+#define TSTL_SRC_PACKED_VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "iterator.hpp"
+#include "memory/memory_usage.hpp"
+#include "vector.hpp"
+
+namespace tstl {
+
+// 表示 x 所需的最少位数，x 为 0 时为 0
+inline unsigned _bit_width(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return x == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned n = 0;
+    for (; x != 0; x >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline std::uint64_t _bit_mask(unsigned width) noexcept {
+    return width >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+}
+
+// 位压缩的基本操作：第 i 个值占据 words 中从第 i * width 位开始的 width 位，低位在前，
+// 一个值至多跨越两个字
+inline std::uint64_t _bitpack_get(const std::uint64_t *words, unsigned width,
+                                  std::size_t i) noexcept {
+    if (width == 0) {
+        return 0;
+    }
+    const std::size_t bit = i * width;
+    const std::size_t word = bit / 64;
+    const unsigned shift = static_cast<unsigned>(bit % 64);
+    std::uint64_t v = words[word] >> shift;
+    if (shift + width > 64) {
+        v |= words[word + 1] << (64 - shift);
+    }
+    return v & _bit_mask(width);
+}
+
+inline void _bitpack_set(std::uint64_t *words, unsigned width, std::size_t i,
+                         std::uint64_t value) noexcept {
+    if (width == 0) {
+        return;
+    }
+    const std::uint64_t mask = _bit_mask(width);
+    const std::size_t bit = i * width;
+    const std::size_t word = bit / 64;
+    const unsigned shift = static_cast<unsigned>(bit % 64);
+    words[word] = (words[word] & ~(mask << shift)) | (value << shift);
+    if (shift + width > 64) {
+        const unsigned done = 64 - shift;
+        words[word + 1] = (words[word + 1] & ~(mask >> done)) | (value >> done);
+    }
+}
+
+// 64 个值恰好占据 width 个字，整组解压时位宽是编译期常量：循环完全展开后每个值的字下标与
+// 移位量都是常量，没有分支，编译器可以据此生成向量化的移位与掩码指令
+template <unsigned Width>
+void _bitunpack64(const std::uint64_t *in, std::uint64_t *out) noexcept {
+    constexpr std::uint64_t mask = Width >= 64 ? ~std::uint64_t(0)
+                                               : (std::uint64_t(1) << (Width % 64)) - 1;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC unroll 64
+#endif
+    for (unsigned j = 0; j < 64; ++j) {
+        const unsigned bit = j * Width;
+        const unsigned shift = bit % 64;
+        std::uint64_t v = Width == 0 ? 0 : in[bit / 64] >> shift;
+        if (Width != 0 && shift + Width > 64) {
+            v |= in[bit / 64 + 1] << ((64 - shift) % 64);
+        }
+        out[j] = v & mask;
+    }
+}
+
+using _bitunpack64_fn = void (*)(const std::uint64_t *, std::uint64_t *);
+
+template <std::size_t... W>
+const _bitunpack64_fn *_bitunpack64_table(std::index_sequence<W...>) noexcept {
+    static const _bitunpack64_fn table[] = {&_bitunpack64<static_cast<unsigned>(W)>...};
+    return table;
+}
+
+// 解压从 in 开始的 64 个 width 位的值
+inline void _bitunpack64(const std::uint64_t *in, unsigned width, std::uint64_t *out) noexcept {
+    _bitunpack64_table(std::make_index_sequence<65>())[width](in, out);
+}
+
+/**
+ * @brief 定宽位压缩的无符号整数数组，每个元素只占 width 位（0 到 64）。
+ *
+ * 支持随机访问、修改与追加；unpack() 以 64 个元素为一组整组解压，适合顺序扫描。
+ * 写入超出位宽的值时抛出 std::out_of_range。迭代器只读，解引用得到元素的值。
+ */
+class packed_vector {
+  public:
+    using value_type = std::uint64_t;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    class const_iterator {
+      public:
+        using iterator_category = tstl::random_access_iterator_tag;
+        using value_type = std::uint64_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::uint64_t;
+
+        const_iterator() noexcept : m_vec(nullptr), m_pos(0) {
+        }
+        const_iterator(const packed_vector *vec, size_type pos) noexcept : m_vec(vec), m_pos(pos) {
+        }
+
+        reference operator*() const noexcept {
+            return (*m_vec)[m_pos];
+        }
+        reference operator[](difference_type n) const noexcept {
+            return (*m_vec)[m_pos + n];
+        }
+
+        const_iterator &operator++() noexcept {
+            ++m_pos;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++m_pos;
+            return tmp;
+        }
+        const_iterator &operator--() noexcept {
+            --m_pos;
+            return *this;
+        }
+        const_iterator operator--(int) noexcept {
+            const_iterator tmp = *this;
+            --m_pos;
+            return tmp;
+        }
+        const_iterator &operator+=(difference_type n) noexcept {
+            m_pos += n;
+            return *this;
+        }
+        const_iterator &operator-=(difference_type n) noexcept {
+            m_pos -= n;
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const noexcept {
+            return const_iterator(m_vec, m_pos + n);
+        }
+        const_iterator operator-(difference_type n) const noexcept {
+            return const_iterator(m_vec, m_pos - n);
+        }
+        difference_type operator-(const const_iterator &rhs) const noexcept {
+            return static_cast<difference_type>(m_pos - rhs.m_pos);
+        }
+
+        bool operator==(const const_iterator &rhs) const noexcept {
+            return m_pos == rhs.m_pos;
+        }
+        bool operator!=(const const_iterator &rhs) const noexcept {
+            return m_pos != rhs.m_pos;
+        }
+        bool operator<(const const_iterator &rhs) const noexcept {
+            return m_pos < rhs.m_pos;
+        }
+        bool operator>(const const_iterator &rhs) const noexcept {
+            return m_pos > rhs.m_pos;
+        }
+        bool operator<=(const const_iterator &rhs) const noexcept {
+            return m_pos <= rhs.m_pos;
+        }
+        bool operator>=(const const_iterator &rhs) const noexcept {
+            return m_pos >= rhs.m_pos;
+        }
+
+      private:
+        const packed_vector *m_vec;
+        size_type m_pos;
+    };
+    using iterator = const_iterator;
+
+    /**
+     * @brief 构造位宽为 width 的空数组。
+     */
+    explicit packed_vector(unsigned width = 64) : m_width(m_check_width(width)), m_size(0) {
+    }
+
+    /**
+     * @brief 构造含 count 个 value 的数组。
+     */
+    packed_vector(unsigned width, size_type count, value_type value = 0)
+        : m_width(m_check_width(width)), m_size(0) {
+        resize(count, value);
+    }
+
+    /**
+     * @brief 由 [first, last) 构造，位宽取能容纳其中最大值的最小位宽。
+     */
+    template <class ForwardIt, typename = tstl::_RequireInputIter<ForwardIt>>
+    packed_vector(ForwardIt first, ForwardIt last) : m_width(0), m_size(0) {
+        value_type max = 0;
+        size_type count = 0;
+        for (ForwardIt it = first; it != last; ++it, ++count) {
+            max = *it > max ? *it : max;
+        }
+        m_width = _bit_width(max);
+        m_words.resize(m_words_for(count));
+        for (; first != last; ++first) {
+            _bitpack_set(m_words.data(), m_width, m_size++, *first);
+        }
+    }
+
+    unsigned width() const noexcept {
+        return m_width;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief 返回在不重新分配存储的前提下能容纳的元素数。
+     */
+    size_type capacity() const noexcept {
+        return m_width == 0 ? static_cast<size_type>(-1) : m_words.capacity() * 64 / m_width;
+    }
+
+    /**
+     * @brief 返回位于 pos 的元素的值，不进行边界检查。
+     */
+    value_type operator[](size_type pos) const noexcept {
+        return _bitpack_get(m_words.data(), m_width, pos);
+    }
+
+    /**
+     * @brief 返回位于 pos 的元素的值，越界时抛出 std::out_of_range。
+     */
+    value_type at(size_type pos) const {
+        if (pos >= m_size) {
+            throw std::out_of_range("packed_vector::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    value_type front() const noexcept {
+        return (*this)[0];
+    }
+
+    value_type back() const noexcept {
+        return (*this)[m_size - 1];
+    }
+
+    /**
+     * @brief 把位于 pos 的元素改为 value。
+     */
+    void set(size_type pos, value_type value) {
+        m_check_value(value);
+        _bitpack_set(m_words.data(), m_width, pos, value);
+    }
+
+    void push_back(value_type value) {
+        m_check_value(value);
+        const size_type words = m_words_for(m_size + 1);
+        if (words > m_words.size()) {
+            m_words.push_back(0);
+        }
+        _bitpack_set(m_words.data(), m_width, m_size++, value);
+    }
+
+    void pop_back() noexcept {
+        --m_size;
+    }
+
+    void reserve(size_type count) {
+        m_words.reserve(m_words_for(count));
+    }
+
+    void resize(size_type count, value_type value = 0) {
+        m_check_value(value);
+        m_words.resize(m_words_for(count));
+        for (size_type i = m_size; i < count; ++i) {
+            _bitpack_set(m_words.data(), m_width, i, value);
+        }
+        m_size = count;
+    }
+
+    void clear() noexcept {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    /**
+     * @brief 把 [pos, pos + count) 解压到 out，out 至少能容纳 count 个元素。
+     *
+     * 按 64 个元素一组整组解压，只有首尾不满一组的部分逐个读取。
+     */
+    void unpack(size_type pos, size_type count, value_type *out) const noexcept {
+        const size_type last = pos + count;
+        for (; pos < last && pos % 64 != 0; ++pos) {
+            *out++ = (*this)[pos];
+        }
+        for (; last - pos >= 64; pos += 64, out += 64) {
+            _bitunpack64(m_words.data() + pos / 64 * m_width, m_width, out);
+        }
+        for (; pos < last; ++pos) {
+            *out++ = (*this)[pos];
+        }
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, m_size);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * @brief 返回底层存储的字，元素按位紧密排列，低位在前。
+     */
+    const std::uint64_t *data() const noexcept {
+        return m_words.data();
+    }
+
+    /**
+     * @brief 返回占用的内存；payload 为压缩后存放元素的字节数，未使用的容量计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = (m_size * m_width + 7) / 8;
+        usage.overhead = sizeof(*this) + m_words.capacity() * sizeof(std::uint64_t) - usage.payload;
+        return usage;
+    }
+
+    void swap(packed_vector &other) noexcept {
+        tstl::swap(m_width, other.m_width);
+        tstl::swap(m_size, other.m_size);
+        m_words.swap(other.m_words);
+    }
+
+    friend bool operator==(const packed_vector &lhs, const packed_vector &rhs) {
+        if (lhs.m_size != rhs.m_size) {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.m_size; ++i) {
+            if (lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const packed_vector &lhs, const packed_vector &rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    unsigned m_width;
+    size_type m_size;
+    tstl::vector<std::uint64_t> m_words;
+
+    static unsigned m_check_width(unsigned width) {
+        if (width > 64) {
+            throw std::out_of_range("packed_vector: width must not exceed 64");
+        }
+        return width;
+    }
+
+    void m_check_value(value_type value) const {
+        if (_bit_width(value) > m_width) {
+            throw std::out_of_range("packed_vector: value exceeds the bit width");
+        }
+    }
+
+    size_type m_words_for(size_type count) const noexcept {
+        return (count * m_width + 63) / 64;
+    }
+};
+
+inline void swap(packed_vector &lhs, packed_vector &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
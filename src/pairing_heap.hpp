@@ -0,0 +1,470 @@
+#ifndef TSTL_SRC_PAIRING_HEAP_HPP
+#define TSTL_SRC_PAIRING_HEAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm.hpp"
+#include "memory/memory_usage.hpp"
+#include "memory/pool_allocator.hpp"
+
+namespace tstl {
+
+// 配对堆的结点：child 指向最左的子结点，next 指向右侧的兄弟；
+// prev 对最左的子结点指向父结点，对其他结点指向左侧的兄弟，堆顶的 prev 与 next 为空
+template <class T>
+struct pairing_heap_node {
+    T value;
+    pairing_heap_node *child;
+    pairing_heap_node *next;
+    pairing_heap_node *prev;
+
+    template <class... Args>
+    explicit pairing_heap_node(Args &&...args)
+        : value(std::forward<Args>(args)...), child(nullptr), next(nullptr), prev(nullptr) {
+    }
+};
+
+/**
+ * @brief 可寻址的配对堆，top() 为按 Compare 最小的元素。
+ *
+ * push 返回指向元素的句柄，元素被弹出或删除之前句柄一直有效，merge 之后仍然有效。
+ * push、top、merge 为 O(1)，pop、erase、update 均摊 O(log n)，decrease_key 均摊 o(log n)。
+ * 每个元素是一个单独分配的结点，默认由 pool_allocator 分配。
+ */
+template <class T, class Compare = std::less<T>, class Allocator = tstl::pool_allocator<T>>
+class pairing_heap {
+    using node_type = pairing_heap_node<T>;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_alloc = typename alloc_traits::template rebind_alloc<node_type>;
+    using node_alloc_traits = std::allocator_traits<node_alloc>;
+
+  public:
+    using value_type = T;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = const T &;
+
+    // 指向堆中元素的句柄，只能读取元素；修改元素须通过 decrease_key 或 update
+    class handle_type {
+      public:
+        handle_type() noexcept : m_node(nullptr) {
+        }
+
+        const T &operator*() const noexcept {
+            return m_node->value;
+        }
+        const T *operator->() const noexcept {
+            return &m_node->value;
+        }
+
+        explicit operator bool() const noexcept {
+            return m_node != nullptr;
+        }
+
+        bool operator==(const handle_type &rhs) const noexcept {
+            return m_node == rhs.m_node;
+        }
+        bool operator!=(const handle_type &rhs) const noexcept {
+            return m_node != rhs.m_node;
+        }
+
+      private:
+        friend class pairing_heap;
+
+        node_type *m_node;
+
+        explicit handle_type(node_type *node) noexcept : m_node(node) {
+        }
+    };
+
+    pairing_heap() : pairing_heap(Compare()) {
+    }
+
+    explicit pairing_heap(const Compare &compare, const Allocator &alloc = Allocator())
+        : m_root(nullptr), m_size(0), m_comp(compare), m_alloc(alloc) {
+    }
+
+    /**
+     * @brief 复制 other 的全部元素，O(n)。other 的句柄不能用于新的堆。
+     */
+    pairing_heap(const pairing_heap &other)
+        : pairing_heap(other.m_comp, alloc_traits::select_on_container_copy_construction(
+                                         Allocator(other.m_alloc))) {
+        other.m_for_each_node([this](const node_type *p) { push(p->value); });
+    }
+
+    pairing_heap(pairing_heap &&other) noexcept
+        : m_root(other.m_root), m_size(other.m_size), m_comp(std::move(other.m_comp)),
+          m_alloc(std::move(other.m_alloc)) {
+        other.m_root = nullptr;
+        other.m_size = 0;
+    }
+
+    /**
+     * @brief 先用赋值后将使用的分配器复制出全部元素，成功后才替换原有内容。
+     */
+    pairing_heap &operator=(const pairing_heap &other) {
+        if (this != &other) {
+            using pocca = typename node_alloc_traits::propagate_on_container_copy_assignment;
+            pairing_heap tmp(other.m_comp, Allocator(m_copy_source(other, pocca())));
+            other.m_for_each_node([&tmp](const node_type *p) { tmp.push(p->value); });
+            clear();
+            m_comp = std::move(tmp.m_comp);
+            m_copy_assign_alloc(tmp, pocca());
+            m_steal(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 分配器随移动转移或两者相等时接管 other 的结点，否则逐个移动元素，other 的句柄随之失效。
+     */
+    pairing_heap &operator=(pairing_heap &&other) noexcept(
+        node_alloc_traits::propagate_on_container_move_assignment::value ||
+        node_alloc_traits::is_always_equal::value) {
+        if (this != &other) {
+            clear();
+            m_comp = std::move(other.m_comp);
+            m_move_assign(other,
+                          typename node_alloc_traits::propagate_on_container_move_assignment());
+        }
+        return *this;
+    }
+
+    ~pairing_heap() {
+        clear();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    const_reference top() const noexcept {
+        return m_root->value;
+    }
+
+    /**
+     * @brief 返回堆顶元素的句柄。
+     */
+    handle_type top_handle() const noexcept {
+        return handle_type(m_root);
+    }
+
+    handle_type push(const value_type &value) {
+        return emplace(value);
+    }
+
+    handle_type push(value_type &&value) {
+        return emplace(std::move(value));
+    }
+
+    template <class... Args>
+    handle_type emplace(Args &&...args) {
+        node_type *p = m_create_node(std::forward<Args>(args)...);
+        m_root = m_root == nullptr ? p : m_link(m_root, p);
+        ++m_size;
+        return handle_type(p);
+    }
+
+    /**
+     * @brief 移除堆顶元素，两两合并它的子树。
+     */
+    void pop() {
+        node_type *old = m_root;
+        m_root = m_merge_pairs(old->child);
+        m_destroy_node(old);
+        --m_size;
+    }
+
+    /**
+     * @brief 把 h 所指元素改为不排在原值之后的 value，并把它的子树移到堆顶。
+     *
+     * value 排在原值之后时抛出 std::invalid_argument，此时应使用 update。
+     */
+    void decrease_key(handle_type h, const value_type &value) {
+        node_type *p = h.m_node;
+        if (m_comp(p->value, value)) {
+            throw std::invalid_argument("pairing_heap::decrease_key: key would increase");
+        }
+        p->value = value;
+        if (p != m_root) {
+            m_cut(p);
+            m_root = m_link(m_root, p);
+        }
+    }
+
+    /**
+     * @brief 把 h 所指元素改为任意的 value。
+     *
+     * 值后移时先取出该结点，把它的子树两两合并后放回，再把结点作为单个元素重新加入。
+     */
+    void update(handle_type h, const value_type &value) {
+        node_type *p = h.m_node;
+        if (!m_comp(p->value, value)) {
+            decrease_key(h, value);
+            return;
+        }
+        m_detach(p);
+        p->value = value;
+        m_root = m_root == nullptr ? p : m_link(m_root, p);
+    }
+
+    /**
+     * @brief 删除 h 所指元素，h 随之失效。
+     */
+    void erase(handle_type h) {
+        node_type *p = h.m_node;
+        m_detach(p);
+        m_destroy_node(p);
+        --m_size;
+    }
+
+    /**
+     * @brief 把 other 的全部元素移入 *this，O(1)，other 变为空，other 的句柄仍指向原来的元素。
+     *
+     * 两个堆的分配器须相等。
+     */
+    void merge(pairing_heap &other) {
+        if (this == &other || other.m_root == nullptr) {
+            return;
+        }
+        assert(m_alloc == other.m_alloc);
+        m_root = m_root == nullptr ? other.m_root : m_link(m_root, other.m_root);
+        m_size += other.m_size;
+        other.m_root = nullptr;
+        other.m_size = 0;
+    }
+
+    void clear() noexcept {
+        m_destroy_all();
+        m_root = nullptr;
+        m_size = 0;
+    }
+
+    /**
+     * @brief 按任意顺序对每个元素调用 fn。
+     */
+    template <class Fn>
+    void for_each(Fn fn) const {
+        m_for_each_node([&fn](const node_type *p) { fn(p->value); });
+    }
+
+    /**
+     * @brief 返回占用的内存；结点中的三个指针计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = m_size * sizeof(T);
+        usage.overhead = sizeof(*this) + m_size * (sizeof(node_type) - sizeof(T));
+        return usage;
+    }
+
+    // 分配器不随交换传播时，要求两者相等
+    void swap(pairing_heap &other) noexcept {
+        tstl::swap(m_root, other.m_root);
+        tstl::swap(m_size, other.m_size);
+        tstl::swap(m_comp, other.m_comp);
+        m_swap_alloc(other, typename node_alloc_traits::propagate_on_container_swap());
+    }
+
+    friend void swap(pairing_heap &lhs, pairing_heap &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+  private:
+    node_type *m_root;
+    size_type m_size;
+    Compare m_comp;
+    node_alloc m_alloc;
+
+    void m_steal(pairing_heap &other) noexcept {
+        tstl::swap(m_root, other.m_root);
+        tstl::swap(m_size, other.m_size);
+    }
+
+    // 复制赋值时新结点使用的分配器
+    const node_alloc &m_copy_source(const pairing_heap &other, std::true_type) const noexcept {
+        return other.m_alloc;
+    }
+    const node_alloc &m_copy_source(const pairing_heap &, std::false_type) const noexcept {
+        return m_alloc;
+    }
+
+    // 要求本堆为空
+    void m_copy_assign_alloc(const pairing_heap &other, std::true_type) noexcept {
+        m_alloc = other.m_alloc;
+    }
+    void m_copy_assign_alloc(const pairing_heap &, std::false_type) noexcept {
+    }
+
+    void m_swap_alloc(pairing_heap &other, std::true_type) noexcept {
+        tstl::swap(m_alloc, other.m_alloc);
+    }
+    void m_swap_alloc(pairing_heap &, std::false_type) noexcept {
+    }
+
+    void m_move_assign(pairing_heap &other, std::true_type) noexcept {
+        m_alloc = std::move(other.m_alloc);
+        m_steal(other);
+    }
+    // 分配器不随移动转移时，只有两者相等才能直接接管结点，否则逐个移动
+    void m_move_assign(pairing_heap &other, std::false_type) {
+        if (m_alloc == other.m_alloc) {
+            m_steal(other);
+        } else {
+            other.m_for_each_node([this](const node_type *p) {
+                push(std::move(const_cast<node_type *>(p)->value));
+            });
+            other.clear();
+        }
+    }
+
+    template <class... Args>
+    node_type *m_create_node(Args &&...args) {
+        node_type *p = node_alloc_traits::allocate(m_alloc, 1);
+        try {
+            node_alloc_traits::construct(m_alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            node_alloc_traits::deallocate(m_alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void m_destroy_node(node_type *p) noexcept {
+        node_alloc_traits::destroy(m_alloc, p);
+        node_alloc_traits::deallocate(m_alloc, p, 1);
+    }
+
+    // 合并两棵树：较大的根成为较小的根的最左子结点，返回新的根
+    node_type *m_link(node_type *a, node_type *b) {
+        if (m_comp(b->value, a->value)) {
+            tstl::swap(a, b);
+        }
+        b->next = a->child;
+        if (a->child != nullptr) {
+            a->child->prev = b;
+        }
+        b->prev = a;
+        a->child = b;
+        a->next = nullptr;
+        a->prev = nullptr;
+        return a;
+    }
+
+    // 把以 p 为根的子树从它的父结点与兄弟中摘下，p 不能是堆顶
+    void m_cut(node_type *p) noexcept {
+        if (p->prev->child == p) {
+            p->prev->child = p->next;
+        } else {
+            p->prev->next = p->next;
+        }
+        if (p->next != nullptr) {
+            p->next->prev = p->prev;
+        }
+        p->next = nullptr;
+        p->prev = nullptr;
+    }
+
+    // 从堆中取出单个结点 p：它的子树两两合并后放回原处
+    void m_detach(node_type *p) {
+        node_type *sub = m_merge_pairs(p->child);
+        p->child = nullptr;
+        if (p == m_root) {
+            m_root = sub;
+            return;
+        }
+        m_cut(p);
+        if (sub != nullptr) {
+            m_root = m_link(m_root, sub);
+        }
+    }
+
+    // 两趟合并一串兄弟：先从左到右两两合并，再从右到左依次并入，返回合并后的根
+    node_type *m_merge_pairs(node_type *first) {
+        if (first == nullptr) {
+            return nullptr;
+        }
+        node_type *pairs = nullptr; // 第一趟的结果，以 next 逆序串起
+        while (first != nullptr) {
+            node_type *a = first;
+            node_type *b = a->next;
+            if (b == nullptr) {
+                a->prev = nullptr;
+                a->next = pairs;
+                pairs = a;
+                break;
+            }
+            first = b->next;
+            node_type *merged = m_link(a, b);
+            merged->next = pairs;
+            pairs = merged;
+        }
+        node_type *result = pairs;
+        pairs = pairs->next;
+        result->next = nullptr;
+        while (pairs != nullptr) {
+            node_type *p = pairs;
+            pairs = pairs->next;
+            result = m_link(result, p);
+        }
+        return result;
+    }
+
+    // 不用递归地先序访问每个结点：先下到最左的子结点，没有右侧的兄弟时沿 prev 回到父结点
+    template <class Fn>
+    void m_for_each_node(Fn fn) const {
+        const node_type *p = m_root;
+        while (p != nullptr) {
+            fn(p);
+            if (p->child != nullptr) {
+                p = p->child;
+                continue;
+            }
+            while (p != m_root && p->next == nullptr) {
+                while (p->prev->child != p) {
+                    p = p->prev;
+                }
+                p = p->prev;
+            }
+            p = p == m_root ? nullptr : p->next;
+        }
+    }
+
+    // 销毁全部结点：把每个结点的子结点串接到待处理的链表前面，不用递归
+    void m_destroy_all() noexcept {
+        node_type *pending = m_root;
+        while (pending != nullptr) {
+            node_type *p = pending;
+            pending = p->next;
+            if (p->child != nullptr) {
+                node_type *last = p->child;
+                while (last->next != nullptr) {
+                    last = last->next;
+                }
+                last->next = pending;
+                pending = p->child;
+            }
+            m_destroy_node(p);
+        }
+    }
+};
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef TSTL_SRC_PERSISTENT_MULTIMAP_HPP
+#define TSTL_SRC_PERSISTENT_MULTIMAP_HPP
+
+#include <mutex>
+
+#include "persistent_rbtree.hpp"
+
+namespace tstl {
+
+// 供一写多读使用的 multimap，底层为可持久化红黑树
+// 读者通过 snapshot() 以 O(1) 取得当前版本的只读快照，此后的读取无需加锁，
+// 写者每次修改只复制 O(log n) 个结点，修改完成后再发布新版本，已发出的快照不受影响
+// 互斥锁只保护根节点的发布与获取，不保护读取过程
+template <class Key, class T, class Compare = std::less<Key>>
+class persistent_multimap {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+
+    // 快照即不可变的一个版本，可以复制、可以在任意线程中读取
+    using snapshot_type = tstl::persistent_rb_tree<value_type, key_compare>;
+    using size_type = typename snapshot_type::size_type;
+
+  private:
+    snapshot_type m_tree;         // 当前版本
+    mutable std::mutex m_publish; // 保护 m_tree 的发布与获取
+    std::mutex m_write;           // 串行化写者
+
+  public:
+    // 构造函数，对象本身不可复制，需要副本时请使用快照
+    persistent_multimap() = default;
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    persistent_multimap(InputIt first, InputIt last) {
+        m_tree.insert_multi(first, last);
+    }
+
+    persistent_multimap(std::initializer_list<value_type> ilist) {
+        m_tree.insert_multi(ilist.begin(), ilist.end());
+    }
+
+    explicit persistent_multimap(const snapshot_type &snapshot) : m_tree(snapshot) {
+    }
+
+    persistent_multimap(const persistent_multimap &) = delete;
+    persistent_multimap &operator=(const persistent_multimap &) = delete;
+
+    // 取得当前版本的快照，O(1)
+    snapshot_type snapshot() const {
+        std::lock_guard<std::mutex> lock(m_publish);
+        return m_tree;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_type size() const {
+        std::lock_guard<std::mutex> lock(m_publish);
+        return m_tree.size();
+    }
+
+    // 在当前版本的副本上执行 fn，完成后一次性发布，fn 中的多次修改对读者原子可见
+    template <class Fn>
+    void update(Fn fn) {
+        std::lock_guard<std::mutex> write_lock(m_write);
+        snapshot_type next = m_tree; // 只有写者修改 m_tree，此处读取无需 m_publish
+        fn(next);
+        {
+            std::lock_guard<std::mutex> lock(m_publish);
+            m_tree.swap(next);
+        }
+        // 旧版本在锁外释放，仍被快照引用的结点不会被销毁
+    }
+
+    void insert(const value_type &value) {
+        update([&](snapshot_type &tree) { tree.insert_multi(value); });
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args) {
+        insert(value_type(std::forward<Args>(args)...));
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        update([&](snapshot_type &tree) { tree.insert_multi(first, last); });
+    }
+
+    size_type erase(const key_type &key) {
+        size_type n = 0;
+        update([&](snapshot_type &tree) { n = tree.erase_multi(key); });
+        return n;
+    }
+
+    void clear() {
+        update([](snapshot_type &tree) { tree.clear(); });
+    }
+};
+
+} // namespace tstl
+
+#endif
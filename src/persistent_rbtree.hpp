@@ -0,0 +1,571 @@
+#ifndef TSTL_SRC_PERSISTENT_RBTREE_HPP
+#define TSTL_SRC_PERSISTENT_RBTREE_HPP
+
+// 这文件主要包含的是可持久化（路径复制）的红黑树 persistent_rb_tree
+// 结点一经创建便不再修改，由引用计数在多个版本之间共享，复制整棵树为 O(1)，
+// 每次修改只复制从根到被修改位置的 O(log n) 个结点，旧版本保持不变，
+// 因此不同线程可以不加锁地同时读取各自持有的版本
+// 结点没有父指针（父指针无法在版本之间共享），插入与删除采用 Okasaki 与 Kahrs 的函数式算法
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "iterator.hpp"
+#include "rbtree.hpp"
+
+namespace tstl {
+
+template <class T>
+struct persistent_rb_tree_node;
+
+// 指向不可变结点的引用计数指针，复制时计数加一，析构时减一，减到零时释放结点及其子树
+template <class T>
+class persistent_rb_tree_ref {
+  public:
+    using node_type = persistent_rb_tree_node<T>;
+
+    persistent_rb_tree_ref() noexcept : m_node(nullptr) {
+    }
+    // 接管一个新建结点，其计数已为 1
+    explicit persistent_rb_tree_ref(const node_type *p) noexcept : m_node(p) {
+    }
+    persistent_rb_tree_ref(const persistent_rb_tree_ref &rhs) noexcept : m_node(rhs.m_node) {
+        if (m_node != nullptr) {
+            m_node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    persistent_rb_tree_ref(persistent_rb_tree_ref &&rhs) noexcept : m_node(rhs.m_node) {
+        rhs.m_node = nullptr;
+    }
+    persistent_rb_tree_ref &operator=(persistent_rb_tree_ref rhs) noexcept {
+        std::swap(m_node, rhs.m_node);
+        return *this;
+    }
+    ~persistent_rb_tree_ref() {
+        release(m_node);
+    }
+
+    const node_type *get() const noexcept {
+        return m_node;
+    }
+    const node_type *operator->() const noexcept {
+        return m_node;
+    }
+    explicit operator bool() const noexcept {
+        return m_node != nullptr;
+    }
+
+  private:
+    const node_type *m_node;
+
+    static void release(const node_type *p) noexcept {
+        // 最后一个引用释放时，需要看到其他线程对该结点的全部访问
+        if (p != nullptr && p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::allocator<node_type> alloc;
+            node_type *np = const_cast<node_type *>(p);
+            np->~node_type(); // 子结点的引用随之释放
+            alloc.deallocate(np, 1);
+        }
+    }
+};
+
+// 可持久化红黑树的结点，除引用计数外创建后不再修改
+template <class T>
+struct persistent_rb_tree_node {
+    using ref_type = persistent_rb_tree_ref<T>;
+
+    mutable std::atomic<std::size_t> refs;
+    rb_tree_color_type color;
+    ref_type left;
+    ref_type right;
+    T value;
+
+    template <class... Args>
+    persistent_rb_tree_node(rb_tree_color_type c, ref_type l, ref_type r, Args &&...args)
+        : refs(1), color(c), left(std::move(l)), right(std::move(r)),
+          value(std::forward<Args>(args)...) {
+    }
+};
+
+// 可持久化红黑树的迭代器，只读，前向
+// 结点没有父指针，迭代器记录从根到当前结点的左右走向（每层一位），红黑树高度不超过
+// 2log(n+1)，128 位足够；另缓存最近的几个“当前结点位于其左子树中”的祖先，
+// 回溯时通常直接取缓存，缓存用尽时才按走向从根重新走一遍
+template <class T>
+struct persistent_rb_tree_iterator : public tstl::iterator<tstl::forward_iterator_tag, T> {
+    using value_type = T;
+    using pointer = const T *;
+    using reference = const T &;
+    using node_type = persistent_rb_tree_node<T>;
+    using self = persistent_rb_tree_iterator<T>;
+
+    static const unsigned max_height = 2 * std::numeric_limits<std::uint64_t>::digits;
+    static const unsigned cache_size = 8; // 2 的幂
+
+    const node_type *root;
+    const node_type *cur;            // 当前结点，为空即为 end
+    std::uint64_t path[2];           // 第 i 位为 1 表示第 i 层向右走
+    unsigned height;                 // 当前结点的深度，根为 0
+    unsigned top;                    // 缓存的环形栈顶
+    unsigned cached;                 // 缓存中有效的祖先个数
+    const node_type *cache[cache_size];
+
+    persistent_rb_tree_iterator() noexcept
+        : root(nullptr), cur(nullptr), path{0, 0}, height(0), top(0), cached(0) {
+    }
+    explicit persistent_rb_tree_iterator(const node_type *r) noexcept
+        : root(r), cur(r), path{0, 0}, height(0), top(0), cached(0) {
+    }
+
+    bool went_right(unsigned i) const noexcept {
+        return (path[i / 64] >> (i % 64)) & 1;
+    }
+    void set_step(unsigned i, bool right) noexcept {
+        const std::uint64_t bit = std::uint64_t(1) << (i % 64);
+        path[i / 64] = right ? (path[i / 64] | bit) : (path[i / 64] & ~bit);
+    }
+    void push_cache(const node_type *x) noexcept {
+        cache[top++ & (cache_size - 1)] = x;
+        if (cached < cache_size) {
+            ++cached;
+        }
+    }
+
+    // 从当前结点向左或向右走一步
+    void go_left() noexcept {
+        assert(height < max_height);
+        push_cache(cur);
+        set_step(height++, false);
+        cur = cur->left.get();
+    }
+    void go_right() noexcept {
+        assert(height < max_height);
+        set_step(height++, true);
+        cur = cur->right.get();
+    }
+    void go_leftmost() noexcept {
+        while (cur->left) {
+            go_left();
+        }
+    }
+
+    // 按记录的走向从根走到深度为 height 的结点，并重新填充缓存
+    void rewalk() noexcept {
+        const unsigned h = height;
+        cur = root;
+        height = 0;
+        cached = 0;
+        while (height < h) {
+            if (went_right(height)) {
+                go_right();
+            } else {
+                go_left();
+            }
+        }
+    }
+
+    const node_type *node() const noexcept {
+        return cur;
+    }
+
+    reference operator*() const {
+        return cur->value;
+    }
+    pointer operator->() const {
+        return &(operator*());
+    }
+    self &operator++() {
+        if (cur->right) {
+            go_right();
+            go_leftmost();
+            return *this;
+        }
+        // 回到最近的一个向左走的祖先
+        unsigned h = height;
+        while (h > 0 && went_right(h - 1)) {
+            --h;
+        }
+        if (h == 0) {
+            *this = self();
+            return *this;
+        }
+        height = h - 1;
+        if (cached > 0) {
+            --cached;
+            cur = cache[--top & (cache_size - 1)];
+        } else {
+            rewalk();
+        }
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const self &rhs) const noexcept {
+        return cur == rhs.cur;
+    }
+    bool operator!=(const self &rhs) const noexcept {
+        return cur != rhs.cur;
+    }
+};
+
+// 模板类 persistent_rb_tree（数据类型，比较类型），允许键值重复
+// 复制为 O(1)，副本与原树共享全部结点，此后对任一方的修改都不影响另一方
+// 同一个对象不能被多个线程同时修改，不同对象（即使共享结点）可以在不同线程中任意使用
+template <class T, class Compare>
+class persistent_rb_tree {
+  public:
+    using value_traits = rb_tree_value_traits<T>;
+    using key_type = typename value_traits::key_type;
+    using mapped_type = typename value_traits::mapped_type;
+    using value_type = typename value_traits::value_type;
+    using key_compare = Compare;
+
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const value_type &;
+    using const_reference = const value_type &;
+
+    using iterator = persistent_rb_tree_iterator<T>;
+    using const_iterator = iterator;
+
+  private:
+    using node_type = persistent_rb_tree_node<T>;
+    using ref_type = persistent_rb_tree_ref<T>;
+
+    ref_type m_root;        // 根节点
+    size_type m_node_count; // 节点数
+    key_compare m_key_comp; // 节点键值比较的准则
+
+  public:
+    // 构造、复制、移动函数，复制只增加根节点的引用计数
+    persistent_rb_tree() : m_root(), m_node_count(0), m_key_comp() {
+    }
+    persistent_rb_tree(const persistent_rb_tree &rhs) = default;
+    persistent_rb_tree(persistent_rb_tree &&rhs) noexcept
+        : m_root(std::move(rhs.m_root)), m_node_count(rhs.m_node_count),
+          m_key_comp(rhs.m_key_comp) {
+        rhs.m_node_count = 0;
+    }
+    persistent_rb_tree &operator=(const persistent_rb_tree &rhs) = default;
+    persistent_rb_tree &operator=(persistent_rb_tree &&rhs) noexcept {
+        if (this != &rhs) {
+            m_root = std::move(rhs.m_root);
+            m_node_count = rhs.m_node_count;
+            m_key_comp = rhs.m_key_comp;
+            rhs.m_node_count = 0;
+        }
+        return *this;
+    }
+    ~persistent_rb_tree() = default;
+
+    key_compare key_comp() const {
+        return m_key_comp;
+    }
+
+    // 迭代器相关操作
+    iterator begin() const noexcept {
+        iterator it(m_root.get());
+        if (it.cur != nullptr) {
+            it.go_leftmost();
+        }
+        return it;
+    }
+    iterator end() const noexcept {
+        return iterator();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // 容量相关操作
+    bool empty() const noexcept {
+        return m_node_count == 0;
+    }
+    size_type size() const noexcept {
+        return m_node_count;
+    }
+
+    // 插入一个元素，键值相等时插在已有元素之后，只复制查找路径上的结点
+    void insert_multi(const value_type &value) {
+        m_root = make_black(insert_at(m_root, value));
+        ++m_node_count;
+    }
+
+    template <class... Args>
+    void emplace_multi(Args &&...args) {
+        insert_multi(value_type(std::forward<Args>(args)...));
+    }
+
+    template <class InputIterator>
+    void insert_multi(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            insert_multi(*first);
+        }
+    }
+
+    // 删除一个键值为 key 的元素，返回是否删除
+    bool erase_one(const key_type &key) {
+        if (find(key) == end()) {
+            return false;
+        }
+        m_root = make_black(erase_at(m_root, key));
+        --m_node_count;
+        return true;
+    }
+
+    // 删除所有键值为 key 的元素，返回删除的个数
+    size_type erase_multi(const key_type &key) {
+        size_type n = 0;
+        while (erase_one(key)) {
+            ++n;
+        }
+        return n;
+    }
+
+    // 清空，只释放本对象持有的引用，仍被其他版本使用的结点不会被销毁
+    void clear() noexcept {
+        m_root = ref_type();
+        m_node_count = 0;
+    }
+
+    void swap(persistent_rb_tree &rhs) noexcept {
+        std::swap(m_root, rhs.m_root);
+        std::swap(m_node_count, rhs.m_node_count);
+        std::swap(m_key_comp, rhs.m_key_comp);
+    }
+
+    // 查找操作
+    iterator lower_bound(const key_type &key) const {
+        return bound(key, [this](const key_type &k, const node_type *x) {
+            return !m_key_comp(node_key(x), k);
+        });
+    }
+    iterator upper_bound(const key_type &key) const {
+        return bound(key, [this](const key_type &k, const node_type *x) {
+            return m_key_comp(k, node_key(x));
+        });
+    }
+    iterator find(const key_type &key) const {
+        iterator it = lower_bound(key);
+        if (it.cur != nullptr && m_key_comp(key, node_key(it.cur))) {
+            return end();
+        }
+        return it;
+    }
+    std::pair<iterator, iterator> equal_range(const key_type &key) const {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+    size_type count(const key_type &key) const {
+        auto range = equal_range(key);
+        return static_cast<size_type>(tstl::distance(range.first, range.second));
+    }
+
+  private:
+    // 沿查找路径下行，返回最后一个满足 go_left 的结点；缓存留空，第一次回溯时从根填充
+    template <class GoLeft>
+    iterator bound(const key_type &key, GoLeft go_left) const {
+        iterator it(m_root.get());
+        unsigned found = 0;
+        const node_type *result = nullptr;
+        while (it.cur != nullptr) {
+            if (go_left(key, it.cur)) {
+                result = it.cur;
+                found = it.height;
+                it.go_left();
+            } else {
+                it.go_right();
+            }
+        }
+        if (result == nullptr) {
+            return end();
+        }
+        it.cur = result;
+        it.height = found;
+        it.cached = 0;
+        return it;
+    }
+
+    static const key_type &node_key(const node_type *x) noexcept {
+        return value_traits::get_key(x->value);
+    }
+
+    static bool is_red(const ref_type &x) noexcept {
+        return x && x->color == rb_tree_red;
+    }
+    static bool is_black(const ref_type &x) noexcept {
+        return x && x->color == rb_tree_black;
+    }
+
+    template <class... Args>
+    static ref_type make(rb_tree_color_type c, ref_type l, ref_type r, Args &&...args) {
+        std::allocator<node_type> alloc;
+        node_type *p = alloc.allocate(1);
+        try {
+            ::new (static_cast<void *>(p))
+                node_type(c, std::move(l), std::move(r), std::forward<Args>(args)...);
+        } catch (...) {
+            alloc.deallocate(p, 1);
+            throw;
+        }
+        return ref_type(p);
+    }
+
+    // 复制结点 x 并改变颜色，子树仍然共享
+    static ref_type recolor(const ref_type &x, rb_tree_color_type c) {
+        return make(c, x->left, x->right, x->value);
+    }
+    static ref_type make_black(ref_type x) {
+        return is_red(x) ? recolor(x, rb_tree_black) : x;
+    }
+
+    // 用 x 连接 a 与 b，消除 a 或 b 中可能出现的红红冲突（Kahrs 的平衡函数，插入与删除共用）
+    static ref_type balance(const ref_type &a, const value_type &x, const ref_type &b) {
+        if (is_red(a) && is_red(b)) {
+            return make(rb_tree_red, recolor(a, rb_tree_black), recolor(b, rb_tree_black), x);
+        }
+        if (is_red(a) && is_red(a->left)) {
+            return make(rb_tree_red, recolor(a->left, rb_tree_black),
+                        make(rb_tree_black, a->right, b, x), a->value);
+        }
+        if (is_red(a) && is_red(a->right)) {
+            const ref_type &ar = a->right;
+            return make(rb_tree_red, make(rb_tree_black, a->left, ar->left, a->value),
+                        make(rb_tree_black, ar->right, b, x), ar->value);
+        }
+        if (is_red(b) && is_red(b->right)) {
+            return make(rb_tree_red, make(rb_tree_black, a, b->left, x),
+                        recolor(b->right, rb_tree_black), b->value);
+        }
+        if (is_red(b) && is_red(b->left)) {
+            const ref_type &bl = b->left;
+            return make(rb_tree_red, make(rb_tree_black, a, bl->left, x),
+                        make(rb_tree_black, bl->right, b->right, b->value), bl->value);
+        }
+        return make(rb_tree_black, a, b, x);
+    }
+
+    ref_type insert_at(const ref_type &t, const value_type &value) const {
+        if (!t) {
+            return make(rb_tree_red, ref_type(), ref_type(), value);
+        }
+        if (m_key_comp(value_traits::get_key(value), node_key(t.get()))) {
+            ref_type l = insert_at(t->left, value);
+            if (t->color == rb_tree_black) {
+                return balance(l, t->value, t->right);
+            }
+            return make(rb_tree_red, std::move(l), t->right, t->value);
+        }
+        ref_type r = insert_at(t->right, value);
+        if (t->color == rb_tree_black) {
+            return balance(t->left, t->value, r);
+        }
+        return make(rb_tree_red, t->left, std::move(r), t->value);
+    }
+
+    // 左子树黑高减一后恢复平衡
+    static ref_type balance_left(const ref_type &l, const value_type &x, const ref_type &r) {
+        if (is_red(l)) {
+            return make(rb_tree_red, recolor(l, rb_tree_black), r, x);
+        }
+        if (is_black(r)) {
+            return balance(l, x, recolor(r, rb_tree_red));
+        }
+        assert(is_red(r) && is_black(r->left));
+        const ref_type &rl = r->left;
+        return make(rb_tree_red, make(rb_tree_black, l, rl->left, x),
+                    balance(rl->right, r->value, recolor(r->right, rb_tree_red)), rl->value);
+    }
+
+    // 右子树黑高减一后恢复平衡
+    static ref_type balance_right(const ref_type &l, const value_type &x, const ref_type &r) {
+        if (is_red(r)) {
+            return make(rb_tree_red, l, recolor(r, rb_tree_black), x);
+        }
+        if (is_black(l)) {
+            return balance(recolor(l, rb_tree_red), x, r);
+        }
+        assert(is_red(l) && is_black(l->right));
+        const ref_type &lr = l->right;
+        return make(rb_tree_red, balance(recolor(l->left, rb_tree_red), l->value, lr->left),
+                    make(rb_tree_black, lr->right, r, x), lr->value);
+    }
+
+    // 连接被删除结点的左右子树
+    static ref_type append(const ref_type &a, const ref_type &b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (is_red(a) && is_red(b)) {
+            ref_type bc = append(a->right, b->left);
+            if (is_red(bc)) {
+                return make(rb_tree_red, make(rb_tree_red, a->left, bc->left, a->value),
+                            make(rb_tree_red, bc->right, b->right, b->value), bc->value);
+            }
+            return make(rb_tree_red, a->left, make(rb_tree_red, bc, b->right, b->value), a->value);
+        }
+        if (is_black(a) && is_black(b)) {
+            ref_type bc = append(a->right, b->left);
+            if (is_red(bc)) {
+                return make(rb_tree_red, make(rb_tree_black, a->left, bc->left, a->value),
+                            make(rb_tree_black, bc->right, b->right, b->value), bc->value);
+            }
+            return balance_left(a->left, a->value,
+                                make(rb_tree_black, bc, b->right, b->value));
+        }
+        if (is_red(b)) {
+            return make(rb_tree_red, append(a, b->left), b->right, b->value);
+        }
+        return make(rb_tree_red, a->left, append(a->right, b), a->value);
+    }
+
+    ref_type erase_at(const ref_type &t, const key_type &key) const {
+        if (!t) {
+            return t;
+        }
+        if (m_key_comp(key, node_key(t.get()))) {
+            ref_type l = erase_at(t->left, key);
+            if (is_black(t->left)) {
+                return balance_left(l, t->value, t->right);
+            }
+            return make(rb_tree_red, std::move(l), t->right, t->value);
+        }
+        if (m_key_comp(node_key(t.get()), key)) {
+            ref_type r = erase_at(t->right, key);
+            if (is_black(t->right)) {
+                return balance_right(t->left, t->value, r);
+            }
+            return make(rb_tree_red, t->left, std::move(r), t->value);
+        }
+        return append(t->left, t->right);
+    }
+};
+
+// 重载比较操作符
+template <class T, class Compare>
+bool operator==(const persistent_rb_tree<T, Compare> &lhs,
+                const persistent_rb_tree<T, Compare> &rhs) {
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare>
+bool operator!=(const persistent_rb_tree<T, Compare> &lhs,
+                const persistent_rb_tree<T, Compare> &rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef TSTL_SRC_QUEUE_HPP
+#define TSTL_SRC_QUEUE_HPP
+
+#include "iterator.hpp"
+#include "algorithm.hpp"
+#include "deque.hpp"
+#include "vector.hpp"
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tstl {
+
+/**
+ * @brief 先进先出的队列，在 Container 的末尾加入元素，从开头取出元素。
+ *
+ * Container 需要提供 front、back、push_back、emplace_back 与 pop_front，默认为 tstl::deque。
+ */
+template <class T, class Container = tstl::deque<T>>
+class queue {
+
+  public:
+    using container_type = Container;
+    using value_type = typename Container::value_type;
+    using size_type = typename Container::size_type;
+    using reference = typename Container::reference;
+    using const_reference = typename Container::const_reference;
+
+    template <class Alloc>
+    struct uses_allocator : std::uses_allocator<Container, Alloc>::type {};
+
+  protected:
+    Container c;
+
+    template <typename Alloc>
+    using _Uses = typename std::enable_if<uses_allocator<Alloc>::value>::type;
+
+  public:
+    queue() : queue(Container()) {
+    }
+
+    explicit queue(const Container &cont) : c(cont) {
+    }
+
+    explicit queue(Container &&cont) : c(std::move(cont)) {
+    }
+
+    queue(const queue &other) = default;
+
+    queue(queue &&other) = default;
+
+    template <class Alloc, typename = _Uses<Alloc>>
+    explicit queue(const Alloc &alloc) : c(alloc) {
+    }
+
+    template <class Alloc, typename = _Uses<Alloc>>
+    queue(const Container &cont, const Alloc &alloc) : c(cont, alloc) {
+    }
+
+    template <class Alloc, typename = _Uses<Alloc>>
+    queue(Container &&cont, const Alloc &alloc) : c(std::move(cont), alloc) {
+    }
+
+    template <class Alloc, typename = _Uses<Alloc>>
+    queue(const queue &other, const Alloc &alloc) : c(other.c, alloc) {
+    }
+
+    template <class Alloc, typename = _Uses<Alloc>>
+    queue(queue &&other, const Alloc &alloc) : c(std::move(other.c), alloc) {
+    }
+
+    ~queue() = default;
+
+    queue &operator=(const queue &other) = default;
+
+    queue &operator=(queue &&other) = default;
+
+    reference front() {
+        return c.front();
+    }
+
+    const_reference front() const {
+        return c.front();
+    }
+
+    reference back() {
+        return c.back();
+    }
+
+    const_reference back() const {
+        return c.back();
+    }
+
+    bool empty() const {
+        return c.empty();
+    }
+
+    size_type size() const {
+        return c.size();
+    }
+
+    void push(const value_type &value) {
+        c.push_back(value);
+    }
+
+    void push(value_type &&value) {
+        c.push_back(std::move(value));
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args) {
+        c.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop() {
+        c.pop_front();
+    }
+
+    void swap(queue &other) noexcept {
+        tstl::swap(c, other.c);
+    }
+
+    friend bool operator==(const queue &lhs, const queue &rhs) {
+        return lhs.c == rhs.c;
+    }
+
+    friend bool operator!=(const queue &lhs, const queue &rhs) {
+        return !(lhs.c == rhs.c);
+    }
+
+    friend bool operator<(const queue &lhs, const queue &rhs) {
+        return lhs.c < rhs.c;
+    }
+
+    friend bool operator>(const queue &lhs, const queue &rhs) {
+        return rhs.c < lhs.c;
+    }
+
+    friend bool operator<=(const queue &lhs, const queue &rhs) {
+        return !(rhs.c < lhs.c);
+    }
+
+    friend bool operator>=(const queue &lhs, const queue &rhs) {
+        return !(lhs.c < rhs.c);
+    }
+
+    friend void swap(queue &lhs, queue &rhs) {
+        lhs.swap(rhs);
+    }
+};
+
+/**
+ * @brief 优先队列，top() 为按 Compare 最大的元素。
+ *
+ * 元素以 Arity 叉堆存放在 Container 中，Container 需要提供随机访问迭代器、push_back 与 pop_back。
+ * Arity 为 4 时堆的高度减半，一个结点的子结点位于相邻位置，pop 的缓存缺失明显少于二叉堆；
+ * 代价是下沉时每层多几次比较，push 则因层数更少而更快。
+ */
+template <class T, class Container = tstl::vector<T>,
+          class Compare = std::less<typename Container::value_type>, std::size_t Arity = 2>
+class priority_queue {
+    static_assert(Arity >= 2, "priority_queue arity must be at least 2");
+
+  public:
+    using container_type = Container;
+    using value_compare = Compare;
+    using value_type = typename Container::value_type;
+    using size_type = typename Container::size_type;
+    using reference = typename Container::reference;
+    using const_reference = typename Container::const_reference;
+
+    static constexpr std::size_t arity = Arity;
+
+  protected:
+    Container c;
+    Compare comp;
+
+  public:
+    priority_queue() : priority_queue(Compare(), Container()) {
+    }
+
+    explicit priority_queue(const Compare &compare) : priority_queue(compare, Container()) {
+    }
+
+    /**
+     * @brief 以 cont 的内容构造，O(n) 建堆。
+     */
+    priority_queue(const Compare &compare, const Container &cont) : c(cont), comp(compare) {
+        tstl::_dary_make_heap<Arity>(c.begin(), c.end(), comp);
+    }
+
+    priority_queue(const Compare &compare, Container &&cont)
+        : c(std::move(cont)), comp(compare) {
+        tstl::_dary_make_heap<Arity>(c.begin(), c.end(), comp);
+    }
+
+    /**
+     * @brief 以 [first, last) 的内容构造，O(n) 建堆。
+     */
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    priority_queue(InputIt first, InputIt last, const Compare &compare = Compare())
+        : comp(compare) {
+        for (; first != last; ++first) {
+            c.push_back(*first);
+        }
+        tstl::_dary_make_heap<Arity>(c.begin(), c.end(), comp);
+    }
+
+    priority_queue(const priority_queue &other) = default;
+
+    priority_queue(priority_queue &&other) = default;
+
+    priority_queue &operator=(const priority_queue &other) = default;
+
+    priority_queue &operator=(priority_queue &&other) = default;
+
+    const_reference top() const {
+        return c.front();
+    }
+
+    bool empty() const {
+        return c.empty();
+    }
+
+    size_type size() const {
+        return c.size();
+    }
+
+    void push(const value_type &value) {
+        c.push_back(value);
+        tstl::_dary_push_heap<Arity>(c.begin(), c.end(), comp);
+    }
+
+    void push(value_type &&value) {
+        c.push_back(std::move(value));
+        tstl::_dary_push_heap<Arity>(c.begin(), c.end(), comp);
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args) {
+        c.emplace_back(std::forward<Args>(args)...);
+        tstl::_dary_push_heap<Arity>(c.begin(), c.end(), comp);
+    }
+
+    /**
+     * @brief 加入 [first, last) 中的元素。
+     *
+     * 新元素不少于已有元素时，整体重新建堆，O(n + k)；否则逐个上浮，O(k log n)。
+     */
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    void push_range(InputIt first, InputIt last) {
+        const size_type old = c.size();
+        for (; first != last; ++first) {
+            c.push_back(*first);
+        }
+        const size_type added = c.size() - old;
+        if (added >= old) {
+            tstl::_dary_make_heap<Arity>(c.begin(), c.end(), comp);
+        } else {
+            for (size_type i = old + 1; i <= c.size(); ++i) {
+                tstl::_dary_push_heap<Arity>(c.begin(), c.begin() + i, comp);
+            }
+        }
+    }
+
+    void pop() {
+        tstl::_dary_pop_heap<Arity>(c.begin(), c.end(), comp);
+        c.pop_back();
+    }
+
+    void swap(priority_queue &other) noexcept {
+        tstl::swap(c, other.c);
+        tstl::swap(comp, other.comp);
+    }
+
+    friend void swap(priority_queue &lhs, priority_queue &rhs) {
+        lhs.swap(rhs);
+    }
+};
+
+} // namespace tstl
+
+#endif
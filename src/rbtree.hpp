@@ -5,13 +5,31 @@
 // rbTree（红黑树），也是set、map、multiset、multimap的底层
 
 #include <cassert>
+#include <cstdint>
+#include <future>
+#include <limits>
 #include <memory>
+#include <thread>
+#include <type_traits>
 
-#include "memory.h"
+#include "memory/construct.hpp"
+#include "memory/memory_usage.hpp"
 #include "iterator.hpp"
 #include "type_traits.hpp"
 #include "algorithm.hpp"
 
+// 批量查找时同时推进的查找个数，越大越能掩盖访存延迟，但会占用更多寄存器与缓存行
+#ifndef TSTL_RB_TREE_BATCH_SIZE
+#define TSTL_RB_TREE_BATCH_SIZE 16
+#endif
+
+// 提示处理器预取 p 所在的缓存行，不支持的编译器上为空操作
+#if defined(__GNUC__) || defined(__clang__)
+#define TSTL_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define TSTL_PREFETCH(p) ((void)(p))
+#endif
+
 namespace tstl {
 
 template <class T>
@@ -20,6 +38,10 @@ struct is_pair : tstl::false_type {};
 template <class T1, class T2>
 struct is_pair<std::pair<T1, T2>> : tstl::true_type {};
 
+// 比较器声明了 is_transparent 时才启用异构查找
+template <class Compare>
+using _require_transparent = typename Compare::is_transparent;
+
 // rb tree 节点颜色的类型
 
 using rb_tree_color_type = bool;
@@ -110,16 +132,36 @@ struct rb_tree_node_traits {
 
 // rb tree 的基本节点
 
+// 节点都至少按指针对齐，父节点指针的最低位恒为 0，用来存放节点颜色，
+// 这样每个节点只有三个指针大小，不再因为单独的颜色字段多出一个指针的填充
 template <class T>
 struct rb_tree_node_base {
     using color_type = rb_tree_color_type;
     using base_ptr = rb_tree_node_base<T> *;
     using node_ptr = rb_tree_node<T> *;
 
-    base_ptr parent;  // 父节点
-    base_ptr left;    // 左子节点
-    base_ptr right;   // 右子节点
-    color_type color; // 节点颜色
+    std::uintptr_t parent_and_color; // 父节点 | 节点颜色
+    base_ptr left;                   // 左子节点
+    base_ptr right;                  // 右子节点
+
+    base_ptr parent() const noexcept {
+        return reinterpret_cast<base_ptr>(parent_and_color & ~std::uintptr_t(1));
+    }
+    void set_parent(base_ptr p) noexcept {
+        parent_and_color = reinterpret_cast<std::uintptr_t>(p) | (parent_and_color & 1);
+    }
+    color_type color() const noexcept {
+        return static_cast<color_type>(parent_and_color & 1);
+    }
+    void set_color(color_type c) noexcept {
+        parent_and_color = (parent_and_color & ~std::uintptr_t(1)) | static_cast<std::uintptr_t>(c);
+    }
+    // 清空所有链接，颜色置为红色
+    void reset() noexcept {
+        parent_and_color = 0;
+        left = nullptr;
+        right = nullptr;
+    }
 
     base_ptr get_base_ptr() {
         return &*this;
@@ -187,10 +229,10 @@ struct rb_tree_iterator_base
         if (node->right != nullptr) {
             node = rb_tree_min(node->right);
         } else { // 如果没有右子节点
-            auto y = node->parent;
+            auto y = node->parent();
             while (y->right == node) {
                 node = y;
-                y = y->parent;
+                y = y->parent();
             }
             // 应对“寻找根节点的下一节点，而根节点没有右子节点”的特殊情况
             if (node->right != y)
@@ -200,24 +242,24 @@ struct rb_tree_iterator_base
 
     // 迭代器的前驱
     void dec() {
-        if (node->parent->parent == node && rb_tree_is_red(node)) { // 如果 node 为 header
+        if (node->parent()->parent() == node && rb_tree_is_red(node)) { // 如果 node 为 header
             node = node->right;                                     // 指向整棵树的 max 节点
         } else if (node->left != nullptr) {
             node = rb_tree_max(node->left);
         } else { // 非 header 节点，也无左子节点
-            auto y = node->parent;
+            auto y = node->parent();
             while (node == y->left) {
                 node = y;
-                y = y->parent;
+                y = y->parent();
             }
             node = y;
         }
     }
 
-    bool operator==(const rb_tree_iterator_base &rhs) {
+    bool operator==(const rb_tree_iterator_base &rhs) const {
         return node == rhs.node;
     }
-    bool operator!=(const rb_tree_iterator_base &rhs) {
+    bool operator!=(const rb_tree_iterator_base &rhs) const {
         return node != rhs.node;
     }
 };
@@ -254,6 +296,7 @@ struct rb_tree_iterator : public rb_tree_iterator_base<T> {
     rb_tree_iterator(const const_iterator &rhs) {
         node = rhs.node;
     }
+    iterator &operator=(const iterator &rhs) = default;
 
     // 重载操作符
     reference operator*() const {
@@ -314,6 +357,7 @@ struct rb_tree_const_iterator : public rb_tree_iterator_base<T> {
     rb_tree_const_iterator(const const_iterator &rhs) {
         node = rhs.node;
     }
+    const_iterator &operator=(const const_iterator &rhs) = default;
 
     // 重载操作符
     reference operator*() const {
@@ -343,6 +387,134 @@ struct rb_tree_const_iterator : public rb_tree_iterator_base<T> {
     }
 };
 
+// 红黑树的结点句柄，持有一个从树中摘下的结点，可再次插入到同类型的树中而无需重新分配
+// 句柄非空时同时持有树的分配器，用于在句柄析构时销毁结点
+template <class T, class Allocator = std::allocator<T>>
+class rb_tree_node_handle {
+  public:
+    using value_traits = rb_tree_value_traits<T>;
+    using key_type = typename value_traits::key_type;
+    using mapped_type = typename value_traits::mapped_type;
+    using value_type = typename value_traits::value_type;
+    using allocator_type = Allocator;
+
+    using node_type = typename rb_tree_traits<T>::node_type;
+    using node_ptr = typename rb_tree_traits<T>::node_ptr;
+
+  private:
+    using node_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+    using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+  public:
+    // 构造、移动、析构函数
+    rb_tree_node_handle() noexcept : m_node(nullptr) {
+    }
+
+    rb_tree_node_handle(rb_tree_node_handle &&rhs) noexcept : m_node(rhs.m_node) {
+        if (m_node != nullptr) {
+            ::new (static_cast<void *>(std::addressof(m_alloc)))
+                node_allocator(std::move(rhs.m_alloc));
+            rhs.reset_alloc();
+            rhs.m_node = nullptr;
+        }
+    }
+
+    rb_tree_node_handle &operator=(rb_tree_node_handle &&rhs) noexcept {
+        if (this != &rhs) {
+            destroy();
+            m_node = rhs.m_node;
+            if (m_node != nullptr) {
+                ::new (static_cast<void *>(std::addressof(m_alloc)))
+                    node_allocator(std::move(rhs.m_alloc));
+                rhs.reset_alloc();
+                rhs.m_node = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    rb_tree_node_handle(const rb_tree_node_handle &) = delete;
+    rb_tree_node_handle &operator=(const rb_tree_node_handle &) = delete;
+
+    ~rb_tree_node_handle() {
+        destroy();
+    }
+
+    // 接口
+    bool empty() const noexcept {
+        return m_node == nullptr;
+    }
+    explicit operator bool() const noexcept {
+        return m_node != nullptr;
+    }
+    // 要求句柄非空
+    allocator_type get_allocator() const {
+        return allocator_type(m_alloc);
+    }
+
+    value_type &value() const {
+        return m_node->value;
+    }
+    // 结点已不在树中，允许修改键值
+    key_type &key() const {
+        return const_cast<key_type &>(value_traits::get_key(m_node->value));
+    }
+    mapped_type &mapped() const {
+        return m_node->value.second;
+    }
+
+    void swap(rb_tree_node_handle &rhs) noexcept {
+        if (m_node != nullptr && rhs.m_node != nullptr) {
+            tstl::swap(m_alloc, rhs.m_alloc);
+        } else if (m_node != nullptr) {
+            ::new (static_cast<void *>(std::addressof(rhs.m_alloc)))
+                node_allocator(std::move(m_alloc));
+            reset_alloc();
+        } else if (rhs.m_node != nullptr) {
+            ::new (static_cast<void *>(std::addressof(m_alloc)))
+                node_allocator(std::move(rhs.m_alloc));
+            rhs.reset_alloc();
+        }
+        tstl::swap(m_node, rhs.m_node);
+    }
+
+  private:
+    template <class, class, class>
+    friend class rb_tree;
+
+    rb_tree_node_handle(node_ptr p, const node_allocator &alloc) noexcept : m_node(p) {
+        ::new (static_cast<void *>(std::addressof(m_alloc))) node_allocator(alloc);
+    }
+
+    // 交出结点的所有权
+    node_ptr release() noexcept {
+        node_ptr p = m_node;
+        m_node = nullptr;
+        reset_alloc();
+        return p;
+    }
+
+    void reset_alloc() noexcept {
+        tstl::destroy_at(std::addressof(m_alloc));
+    }
+
+    void destroy() {
+        if (m_node != nullptr) {
+            node_alloc_traits::destroy(m_alloc, std::addressof(m_node->value));
+            node_alloc_traits::deallocate(m_alloc, m_node, 1);
+            m_node = nullptr;
+            reset_alloc();
+        }
+    }
+
+    node_ptr m_node;
+    // 分配器不一定可默认构造，仅在 m_node 非空时有效
+    union {
+        node_allocator m_alloc;
+    };
+};
+
 // 方便调用的函数
 template <class NodePtr>
 NodePtr rb_tree_min(NodePtr x) noexcept {
@@ -360,19 +532,19 @@ NodePtr rb_tree_max(NodePtr x) noexcept {
 }
 template <class NodePtr>
 bool rb_tree_is_lchild(NodePtr node) noexcept {
-    return node == node->parent->left;
+    return node == node->parent()->left;
 }
 template <class NodePtr>
 bool rb_tree_is_red(NodePtr node) noexcept {
-    return node->color == rb_tree_red;
+    return node->color() == rb_tree_red;
 }
 template <class NodePtr>
-void rb_tree_set_black(NodePtr &node) noexcept {
-    node->color = rb_tree_black;
+void rb_tree_set_black(NodePtr node) noexcept {
+    node->set_color(rb_tree_black);
 }
 template <class NodePtr>
-void rb_tree_set_red(NodePtr &node) noexcept {
-    node->color = rb_tree_red;
+void rb_tree_set_red(NodePtr node) noexcept {
+    node->set_color(rb_tree_red);
 }
 template <class NodePtr>
 NodePtr rb_tree_next(NodePtr node) noexcept {
@@ -380,56 +552,54 @@ NodePtr rb_tree_next(NodePtr node) noexcept {
         return rb_tree_min(node->right);
     }
     while (!rb_tree_is_lchild(node)) {
-        node = node->parent;
+        node = node->parent();
+    }
+    return node->parent();
+}
+
+// 用 y 顶替 x 在其父节点中的位置，header 的父节点即为根节点
+template <class NodePtr>
+void rb_tree_replace_child(NodePtr x, NodePtr y, NodePtr header) noexcept {
+    if (x == header->parent()) { // 如果 x 为根节点，让 y 顶替 x 成为根节点
+        header->set_parent(y);
+    } else if (rb_tree_is_lchild(x)) { // 如果 x 是左子节点
+        x->parent()->left = y;
+    } else { // 如果 x 是右子节点
+        x->parent()->right = y;
     }
-    return node->parent;
 }
 
-// 左旋，（左旋点，根节点）
+// 左旋，（左旋点，头节点）
 template <class NodePtr>
-void rb_tree_rotate_left(NodePtr x, NodePtr &root) noexcept {
+void rb_tree_rotate_left(NodePtr x, NodePtr header) noexcept {
     auto y = x->right; // y 为 x 的右子节点
     x->right = y->left;
     if (y->left != nullptr) {
-        y->left->parent = x;
-    }
-    y->parent = x->parent;
-
-    if (x == root) { // 如果 x 为根节点，让 y 顶替 x 成为根节点
-        root = y;
-    } else if (rb_tree_is_lchild(x)) { // 如果 x 是左子节点
-        x->parent->left = y;
-    } else { // 如果 x 是右子节点
-        x->parent->right = y;
+        y->left->set_parent(x);
     }
+    y->set_parent(x->parent());
+    rb_tree_replace_child(x, y, header);
     // 调整 x 与 y 的关系
     y->left = x;
-    x->parent = y;
+    x->set_parent(y);
 }
 
-// 右旋，(右旋点，根节点)
+// 右旋，(右旋点，头节点)
 template <class NodePtr>
-void rb_tree_rotate_right(NodePtr x, NodePtr &root) noexcept {
+void rb_tree_rotate_right(NodePtr x, NodePtr header) noexcept {
     auto y = x->left;
     x->left = y->right;
     if (y->right) {
-        y->right->parent = x;
-    }
-    y->parent = x->parent;
-
-    if (x == root) { // 如果 x 为根节点，让 y 顶替 x 成为根节点
-        root = y;
-    } else if (rb_tree_is_lchild(x)) { // 如果 x 是右子节点
-        x->parent->left = y;
-    } else { // 如果 x 是左子节点
-        x->parent->right = y;
+        y->right->set_parent(x);
     }
+    y->set_parent(x->parent());
+    rb_tree_replace_child(x, y, header);
     // 调整 x 与 y 的关系
     y->right = x;
-    x->parent = y;
+    x->set_parent(y);
 }
 
-// 插入节点后使 rb tree 重新平衡，参数一为新增节点，参数二为根节点
+// 插入节点后使 rb tree 重新平衡，参数一为新增节点，参数二为头节点
 //
 // case 1: 新增节点位于根节点，令新增节点为黑
 // case 2: 新增节点的父节点为黑，没有破坏平衡，直接返回
@@ -441,56 +611,63 @@ void rb_tree_rotate_right(NodePtr x, NodePtr &root) noexcept {
 // case 5: 父节点为红，叔叔节点为 NIL
 // 或黑色，父节点为左（右）孩子，当前节点为左（右）孩子，
 //         让父节点变为黑色，祖父节点变为红色，以祖父节点为支点右（左）旋
-// 插入平衡函数
+// 插入平衡函数，返回整棵树的黑高是否加一
 template <class NodePtr>
-void rb_tree_insert_rebalance(NodePtr x, NodePtr &root) noexcept {
+bool rb_tree_insert_rebalance(NodePtr x, NodePtr header) noexcept {
     rb_tree_set_red(x); // 新增节点为红色
-    while (x != root && rb_tree_is_red(x->parent)) {
-        if (rb_tree_is_lchild(x->parent)) { // 如果父节点是左子节点
-            auto uncle = x->parent->parent->right;
+    while (x != header->parent() && rb_tree_is_red(x->parent())) {
+        NodePtr xp = x->parent();
+        NodePtr xpp = xp->parent();
+        if (rb_tree_is_lchild(xp)) { // 如果父节点是左子节点
+            auto uncle = xpp->right;
             if (uncle != nullptr && rb_tree_is_red(uncle)) { // case 3: 父节点和叔叔节点都为红
-                rb_tree_set_black(x->parent);
+                rb_tree_set_black(xp);
                 rb_tree_set_black(uncle);
-                x = x->parent->parent;
+                x = xpp;
                 rb_tree_set_red(x);
             } else {                         // 无叔叔节点或叔叔节点为黑
                 if (!rb_tree_is_lchild(x)) { // case 4: 当前节点 x 为右子节点
-                    x = x->parent;
-                    rb_tree_rotate_left(x, root);
+                    x = xp;
+                    rb_tree_rotate_left(x, header);
                 }
                 // 都转换成 case 5： 当前节点为左子节点
-                rb_tree_set_black(x->parent);
-                rb_tree_set_red(x->parent->parent);
-                rb_tree_rotate_right(x->parent->parent, root);
+                rb_tree_set_black(x->parent());
+                rb_tree_set_red(xpp);
+                rb_tree_rotate_right(xpp, header);
                 break;
             }
         } else { // 如果父节点是右子节点，对称处理
-            auto uncle = x->parent->parent->left;
+            auto uncle = xpp->left;
             if (uncle != nullptr && rb_tree_is_red(uncle)) { // case 3: 父节点和叔叔节点都为红
-                rb_tree_set_black(x->parent);
+                rb_tree_set_black(xp);
                 rb_tree_set_black(uncle);
-                x = x->parent->parent;
+                x = xpp;
                 rb_tree_set_red(x);
                 // 此时祖父节点为红，可能会破坏红黑树的性质，令当前节点为祖父节点，继续处理
             } else {                        // 无叔叔节点或叔叔节点为黑
                 if (rb_tree_is_lchild(x)) { // case 4: 当前节点 x 为左子节点
-                    x = x->parent;
-                    rb_tree_rotate_right(x, root);
+                    x = xp;
+                    rb_tree_rotate_right(x, header);
                 }
                 // 都转换成 case 5： 当前节点为左子节点
-                rb_tree_set_black(x->parent);
-                rb_tree_set_red(x->parent->parent);
-                rb_tree_rotate_left(x->parent->parent, root);
+                rb_tree_set_black(x->parent());
+                rb_tree_set_red(xpp);
+                rb_tree_rotate_left(xpp, header);
                 break;
             }
         }
     }
-    rb_tree_set_black(root); // 根节点永远为黑
+    // 此时根节点若为红，说明调整一直进行到了根节点，将其染黑后整棵树的黑高加一
+    bool grown = rb_tree_is_red(header->parent());
+    rb_tree_set_black(header->parent()); // 根节点永远为黑
+    return grown;
 }
 
-// 删除节点后的自平衡
+// 删除节点后的自平衡，header 的左右子节点分别为最左与最右节点
 template <class NodePtr>
-NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, NodePtr &rightmost) {
+NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr header) {
+    NodePtr &leftmost = header->left;
+    NodePtr &rightmost = header->right;
     // y 是可能的替换节点，指向最终要删除的节点
     auto y = (z->left == nullptr || z->right == nullptr) ? z : rb_tree_next(z);
     // x 是 y 的一个独子节点或 NIL 节点
@@ -501,50 +678,40 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, Nod
     // y != z 说明 z 有两个非空子节点，此时 y 指向 z 右子树的最左节点，x 指向 y
     // 的右子节点。 用 y 顶替 z 的位置，用 x 顶替 y 的位置，最后用 y 指向 z
     if (y != z) {
-        z->left->parent = y;
+        z->left->set_parent(y);
         y->left = z->left;
 
         // 如果 y 不是 z 的右子节点，那么 z 的右子节点一定有左孩子
         if (y != z->right) { // x 替换 y 的位置
-            xp = y->parent;
+            xp = y->parent();
             if (x != nullptr) {
-                x->parent = y->parent;
+                x->set_parent(y->parent());
             }
 
-            y->parent->left = x;
+            y->parent()->left = x;
             y->right = z->right;
-            z->right->parent = y;
+            z->right->set_parent(y);
         } else {
             xp = y;
         }
 
         // 连接 y 与 z 的父节点
-        if (root == z) {
-            root = y;
-        } else if (rb_tree_is_lchild(z)) {
-            z->parent->left = y;
-        } else {
-            z->parent->right = y;
-        }
-        y->parent = z->parent;
-        tstl::swap(y->color, z->color);
+        rb_tree_replace_child(z, y, header);
+        y->set_parent(z->parent());
+        auto y_color = y->color();
+        y->set_color(z->color());
+        z->set_color(y_color);
         y = z;
     }
     // y == z 说明 z 至多只有一个孩子
     else {
-        xp = y->parent;
+        xp = y->parent();
         if (x) {
-            x->parent = y->parent;
+            x->set_parent(y->parent());
         }
 
         // 连接 x 与 z 的父节点
-        if (root == z) {
-            root = x;
-        } else if (rb_tree_is_lchild(z)) {
-            z->parent->left = x;
-        } else {
-            z->parent->right = x;
-        }
+        rb_tree_replace_child(z, x, header);
 
         // 此时 z 有可能是最左节点或最右节点，更新数据
         if (leftmost == z) {
@@ -567,13 +734,13 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, Nod
     // 兄弟节点为黑色，右子节点为红色，令兄弟节点为父节点的颜色，父节点为黑色，兄弟节点的右子节点
     //         为黑色，以父节点为支点左（右）旋，树的性质调整完成，算法结束
     if (!rb_tree_is_red(y)) { // x 为黑色时，调整，否则直接将 x 变为黑色即可
-        while (x != root && (x == nullptr || !rb_tree_is_red(x))) {
+        while (x != header->parent() && (x == nullptr || !rb_tree_is_red(x))) {
             if (x == xp->left) { // 如果 x 为左子节点
                 auto brother = xp->right;
                 if (rb_tree_is_red(brother)) { // case 1
                     rb_tree_set_black(brother);
                     rb_tree_set_red(xp);
-                    rb_tree_rotate_left(xp, root);
+                    rb_tree_rotate_left(xp, header);
                     brother = xp->right;
                 }
                 // case 1 转为为了 case 2、3、4 中的一种
@@ -581,23 +748,23 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, Nod
                     (brother->right == nullptr || !rb_tree_is_red(brother->right))) { // case 2
                     rb_tree_set_red(brother);
                     x = xp;
-                    xp = xp->parent;
+                    xp = xp->parent();
                 } else {
                     if (brother->right == nullptr || !rb_tree_is_red(brother->right)) { // case 3
                         if (brother->left != nullptr) {
                             rb_tree_set_black(brother->left);
                         }
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_right(brother, root);
+                        rb_tree_rotate_right(brother, header);
                         brother = xp->right;
                     }
                     // 转为 case 4
-                    brother->color = xp->color;
+                    brother->set_color(xp->color());
                     rb_tree_set_black(xp);
                     if (brother->right != nullptr) {
                         rb_tree_set_black(brother->right);
                     }
-                    rb_tree_rotate_left(xp, root);
+                    rb_tree_rotate_left(xp, header);
                     break;
                 }
             } else { // x 为右子节点，对称处理
@@ -605,30 +772,30 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, Nod
                 if (rb_tree_is_red(brother)) { // case 1
                     rb_tree_set_black(brother);
                     rb_tree_set_red(xp);
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right(xp, header);
                     brother = xp->left;
                 }
                 if ((brother->left == nullptr || !rb_tree_is_red(brother->left)) &&
                     (brother->right == nullptr || !rb_tree_is_red(brother->right))) { // case 2
                     rb_tree_set_red(brother);
                     x = xp;
-                    xp = xp->parent;
+                    xp = xp->parent();
                 } else {
                     if (brother->left == nullptr || !rb_tree_is_red(brother->left)) { // case 3
                         if (brother->right != nullptr) {
                             rb_tree_set_black(brother->right);
                         }
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_left(brother, root);
+                        rb_tree_rotate_left(brother, header);
                         brother = xp->left;
                     }
                     // 转为 case 4
-                    brother->color = xp->color;
+                    brother->set_color(xp->color());
                     rb_tree_set_black(xp);
                     if (brother->left != nullptr) {
                         rb_tree_set_black(brother->left);
                     }
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right(xp, header);
                     break;
                 }
             }
@@ -640,8 +807,144 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr &root, NodePtr &leftmost, Nod
     return y;
 }
 
-// 模板类 rb_tree（数据类型，比较类型）
-template <class T, class Compare>
+// 以下函数用于基于 join 的集合操作，操作对象是脱离了头节点的子树，子树根的父指针没有意义
+// 子树的黑高随子树一起传递，避免每次连接都重新计算
+
+// 黑高：从 x 到 NIL 的路径上黑色节点的个数，NIL 的黑高为 0
+template <class NodePtr>
+int rb_tree_black_height(NodePtr x) noexcept {
+    int h = 0;
+    for (; x != nullptr; x = x->left) {
+        if (!rb_tree_is_red(x)) {
+            ++h;
+        }
+    }
+    return h;
+}
+
+// 子树的根及其黑高
+template <class NodePtr>
+struct rb_tree_subtree {
+    NodePtr root;
+    int height;
+};
+
+// 黑高为 h 的子树 x 的左右孩子的黑高
+template <class NodePtr>
+int rb_tree_child_height(NodePtr x, int h) noexcept {
+    return rb_tree_is_red(x) ? h : h - 1;
+}
+
+// 用 k 连接 l 与 r 两棵子树，要求 l 中所有节点 <= k <= r 中所有节点，返回新的子树
+// 沿较高一侧子树的右（左）链下降到黑高与另一侧相同的黑色节点 c，以红色的 k 顶替 c，
+// c 与较矮的子树分别成为 k 的左右孩子，此时只可能出现红红冲突，交给插入平衡函数处理
+template <class NodePtr>
+rb_tree_subtree<NodePtr> rb_tree_join(rb_tree_subtree<NodePtr> l, NodePtr k,
+                                      rb_tree_subtree<NodePtr> r) noexcept {
+    // 先把两侧的根染黑，保证插入平衡函数不会越过根节点
+    if (l.root != nullptr && rb_tree_is_red(l.root)) {
+        rb_tree_set_black(l.root);
+        ++l.height;
+    }
+    if (r.root != nullptr && rb_tree_is_red(r.root)) {
+        rb_tree_set_black(r.root);
+        ++r.height;
+    }
+    if (l.height == r.height) {
+        k->left = l.root;
+        k->right = r.root;
+        if (l.root != nullptr) {
+            l.root->set_parent(k);
+        }
+        if (r.root != nullptr) {
+            r.root->set_parent(k);
+        }
+        k->set_parent(nullptr);
+        rb_tree_set_black(k);
+        return {k, l.height + 1};
+    }
+
+    // 临时的头节点，只用到其父指针指向根
+    typename std::remove_pointer<NodePtr>::type header;
+    header.reset();
+    NodePtr hp = &header;
+    NodePtr p = nullptr;
+    int height;
+    if (l.height > r.height) {
+        height = l.height;
+        hp->set_parent(l.root);
+        l.root->set_parent(hp);
+        NodePtr c = l.root;
+        int h = l.height;
+        while (c != nullptr && (rb_tree_is_red(c) || h != r.height)) {
+            h = rb_tree_child_height(c, h);
+            p = c;
+            c = c->right;
+        }
+        k->left = c;
+        k->right = r.root;
+        p->right = k;
+    } else {
+        height = r.height;
+        hp->set_parent(r.root);
+        r.root->set_parent(hp);
+        NodePtr c = r.root;
+        int h = r.height;
+        while (c != nullptr && (rb_tree_is_red(c) || h != l.height)) {
+            h = rb_tree_child_height(c, h);
+            p = c;
+            c = c->left;
+        }
+        k->left = l.root;
+        k->right = c;
+        p->left = k;
+    }
+    k->set_parent(p);
+    if (k->left != nullptr) {
+        k->left->set_parent(k);
+    }
+    if (k->right != nullptr) {
+        k->right->set_parent(k);
+    }
+    if (rb_tree_insert_rebalance(k, hp)) {
+        ++height;
+    }
+    NodePtr root = hp->parent();
+    root->set_parent(nullptr);
+    return {root, height};
+}
+
+// 摘下子树 x 中的最大节点，返回剩余的子树与该节点
+template <class NodePtr>
+std::pair<rb_tree_subtree<NodePtr>, NodePtr>
+rb_tree_split_last(rb_tree_subtree<NodePtr> x) noexcept {
+    NodePtr k = x.root;
+    int h = rb_tree_child_height(k, x.height);
+    rb_tree_subtree<NodePtr> l = {k->left, h};
+    if (k->right == nullptr) {
+        return std::make_pair(l, k);
+    }
+    auto rest = rb_tree_split_last(rb_tree_subtree<NodePtr>{k->right, h});
+    return std::make_pair(rb_tree_join(l, k, rest.first), rest.second);
+}
+
+// 连接 l 与 r 两棵子树，要求 l 中所有节点 <= r 中所有节点，以 l 中的最大节点作为连接点
+template <class NodePtr>
+rb_tree_subtree<NodePtr> rb_tree_join2(rb_tree_subtree<NodePtr> l,
+                                       rb_tree_subtree<NodePtr> r) noexcept {
+    if (l.root == nullptr) {
+        return r;
+    }
+    if (r.root == nullptr) {
+        return l;
+    }
+    auto rest = rb_tree_split_last(l);
+    return rb_tree_join(rest.first, rest.second, r);
+}
+
+// 模板类 rb_tree（数据类型，比较类型，分配器类型）
+// 结点的摘取、合并、连接与集合操作直接搬移结点，要求参与的两棵树分配器相等
+template <class T, class Compare, class Allocator = std::allocator<T>>
 class rb_tree {
   public:
     using tree_traits = rb_tree_traits<T>;
@@ -656,25 +959,26 @@ class rb_tree {
     using value_type = typename tree_traits::value_type;
     using key_compare = Compare;
 
-    using allocator_type = std::allocator<T>;
-    using data_allocator = std::allocator<T>;
-    using base_allocator = std::allocator<base_type>;
-    using node_allocator = std::allocator<node_type>;
+    using allocator_type = Allocator;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_allocator = typename alloc_traits::template rebind_alloc<node_type>;
+    using node_alloc_traits = std::allocator_traits<node_allocator>;
 
-    using pointer = typename allocator_type::pointer;
-    using const_pointer = typename allocator_type::const_pointer;
-    using reference = typename allocator_type::reference;
-    using const_reference = typename allocator_type::const_reference;
-    using size_type = typename allocator_type::size_type;
-    using difference_type = typename allocator_type::difference_type;
+    using pointer = typename alloc_traits::pointer;
+    using const_pointer = typename alloc_traits::const_pointer;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
 
     using iterator = rb_tree_iterator<T>;
     using const_iterator = rb_tree_const_iterator<T>;
     using reverse_iterator = tstl::reverse_iterator<iterator>;
     using const_reverse_iterator = typename tstl::reverse_iterator<const_iterator>;
+    using node_handle = rb_tree_node_handle<T, Allocator>;
 
     allocator_type get_allocator() const {
-        return m_node_alloc;
+        return allocator_type(m_node_alloc);
     }
     key_compare key_comp() const {
         return m_key_comp;
@@ -682,24 +986,39 @@ class rb_tree {
 
   private:
     // 用以下三个数据表现 rb tree
-    base_ptr m_header;      // 特殊节点，与根节点互为对方的父节点
+    base_type m_header;     // 特殊节点，与根节点互为对方的父节点，直接内嵌在树中，无需单独分配
     size_type m_node_count; // 节点数
     key_compare m_key_comp; // 节点键值比较的准则
-    allocator_type m_alloc; // 四种类型的分配器
-    data_allocator m_data_alloc;
-    base_allocator m_base_alloc;
     node_allocator m_node_alloc;
 
+    using subtree = rb_tree_subtree<base_ptr>; // 集合操作中传递的子树及其黑高
+
   private:
-    // 以下三个函数用于取得根节点，最小节点和最大节点
-    base_ptr &root() const {
-        return m_header->parent;
+    // 分配器不相等时把 rhs 的元素逐个移入（移动可能抛出异常时复制）本树，键值相等的排在已有元素之后
+    // 每转移一个元素就从 rhs 中删除，抛出异常时已转移的元素留在本树，其余仍完好地留在 rhs
+    void transfer_values(rb_tree &rhs) {
+        while (rhs.m_node_count != 0) {
+            iterator first = rhs.begin();
+            emplace_multi(std::move_if_noexcept(*first));
+            rhs.erase(first);
+        }
+    }
+
+    // 以下函数用于取得头节点，根节点，最小节点和最大节点
+    base_ptr header() const noexcept {
+        return const_cast<base_ptr>(&m_header);
+    }
+    base_ptr root() const noexcept {
+        return m_header.parent();
     }
-    base_ptr &leftmost() const {
-        return m_header->left;
+    void set_root(base_ptr x) noexcept {
+        m_header.set_parent(x);
     }
-    base_ptr &rightmost() const {
-        return m_header->right;
+    base_ptr &leftmost() const noexcept {
+        return header()->left;
+    }
+    base_ptr &rightmost() const noexcept {
+        return header()->right;
     }
 
   public:
@@ -708,29 +1027,50 @@ class rb_tree {
         rb_tree_init();
     }
 
-    rb_tree(const rb_tree &rhs) {
+    explicit rb_tree(const allocator_type &alloc) : m_key_comp(), m_node_alloc(alloc) {
+        rb_tree_init();
+    }
+
+    rb_tree(const key_compare &comp, const allocator_type &alloc)
+        : m_key_comp(comp), m_node_alloc(alloc) {
+        rb_tree_init();
+    }
+
+    rb_tree(const rb_tree &rhs)
+        : rb_tree(rhs, alloc_traits::select_on_container_copy_construction(rhs.get_allocator())) {
+    }
+
+    rb_tree(const rb_tree &rhs, const allocator_type &alloc)
+        : m_key_comp(rhs.m_key_comp), m_node_alloc(alloc) {
         rb_tree_init();
         if (rhs.m_node_count != 0) {
-            root() = copy_from(rhs.root(), m_header);
+            set_root(copy_from(rhs.root(), header()));
             leftmost() = rb_tree_min(root());
             rightmost() = rb_tree_max(root());
         }
         m_node_count = rhs.m_node_count;
-        m_key_comp = rhs.m_key_comp;
     }
 
     rb_tree(rb_tree &&rhs) noexcept
-        : m_header(std::move(rhs.m_header)), m_node_count(rhs.m_node_count),
-          m_key_comp(rhs.m_key_comp) {
-        rhs.reset();
+        : m_key_comp(rhs.m_key_comp), m_node_alloc(std::move(rhs.m_node_alloc)) {
+        rb_tree_init();
+        take_nodes(rhs);
+    }
+
+    rb_tree(rb_tree &&rhs, const allocator_type &alloc)
+        : m_key_comp(rhs.m_key_comp), m_node_alloc(alloc) {
+        rb_tree_init();
+        move_assign(rhs, std::false_type());
     }
 
     rb_tree &operator=(const rb_tree &rhs) {
         if (this != &rhs) {
             clear();
+            assign_alloc(rhs.m_node_alloc,
+                         typename node_alloc_traits::propagate_on_container_copy_assignment());
 
             if (rhs.m_node_count != 0) {
-                root() = copy_from(rhs.root(), m_header);
+                set_root(copy_from(rhs.root(), header()));
                 leftmost() = rb_tree_min(root());
                 rightmost() = rb_tree_max(root());
             }
@@ -740,19 +1080,20 @@ class rb_tree {
         }
         return *this;
     }
-    rb_tree &operator=(rb_tree &&rhs) {
-        clear();
-        m_header = std::move(rhs.m_header);
-        m_node_count = rhs.m_node_count;
-        m_key_comp = rhs.m_key_comp;
-        rhs.reset();
+    rb_tree &operator=(rb_tree &&rhs) noexcept(
+        (node_alloc_traits::propagate_on_container_move_assignment::value ||
+         node_alloc_traits::is_always_equal::value) &&
+        std::is_nothrow_copy_assignable<key_compare>::value) {
+        if (this != &rhs) {
+            clear();
+            m_key_comp = rhs.m_key_comp;
+            move_assign(rhs, typename node_alloc_traits::propagate_on_container_move_assignment());
+        }
         return *this;
     }
 
     ~rb_tree() {
         clear();
-        m_base_alloc.destroy(m_header);
-        m_base_alloc.deallocate(m_header, 1);
     }
 
   public:
@@ -764,10 +1105,10 @@ class rb_tree {
         return leftmost();
     }
     iterator end() noexcept {
-        return m_header;
+        return header();
     }
     const_iterator end() const noexcept {
-        return m_header;
+        return header();
     }
 
     reverse_iterator rbegin() noexcept {
@@ -806,6 +1147,13 @@ class rb_tree {
     size_type max_size() const noexcept {
         return static_cast<size_type>(-1);
     }
+    // 结点中的指针与颜色、内嵌在树中的头结点计入额外开销
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = m_node_count * sizeof(value_type);
+        usage.overhead = sizeof(*this) + m_node_count * (sizeof(node_type) - sizeof(value_type));
+        return usage;
+    }
 
     // 插入删除相关操作
 
@@ -830,33 +1178,13 @@ class rb_tree {
 
     template <class... Args>
     iterator emplace_multi_use_hint(iterator hint, Args &&...args) {
-        node_ptr np = create_node(std::forward<Args>(args)...);
-        if (m_node_count == 0) {
-            return insert_node_at(m_header, np, true);
-        }
-        key_type key = value_traits::get_key(np->value);
-        if (hint == begin()) { // 位于 begin 处
-            if (m_key_comp(key, value_traits::get_key(*hint))) {
-                return insert_node_at(hint.node, np, true);
-            } else {
-                auto pos = get_insert_multi_pos(key);
-                return insert_node_at(pos.first, np, pos.second);
-            }
-        } else if (hint == end()) { // 位于 end 处
-            if (!m_key_comp(key, value_traits::get_key(rightmost()->get_node_ptr()->value))) {
-                return insert_node_at(rightmost(), np, false);
-            } else {
-                auto pos = get_insert_multi_pos(key);
-                return insert_node_at(pos.first, np, pos.second);
-            }
-        }
-        return insert_multi_use_hint(hint, key, np);
+        return insert_node_multi_use_hint(hint, create_node(std::forward<Args>(args)...));
     }
     template <class... Args>
     iterator emplace_unique_use_hint(iterator hint, Args &&...args) {
         node_ptr np = create_node(std::forward<Args>(args)...);
         if (m_node_count == 0) {
-            return insert_node_at(m_header, np, true);
+            return insert_node_at(header(), np, true);
         }
         key_type key = value_traits::get_key(np->value);
         if (hint == begin()) { // 位于 begin 处
@@ -942,7 +1270,7 @@ class rb_tree {
         iterator next(node);
         ++next;
 
-        rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
+        rb_tree_erase_rebalance(hint.node, header());
         destroy_node(node);
         --m_node_count;
         return next;
@@ -973,45 +1301,253 @@ class rb_tree {
             }
         }
     }
-    // 递归清空
+    // 结点句柄相关操作，摘下与插回结点都只修改指针，不分配也不释放内存
+    node_handle extract(const_iterator position) {
+        base_ptr node = position.node;
+        rb_tree_erase_rebalance(node, header());
+        --m_node_count;
+        node->reset();
+        return node_handle(node->get_node_ptr(), m_node_alloc);
+    }
+
+    node_handle extract(const key_type &key) {
+        auto it = find(key);
+        return it == end() ? node_handle() : extract(it);
+    }
+
+    iterator insert_node_multi(node_handle &&nh) {
+        if (nh.empty()) {
+            return end();
+        }
+        node_ptr np = nh.release();
+        auto res = get_insert_multi_pos(value_traits::get_key(np->value));
+        return insert_node_at(res.first, np, res.second);
+    }
+
+    iterator insert_node_multi(iterator hint, node_handle &&nh) {
+        if (nh.empty()) {
+            return end();
+        }
+        return insert_node_multi_use_hint(hint, nh.release());
+    }
+
+    // 插入失败时结点仍留在 nh 中
+    std::pair<iterator, bool> insert_node_unique(node_handle &&nh) {
+        if (nh.empty()) {
+            return std::make_pair(end(), false);
+        }
+        auto res = get_insert_unique_pos(value_traits::get_key(nh.value()));
+        if (res.second) {
+            return std::make_pair(insert_node_at(res.first.first, nh.release(), res.first.second),
+                                  true);
+        }
+        return std::make_pair(iterator(res.first.first), false);
+    }
+
+    // 将 source 的全部结点按序转移到本树中，键值相等的结点排在已有结点之后
+    void merge_multi(rb_tree &source) {
+        if (this == &source || source.m_node_count == 0) {
+            return;
+        }
+        if (!(m_node_alloc == source.m_node_alloc)) {
+            transfer_values(source);
+            return;
+        }
+        if (m_node_count == 0) {
+            swap(source);
+            return;
+        }
+        base_ptr x = source.root();
+        source.rb_tree_init();
+        try {
+            // 边右旋边中序遍历，被访问的结点都已脱离剩余的子树，无需额外的栈
+            while (x != nullptr) {
+                if (x->left != nullptr) {
+                    base_ptr y = x->left;
+                    x->left = y->right;
+                    y->right = x;
+                    x = y;
+                } else {
+                    base_ptr next = x->right;
+                    node_ptr np = x->get_node_ptr();
+                    np->right = nullptr;
+                    auto res = get_insert_multi_pos(value_traits::get_key(np->value));
+                    insert_node_at(res.first, np, res.second);
+                    x = next;
+                }
+            }
+        } catch (...) {
+            erase_since(x);
+            throw;
+        }
+    }
+
+    // 以下为基于 join 的集合操作，不重新分配结点，对大树按子树并行处理
+    // 两棵树的分配器不相等时结点不能转移，merge_multi、join 与 union_multi 退化为逐个复制元素
+    // 要求比较器不抛出异常，并行处理时会从多个线程调用比较器
+
+    // 把 rhs 连接到本树之后，要求本树中所有键值 <= rhs 中所有键值，rhs 随后变为空树，O(log n)
+    void join(rb_tree &rhs) {
+        if (this == &rhs || rhs.m_node_count == 0) {
+            return;
+        }
+        if (!(m_node_alloc == rhs.m_node_alloc)) {
+            transfer_values(rhs);
+            return;
+        }
+        if (m_node_count == 0) {
+            swap(rhs);
+            return;
+        }
+        assert(!m_key_comp(value_traits::get_key(rhs.leftmost()->get_node_ptr()->value),
+                           value_traits::get_key(rightmost()->get_node_ptr()->value)));
+        // 从 rhs 中摘下最小结点作为连接点
+        base_ptr k = rhs.leftmost();
+        rb_tree_erase_rebalance(k, rhs.header());
+        size_type count = m_node_count + rhs.m_node_count;
+        base_ptr r = rhs.root();
+        base_ptr r_max = r == nullptr ? k : rhs.rightmost();
+        rhs.rb_tree_init();
+        subtree t = rb_tree_join(whole_tree(root()), k, whole_tree(r));
+        reset_root(t.root, leftmost(), r_max, count);
+    }
+
+    // 把键值不小于 key 的结点移到返回的新树中，本树只保留键值小于 key 的结点
+    // 分割本身为 O(log n)，统计两侧大小需要 O(min(左侧大小, 右侧大小))
+    rb_tree split(const key_type &key) {
+        rb_tree result(m_key_comp, get_allocator());
+        if (m_node_count == 0) {
+            return result;
+        }
+        size_type count = m_node_count;
+        auto parts = split_at(whole_tree(root()), key, false);
+        rb_tree_init();
+        reset_root(parts.first.root, count);
+        result.reset_root(parts.second.root, 0);
+        // 两侧同步计数，较小的一侧走完即可得出两侧的大小
+        iterator l = begin();
+        iterator r = result.begin();
+        size_type n = 0;
+        while (l != end() && r != result.end()) {
+            ++l;
+            ++r;
+            ++n;
+        }
+        if (l == end()) {
+            m_node_count = n;
+            result.m_node_count = count - n;
+        } else {
+            result.m_node_count = n;
+            m_node_count = count - n;
+        }
+        return result;
+    }
+
+    // 把 rhs 的全部结点并入本树，键值相等的结点排在已有结点之后，rhs 随后变为空树
+    // 较小的树大小为 m，较大的为 n 时，复杂度为 O(m log(n / m + 1))
+    void union_multi(rb_tree &rhs) {
+        if (this == &rhs || rhs.m_node_count == 0) {
+            return;
+        }
+        if (!(m_node_alloc == rhs.m_node_alloc)) {
+            transfer_values(rhs);
+            return;
+        }
+        size_type count = m_node_count + rhs.m_node_count;
+        subtree t1 = whole_tree(root());
+        subtree t2 = whole_tree(rhs.root());
+        rb_tree_init();
+        rhs.rb_tree_init();
+        reset_root(union_nodes(t1, t2, parallel_depth()).root, count);
+    }
+
+    // 只保留键值在 rhs 中出现过的结点
+    void intersect(const rb_tree &rhs) {
+        if (this == &rhs || m_node_count == 0) {
+            return;
+        }
+        size_type count = m_node_count;
+        subtree t1 = whole_tree(root());
+        rb_tree_init();
+        size_type erased = 0;
+        subtree t = filter_nodes(t1, rhs.root(), parallel_depth(), true, erased);
+        reset_root(t.root, count - erased);
+    }
+
+    // 删除键值在 rhs 中出现过的结点
+    void subtract(const rb_tree &rhs) {
+        if (m_node_count == 0) {
+            return;
+        }
+        if (this == &rhs) {
+            clear();
+            return;
+        }
+        size_type count = m_node_count;
+        subtree t1 = whole_tree(root());
+        rb_tree_init();
+        size_type erased = 0;
+        subtree t = filter_nodes(t1, rhs.root(), parallel_depth(), false, erased);
+        reset_root(t.root, count - erased);
+    }
+
+    // 清空
+    // 分配器的释放为空操作且元素无需析构时（如 arena_allocator），直接丢弃全部结点，O(1)
     void clear() {
         if (m_node_count != 0) {
-            erase_since(root());
-            leftmost() = m_header;
-            root() = nullptr;
-            rightmost() = m_header;
-            m_node_count = 0;
+            if (!discard_nodes) {
+                erase_since(root());
+            }
+            rb_tree_init();
         }
     }
 
-    // 查找操作（mulit与unique两种）
-    iterator find(const key_type &key) {
-        auto y = m_header; // 最后一个不小于 key 的节点
-        auto x = root();
-        while (x != nullptr) {
-            if (!m_key_comp(value_traits::get_key(x->get_node_ptr()->value),
-                            key)) { // key 小于等于 x 键值，向左走
-                y = x, x = x->left;
-            } else { // key 大于 x 键值，向右走
-                x = x->right;
+    // 用 n 个按键值有序的值替换本树的内容，gen() 依次返回各个值，O(n)
+    // 先按顺序创建全部结点并经 right 指针串起来，再一次性连成平衡的树，无需比较与旋转
+    // gen() 抛出异常时已创建的结点全部销毁，本树变为空树
+    template <class Generator>
+    void assign_sorted(size_type n, Generator gen) {
+        clear();
+        if (n == 0) {
+            return;
+        }
+        base_ptr first = nullptr;
+        base_ptr last = nullptr;
+        try {
+            for (size_type i = 0; i < n; ++i) {
+                base_ptr x = create_node(gen());
+                if (last == nullptr) {
+                    first = x;
+                } else {
+                    last->right = x;
+                }
+                last = x;
+            }
+        } catch (...) {
+            while (first != nullptr) {
+                base_ptr next = first->right;
+                destroy_node(first->get_node_ptr());
+                first = next;
             }
+            throw;
         }
-        iterator j = iterator(y);
-        return (j == end() || m_key_comp(key, value_traits::get_key(*j))) ? end() : j;
+        // 左右子树大小至多相差 1，空链接的深度只有两种，把最深一层的结点染红即可保持黑高相同
+        int red_depth = -1;
+        for (size_type m = n; m != 0; m >>= 1) {
+            ++red_depth;
+        }
+        base_ptr cur = first;
+        base_ptr x = build_sorted(cur, n, 0, red_depth);
+        x->set_color(rb_tree_black);
+        reset_root(x, first, last, n);
+    }
+
+    // 查找操作（mulit与unique两种）
+    iterator find(const key_type &key) {
+        return lookup_find(key);
     }
     const_iterator find(const key_type &key) const {
-        auto y = m_header; // 最后一个不小于 key 的节点
-        auto x = root();
-        while (x != nullptr) {
-            if (!m_key_comp(value_traits::get_key(x->get_node_ptr()->value),
-                            key)) { // key 小于等于 x 键值，向左走
-                y = x, x = x->left;
-            } else { // key 大于 x 键值，向右走
-                x = x->right;
-            }
-        }
-        const_iterator j = const_iterator(y);
-        return (j == end() || m_key_comp(key, value_traits::get_key(*j))) ? end() : j;
+        return lookup_find(key);
     }
 
     size_type count_multi(const key_type &key) const {
@@ -1023,55 +1559,17 @@ class rb_tree {
     }
     // 二分查找
     iterator lower_bound(const key_type &key) {
-        auto y = m_header;
-        auto x = root();
-        while (x != nullptr) {
-            if (!m_key_comp(value_traits::get_key(x->get_node_ptr()->value), key)) { // key <= x
-                y = x, x = x->left;
-            } else {
-                x = x->right;
-            }
-        }
-        return iterator(y);
+        return lookup_lower_bound(key);
     }
-
     const_iterator lower_bound(const key_type &key) const {
-        auto y = m_header;
-        auto x = root();
-        while (x != nullptr) {
-            if (!m_key_comp(value_traits::get_key(x->get_node_ptr()->value), key)) { // key <= x
-                y = x, x = x->left;
-            } else {
-                x = x->right;
-            }
-        }
-        return const_iterator(y);
+        return lookup_lower_bound(key);
     }
 
     iterator upper_bound(const key_type &key) {
-        auto y = m_header;
-        auto x = root();
-        while (x != nullptr) {
-            if (m_key_comp(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
-                y = x, x = x->left;
-            } else {
-                x = x->right;
-            }
-        }
-        return iterator(y);
+        return lookup_upper_bound(key);
     }
-
     const_iterator upper_bound(const key_type &key) const {
-        auto y = m_header;
-        auto x = root();
-        while (x != nullptr) {
-            if (m_key_comp(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
-                y = x, x = x->left;
-            } else {
-                x = x->right;
-            }
-        }
-        return const_iterator(y);
+        return lookup_upper_bound(key);
     }
 
     std::pair<iterator, iterator> equal_range_multi(const key_type &key) {
@@ -1091,12 +1589,83 @@ class rb_tree {
         auto next = it;
         return it == end() ? std::make_pair(it, it) : std::make_pair(it, ++next);
     }
+
+    // 批量查找，对 [first, last) 中的每个键值依次向 out 写入查找结果，与逐个调用 find 的结果相同
+    // 多个查找在树中逐层同步推进，并预取下一层的结点，使各查找的缓存未命中相互重叠
+    // 键值须为左值（如来自数组或 vector），比较器须能比较结点键值与迭代器指向的类型
+    template <class ForwardIt, class OutputIt>
+    OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) {
+        return lookup_batch<iterator>(first, last, out, true);
+    }
+    template <class ForwardIt, class OutputIt>
+    OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+        return lookup_batch<const_iterator>(first, last, out, true);
+    }
+
+    // 批量的 lower_bound，与 find_batch 相同的方式推进
+    template <class ForwardIt, class OutputIt>
+    OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) {
+        return lookup_batch<iterator>(first, last, out, false);
+    }
+    template <class ForwardIt, class OutputIt>
+    OutputIt lower_bound_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+        return lookup_batch<const_iterator>(first, last, out, false);
+    }
+
+    // 异构查找，仅当比较器声明了 is_transparent 时可用，查找时不构造 key_type 临时对象
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    iterator find(const K &key) {
+        return lookup_find(key);
+    }
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    const_iterator find(const K &key) const {
+        return lookup_find(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    size_type count_multi(const K &key) const {
+        auto p = equal_range_multi(key);
+        return static_cast<size_type>(tstl::distance(p.first, p.second));
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    iterator lower_bound(const K &key) {
+        return lookup_lower_bound(key);
+    }
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    const_iterator lower_bound(const K &key) const {
+        return lookup_lower_bound(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    iterator upper_bound(const K &key) {
+        return lookup_upper_bound(key);
+    }
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    const_iterator upper_bound(const K &key) const {
+        return lookup_upper_bound(key);
+    }
+
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    std::pair<iterator, iterator> equal_range_multi(const K &key) {
+        return std::pair<iterator, iterator>(lookup_lower_bound(key), lookup_upper_bound(key));
+    }
+    template <class K, class C = Compare, typename = tstl::_require_transparent<C>>
+    std::pair<const_iterator, const_iterator> equal_range_multi(const K &key) const {
+        return std::pair<const_iterator, const_iterator>(lookup_lower_bound(key),
+                                                         lookup_upper_bound(key));
+    }
+
     //交换
     void swap(rb_tree &rhs) noexcept {
         if (this != &rhs) {
             tstl::swap(m_header, rhs.m_header);
             tstl::swap(m_node_count, rhs.m_node_count);
             tstl::swap(m_key_comp, rhs.m_key_comp);
+            swap_alloc(rhs, typename node_alloc_traits::propagate_on_container_swap());
+            // 头节点内嵌在树中，交换后需要让根节点重新指向自己的头节点
+            relink_header();
+            rhs.relink_header();
         }
     }
 
@@ -1104,49 +1673,176 @@ class rb_tree {
     //初始化
     template <class... Args>
     node_ptr create_node(Args &&...args) {
-        auto tmp = m_node_alloc.allocate(1);
+        node_ptr tmp = node_alloc_traits::allocate(m_node_alloc, 1);
         try {
-            m_data_alloc.construct(std::addressof(tmp->value), std::forward<Args>(args)...);
-            tmp->left = nullptr;
-            tmp->right = nullptr;
-            tmp->parent = nullptr;
+            node_alloc_traits::construct(m_node_alloc, std::addressof(tmp->value),
+                                         std::forward<Args>(args)...);
+            tmp->reset();
         } catch (...) {
-            m_node_alloc.destroy(tmp);
+            node_alloc_traits::deallocate(m_node_alloc, tmp, 1);
             throw;
         }
         return tmp;
     }
     node_ptr clone_node(base_ptr x) {
         node_ptr tmp = create_node(x->get_node_ptr()->value);
-        tmp->color = x->color;
-        tmp->left = nullptr;
-        tmp->right = nullptr;
+        tmp->set_color(x->color());
         return tmp;
     }
     void destroy_node(node_ptr p) {
-        m_data_alloc.destroy(&p->value);
-        m_node_alloc.destroy(p);
-        m_node_alloc.deallocate(p, 1);
+        node_alloc_traits::destroy(m_node_alloc, std::addressof(p->value));
+        node_alloc_traits::deallocate(m_node_alloc, p, 1);
+    }
+
+    // 分配器相关的赋值与交换，按 propagate_on_container_* 决定是否随元素一起转移
+    void assign_alloc(const node_allocator &alloc, std::true_type) {
+        m_node_alloc = alloc;
+    }
+    void assign_alloc(const node_allocator &, std::false_type) {
+    }
+
+    void move_assign(rb_tree &rhs, std::true_type) {
+        m_node_alloc = std::move(rhs.m_node_alloc);
+        take_nodes(rhs);
+    }
+    // 分配器不随移动转移时，只有两者相等才能直接接管结点，否则逐个复制后清空 rhs
+    void move_assign(rb_tree &rhs, std::false_type) {
+        if (m_node_alloc == rhs.m_node_alloc) {
+            take_nodes(rhs);
+        } else {
+            if (rhs.m_node_count != 0) {
+                set_root(copy_from(rhs.root(), header()));
+                leftmost() = rb_tree_min(root());
+                rightmost() = rb_tree_max(root());
+                m_node_count = rhs.m_node_count;
+            }
+            rhs.clear();
+        }
+    }
+
+    void swap_alloc(rb_tree &rhs, std::true_type) noexcept {
+        tstl::swap(m_node_alloc, rhs.m_node_alloc);
+    }
+    void swap_alloc(rb_tree &, std::false_type) noexcept {
     }
 
     void rb_tree_init() {
-        m_header = m_base_alloc.allocate(1);
-        m_header->color = rb_tree_red; // header_ 节点颜色为红，与 root 区分
-        root() = nullptr;
-        leftmost() = m_header;
-        rightmost() = m_header;
+        m_header.reset(); // header 节点颜色为红，与 root 区分
+        leftmost() = header();
+        rightmost() = header();
         m_node_count = 0;
     }
 
-    void reset() {
-        m_header = nullptr;
-        m_node_count = 0;
+    // 接管 rhs 的全部节点，要求本树为空，rhs 随后变为空树
+    void take_nodes(rb_tree &rhs) noexcept {
+        if (rhs.m_node_count != 0) {
+            set_root(rhs.root());
+            leftmost() = rhs.leftmost();
+            rightmost() = rhs.rightmost();
+            m_node_count = rhs.m_node_count;
+            root()->set_parent(header());
+            rhs.rb_tree_init();
+        }
+    }
+
+    void relink_header() noexcept {
+        if (m_node_count == 0) {
+            rb_tree_init();
+        } else {
+            root()->set_parent(header());
+        }
+    }
+
+    // 查找的实现，K 为 key_type 或可与之透明比较的类型
+    template <class K>
+    base_ptr lookup_lower_bound(const K &key) const {
+        auto y = header(); // 最后一个不小于 key 的节点
+        auto x = root();
+        while (x != nullptr) {
+            if (!m_key_comp(value_traits::get_key(x->get_node_ptr()->value), key)) { // key <= x
+                y = x, x = x->left;
+            } else { // key 大于 x 键值，向右走
+                x = x->right;
+            }
+        }
+        return y;
+    }
+
+    template <class K>
+    base_ptr lookup_upper_bound(const K &key) const {
+        auto y = header();
+        auto x = root();
+        while (x != nullptr) {
+            if (m_key_comp(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
+                y = x, x = x->left;
+            } else {
+                x = x->right;
+            }
+        }
+        return y;
+    }
+
+    template <class K>
+    base_ptr lookup_find(const K &key) const {
+        base_ptr y = lookup_lower_bound(key);
+        if (y == header() || m_key_comp(key, value_traits::get_key(y->get_node_ptr()->value))) {
+            return header();
+        }
+        return y;
+    }
+
+    // 批量查找的实现，每组 TSTL_RB_TREE_BATCH_SIZE 个键值，exact 为 true 时为 find，否则为 lower_bound
+    template <class Iter, class ForwardIt, class OutputIt>
+    OutputIt lookup_batch(ForwardIt first, ForwardIt last, OutputIt out, bool exact) const {
+        using key_arg = typename std::iterator_traits<ForwardIt>::value_type;
+        const int group = TSTL_RB_TREE_BATCH_SIZE;
+        const key_arg *keys[group];
+        base_ptr x[group]; // 各查找当前所在的结点
+        base_ptr y[group]; // 各查找目前最后一个不小于键值的结点
+        while (first != last) {
+            int n = 0;
+            for (; n < group && first != last; ++n, ++first) {
+                keys[n] = std::addressof(*first);
+                x[n] = root();
+                y[n] = header();
+            }
+            // 逐层推进，每一轮每个查找前进一层，并预取下一轮要访问的结点
+            for (bool active = true; active;) {
+                active = false;
+                for (int i = 0; i < n; ++i) {
+                    base_ptr p = x[i];
+                    if (p == nullptr) {
+                        continue;
+                    }
+                    if (!m_key_comp(value_traits::get_key(p->get_node_ptr()->value), *keys[i])) {
+                        y[i] = p;
+                        p = p->left;
+                    } else {
+                        p = p->right;
+                    }
+                    x[i] = p;
+                    if (p != nullptr) {
+                        TSTL_PREFETCH(p);
+                        active = true;
+                    }
+                }
+            }
+            for (int i = 0; i < n; ++i, ++out) {
+                base_ptr r = y[i];
+                if (exact && r != header() &&
+                    m_key_comp(*keys[i], value_traits::get_key(r->get_node_ptr()->value))) {
+                    r = header();
+                }
+                *out = Iter(r);
+            }
+        }
+        return out;
     }
 
     // 插入结点
     std::pair<base_ptr, bool> get_insert_multi_pos(const key_type &key) {
         auto x = root();
-        auto y = m_header;
+        auto y = header();
         bool add_to_left = true;
         while (x != nullptr) {
             y = x;
@@ -1161,7 +1857,7 @@ class rb_tree {
         // bool 表示是否在左边插入，
         // 第二个值为一个 bool，表示是否插入成功
         auto x = root();
-        auto y = m_header;
+        auto y = header();
         bool add_to_left = true; // 树为空时也在 header_ 左边插入
         while (x != nullptr) {
             y = x;
@@ -1170,7 +1866,7 @@ class rb_tree {
         }
         iterator j = iterator(y); // 此时 y 为插入点的父节点
         if (add_to_left) {
-            if (y == m_header ||
+            if (y == header() ||
                 j == begin()) { // 如果树为空树或插入点在最左节点处，肯定可以插入新的节点
                 return std::make_pair(std::make_pair(y, true), true);
             } else { // 否则，如果存在重复节点，那么 --j 就是重复的值
@@ -1186,10 +1882,10 @@ class rb_tree {
 
     iterator insert_value_at(base_ptr x, const value_type &value, bool add_to_left) {
         node_ptr node = create_node(value);
-        node->parent = x;
+        node->set_parent(x);
         auto base_node = node->get_base_ptr();
-        if (x == m_header) {
-            root() = base_node;
+        if (x == header()) {
+            set_root(base_node);
             leftmost() = base_node;
             rightmost() = base_node;
         } else if (add_to_left) {
@@ -1203,16 +1899,16 @@ class rb_tree {
                 rightmost() = base_node;
             }
         }
-        rb_tree_insert_rebalance(base_node, root());
+        rb_tree_insert_rebalance(base_node, header());
         ++m_node_count;
         return iterator(node);
     }
 
     iterator insert_node_at(base_ptr x, node_ptr node, bool add_to_left) {
-        node->parent = x;
+        node->set_parent(x);
         auto base_node = node->get_base_ptr();
-        if (x == m_header) {
-            root() = base_node;
+        if (x == header()) {
+            set_root(base_node);
             leftmost() = base_node;
             rightmost() = base_node;
         } else if (add_to_left) {
@@ -1226,11 +1922,34 @@ class rb_tree {
                 rightmost() = base_node;
             }
         }
-        rb_tree_insert_rebalance(base_node, root());
+        rb_tree_insert_rebalance(base_node, header());
         ++m_node_count;
         return iterator(node);
     }
 
+    iterator insert_node_multi_use_hint(iterator hint, node_ptr np) {
+        if (m_node_count == 0) {
+            return insert_node_at(header(), np, true);
+        }
+        key_type key = value_traits::get_key(np->value);
+        if (hint == begin()) { // 位于 begin 处
+            if (m_key_comp(key, value_traits::get_key(*hint))) {
+                return insert_node_at(hint.node, np, true);
+            } else {
+                auto pos = get_insert_multi_pos(key);
+                return insert_node_at(pos.first, np, pos.second);
+            }
+        } else if (hint == end()) { // 位于 end 处
+            if (!m_key_comp(key, value_traits::get_key(rightmost()->get_node_ptr()->value))) {
+                return insert_node_at(rightmost(), np, false);
+            } else {
+                auto pos = get_insert_multi_pos(key);
+                return insert_node_at(pos.first, np, pos.second);
+            }
+        }
+        return insert_multi_use_hint(hint, key, np);
+    }
+
     iterator insert_multi_use_hint(iterator hint, key_type key, node_ptr node) {
         // 在 hint 附近寻找可插入的位置
         auto np = hint.node;
@@ -1272,25 +1991,240 @@ class rb_tree {
         return insert_node_at(pos.first.first, node, pos.first.second);
     }
 
-    // 复制树
+    // 从 cur 开始的结点链中取出 n 个结点，按中序连成平衡的子树，cur 随之前移
+    static base_ptr build_sorted(base_ptr &cur, size_type n, int depth, int red_depth) noexcept {
+        if (n == 0) {
+            return nullptr;
+        }
+        const size_type left_count = (n - 1) / 2;
+        base_ptr l = build_sorted(cur, left_count, depth + 1, red_depth);
+        base_ptr x = cur;
+        cur = cur->right;
+        base_ptr r = build_sorted(cur, n - 1 - left_count, depth + 1, red_depth);
+        x->left = l;
+        x->right = r;
+        if (l != nullptr) {
+            l->set_parent(x);
+        }
+        if (r != nullptr) {
+            r->set_parent(x);
+        }
+        x->set_color(depth == red_depth ? rb_tree_red : rb_tree_black);
+        return x;
+    }
+
+    // 以 x 为根的子树成为整棵树，重新设置最左、最右结点与结点数
+    void reset_root(base_ptr x, size_type count) noexcept {
+        if (x == nullptr) {
+            rb_tree_init();
+        } else {
+            reset_root(x, rb_tree_min(x), rb_tree_max(x), count);
+        }
+    }
+    void reset_root(base_ptr x, base_ptr min, base_ptr max, size_type count) noexcept {
+        set_root(x);
+        x->set_parent(header());
+        leftmost() = min;
+        rightmost() = max;
+        m_node_count = count;
+    }
+
+    const key_type &node_key(base_ptr x) const noexcept {
+        return value_traits::get_key(x->get_node_ptr()->value);
+    }
+
+    // 整棵树或树中的一棵子树，黑高需要沿最左链计算一次
+    static subtree whole_tree(base_ptr x) noexcept {
+        return {x, rb_tree_black_height(x)};
+    }
+
+    // 按 key 把子树 x 分为两棵，upper 为 false 时左侧键值 < key，
+    // 为 true 时左侧键值 <= key，其余结点在右侧
+    std::pair<subtree, subtree> split_at(subtree x, const key_type &key, bool upper) const {
+        if (x.root == nullptr) {
+            return std::make_pair(x, x);
+        }
+        base_ptr k = x.root;
+        int h = rb_tree_child_height(k, x.height);
+        subtree l = {k->left, h};
+        subtree r = {k->right, h};
+        bool to_left = upper ? !m_key_comp(key, node_key(k)) : m_key_comp(node_key(k), key);
+        if (to_left) {
+            auto parts = split_at(r, key, upper);
+            return std::make_pair(rb_tree_join(l, k, parts.first), parts.second);
+        }
+        auto parts = split_at(l, key, upper);
+        return std::make_pair(parts.first, rb_tree_join(parts.second, k, r));
+    }
+
+    // 元素无需析构且分配器的释放为空操作时，清空可以不遍历结点
+    static constexpr bool discard_nodes = std::is_trivially_destructible<value_type>::value &&
+                                          tstl::_alloc_trivially_deallocate<node_allocator>::value;
+
+    // 集合操作会在工作线程中释放结点，只对默认分配器或释放为空操作的分配器并行
+    static constexpr bool parallel_alloc =
+        std::is_same<Allocator, std::allocator<T>>::value ||
+        tstl::_alloc_trivially_deallocate<node_allocator>::value;
+
+    // 并行处理时递归的层数，约为硬件线程数的对数，每层至多把任务一分为二
+    static int parallel_depth() noexcept {
+        if (!parallel_alloc) {
+            return 0;
+        }
+        unsigned threads = std::thread::hardware_concurrency();
+        int depth = 0;
+        while ((1u << depth) < threads) {
+            ++depth;
+        }
+        return depth;
+    }
+
+    // 子树的黑高不低于该值时才值得交给另一个线程，约对应数千个结点
+    static constexpr int parallel_grain_height = 10;
+
+    // 依次计算 left() 与 right()，条件允许时让 left() 在另一个线程中执行
+    template <class Left, class Right>
+    static void fork_join(bool parallel, Left left, Right right) {
+        if (parallel) {
+            std::future<void> task;
+            try {
+                task = std::async(std::launch::async, left);
+            } catch (const std::system_error &) {
+                // 无法创建线程时退化为串行
+                left();
+                right();
+                return;
+            }
+            right();
+            task.get();
+        } else {
+            left();
+            right();
+        }
+    }
+
+    // 把单个结点 k 插入子树 t 中键值相等的结点之后，比切分后再连接少了一半的结构调整
+    subtree insert_leaf(subtree t, base_ptr k) const noexcept {
+        if (rb_tree_is_red(t.root)) {
+            rb_tree_set_black(t.root);
+            ++t.height;
+        }
+        base_type local_header;
+        local_header.reset();
+        base_ptr hp = &local_header;
+        hp->set_parent(t.root);
+        t.root->set_parent(hp);
+        base_ptr p = t.root;
+        while (true) {
+            base_ptr &child = m_key_comp(node_key(k), node_key(p)) ? p->left : p->right;
+            if (child == nullptr) {
+                child = k;
+                break;
+            }
+            p = child;
+        }
+        k->set_parent(p);
+        if (rb_tree_insert_rebalance(k, hp)) {
+            ++t.height;
+        }
+        t.root = hp->parent();
+        t.root->set_parent(nullptr);
+        return t;
+    }
+
+    // 以 t2 的根切分 t1，两侧分别合并后再用 t2 的根连接
+    subtree union_nodes(subtree t1, subtree t2, int depth) const {
+        if (t1.root == nullptr) {
+            return t2;
+        }
+        if (t2.root == nullptr) {
+            return t1;
+        }
+        base_ptr k = t2.root;
+        if (k->left == nullptr && k->right == nullptr) {
+            return insert_leaf(t1, k);
+        }
+        int h = rb_tree_child_height(k, t2.height);
+        subtree l2 = {k->left, h};
+        subtree r2 = {k->right, h};
+        auto parts = split_at(t1, node_key(k), true);
+        bool parallel = depth > 0 && t2.height >= parallel_grain_height;
+        subtree l;
+        subtree r;
+        fork_join(
+            parallel, [&] { l = union_nodes(parts.first, l2, depth - 1); },
+            [&] { r = union_nodes(parts.second, r2, depth - 1); });
+        return rb_tree_join(l, k, r);
+    }
+
+    // 以 rhs 中子树 t2 的根 k 把 t1 分为 < k、== k、> k 三部分，只读取 t2，不修改 rhs
+    // keep 为 true 时保留 == k 的部分（交集），否则将其销毁（差集），erased 累计销毁的结点数
+    subtree filter_nodes(subtree t1, base_ptr t2, int depth, bool keep, size_type &erased) {
+        if (t1.root == nullptr) {
+            return t1;
+        }
+        if (t2 == nullptr) {
+            if (keep) {
+                erased += erase_since(t1.root);
+                return subtree{nullptr, 0};
+            }
+            return t1;
+        }
+        const key_type &key = node_key(t2);
+        auto lower = split_at(t1, key, false);
+        auto upper = split_at(lower.second, key, true);
+        bool parallel = depth > 0 && t1.height >= parallel_grain_height;
+        subtree l;
+        subtree r;
+        size_type erased_l = 0;
+        size_type erased_r = 0;
+        fork_join(
+            parallel,
+            [&] { l = filter_nodes(lower.first, t2->left, depth - 1, keep, erased_l); },
+            [&] { r = filter_nodes(upper.second, t2->right, depth - 1, keep, erased_r); });
+        erased += erased_l + erased_r;
+        if (keep) {
+            return rb_tree_join2(rb_tree_join2(l, upper.first), r);
+        }
+        erased += erase_since(upper.first.root);
+        return rb_tree_join2(l, r);
+    }
+
+    // 复制以 x 为根的子树，新子树的根挂在 p 下
+    // 先序遍历，用定长数组记录尚未复制的右子树，红黑树高度不超过 2log(n+1)，不会溢出
     base_ptr copy_from(base_ptr x, base_ptr p) {
-        auto top = clone_node(x);
-        top->parent = p;
+        struct pending {
+            base_ptr src;    // 待复制的右子树
+            base_ptr parent; // 新树中对应的父结点
+        };
+        pending stack[2 * std::numeric_limits<size_type>::digits];
+        size_type depth = 0;
+
+        base_ptr top = clone_node(x);
+        top->set_parent(p);
         try {
-            if (x->right) {
-                top->right = copy_from(x->right, top);
-            }
-            p = top;
-            x = x->left;
-            while (x != nullptr) {
-                auto y = clone_node(x);
-                p->left = y;
-                y->parent = p;
-                if (x->right) {
-                    y->right = copy_from(x->right, y);
+            base_ptr d = top;
+            while (true) {
+                if (x->right != nullptr) {
+                    assert(depth < sizeof(stack) / sizeof(stack[0]));
+                    stack[depth++] = {x->right, d};
                 }
-                p = y;
-                x = x->left;
+                base_ptr y;
+                if (x->left != nullptr) {
+                    x = x->left;
+                    y = clone_node(x);
+                    d->left = y;
+                } else if (depth != 0) {
+                    --depth;
+                    x = stack[depth].src;
+                    d = stack[depth].parent;
+                    y = clone_node(x);
+                    d->right = y;
+                } else {
+                    break;
+                }
+                y->set_parent(d);
+                d = y;
             }
         } catch (...) {
             erase_since(top);
@@ -1299,49 +2233,60 @@ class rb_tree {
         return top;
     }
 
-    void erase_since(base_ptr x) {
+    // 销毁以 x 为根的子树，只依赖左右指针，返回销毁的结点数
+    // 不断右旋把左子树转到右侧，左子树为空时即可释放当前结点，不使用递归与额外的栈
+    size_type erase_since(base_ptr x) noexcept {
+        size_type n = 0;
         while (x != nullptr) {
-            erase_since(x->right);
-            auto y = x->left;
-            destroy_node(x->get_node_ptr());
-            x = y;
+            if (x->left != nullptr) {
+                base_ptr y = x->left;
+                x->left = y->right;
+                y->right = x;
+                x = y;
+            } else {
+                base_ptr y = x->right;
+                destroy_node(x->get_node_ptr());
+                x = y;
+                ++n;
+            }
         }
+        return n;
     }
 };
 
 // 重载比较操作符
-template <class T, class Compare>
-bool operator==(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+template <class T, class Compare, class Alloc>
+bool operator==(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
     return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T, class Compare>
-bool operator<(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+template <class T, class Compare, class Alloc>
+bool operator<(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
     return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T, class Compare>
-bool operator!=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+template <class T, class Compare, class Alloc>
+bool operator!=(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
     return !(lhs == rhs);
 }
 
-template <class T, class Compare>
-bool operator>(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+template <class T, class Compare, class Alloc>
+bool operator>(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
     return rhs < lhs;
 }
 
-template <class T, class Compare>
-bool operator<=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+template <class T, class Compare, class Alloc>
+bool operator<=(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
     return !(rhs < lhs);
 }
 
-template <class T, class Compare>
-bool operator>=(const rb_tree<T, Compare> &lhs, const rb_tree<T, Compare> &rhs) {
+template <class T, class Compare, class Alloc>
+bool operator>=(const rb_tree<T, Compare, Alloc> &lhs, const rb_tree<T, Compare, Alloc> &rhs) {
     return !(lhs < rhs);
 }
 
-template <class T, class Compare>
-void swap(rb_tree<T, Compare> &lhs, rb_tree<T, Compare> &rhs) noexcept {
+template <class T, class Compare, class Alloc>
+void swap(rb_tree<T, Compare, Alloc> &lhs, rb_tree<T, Compare, Alloc> &rhs) noexcept {
     lhs.swap(rhs);
 }
 
@@ -0,0 +1,425 @@
+#ifndef TSTL_SRC_RING_BUFFER_HPP
+#define TSTL_SRC_RING_BUFFER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "algorithm.hpp"
+#include "memory/memory_usage.hpp"
+#include "memory/uninitialized.hpp"
+#include "span.hpp"
+
+namespace tstl {
+
+// ring_buffer 中一段逻辑上连续的元素，回绕时分为两段：first 在前，second 在后，second 可能为空
+template <class T>
+struct ring_buffer_spans {
+    tstl::span<T> first;
+    tstl::span<T> second;
+
+    std::size_t size() const noexcept {
+        return first.size() + second.size();
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+};
+
+/**
+ * @brief 容量固定的环形缓冲区，容量取整为 2 的幂，下标以掩码回绕。
+ *
+ * 构造时一次分配并值初始化全部槽位，此后的所有操作都不再分配内存。加入元素是对槽位赋值，
+ * 取出元素只移动读位置，元素留在槽位中直到被覆盖，因此 pop_n 返回的 span 在下一次写入之前有效。
+ * 缓冲区满时，reject 模式下拒绝新元素，overwrite_oldest 模式下覆盖最早的元素。
+ * 被移动后的对象容量为 0，任何模式下加入元素都返回 false，可以赋值、复制或销毁。
+ */
+template <class T, class Allocator = std::allocator<T>>
+class ring_buffer {
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+  public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using spans = ring_buffer_spans<T>;
+    using const_spans = ring_buffer_spans<const T>;
+
+    enum overflow_mode { reject, overwrite_oldest };
+
+    /**
+     * @brief 构造容量不小于 min_capacity 的缓冲区，min_capacity 须大于 0。
+     */
+    explicit ring_buffer(size_type min_capacity, overflow_mode mode = reject,
+                         const Allocator &alloc = Allocator())
+        : m_alloc(alloc), m_capacity(m_round_up(min_capacity)), m_mask(m_capacity - 1),
+          m_head(0), m_tail(0), m_mode(mode) {
+        m_slots = m_allocate_slots(m_capacity);
+    }
+
+    ring_buffer(const ring_buffer &other)
+        : m_alloc(alloc_traits::select_on_container_copy_construction(other.m_alloc)),
+          m_slots(nullptr), m_capacity(other.m_capacity), m_mask(other.m_mask), m_head(0),
+          m_tail(0), m_mode(other.m_mode) {
+        m_slots = m_allocate_slots(m_capacity);
+        for (size_type i = other.m_head; i != other.m_tail; ++i) {
+            push_back(other.m_slots[i & m_mask]);
+        }
+    }
+
+    ring_buffer(ring_buffer &&other) noexcept
+        : m_alloc(std::move(other.m_alloc)), m_slots(other.m_slots), m_capacity(other.m_capacity),
+          m_mask(other.m_mask), m_head(other.m_head), m_tail(other.m_tail), m_mode(other.m_mode) {
+        other.m_slots = nullptr;
+        other.m_capacity = 0;
+        other.m_mask = 0;
+        other.m_head = other.m_tail = 0;
+    }
+
+    /**
+     * @brief 容量与 other 相同时对已有槽位逐个赋值，否则按 other 的容量重新分配槽位。
+     */
+    ring_buffer &operator=(const ring_buffer &other) {
+        if (this != &other) {
+            m_copy_assign_alloc(other,
+                                typename alloc_traits::propagate_on_container_copy_assignment());
+            m_reset_slots(other.m_capacity);
+            m_mode = other.m_mode;
+            for (size_type i = other.m_head; i != other.m_tail; ++i) {
+                m_slots[m_tail++ & m_mask] = other.m_slots[i & other.m_mask];
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 分配器随移动转移或两者相等时接管 other 的槽位，否则像复制赋值一样逐个移动元素。
+     */
+    ring_buffer &operator=(ring_buffer &&other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
+        if (this != &other) {
+            m_move_assign(other, typename alloc_traits::propagate_on_container_move_assignment());
+        }
+        return *this;
+    }
+
+    ~ring_buffer() {
+        m_release_slots();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return m_alloc;
+    }
+
+    size_type size() const noexcept {
+        return m_tail - m_head;
+    }
+
+    size_type capacity() const noexcept {
+        return m_capacity;
+    }
+
+    bool empty() const noexcept {
+        return m_head == m_tail;
+    }
+
+    bool full() const noexcept {
+        return size() == m_capacity;
+    }
+
+    overflow_mode mode() const noexcept {
+        return m_mode;
+    }
+
+    /**
+     * @brief 返回最早加入的第 pos 个元素，不进行边界检查。
+     */
+    reference operator[](size_type pos) noexcept {
+        return m_slots[(m_head + pos) & m_mask];
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return m_slots[(m_head + pos) & m_mask];
+    }
+
+    reference at(size_type pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("ring_buffer::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("ring_buffer::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    reference front() noexcept {
+        return m_slots[m_head & m_mask];
+    }
+
+    const_reference front() const noexcept {
+        return m_slots[m_head & m_mask];
+    }
+
+    reference back() noexcept {
+        return m_slots[(m_tail - 1) & m_mask];
+    }
+
+    const_reference back() const noexcept {
+        return m_slots[(m_tail - 1) & m_mask];
+    }
+
+    /**
+     * @brief 在末尾加入 value；reject 模式下缓冲区已满时不加入并返回 false。
+     */
+    bool push_back(const value_type &value) {
+        if (!m_make_room()) {
+            return false;
+        }
+        m_slots[m_tail & m_mask] = value;
+        ++m_tail;
+        return true;
+    }
+
+    bool push_back(value_type &&value) {
+        if (!m_make_room()) {
+            return false;
+        }
+        m_slots[m_tail & m_mask] = std::move(value);
+        ++m_tail;
+        return true;
+    }
+
+    template <class... Args>
+    bool emplace_back(Args &&...args) {
+        if (!m_make_room()) {
+            return false;
+        }
+        m_slots[m_tail & m_mask] = value_type(std::forward<Args>(args)...);
+        ++m_tail;
+        return true;
+    }
+
+    /**
+     * @brief 移除最早的元素，缓冲区不能为空。
+     */
+    void pop_front() noexcept {
+        ++m_head;
+    }
+
+    /**
+     * @brief 把 [src, src + count) 加入末尾，返回写入后这些元素所在的至多两段槽位。
+     *
+     * reject 模式下只写入空闲槽位能容纳的部分；overwrite_oldest 模式下覆盖最早的元素，
+     * count 超过容量时只保留最后 capacity() 个。
+     */
+    spans push_n(const value_type *src, size_type count) {
+        if (count > m_capacity - size()) {
+            if (m_mode == reject) {
+                count = m_capacity - size();
+            } else {
+                if (count > m_capacity) {
+                    src += count - m_capacity;
+                    count = m_capacity;
+                }
+                m_head = m_tail + count - m_capacity;
+            }
+        }
+        spans result = m_spans(m_tail, count);
+        tstl::copy(src, src + result.first.size(), result.first.begin());
+        tstl::copy(src + result.first.size(), src + count, result.second.begin());
+        m_tail += count;
+        return result;
+    }
+
+    /**
+     * @brief 移除最早的至多 count 个元素，返回它们所在的至多两段槽位，在下一次写入前有效。
+     */
+    spans pop_n(size_type count) noexcept {
+        count = count < size() ? count : size();
+        spans result = m_spans(m_head, count);
+        m_head += count;
+        return result;
+    }
+
+    /**
+     * @brief 返回最早的至多 count 个元素所在的槽位，不移除它们。
+     */
+    const_spans peek_n(size_type count) const noexcept {
+        count = count < size() ? count : size();
+        spans result = const_cast<ring_buffer *>(this)->m_spans(m_head, count);
+        return const_spans{result.first, result.second};
+    }
+
+    void clear() noexcept {
+        m_head = m_tail = 0;
+    }
+
+    /**
+     * @brief 返回占用的内存；全部槽位在构造时已经分配，未使用的槽位计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = size() * sizeof(T);
+        usage.overhead = sizeof(*this) + (m_capacity - size()) * sizeof(T);
+        return usage;
+    }
+
+    // 分配器不随交换传播时，要求两者相等
+    void swap(ring_buffer &other) noexcept {
+        m_swap_alloc(other, typename alloc_traits::propagate_on_container_swap());
+        tstl::swap(m_slots, other.m_slots);
+        tstl::swap(m_capacity, other.m_capacity);
+        tstl::swap(m_mask, other.m_mask);
+        tstl::swap(m_head, other.m_head);
+        tstl::swap(m_tail, other.m_tail);
+        tstl::swap(m_mode, other.m_mode);
+    }
+
+    friend void swap(ring_buffer &lhs, ring_buffer &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+  private:
+    Allocator m_alloc;
+    T *m_slots;
+    size_type m_capacity;
+    size_type m_mask;
+    // 读、写位置只增不减，取槽位时与 m_mask 按位与；无符号数溢出回绕不影响差值与掩码
+    size_type m_head;
+    size_type m_tail;
+    overflow_mode m_mode;
+
+    static size_type m_round_up(size_type n) {
+        if (n == 0) {
+            throw std::invalid_argument("ring_buffer: capacity must be positive");
+        }
+        if (n > (size_type(-1) >> 1) + 1) {
+            throw std::length_error("ring_buffer: capacity too large");
+        }
+        size_type cap = 1;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    // 分配并值初始化 n 个槽位，n 为 0（复制被移动后的对象）时不分配
+    T *m_allocate_slots(size_type n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T *slots = alloc_traits::allocate(m_alloc, n);
+        try {
+            tstl::_uninitialized_default_construct_a(slots, slots + n, m_alloc);
+        } catch (...) {
+            alloc_traits::deallocate(m_alloc, slots, n);
+            throw;
+        }
+        return slots;
+    }
+
+    // 销毁并释放全部槽位，之后与被移动后的对象相同
+    void m_release_slots() noexcept {
+        if (m_slots != nullptr) {
+            tstl::_destroy_a(m_slots, m_slots + m_capacity, m_alloc);
+            alloc_traits::deallocate(m_alloc, m_slots, m_capacity);
+        }
+        m_slots = nullptr;
+        m_capacity = m_mask = 0;
+        m_head = m_tail = 0;
+    }
+
+    // 清空缓冲区，容量不是 n 时换成新分配的 n 个槽位；分配失败时原有槽位保持不变
+    void m_reset_slots(size_type n) {
+        clear();
+        if (n != m_capacity) {
+            T *slots = m_allocate_slots(n);
+            m_release_slots();
+            m_slots = slots;
+            m_capacity = n;
+            m_mask = n == 0 ? 0 : n - 1;
+        }
+    }
+
+    // 接管 other 的槽位，要求本对象没有槽位且两者的分配器相等
+    void m_take(ring_buffer &other) noexcept {
+        m_slots = other.m_slots;
+        m_capacity = other.m_capacity;
+        m_mask = other.m_mask;
+        m_head = other.m_head;
+        m_tail = other.m_tail;
+        m_mode = other.m_mode;
+        other.m_slots = nullptr;
+        other.m_capacity = other.m_mask = 0;
+        other.m_head = other.m_tail = 0;
+    }
+
+    // 分配器不同时原有槽位由旧分配器释放
+    void m_copy_assign_alloc(const ring_buffer &other, std::true_type) {
+        if (!(m_alloc == other.m_alloc)) {
+            m_release_slots();
+            m_alloc = other.m_alloc;
+        }
+    }
+    void m_copy_assign_alloc(const ring_buffer &, std::false_type) {
+    }
+
+    void m_move_assign(ring_buffer &other, std::true_type) noexcept {
+        m_release_slots();
+        m_alloc = std::move(other.m_alloc);
+        m_take(other);
+    }
+
+    // 分配器不随移动转移时，只有两者相等才能直接接管槽位，否则逐个移动到自己的槽位中
+    void m_move_assign(ring_buffer &other, std::false_type) {
+        if (m_alloc == other.m_alloc) {
+            m_release_slots();
+            m_take(other);
+            return;
+        }
+        m_reset_slots(other.m_capacity);
+        m_mode = other.m_mode;
+        for (size_type i = other.m_head; i != other.m_tail; ++i) {
+            m_slots[m_tail++ & m_mask] = std::move(other.m_slots[i & other.m_mask]);
+        }
+        other.clear();
+    }
+
+    void m_swap_alloc(ring_buffer &other, std::true_type) noexcept {
+        tstl::swap(m_alloc, other.m_alloc);
+    }
+    void m_swap_alloc(ring_buffer &, std::false_type) noexcept {
+    }
+
+    // 为一个新元素腾出位置，reject 模式或容量为 0 时缓冲区已满则返回 false
+    bool m_make_room() noexcept {
+        if (full()) {
+            if (m_mode == reject || m_capacity == 0) {
+                return false;
+            }
+            ++m_head;
+        }
+        return true;
+    }
+
+    // 从逻辑位置 pos 开始的 count 个槽位
+    spans m_spans(size_type pos, size_type count) noexcept {
+        const size_type begin = pos & m_mask;
+        const size_type first = count < m_capacity - begin ? count : m_capacity - begin;
+        return spans{tstl::span<T>(m_slots + begin, first),
+                     tstl::span<T>(m_slots, count - first)};
+    }
+};
+
+} // namespace tstl
+
+#endif
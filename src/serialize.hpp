@@ -0,0 +1,330 @@
+#ifndef TSTL_SRC_SERIALIZE_HPP
+#define TSTL_SRC_SERIALIZE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "deque.hpp"
+#include "list.hpp"
+#include "multimap.hpp"
+#include "unordered_map.hpp"
+#include "unordered_set.hpp"
+#include "vector.hpp"
+
+namespace tstl {
+
+// 容器的二进制序列化
+// 格式：容器先写入 uint64 的元素个数，再依次写入各个元素；可平凡复制的值直接写入其字节，
+// std::string 写入长度与字符，std::pair 依次写入两个成员。数值按机器的字节序存放，不能跨平台使用
+// 元素可平凡复制时，vector 整块一次读写，deque 每个缓冲区一次读写
+// multimap 只写入按键值排列的元素，不保存树的结构，读取时由 assign_sorted 以 O(n) 重建
+// 其他类型可以特化 serializer，提供 write、read 与 load 三个静态函数
+
+template <class T, class = void>
+struct serializer;
+
+inline void _serialize_bytes(std::ostream &os, const void *p, std::size_t n) {
+    os.write(static_cast<const char *>(p), static_cast<std::streamsize>(n));
+}
+
+// 数据不足时抛出 std::runtime_error，避免把残缺的内容当作有效数据
+inline void _deserialize_bytes(std::istream &is, void *p, std::size_t n) {
+    if (!is.read(static_cast<char *>(p), static_cast<std::streamsize>(n))) {
+        throw std::runtime_error("tstl::deserialize: unexpected end of stream");
+    }
+}
+
+inline void _serialize_size(std::ostream &os, std::size_t n) {
+    std::uint64_t size = n;
+    _serialize_bytes(os, &size, sizeof(size));
+}
+
+inline std::size_t _deserialize_size(std::istream &is) {
+    std::uint64_t size;
+    _deserialize_bytes(is, &size, sizeof(size));
+    return static_cast<std::size_t>(size);
+}
+
+// 读出元素个数并检查是否可信：不超过 max，且在流可定位时不超过剩余的字节数（每个元素至少一字节）
+inline std::size_t _deserialize_count(std::istream &is, std::size_t max) {
+    const std::uint64_t size = _deserialize_size(is);
+    bool plausible = size <= max;
+    const std::istream::pos_type cur = is.tellg();
+    if (plausible && cur != std::istream::pos_type(-1)) {
+        is.seekg(0, std::ios_base::end);
+        const std::istream::pos_type end = is.tellg();
+        is.seekg(cur);
+        plausible = end == std::istream::pos_type(-1) ||
+                    size <= static_cast<std::uint64_t>(end - cur);
+    }
+    if (!plausible) {
+        throw std::runtime_error("tstl::deserialize: implausible element count");
+    }
+    return static_cast<std::size_t>(size);
+}
+
+template <class T>
+void serialize(std::ostream &os, const T &value) {
+    serializer<T>::write(os, value);
+}
+
+template <class T>
+void deserialize(std::istream &is, T &value) {
+    serializer<T>::read(is, value);
+}
+
+// 读出一个值并返回，可用于 std::pair<const Key, T> 这类不能原地读取的类型
+template <class T>
+T _deserialize_load(std::istream &is) {
+    return serializer<T>::load(is);
+}
+
+template <class T>
+struct serializer<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> {
+    static void write(std::ostream &os, const T &value) {
+        _serialize_bytes(os, std::addressof(value), sizeof(T));
+    }
+    static void read(std::istream &is, T &value) {
+        _deserialize_bytes(is, std::addressof(value), sizeof(T));
+    }
+    static T load(std::istream &is) {
+        alignas(T) unsigned char buf[sizeof(T)];
+        _deserialize_bytes(is, buf, sizeof(T));
+        return *reinterpret_cast<T *>(buf);
+    }
+
+    // 连续存放的 n 个值一次读写
+    static void write_n(std::ostream &os, const T *p, std::size_t n) {
+        _serialize_bytes(os, p, n * sizeof(T));
+    }
+    static void read_n(std::istream &is, T *p, std::size_t n) {
+        _deserialize_bytes(is, p, n * sizeof(T));
+    }
+};
+
+template <class CharT, class Traits, class Alloc>
+struct serializer<std::basic_string<CharT, Traits, Alloc>> {
+    using string_type = std::basic_string<CharT, Traits, Alloc>;
+
+    static void write(std::ostream &os, const string_type &str) {
+        _serialize_size(os, str.size());
+        _serialize_bytes(os, str.data(), str.size() * sizeof(CharT));
+    }
+    static void read(std::istream &is, string_type &str) {
+        str.resize(_deserialize_count(is, str.max_size()));
+        _deserialize_bytes(is, &str[0], str.size() * sizeof(CharT));
+    }
+    static string_type load(std::istream &is) {
+        string_type str;
+        read(is, str);
+        return str;
+    }
+};
+
+template <class T1, class T2>
+struct serializer<std::pair<T1, T2>, typename std::enable_if<!std::is_trivially_copyable<
+                                         std::pair<T1, T2>>::value>::type> {
+    using first_type = typename std::remove_const<T1>::type;
+    using second_type = typename std::remove_const<T2>::type;
+
+    static void write(std::ostream &os, const std::pair<T1, T2> &value) {
+        serializer<first_type>::write(os, value.first);
+        serializer<second_type>::write(os, value.second);
+    }
+    static void read(std::istream &is, std::pair<T1, T2> &value) {
+        value = load(is);
+    }
+    static std::pair<T1, T2> load(std::istream &is) {
+        first_type first = serializer<first_type>::load(is);
+        second_type second = serializer<second_type>::load(is);
+        return std::pair<T1, T2>(std::move(first), std::move(second));
+    }
+};
+
+// 按顺序读写的容器共用的部分
+template <class Container>
+struct _sequence_serializer {
+    using value_type = typename Container::value_type;
+    using bulk = std::is_trivially_copyable<value_type>;
+
+    static void write_each(std::ostream &os, const Container &c) {
+        _serialize_size(os, c.size());
+        for (const auto &value : c) {
+            serializer<value_type>::write(os, value);
+        }
+    }
+
+    static Container load(std::istream &is) {
+        Container c;
+        serializer<Container>::read(is, c);
+        return c;
+    }
+};
+
+template <class T, class Alloc>
+struct serializer<tstl::vector<T, Alloc>> : _sequence_serializer<tstl::vector<T, Alloc>> {
+    using container = tstl::vector<T, Alloc>;
+    using base = _sequence_serializer<container>;
+
+    static void write(std::ostream &os, const container &vec) {
+        write(os, vec, typename base::bulk());
+    }
+    static void read(std::istream &is, container &vec) {
+        read(is, vec, typename base::bulk());
+    }
+
+  private:
+    static void write(std::ostream &os, const container &vec, std::true_type) {
+        _serialize_size(os, vec.size());
+        serializer<T>::write_n(os, vec.data(), vec.size());
+    }
+    static void write(std::ostream &os, const container &vec, std::false_type) {
+        base::write_each(os, vec);
+    }
+
+    static void read(std::istream &is, container &vec, std::true_type) {
+        vec.clear();
+        vec.resize(_deserialize_count(is, vec.max_size()));
+        serializer<T>::read_n(is, vec.data(), vec.size());
+    }
+    static void read(std::istream &is, container &vec, std::false_type) {
+        const std::size_t n = _deserialize_count(is, vec.max_size());
+        vec.clear();
+        vec.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            vec.push_back(serializer<T>::load(is));
+        }
+    }
+};
+
+template <class T, class Alloc>
+struct serializer<tstl::deque<T, Alloc>> : _sequence_serializer<tstl::deque<T, Alloc>> {
+    using container = tstl::deque<T, Alloc>;
+    using base = _sequence_serializer<container>;
+
+    static void write(std::ostream &os, const container &deq) {
+        write(os, deq, typename base::bulk());
+    }
+    static void read(std::istream &is, container &deq) {
+        read(is, deq, typename base::bulk());
+    }
+
+  private:
+    // 依次处理 [first, last) 落在各个缓冲区中的连续片段
+    template <class Iter, class Fn>
+    static void for_each_segment(Iter first, Iter last, Fn fn) {
+        while (first.m_node != last.m_node) {
+            fn(first.m_cur, static_cast<std::size_t>(first.m_last - first.m_cur));
+            first.m_set_node(first.m_node + 1);
+            first.m_cur = first.m_first;
+        }
+        fn(first.m_cur, static_cast<std::size_t>(last.m_cur - first.m_cur));
+    }
+
+    static void write(std::ostream &os, const container &deq, std::true_type) {
+        _serialize_size(os, deq.size());
+        for_each_segment(deq.begin(), deq.end(), [&os](const T *p, std::size_t n) {
+            serializer<T>::write_n(os, p, n);
+        });
+    }
+    static void write(std::ostream &os, const container &deq, std::false_type) {
+        base::write_each(os, deq);
+    }
+
+    static void read(std::istream &is, container &deq, std::true_type) {
+        deq.clear();
+        deq.resize(_deserialize_count(is, deq.max_size()));
+        for_each_segment(deq.begin(), deq.end(), [&is](T *p, std::size_t n) {
+            serializer<T>::read_n(is, p, n);
+        });
+    }
+    static void read(std::istream &is, container &deq, std::false_type) {
+        const std::size_t n = _deserialize_count(is, deq.max_size());
+        deq.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            deq.push_back(serializer<T>::load(is));
+        }
+    }
+};
+
+template <class T, class Alloc>
+struct serializer<tstl::list<T, Alloc>> : _sequence_serializer<tstl::list<T, Alloc>> {
+    using container = tstl::list<T, Alloc>;
+
+    static void write(std::ostream &os, const container &lst) {
+        _sequence_serializer<container>::write_each(os, lst);
+    }
+    static void read(std::istream &is, container &lst) {
+        const std::size_t n = _deserialize_count(is, lst.max_size());
+        lst.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            lst.push_back(serializer<T>::load(is));
+        }
+    }
+};
+
+template <class Key, class T, class Compare, class Alloc>
+struct serializer<tstl::multimap<Key, T, Compare, Alloc>>
+    : _sequence_serializer<tstl::multimap<Key, T, Compare, Alloc>> {
+    using container = tstl::multimap<Key, T, Compare, Alloc>;
+    using key_type = typename container::key_type;
+    using value_type = typename container::value_type;
+
+    static void write(std::ostream &os, const container &mp) {
+        _sequence_serializer<container>::write_each(os, mp);
+    }
+    // 元素按写入时的顺序即键值顺序读出，直接连成平衡的树
+    // assign_sorted 不检查顺序，读出每个元素时先与上一个键值比较，乱序的数据抛出异常
+    static void read(std::istream &is, container &mp) {
+        const std::size_t n = _deserialize_count(is, mp.max_size());
+        const Compare comp = mp.key_comp();
+        std::unique_ptr<key_type> prev;
+        mp.assign_sorted(n, [&] {
+            value_type value = serializer<value_type>::load(is);
+            if (!prev) {
+                prev.reset(new key_type(value.first));
+            } else if (comp(value.first, *prev)) {
+                throw std::runtime_error("tstl::deserialize: multimap keys out of order");
+            } else {
+                *prev = value.first;
+            }
+            return value;
+        });
+    }
+};
+
+// 哈希容器按遍历顺序写入，读取时先预留槽位再逐个插入
+template <class Container>
+struct _hash_serializer : _sequence_serializer<Container> {
+    using value_type = typename Container::value_type;
+
+    static void write(std::ostream &os, const Container &c) {
+        _sequence_serializer<Container>::write_each(os, c);
+    }
+    static void read(std::istream &is, Container &c) {
+        const std::size_t n = _deserialize_count(is, c.max_size());
+        c.clear();
+        c.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            c.insert(serializer<value_type>::load(is));
+        }
+    }
+};
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+struct serializer<tstl::unordered_map<Key, T, Hash, KeyEqual, Alloc>>
+    : _hash_serializer<tstl::unordered_map<Key, T, Hash, KeyEqual, Alloc>> {};
+
+template <class Key, class Hash, class KeyEqual, class Alloc>
+struct serializer<tstl::unordered_set<Key, Hash, KeyEqual, Alloc>>
+    : _hash_serializer<tstl::unordered_set<Key, Hash, KeyEqual, Alloc>> {};
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,510 @@
+#ifndef TSTL_SRC_SOA_VECTOR_HPP
+#define TSTL_SRC_SOA_VECTOR_HPP
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "algorithm.hpp"
+#include "iterator.hpp"
+#include "memory/memory_usage.hpp"
+#include "span.hpp"
+#include "vector.hpp"
+
+namespace tstl {
+
+// soa_vector 的随机访问迭代器，解引用得到由各列元素的引用组成的 tuple
+// 解引用返回的是临时的代理对象，没有 operator->
+template <class Vec, class Reference>
+class _soa_iterator {
+  public:
+    using iterator_category = tstl::random_access_iterator_tag;
+    using value_type = typename std::remove_const<Vec>::type::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Reference;
+
+    _soa_iterator() noexcept : m_vec(nullptr), m_pos(0) {
+    }
+
+    _soa_iterator(Vec *vec, std::size_t pos) noexcept : m_vec(vec), m_pos(pos) {
+    }
+
+    // iterator 可以转换为 const_iterator
+    template <class V, class R,
+              typename = typename std::enable_if<std::is_convertible<V *, Vec *>::value>::type>
+    _soa_iterator(const _soa_iterator<V, R> &other) noexcept
+        : m_vec(other.m_vec), m_pos(other.m_pos) {
+    }
+
+    reference operator*() const {
+        return (*m_vec)[m_pos];
+    }
+    reference operator[](difference_type n) const {
+        return (*m_vec)[m_pos + n];
+    }
+
+    // 在容器中的下标
+    std::size_t index() const noexcept {
+        return m_pos;
+    }
+
+    _soa_iterator &operator++() noexcept {
+        ++m_pos;
+        return *this;
+    }
+    _soa_iterator operator++(int) noexcept {
+        _soa_iterator tmp = *this;
+        ++m_pos;
+        return tmp;
+    }
+    _soa_iterator &operator--() noexcept {
+        --m_pos;
+        return *this;
+    }
+    _soa_iterator operator--(int) noexcept {
+        _soa_iterator tmp = *this;
+        --m_pos;
+        return tmp;
+    }
+    _soa_iterator &operator+=(difference_type n) noexcept {
+        m_pos += n;
+        return *this;
+    }
+    _soa_iterator &operator-=(difference_type n) noexcept {
+        m_pos -= n;
+        return *this;
+    }
+    _soa_iterator operator+(difference_type n) const noexcept {
+        return _soa_iterator(m_vec, m_pos + n);
+    }
+    _soa_iterator operator-(difference_type n) const noexcept {
+        return _soa_iterator(m_vec, m_pos - n);
+    }
+    friend _soa_iterator operator+(difference_type n, const _soa_iterator &it) noexcept {
+        return it + n;
+    }
+    difference_type operator-(const _soa_iterator &rhs) const noexcept {
+        return static_cast<difference_type>(m_pos) - static_cast<difference_type>(rhs.m_pos);
+    }
+
+    bool operator==(const _soa_iterator &rhs) const noexcept {
+        return m_pos == rhs.m_pos;
+    }
+    bool operator!=(const _soa_iterator &rhs) const noexcept {
+        return m_pos != rhs.m_pos;
+    }
+    bool operator<(const _soa_iterator &rhs) const noexcept {
+        return m_pos < rhs.m_pos;
+    }
+    bool operator>(const _soa_iterator &rhs) const noexcept {
+        return m_pos > rhs.m_pos;
+    }
+    bool operator<=(const _soa_iterator &rhs) const noexcept {
+        return m_pos <= rhs.m_pos;
+    }
+    bool operator>=(const _soa_iterator &rhs) const noexcept {
+        return m_pos >= rhs.m_pos;
+    }
+
+  private:
+    template <class V, class R>
+    friend class _soa_iterator;
+
+    Vec *m_vec;
+    std::size_t m_pos;
+};
+
+/**
+ * @brief 按列存储的 vector：每个字段各自存放在一个连续的数组中，行 i 由各列的第 i 个元素组成。
+ *
+ * 只读写少数字段的循环只会载入这些列，缓存行中不再混有用不到的字段；column<I>() 返回第 I 列的
+ * span，可以直接交给向量化的计算核心。各列同时扩容，容量始终相同。
+ * 下标访问与迭代器解引用返回由各列元素的引用组成的 tuple，可以使用结构化绑定。
+ */
+template <class... Ts>
+class soa_vector {
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+    using m_indices = std::index_sequence_for<Ts...>;
+
+  public:
+    using value_type = std::tuple<Ts...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<Ts &...>;
+    using const_reference = std::tuple<const Ts &...>;
+    using iterator = _soa_iterator<soa_vector, reference>;
+    using const_iterator = _soa_iterator<const soa_vector, const_reference>;
+
+    template <std::size_t I>
+    using column_type = typename std::tuple_element<I, value_type>::type;
+
+    static constexpr size_type column_count = sizeof...(Ts);
+
+    soa_vector() = default;
+
+    /**
+     * @brief 构造拥有 count 个值初始化的行的容器。
+     */
+    explicit soa_vector(size_type count) {
+        resize(count);
+    }
+
+    size_type size() const noexcept {
+        return std::get<0>(m_columns).size();
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    size_type capacity() const noexcept {
+        return std::get<0>(m_columns).capacity();
+    }
+
+    /**
+     * @brief 为每一列预留至少 new_cap 个元素的空间。
+     *
+     * 先为所有列分配新的存储，再一并替换；抛出异常时各列保持原样。
+     */
+    void reserve(size_type new_cap) {
+        if (new_cap > capacity()) {
+            m_reallocate(new_cap, m_indices());
+        }
+    }
+
+    /**
+     * @brief 改变行数，新增的行值初始化。
+     */
+    void resize(size_type count) {
+        if (count > capacity()) {
+            reserve(count);
+        }
+        m_for_each_column([count](auto &col) { col.resize(count); });
+    }
+
+    void clear() noexcept {
+        m_for_each_column([](auto &col) { col.clear(); });
+    }
+
+    /**
+     * @brief 返回第 pos 行，不进行边界检查。
+     */
+    reference operator[](size_type pos) noexcept {
+        return m_row(pos, m_indices());
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return m_row(pos, m_indices());
+    }
+
+    /**
+     * @brief 返回第 pos 行，越界时抛出 std::out_of_range。
+     */
+    reference at(size_type pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("soa_vector::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("soa_vector::at: out of range");
+        }
+        return (*this)[pos];
+    }
+
+    reference front() noexcept {
+        return (*this)[0];
+    }
+
+    const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    reference back() noexcept {
+        return (*this)[size() - 1];
+    }
+
+    const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    /**
+     * @brief 返回第 I 列的视图，长度为 size()。扩容后失效。
+     */
+    template <std::size_t I>
+    tstl::span<column_type<I>> column() noexcept {
+        auto &col = std::get<I>(m_columns);
+        return tstl::span<column_type<I>>(col.data(), col.size());
+    }
+
+    template <std::size_t I>
+    tstl::span<const column_type<I>> column() const noexcept {
+        const auto &col = std::get<I>(m_columns);
+        return tstl::span<const column_type<I>>(col.data(), col.size());
+    }
+
+    /**
+     * @brief 在末尾追加一行。
+     */
+    void push_back(const value_type &value) {
+        m_push_back_row(value, m_indices());
+    }
+
+    void push_back(value_type &&value) {
+        m_push_back_row(std::move(value), m_indices());
+    }
+
+    /**
+     * @brief 在末尾追加一行，第 i 个参数用于构造第 i 列的元素。
+     *
+     * 某一列的构造抛出异常时，已追加的其他列会被撤销，容器保持不变。
+     */
+    template <class... Args>
+    void emplace_back(Args &&...args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts),
+                      "soa_vector::emplace_back takes one argument per column");
+        m_emplace_back(m_indices(), std::forward<Args>(args)...);
+    }
+
+    void pop_back() noexcept {
+        m_for_each_column([](auto &col) { col.pop_back(); });
+    }
+
+    /**
+     * @brief 移除 pos 处的行，返回指向其后一行的迭代器。
+     */
+    iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    /**
+     * @brief 移除 [first, last) 中的行，返回指向其后一行的迭代器。
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        const size_type f = first.index();
+        const size_type l = last.index();
+        m_for_each_column([f, l](auto &col) { col.erase(col.begin() + f, col.begin() + l); });
+        return iterator(this, f);
+    }
+
+    /**
+     * @brief 按 cmp 对各行排序，cmp 接收两个 const_reference。排序不稳定。
+     *
+     * 先对行号排序，再按排好的行号逐列重排，每一列只顺序写入一次。
+     */
+    template <class Compare>
+    void sort(Compare cmp) {
+        const soa_vector &self = *this;
+        m_sort_order([&self, &cmp](size_type a, size_type b) { return cmp(self[a], self[b]); });
+    }
+
+    /**
+     * @brief 按各列的字典序对各行排序。
+     */
+    void sort() {
+        sort([](const const_reference &a, const const_reference &b) { return a < b; });
+    }
+
+    /**
+     * @brief 只按第 I 列对各行排序，比较时不读取其他列。
+     */
+    template <std::size_t I, class Compare = std::less<column_type<I>>>
+    void sort_by(Compare cmp = Compare()) {
+        const column_type<I> *key = std::get<I>(m_columns).data();
+        m_sort_order([key, &cmp](size_type a, size_type b) { return cmp(key[a], key[b]); });
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size());
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, size());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * @brief 返回各列占用内存之和，未使用的容量计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.overhead = sizeof(*this);
+        m_for_each_column([&usage](const auto &col) {
+            container_memory c = col.memory_usage();
+            usage.payload += c.payload;
+            usage.overhead += c.overhead - sizeof(col);
+        });
+        return usage;
+    }
+
+    void swap(soa_vector &other) noexcept {
+        m_columns.swap(other.m_columns);
+    }
+
+    friend bool operator==(const soa_vector &lhs, const soa_vector &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.size(); ++i) {
+            if (lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const soa_vector &lhs, const soa_vector &rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    std::tuple<tstl::vector<Ts>...> m_columns;
+
+    template <class Fn, std::size_t... I>
+    void m_for_each_column(Fn fn, std::index_sequence<I...>) {
+        (void)std::initializer_list<int>{(fn(std::get<I>(m_columns)), 0)...};
+    }
+
+    template <class Fn, std::size_t... I>
+    void m_for_each_column(Fn fn, std::index_sequence<I...>) const {
+        (void)std::initializer_list<int>{(fn(std::get<I>(m_columns)), 0)...};
+    }
+
+    template <class Fn>
+    void m_for_each_column(Fn fn) {
+        m_for_each_column(fn, m_indices());
+    }
+
+    template <class Fn>
+    void m_for_each_column(Fn fn) const {
+        m_for_each_column(fn, m_indices());
+    }
+
+    template <std::size_t... I>
+    reference m_row(size_type pos, std::index_sequence<I...>) noexcept {
+        return reference(std::get<I>(m_columns)[pos]...);
+    }
+
+    template <std::size_t... I>
+    const_reference m_row(size_type pos, std::index_sequence<I...>) const noexcept {
+        return const_reference(std::get<I>(m_columns)[pos]...);
+    }
+
+    template <class Tuple, std::size_t... I>
+    void m_push_back_row(Tuple &&row, std::index_sequence<I...> seq) {
+        m_emplace_back(seq, std::get<I>(std::forward<Tuple>(row))...);
+    }
+
+    // 容量足够时逐列追加；某列构造失败时把各列截回原来的长度
+    template <std::size_t... I, class... Args>
+    void m_emplace_back(std::index_sequence<I...> seq, Args &&...args) {
+        const size_type n = size();
+        if (n == capacity()) {
+            m_emplace_back_realloc(seq, std::forward<Args>(args)...);
+            return;
+        }
+        try {
+            (void)std::initializer_list<int>{
+                (std::get<I>(m_columns).emplace_back(std::forward<Args>(args)), 0)...};
+        } catch (...) {
+            m_for_each_column([n](auto &col) { col.erase(col.begin() + n, col.end()); });
+            throw;
+        }
+    }
+
+    // 参数可能引用已有的行，先在临时对象中构造新行，扩容之后再移入各列
+    template <std::size_t... I, class... Args>
+    void m_emplace_back_realloc(std::index_sequence<I...> seq, Args &&...args) {
+        const size_type n = size();
+        value_type row(std::forward<Args>(args)...);
+        reserve(n == 0 ? 1 : 2 * n);
+        m_emplace_back(seq, std::move(std::get<I>(row))...);
+    }
+
+    // 第一趟复制移动可能抛出异常的列，第二趟移动其余的列；第一趟失败时原有的列都未被改动
+    template <std::size_t... I>
+    void m_reallocate(size_type new_cap, std::index_sequence<I...>) {
+        std::tuple<tstl::vector<Ts>...> fresh;
+        (void)std::initializer_list<int>{(std::get<I>(fresh).reserve(new_cap), 0)...};
+        (void)std::initializer_list<int>{
+            (m_transfer_column(std::get<I>(m_columns), std::get<I>(fresh), std::false_type(),
+                               typename std::is_nothrow_move_constructible<Ts>::type()),
+             0)...};
+        (void)std::initializer_list<int>{
+            (m_transfer_column(std::get<I>(m_columns), std::get<I>(fresh), std::true_type(),
+                               typename std::is_nothrow_move_constructible<Ts>::type()),
+             0)...};
+        m_columns.swap(fresh);
+    }
+
+    template <class Col, class Pass, class Nothrow>
+    static void m_transfer_column(Col &, Col &, Pass, Nothrow) noexcept {
+    }
+
+    template <class Col>
+    static void m_transfer_column(Col &src, Col &dst, std::false_type, std::false_type) {
+        for (auto &value : src) {
+            dst.push_back(value);
+        }
+    }
+
+    template <class Col>
+    static void m_transfer_column(Col &src, Col &dst, std::true_type, std::true_type) noexcept {
+        for (auto &value : src) {
+            dst.push_back(std::move(value));
+        }
+    }
+
+    // 对行号排序，再把每一列按排好的行号移动到新的数组中
+    template <class IndexCompare>
+    void m_sort_order(IndexCompare cmp) {
+        const size_type n = size();
+        tstl::vector<size_type> order(n);
+        for (size_type i = 0; i < n; ++i) {
+            order[i] = i;
+        }
+        tstl::sort(order.data(), order.data() + n, cmp);
+        const size_type *idx = order.data();
+        m_for_each_column([n, idx](auto &col) {
+            using T = typename std::decay<decltype(col)>::type::value_type;
+            tstl::vector<T> sorted;
+            sorted.reserve(n);
+            for (size_type i = 0; i < n; ++i) {
+                sorted.push_back(std::move(col[idx[i]]));
+            }
+            col.swap(sorted);
+        });
+    }
+};
+
+template <class... Ts>
+void swap(soa_vector<Ts...> &lhs, soa_vector<Ts...> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef TSTL_SRC_SPAN_HPP
+#define TSTL_SRC_SPAN_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator.hpp"
+
+namespace tstl {
+
+/**
+ * @brief 连续存储的一段元素的视图，不拥有元素，等同于 C++20 的 std::span（动态长度）。
+ */
+template <class T>
+class span {
+  public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using reverse_iterator = tstl::reverse_iterator<iterator>;
+
+    /**
+     * @brief 构造空的视图。
+     */
+    constexpr span() noexcept : m_data(nullptr), m_size(0) {
+    }
+
+    /**
+     * @brief 构造从 first 开始、长度为 count 的视图。
+     */
+    constexpr span(pointer first, size_type count) noexcept : m_data(first), m_size(count) {
+    }
+
+    /**
+     * @brief 构造 [first, last) 的视图。
+     */
+    constexpr span(pointer first, pointer last) noexcept
+        : m_data(first), m_size(static_cast<size_type>(last - first)) {
+    }
+
+    /**
+     * @brief 由 span<U> 构造，允许 span<T> 转为 span<const T>。
+     */
+    template <class U, typename = typename std::enable_if<
+                           std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    constexpr span(const span<U> &other) noexcept : m_data(other.data()), m_size(other.size()) {
+    }
+
+    /**
+     * @brief 返回指向首元素的迭代器。
+     */
+    constexpr iterator begin() const noexcept {
+        return m_data;
+    }
+
+    /**
+     * @brief 返回指向末元素后一元素的迭代器。
+     */
+    constexpr iterator end() const noexcept {
+        return m_data + m_size;
+    }
+
+    reverse_iterator rbegin() const noexcept {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() const noexcept {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * @brief 访问首元素。
+     */
+    constexpr reference front() const {
+        assert(m_size != 0);
+        return m_data[0];
+    }
+
+    /**
+     * @brief 访问末元素。
+     */
+    constexpr reference back() const {
+        assert(m_size != 0);
+        return m_data[m_size - 1];
+    }
+
+    /**
+     * @brief 访问第 idx 个元素，不检查越界。
+     */
+    constexpr reference operator[](size_type idx) const {
+        assert(idx < m_size);
+        return m_data[idx];
+    }
+
+    /**
+     * @brief 返回指向首元素的指针。
+     */
+    constexpr pointer data() const noexcept {
+        return m_data;
+    }
+
+    /**
+     * @brief 返回元素个数。
+     */
+    constexpr size_type size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * @brief 返回元素所占的字节数。
+     */
+    constexpr size_type size_bytes() const noexcept {
+        return m_size * sizeof(element_type);
+    }
+
+    /**
+     * @brief 检查视图是否为空。
+     */
+    constexpr bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief 返回从 offset 开始、长度为 count 的子视图，count 缺省时直到末尾。
+     */
+    constexpr span subspan(size_type offset, size_type count = size_type(-1)) const {
+        assert(offset <= m_size);
+        return span(m_data + offset, count == size_type(-1) ? m_size - offset : count);
+    }
+
+  private:
+    pointer m_data;
+    size_type m_size;
+};
+
+} // namespace tstl
+
+#endif
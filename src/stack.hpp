@@ -3,12 +3,20 @@
 
 #include "iterator.hpp"
 #include "algorithm.hpp"
-#include <limits>
-#include <deque>
+#include "chunked_storage.hpp"
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace tstl {
 
-template <class T, class Container = std::deque<T>>
+/**
+ * @brief 后进先出的栈，在 Container 的末尾加入与取出元素。
+ *
+ * Container 需要提供 back、push_back、emplace_back 与 pop_back，默认为 tstl::chunked_storage，
+ * 增长时不搬移已有元素。
+ */
+template <class T, class Container = tstl::chunked_storage<T>>
 class stack {
 
   public:
@@ -34,31 +42,31 @@ class stack {
     explicit stack(const Container &cont) : c(cont) {
     }
 
-    explicit stack(Container &&cont) : c(cont) {
+    explicit stack(Container &&cont) : c(std::move(cont)) {
     }
 
     stack(const stack &other) = default;
 
-    stack(stack &&other) noexcept = default;
+    stack(stack &&other) = default;
 
-    template <class Alloc, _Uses<Alloc>>
+    template <class Alloc, typename = _Uses<Alloc>>
     explicit stack(const Alloc &alloc) : c(alloc) {
     }
 
-    template <class Alloc, _Uses<Alloc>>
+    template <class Alloc, typename = _Uses<Alloc>>
     stack(const Container &cont, const Alloc &alloc) : c(cont, alloc) {
     }
 
-    template <class Alloc, _Uses<Alloc>>
-    stack(Container &&cont, const Alloc &alloc) : c(cont, alloc) {
+    template <class Alloc, typename = _Uses<Alloc>>
+    stack(Container &&cont, const Alloc &alloc) : c(std::move(cont), alloc) {
     }
 
-    template <class Alloc, _Uses<Alloc>>
+    template <class Alloc, typename = _Uses<Alloc>>
     stack(const stack &other, const Alloc &alloc) : c(other.c, alloc) {
     }
 
-    template <class Alloc, _Uses<Alloc>>
-    stack(stack &&other, const Alloc &alloc) : c(other.c, alloc) {
+    template <class Alloc, typename = _Uses<Alloc>>
+    stack(stack &&other, const Alloc &alloc) : c(std::move(other.c), alloc) {
     }
 
     ~stack() = default;
@@ -100,6 +108,23 @@ class stack {
         c.pop_back();
     }
 
+    /**
+     * @brief 依次压入 [first, last) 中的元素，last 之前的元素位于栈顶。
+     *
+     * 需要 Container 提供 push_range。
+     */
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    void push_range(InputIt first, InputIt last) {
+        c.push_range(first, last);
+    }
+
+    /**
+     * @brief 弹出栈顶的 n 个元素，n 不能超过 size()。需要 Container 提供 pop_n。
+     */
+    void pop_n(size_type n) {
+        c.pop_n(n);
+    }
+
     void swap(stack &other) noexcept {
         tstl::swap(c, other.c);
     }
@@ -109,7 +134,7 @@ class stack {
     }
 
     friend bool operator!=(const stack &lhs, const stack &rhs) {
-        return lhs.c != rhs.c;
+        return !(lhs.c == rhs.c);
     }
 
     friend bool operator<(const stack &lhs, const stack &rhs) {
@@ -117,15 +142,15 @@ class stack {
     }
 
     friend bool operator>(const stack &lhs, const stack &rhs) {
-        return lhs.c > rhs.c;
+        return rhs.c < lhs.c;
     }
 
     friend bool operator<=(const stack &lhs, const stack &rhs) {
-        return lhs.c < rhs.c;
+        return !(rhs.c < lhs.c);
     }
 
     friend bool operator>=(const stack &lhs, const stack &rhs) {
-        return lhs.c > rhs.c;
+        return !(lhs.c < rhs.c);
     }
 
     friend void swap(stack &lhs, stack &rhs) {
@@ -136,8 +161,8 @@ class stack {
 /**
  * @brief 为 stack 特化 swap 算法。
  */
-template <class T, class Alloc>
-void swap(stack<T, Alloc> &lhs, stack<T, Alloc> &rhs) {
+template <class T, class Container>
+void swap(stack<T, Container> &lhs, stack<T, Container> &rhs) {
     lhs.swap(rhs);
 }
 
@@ -0,0 +1,305 @@
+#ifndef TSTL_SRC_UNORDERED_MAP_HPP
+#define TSTL_SRC_UNORDERED_MAP_HPP
+
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "hashtable.hpp"
+
+namespace tstl {
+
+// 键值唯一的哈希映射，底层为开放寻址的 hashtable
+// 与 std::unordered_map 不同，元素直接存放在槽位数组中：扩容与删除后的重建会移动元素，
+// 使所有迭代器、指针与引用失效
+template <class Key,
+          class T,
+          class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T>>>
+class unordered_map {
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+  private:
+    using base_type = tstl::hashtable<value_type, Hash, KeyEqual, Allocator>;
+    base_type m_table;
+
+  public:
+    using pointer = typename base_type::pointer;
+    using const_pointer = typename base_type::const_pointer;
+    using reference = typename base_type::reference;
+    using const_reference = typename base_type::const_reference;
+    using iterator = typename base_type::iterator;
+    using const_iterator = typename base_type::const_iterator;
+    using size_type = typename base_type::size_type;
+    using difference_type = typename base_type::difference_type;
+    using allocator_type = typename base_type::allocator_type;
+
+  public:
+    // 构造、复制、移动函数
+    unordered_map() = default;
+
+    ~unordered_map() = default;
+
+    explicit unordered_map(size_type bucket_count,
+                           const Hash &hash = Hash(),
+                           const KeyEqual &equal = KeyEqual(),
+                           const Allocator &alloc = Allocator())
+        : m_table(bucket_count, hash, equal, alloc) {
+    }
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    unordered_map(InputIt first, InputIt last) : m_table() {
+        m_table.insert_unique(first, last);
+    }
+
+    unordered_map(std::initializer_list<value_type> ilist) : m_table(ilist.size()) {
+        m_table.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    unordered_map(const unordered_map &other) = default;
+
+    unordered_map(unordered_map &&other) noexcept = default;
+
+    unordered_map &operator=(const unordered_map &rhs) = default;
+
+    unordered_map &operator=(unordered_map &&rhs) noexcept = default;
+
+    unordered_map &operator=(std::initializer_list<value_type> ilist) {
+        m_table.clear();
+        m_table.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 接口
+    hasher hash_function() const {
+        return m_table.hash_function();
+    }
+
+    key_equal key_eq() const {
+        return m_table.key_eq();
+    }
+
+    allocator_type get_allocator() const {
+        return m_table.get_allocator();
+    }
+
+    iterator begin() noexcept {
+        return m_table.begin();
+    }
+
+    const_iterator begin() const noexcept {
+        return m_table.begin();
+    }
+
+    iterator end() noexcept {
+        return m_table.end();
+    }
+
+    const_iterator end() const noexcept {
+        return m_table.end();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // 容量相关
+    bool empty() const noexcept {
+        return m_table.empty();
+    }
+
+    size_type size() const noexcept {
+        return m_table.size();
+    }
+
+    size_type max_size() const noexcept {
+        return m_table.max_size();
+    }
+
+    size_type bucket_count() const noexcept {
+        return m_table.bucket_count();
+    }
+
+    float load_factor() const noexcept {
+        return m_table.load_factor();
+    }
+
+    float max_load_factor() const noexcept {
+        return m_table.max_load_factor();
+    }
+
+    void reserve(size_type count) {
+        m_table.reserve(count);
+    }
+
+    void rehash(size_type count) {
+        m_table.rehash(count);
+    }
+
+    // 访问元素
+    mapped_type &at(const key_type &key) {
+        auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("unordered_map::at: key not found");
+        }
+        return it->second;
+    }
+
+    const mapped_type &at(const key_type &key) const {
+        auto it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("unordered_map::at: key not found");
+        }
+        return it->second;
+    }
+
+    mapped_type &operator[](const key_type &key) {
+        return try_emplace(key).first->second;
+    }
+
+    mapped_type &operator[](key_type &&key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    // 插入删除操作
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return m_table.insert_unique(value);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return m_table.insert_unique(std::move(value));
+    }
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    void insert(InputIt first, InputIt last) {
+        m_table.insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        m_table.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        return m_table.emplace_unique(std::forward<Args>(args)...);
+    }
+
+    // 键值已存在时不构造任何对象，args 也不会被移动
+    template <class K, class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        const key_type &k = key;
+        return m_table.emplace_key(k, std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<K>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj) {
+        auto res = try_emplace(key, std::forward<M>(obj));
+        if (!res.second) {
+            res.first->second = std::forward<M>(obj);
+        }
+        return res;
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(key_type &&key, M &&obj) {
+        auto res = try_emplace(std::move(key), std::forward<M>(obj));
+        if (!res.second) {
+            res.first->second = std::forward<M>(obj);
+        }
+        return res;
+    }
+
+    iterator erase(const_iterator pos) {
+        return m_table.erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return m_table.erase(first, last);
+    }
+
+    size_type erase(const key_type &key) {
+        return m_table.erase(key);
+    }
+
+    void clear() noexcept {
+        m_table.clear();
+    }
+
+    void swap(unordered_map &other) noexcept {
+        m_table.swap(other.m_table);
+    }
+
+    // 查找
+    iterator find(const key_type &key) {
+        return m_table.find(key);
+    }
+
+    const_iterator find(const key_type &key) const {
+        return m_table.find(key);
+    }
+
+    size_type count(const key_type &key) const {
+        return m_table.count(key);
+    }
+
+    bool contains(const key_type &key) const {
+        return m_table.contains(key);
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type &key) {
+        auto first = find(key);
+        auto last = first;
+        if (last != end()) {
+            ++last;
+        }
+        return {first, last};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+        auto first = find(key);
+        auto last = first;
+        if (last != end()) {
+            ++last;
+        }
+        return {first, last};
+    }
+
+    friend bool operator==(const unordered_map &lhs, const unordered_map &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (auto &kv : lhs) {
+            auto it = rhs.find(kv.first);
+            if (it == rhs.end() || !(it->second == kv.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const unordered_map &lhs, const unordered_map &rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+void swap(unordered_map<Key, T, Hash, KeyEqual, Allocator> &lhs,
+          unordered_map<Key, T, Hash, KeyEqual, Allocator> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef TSTL_SRC_UNORDERED_SET_HPP
+#define TSTL_SRC_UNORDERED_SET_HPP
+
+#include <functional>
+#include <initializer_list>
+
+#include "hashtable.hpp"
+
+namespace tstl {
+
+// 元素唯一的哈希集合，底层为开放寻址的 hashtable
+// 扩容与删除后的重建会移动元素，使所有迭代器、指针与引用失效
+template <class Key,
+          class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class Allocator = std::allocator<Key>>
+class unordered_set {
+  public:
+    using key_type = Key;
+    using value_type = Key;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+  private:
+    using base_type = tstl::hashtable<value_type, Hash, KeyEqual, Allocator>;
+    base_type m_table;
+
+  public:
+    // 元素不可修改，iterator 与 const_iterator 相同
+    using pointer = typename base_type::const_pointer;
+    using const_pointer = typename base_type::const_pointer;
+    using reference = typename base_type::const_reference;
+    using const_reference = typename base_type::const_reference;
+    using iterator = typename base_type::const_iterator;
+    using const_iterator = typename base_type::const_iterator;
+    using size_type = typename base_type::size_type;
+    using difference_type = typename base_type::difference_type;
+    using allocator_type = typename base_type::allocator_type;
+
+  public:
+    // 构造、复制、移动函数
+    unordered_set() = default;
+
+    ~unordered_set() = default;
+
+    explicit unordered_set(size_type bucket_count,
+                           const Hash &hash = Hash(),
+                           const KeyEqual &equal = KeyEqual(),
+                           const Allocator &alloc = Allocator())
+        : m_table(bucket_count, hash, equal, alloc) {
+    }
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    unordered_set(InputIt first, InputIt last) : m_table() {
+        m_table.insert_unique(first, last);
+    }
+
+    unordered_set(std::initializer_list<value_type> ilist) : m_table(ilist.size()) {
+        m_table.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    unordered_set(const unordered_set &other) = default;
+
+    unordered_set(unordered_set &&other) noexcept = default;
+
+    unordered_set &operator=(const unordered_set &rhs) = default;
+
+    unordered_set &operator=(unordered_set &&rhs) noexcept = default;
+
+    unordered_set &operator=(std::initializer_list<value_type> ilist) {
+        m_table.clear();
+        m_table.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 接口
+    hasher hash_function() const {
+        return m_table.hash_function();
+    }
+
+    key_equal key_eq() const {
+        return m_table.key_eq();
+    }
+
+    allocator_type get_allocator() const {
+        return m_table.get_allocator();
+    }
+
+    iterator begin() const noexcept {
+        return m_table.begin();
+    }
+
+    iterator end() const noexcept {
+        return m_table.end();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // 容量相关
+    bool empty() const noexcept {
+        return m_table.empty();
+    }
+
+    size_type size() const noexcept {
+        return m_table.size();
+    }
+
+    size_type max_size() const noexcept {
+        return m_table.max_size();
+    }
+
+    size_type bucket_count() const noexcept {
+        return m_table.bucket_count();
+    }
+
+    float load_factor() const noexcept {
+        return m_table.load_factor();
+    }
+
+    float max_load_factor() const noexcept {
+        return m_table.max_load_factor();
+    }
+
+    void reserve(size_type count) {
+        m_table.reserve(count);
+    }
+
+    void rehash(size_type count) {
+        m_table.rehash(count);
+    }
+
+    // 插入删除操作
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return m_table.insert_unique(value);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return m_table.insert_unique(std::move(value));
+    }
+
+    template <class InputIt, typename = tstl::_RequireInputIter<InputIt>>
+    void insert(InputIt first, InputIt last) {
+        m_table.insert_unique(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        m_table.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        return m_table.emplace_unique(std::forward<Args>(args)...);
+    }
+
+    iterator erase(const_iterator pos) {
+        return m_table.erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        return m_table.erase(first, last);
+    }
+
+    size_type erase(const key_type &key) {
+        return m_table.erase(key);
+    }
+
+    void clear() noexcept {
+        m_table.clear();
+    }
+
+    void swap(unordered_set &other) noexcept {
+        m_table.swap(other.m_table);
+    }
+
+    // 查找
+    iterator find(const key_type &key) const {
+        return m_table.find(key);
+    }
+
+    size_type count(const key_type &key) const {
+        return m_table.count(key);
+    }
+
+    bool contains(const key_type &key) const {
+        return m_table.contains(key);
+    }
+
+    friend bool operator==(const unordered_set &lhs, const unordered_set &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (auto &key : lhs) {
+            if (!rhs.contains(key)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const unordered_set &lhs, const unordered_set &rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template <class Key, class Hash, class KeyEqual, class Allocator>
+void swap(unordered_set<Key, Hash, KeyEqual, Allocator> &lhs,
+          unordered_set<Key, Hash, KeyEqual, Allocator> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tstl
+
+#endif
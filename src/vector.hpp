@@ -4,6 +4,9 @@
 #include "iterator.hpp"
 #include "algorithm.hpp"
 #include "memory/uninitialized.hpp"
+#include "memory/memory_usage.hpp"
+#include "memory/memory_resource.hpp"
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 
@@ -13,6 +16,10 @@ template <class T, class Allocator = std::allocator<T>>
 class vector {
   private:
     using alloc_traits = std::allocator_traits<Allocator>;
+    // 元素可平凡复制且分配器提供 reallocate 时，扩容交给分配器调整存储，而不是逐个复制元素
+    using m_use_reallocate =
+        tstl::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                          tstl::_alloc_has_reallocate<Allocator>::value>;
 
   public:
     using value_type = T;
@@ -83,7 +90,9 @@ class vector {
     /**
      * @brief 移动构造函数。
      */
-    vector(vector &&other) noexcept = default;
+    vector(vector &&other) noexcept : m_alloc(std::move(other.m_alloc)) {
+        m_swap_data(other);
+    }
 
     /**
      * @brief 有分配器扩展的移动构造函数。
@@ -105,7 +114,7 @@ class vector {
      * @brief 销毁 vector。
      */
     ~vector() {
-        m_destroy(m_start);
+        m_destroy(m_start, m_finish);
         m_deallocate(m_start, capacity());
     }
 
@@ -138,8 +147,11 @@ class vector {
      * @brief 移动赋值运算符。
      */
 
-    vector &operator=(vector &&other) noexcept {
-        m_move_assign(std::move(other));
+    vector &operator=(vector &&other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
+        m_move_assign(std::move(other),
+                      typename alloc_traits::propagate_on_container_move_assignment());
         return *this;
     }
 
@@ -358,7 +370,7 @@ class vector {
      */
     size_type max_size() const {
         size_type diff_max = std::numeric_limits<difference_type>::max();
-        size_type alloc_max = alloc_traits::max_size();
+        size_type alloc_max = alloc_traits::max_size(m_alloc);
         return tstl::min(diff_max, alloc_max);
     }
 
@@ -373,13 +385,7 @@ class vector {
     void reserve(size_type new_cap) {
         if (capacity() >= new_cap)
             return;
-        const size_type old_size = size();
-        iterator tmp = m_allocate_and_copy(new_cap, m_start, m_finish);
-        m_destroy(m_start, m_finish);
-        m_deallocate(m_start, m_end_of_storage - m_start);
-        m_start = tmp;
-        m_finish = tmp + old_size;
-        m_end_of_storage = m_start + new_cap;
+        m_reserve(new_cap, m_use_reallocate());
     }
 
     /**
@@ -389,6 +395,16 @@ class vector {
         return tstl::distance(m_start, m_end_of_storage);
     }
 
+    /**
+     * @brief 返回容器占用的内存，未使用的容量计入额外开销。
+     */
+    container_memory memory_usage() const noexcept {
+        container_memory usage;
+        usage.payload = size() * sizeof(T);
+        usage.overhead = sizeof(*this) + (capacity() - size()) * sizeof(T);
+        return usage;
+    }
+
     void shrink_to_fit() {
         // TODO
     }
@@ -408,7 +424,7 @@ class vector {
     iterator insert(const_iterator pos, const T &value) {
         const size_type offset = pos - cbegin();
         if (m_finish != m_end_of_storage) {
-            if (pos == end()) {
+            if (pos == cend()) {
                 m_construct(m_finish, value);
                 ++m_finish;
             } else {
@@ -489,7 +505,7 @@ class vector {
      * @brief 移动 value 进新元素。
      */
     void push_back(T &&value) {
-        emplace_back(value);
+        emplace_back(std::move(value));
     }
 
     /**
@@ -538,10 +554,10 @@ class vector {
     /**
      * @brief 与 other 的交换。
      */
+    // 分配器不随交换传播时，要求两者相等
     void swap(vector &other) {
-        tstl::swap(m_start, other.m_start);
-        tstl::swap(m_finish, other.m_finish);
-        tstl::swap(m_end_of_storage, other.m_end_of_storage);
+        m_swap_data(other);
+        m_swap_alloc(other, typename alloc_traits::propagate_on_container_swap());
     }
 
     friend bool operator==(const vector &lhs, const vector &rhs) {
@@ -692,6 +708,12 @@ class vector {
         tstl::swap(m_end_of_storage, other.m_end_of_storage);
     }
 
+    void m_swap_alloc(vector &other, std::true_type) {
+        tstl::swap(m_alloc, other.m_alloc);
+    }
+    void m_swap_alloc(vector &, std::false_type) {
+    }
+
     template <class InputIt>
     void m_insert_dispatch(iterator pos, InputIt first, InputIt last, false_type) {
         m_range_insert(pos, first, last, tstl::_iterator_category(first));
@@ -792,18 +814,78 @@ class vector {
         }
     }
 
-    void m_move_assign(vector &&other) {
+    // 分配器随移动转移：原有元素交给以原分配器构造的 tmp 释放，再接管 other 的存储
+    void m_move_assign(vector &&other, std::true_type) {
         vector tmp(get_allocator());
+        m_swap_data(tmp);
+        m_alloc = other.m_alloc;
         m_swap_data(other);
-        tmp.m_swap_data(other);
+    }
+
+    // 分配器不随移动转移时，只有两者相等才能直接接管存储，否则逐个移动到自己的存储中
+    void m_move_assign(vector &&other, std::false_type) {
+        if (m_alloc == other.m_alloc) {
+            vector tmp(get_allocator());
+            m_swap_data(tmp);
+            m_swap_data(other);
+        } else {
+            clear();
+            reserve(other.size());
+            for (T &value : other) {
+                emplace_back(std::move(value));
+            }
+            other.clear();
+        }
     }
 
     iterator m_emplace_aux(const_iterator pos, T &&value) {
         return m_insert_rval(pos, std::move(value));
     }
 
+    void m_reserve(size_type new_cap, tstl::false_type) {
+        const size_type old_size = size();
+        pointer tmp = m_allocate_and_copy(new_cap, m_start, m_finish);
+        m_destroy(m_start, m_finish);
+        m_deallocate(m_start, m_end_of_storage - m_start);
+        m_start = tmp;
+        m_finish = tmp + old_size;
+        m_end_of_storage = m_start + new_cap;
+    }
+
+    void m_reserve(size_type new_cap, tstl::true_type) {
+        m_reallocate_storage(new_cap);
+    }
+
+    // 由分配器把存储调整为 new_cap 个元素，已有元素的字节随之保留
+    void m_reallocate_storage(size_type new_cap) {
+        const size_type old_size = size();
+        m_start = m_alloc.reallocate(m_start, capacity(), new_cap);
+        m_finish = m_start + old_size;
+        m_end_of_storage = m_start + new_cap;
+    }
+
     template <class... Args>
     void m_realloc_insert(iterator pos, Args &&...args) {
+        m_realloc_insert_aux(m_use_reallocate(), pos, std::forward<Args>(args)...);
+    }
+
+    // args 可能引用旧存储中的元素，先构造出新元素再调整存储
+    template <class... Args>
+    void m_realloc_insert_aux(tstl::true_type, iterator pos, Args &&...args) {
+        T value(std::forward<Args>(args)...);
+        const size_type elems_before = pos - begin();
+        const size_type elems_after = end() - pos;
+        m_reallocate_storage(m_check_len(1));
+        pointer p = m_start + elems_before;
+        if (elems_after != 0) {
+            std::memmove(static_cast<void *>(p + 1), p, elems_after * sizeof(T));
+        }
+        m_construct(p, std::move(value));
+        ++m_finish;
+    }
+
+    template <class... Args>
+    void m_realloc_insert_aux(tstl::false_type, iterator pos, Args &&...args) {
         const size_type len = m_check_len(1);
         pointer old_start = m_start;
         pointer old_finish = m_finish;
@@ -934,6 +1016,11 @@ void swap(vector<T, Alloc> &lhs, vector<T, Alloc> &rhs) {
     lhs.swap(rhs);
 }
 
+namespace pmr {
+template <class T>
+using vector = tstl::vector<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstl
 
 #endif
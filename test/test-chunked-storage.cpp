@@ -0,0 +1,160 @@
+#ifndef TEST_TEST_CHUNKED_STORAGE
+#define TEST_TEST_CHUNKED_STORAGE
+
+#include "../src/chunked_storage.hpp"
+#include "../src/memory/memory_resource.hpp"
+#include "../src/stack.hpp"
+#include "../src/vector.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(ChunkedStorageTest, All) {
+    using storage = tstl::chunked_storage<int>;
+    const std::size_t first = storage::first_chunk_size;
+    storage s;
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.capacity(), 0);
+
+    // 已有元素的地址在增长过程中保持不变
+    std::vector<int *> addr;
+    for (int i = 0; i < 10000; ++i) {
+        s.push_back(i);
+        addr.push_back(&s.back());
+    }
+    EXPECT_EQ(s.size(), 10000);
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_EQ(&s[i], addr[i]);
+        ASSERT_EQ(s[i], i);
+    }
+    EXPECT_EQ(s.front(), 0);
+    EXPECT_THROW(s.at(10000), std::out_of_range);
+
+    // 块容量依次翻倍
+    std::size_t cap = 0;
+    std::size_t chunk = first;
+    while (cap < 10000) {
+        cap += chunk;
+        chunk *= 2;
+    }
+    EXPECT_EQ(s.capacity(), cap);
+
+    s.pop_n(10000 - static_cast<int>(first));
+    EXPECT_EQ(s.size(), first);
+    EXPECT_EQ(s.back(), static_cast<int>(first) - 1);
+    EXPECT_EQ(s.capacity(), cap);
+    s.push_back(-1);
+    EXPECT_EQ(&s.back(), addr[first]);
+    s.pop_back();
+    s.shrink_to_fit();
+    EXPECT_EQ(s.capacity(), first);
+    s.clear();
+    s.shrink_to_fit();
+    EXPECT_EQ(s.capacity(), 0);
+
+    int src[] = {1, 2, 3, 4, 5};
+    s.push_range(src, src + 5);
+    storage t = {1, 2, 3, 4, 5};
+    EXPECT_TRUE(s == t);
+    t.push_back(0);
+    EXPECT_TRUE(s < t);
+    t.pop_back();
+    t.back() = 6;
+    EXPECT_TRUE(s < t);
+    EXPECT_TRUE(t > s);
+    EXPECT_TRUE(s <= t);
+    EXPECT_FALSE(s >= t);
+}
+
+TEST(ChunkedStorageTest, Random) {
+    std::mt19937 gen(50);
+    tstl::chunked_storage<std::string> s;
+    std::vector<std::string> expect;
+    for (int round = 0; round < 3000; ++round) {
+        int op = static_cast<int>(gen() % 4);
+        if (op == 0) {
+            s.emplace_back(std::to_string(round));
+            expect.push_back(std::to_string(round));
+        } else if (op == 1) {
+            tstl::vector<std::string> src(gen() % 100, std::to_string(round));
+            s.push_range(src.begin(), src.end());
+            expect.insert(expect.end(), src.data(), src.data() + src.size());
+        } else if (op == 2 && !expect.empty()) {
+            std::size_t n = gen() % (expect.size() + 1);
+            s.pop_n(n);
+            expect.resize(expect.size() - n);
+        } else if (!expect.empty()) {
+            ASSERT_EQ(s.back(), expect.back());
+            s.pop_back();
+            expect.pop_back();
+        }
+        ASSERT_EQ(s.size(), expect.size());
+        if (!expect.empty()) {
+            ASSERT_EQ(s.back(), expect.back());
+        }
+    }
+    std::size_t i = 0;
+    s.for_each([&](const std::string &v) { EXPECT_EQ(v, expect[i++]); });
+    EXPECT_EQ(i, expect.size());
+
+    tstl::chunked_storage<std::string> copy = s;
+    EXPECT_TRUE(copy == s);
+    tstl::chunked_storage<std::string> moved = std::move(copy);
+    EXPECT_TRUE(moved == s);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(moved.memory_usage().payload, s.size() * sizeof(std::string));
+}
+
+// 多态分配器不随复制、移动与交换传播，资源不同时逐个复制或移动元素
+TEST(ChunkedStorageTest, Allocator) {
+    using pmr_storage =
+        tstl::chunked_storage<std::string, tstl::pmr::polymorphic_allocator<std::string>>;
+    tstl::pmr::unsynchronized_pool_resource r1, r2;
+    pmr_storage a(&r1), b(&r2);
+    for (int i = 0; i < 1000; ++i) {
+        b.push_back(std::to_string(i));
+    }
+
+    a = b;
+    EXPECT_EQ(a.get_allocator().resource(), &r1);
+    EXPECT_TRUE(a == b);
+
+    pmr_storage c(&r1);
+    c.push_back("x");
+    c = std::move(b);
+    EXPECT_EQ(c.get_allocator().resource(), &r1);
+    EXPECT_EQ(c.size(), 1000);
+    EXPECT_EQ(c.back(), "999");
+    EXPECT_TRUE(b.empty());
+
+    // 资源相同时直接接管块
+    const std::string *first = &a.front();
+    pmr_storage d(std::move(a), &r1);
+    EXPECT_EQ(&d.front(), first);
+    EXPECT_TRUE(a.empty());
+    pmr_storage e(std::move(d), &r2);
+    EXPECT_EQ(e.get_allocator().resource(), &r2);
+    EXPECT_EQ(e.size(), 1000);
+    EXPECT_EQ(e[500], "500");
+
+    pmr_storage f(&r1);
+    f.push_back("f");
+    c.swap(f);
+    EXPECT_EQ(c.size(), 1);
+    EXPECT_EQ(f.size(), 1000);
+    EXPECT_EQ(f.get_allocator().resource(), &r1);
+
+    using pmr_stack = tstl::stack<std::string, pmr_storage>;
+    pmr_stack s1{pmr_storage(&r1)}, s2{pmr_storage(&r2)};
+    s2.push("top");
+    s1 = s2;
+    EXPECT_EQ(s1.top(), "top");
+    s1 = std::move(s2);
+    EXPECT_EQ(s1.size(), 1);
+
+    // std::allocator 的移动赋值不会抛出异常
+    static_assert(std::is_nothrow_move_assignable<tstl::chunked_storage<int>>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<pmr_storage>::value, "");
+}
+
+#endif
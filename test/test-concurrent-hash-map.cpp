@@ -0,0 +1,127 @@
+#ifndef TEST_TEST_CONCURRENT_HASH_MAP
+#define TEST_TEST_CONCURRENT_HASH_MAP
+
+#include "../src/concurrent_hash_map.hpp"
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST(ConcurrentHashMapTest, All) {
+    // 映射值不可按字节复制
+    tstl::concurrent_hash_map<int, std::string> mp(8);
+    EXPECT_EQ(mp.shard_count(), 8);
+    EXPECT_TRUE(mp.insert_or_assign(1, "a"));
+    EXPECT_FALSE(mp.insert_or_assign(1, "b"));
+    std::string value;
+    EXPECT_TRUE(mp.find(1, value));
+    EXPECT_EQ(value, "b");
+    EXPECT_FALSE(mp.find(2, value));
+    EXPECT_TRUE(mp.visit(1, [](std::string &s) { s += "c"; }));
+    EXPECT_FALSE(mp.visit(2, [](std::string &) {}));
+    mp.find(1, value);
+    EXPECT_EQ(value, "bc");
+    EXPECT_TRUE(mp.erase(1));
+    EXPECT_FALSE(mp.erase(1));
+    EXPECT_TRUE(mp.empty());
+
+    // 插入删除交替，覆盖扩容与清理墓碑
+    std::mt19937 gen(21);
+    tstl::concurrent_hash_map<int, int> imp(4);
+    std::unordered_map<int, int> expect;
+    for (int i = 0; i < 200000; ++i) {
+        int key = static_cast<int>(gen() % 5000);
+        if (gen() % 3 == 0) {
+            EXPECT_EQ(imp.erase(key), expect.erase(key) == 1);
+        } else {
+            EXPECT_EQ(imp.insert_or_assign(key, i), expect.count(key) == 0);
+            expect[key] = i;
+        }
+    }
+    EXPECT_EQ(imp.size(), expect.size());
+    for (int key = 0; key < 5000; ++key) {
+        int v = -1;
+        auto it = expect.find(key);
+        ASSERT_EQ(imp.find(key, v), it != expect.end());
+        if (it != expect.end()) {
+            EXPECT_EQ(v, it->second);
+        }
+        EXPECT_EQ(imp.contains(key), it != expect.end());
+    }
+    imp.clear();
+    EXPECT_TRUE(imp.empty());
+    EXPECT_FALSE(imp.contains(0));
+    imp.insert_or_assign(0, 1);
+    EXPECT_TRUE(imp.contains(0));
+}
+
+// 两个字段总是一起写入，读者不应读到只写了一半的值
+struct TwoHalves {
+    long long a;
+    long long b;
+};
+
+TEST(ConcurrentHashMapTest, ConcurrentReadersAndWriters) {
+    tstl::concurrent_hash_map<int, TwoHalves> mp(4);
+    tstl::concurrent_hash_map<int, long long> counters(4);
+    const int keys = 2000;
+    const int writers = 2;
+    const int readers = 2;
+    const int rounds = 20000;
+    std::atomic<bool> torn(false);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            std::mt19937 gen(w);
+            for (int i = 0; i < rounds; ++i) {
+                int key = static_cast<int>(gen() % keys);
+                long long v = gen();
+                if (i % 5 == 0) {
+                    mp.erase(key);
+                } else {
+                    mp.insert_or_assign(key, TwoHalves{v, -v});
+                }
+                counters.insert_or_assign(i % 16 + w * 16, 0LL);
+            }
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            std::mt19937 gen(100 + r);
+            TwoHalves value;
+            for (int i = 0; i < rounds; ++i) {
+                if (mp.find(static_cast<int>(gen() % keys), value) && value.a != -value.b) {
+                    torn = true;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_FALSE(torn);
+    EXPECT_EQ(counters.size(), writers * 16);
+
+    // visit 在分片锁内修改，并发累加不丢失
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                counters.visit(i % 8, [](long long &c) { ++c; });
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    long long total = 0;
+    for (int k = 0; k < 8; ++k) {
+        long long c = 0;
+        counters.find(k, c);
+        total += c;
+    }
+    EXPECT_EQ(total, 4 * 10000);
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef TEST_TEST_COUNTING_ALLOCATOR
+#define TEST_TEST_COUNTING_ALLOCATOR
+
+#include "../src/memory/counting_allocator.hpp"
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/multimap.hpp"
+#include "../src/vector.hpp"
+
+TEST(CountingAllocatorTest, All) {
+    tstl::allocation_stats stats;
+    tstl::counting_allocator<std::allocator<int>> alloc(stats);
+    {
+        tstl::vector<int, tstl::counting_allocator<std::allocator<int>>> vec(alloc);
+        for (int i = 0; i < 1000; ++i) {
+            vec.push_back(i);
+        }
+        // 每次扩容都是一次新的分配，旧的存储随即释放
+        EXPECT_EQ(stats.live_allocations(), 1);
+        EXPECT_EQ(stats.live_bytes, vec.capacity() * sizeof(int));
+        EXPECT_GE(stats.peak_bytes, stats.live_bytes);
+        EXPECT_GT(stats.allocations, 5);
+        EXPECT_EQ(stats.histogram[tstl::allocation_stats::bucket(vec.capacity() * sizeof(int))],
+                  1);
+    }
+    EXPECT_EQ(stats.live_bytes, 0);
+    EXPECT_EQ(stats.allocations, stats.deallocations);
+
+    // rebind 后的分配器共享同一份统计，结点与中控器都计入其中
+    stats.reset();
+    {
+        using pair_alloc = tstl::counting_allocator<std::allocator<std::pair<const int, int>>>;
+        tstl::multimap<int, int, std::less<int>, pair_alloc> mp{pair_alloc(stats)};
+        tstl::list<int, tstl::counting_allocator<std::allocator<int>>> lst(alloc);
+        tstl::deque<int, tstl::counting_allocator<std::allocator<int>>> deq(alloc);
+        for (int i = 0; i < 100; ++i) {
+            mp.emplace(i, i);
+            lst.push_back(i);
+            deq.push_back(i);
+        }
+        auto mp_usage = mp.memory_usage();
+        auto lst_usage = lst.memory_usage();
+        auto deq_usage = deq.memory_usage();
+        EXPECT_EQ(stats.live_bytes, mp_usage.total() - sizeof(mp) + lst_usage.total() -
+                                        sizeof(lst) + deq_usage.total() - sizeof(deq));
+        EXPECT_EQ(mp.get_allocator(), pair_alloc(stats));
+    }
+    EXPECT_EQ(stats.live_bytes, 0);
+    EXPECT_GT(stats.peak_bytes, 0);
+}
+
+TEST(CountingAllocatorTest, MemoryUsage) {
+    tstl::vector<int> vec;
+    vec.reserve(100);
+    vec.push_back(1);
+    EXPECT_EQ(vec.memory_usage().payload, sizeof(int));
+    EXPECT_EQ(vec.memory_usage().overhead, sizeof(vec) + 99 * sizeof(int));
+
+    tstl::list<int> lst = {1, 2, 3};
+    EXPECT_EQ(lst.memory_usage().payload, 3 * sizeof(int));
+    EXPECT_GT(lst.memory_usage().overhead, 3 * 2 * sizeof(void *));
+
+    tstl::deque<char> deq;
+    deq.push_back('a');
+    EXPECT_EQ(deq.memory_usage().payload, 1);
+    EXPECT_GE(deq.memory_usage().overhead, TSTL_DEQUE_BUF_SIZE - 1);
+
+    tstl::multimap<int, int> mp;
+    EXPECT_EQ(mp.memory_usage().payload, 0);
+    EXPECT_EQ(mp.memory_usage().overhead, sizeof(mp));
+    mp.emplace(1, 1);
+    EXPECT_EQ(mp.memory_usage().payload, sizeof(std::pair<const int, int>));
+}
+
+#endif
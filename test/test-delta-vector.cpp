@@ -0,0 +1,79 @@
+#ifndef TEST_TEST_DELTA_VECTOR
+#define TEST_TEST_DELTA_VECTOR
+
+#include "../src/delta_vector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+TEST(DeltaVectorTest, All) {
+    std::mt19937_64 gen(441);
+    std::vector<std::uint64_t> expect;
+    std::uint64_t v = 1000;
+    for (int i = 0; i < 10000; ++i) {
+        // 差值的位宽按块变化，偶尔出现重复值与很大的跳跃
+        int r = static_cast<int>(gen() % 100);
+        v += r < 10 ? 0 : r < 98 ? gen() % (1u << (i / 1000)) : gen() >> 8;
+        expect.push_back(v);
+    }
+    // 范围构造要求 tstl 的迭代器，用指针传入
+    tstl::delta_vector vec(expect.data(), expect.data() + expect.size());
+    ASSERT_EQ(vec.size(), expect.size());
+    EXPECT_EQ(vec.front(), expect.front());
+    EXPECT_EQ(vec.back(), expect.back());
+    for (std::size_t i = 0; i < expect.size(); i += 7) {
+        ASSERT_EQ(vec[i], expect[i]);
+    }
+    EXPECT_EQ(vec.at(9999), expect[9999]);
+    EXPECT_THROW(vec.at(10000), std::out_of_range);
+    EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expect.begin()));
+
+    std::vector<std::uint64_t> out;
+    vec.decode(std::back_inserter(out));
+    EXPECT_EQ(out, expect);
+
+    for (int i = 0; i < 2000; ++i) {
+        std::uint64_t key = i % 2 == 0 ? expect[gen() % expect.size()] : gen() % (v + 10);
+        auto it = vec.lower_bound(key);
+        auto pos = std::lower_bound(expect.begin(), expect.end(), key) - expect.begin();
+        ASSERT_EQ(it.index(), static_cast<std::size_t>(pos));
+        if (it != vec.end()) {
+            EXPECT_EQ(*it, expect[pos]);
+        }
+        EXPECT_EQ(vec.contains(key), std::binary_search(expect.begin(), expect.end(), key));
+    }
+    EXPECT_EQ(vec.lower_bound(0).index(), 0);
+    EXPECT_TRUE(vec.lower_bound(v + 1) == vec.end());
+
+    EXPECT_THROW(vec.push_back(v - 1), std::invalid_argument);
+    vec.push_back(v);
+    EXPECT_EQ(vec.size(), 10001);
+    EXPECT_TRUE(vec != tstl::delta_vector(expect.data(), expect.data() + expect.size()));
+}
+
+TEST(DeltaVectorTest, Compression) {
+    // 相邻差值小于 16 的 100 万个时间戳，每个元素约 4 位
+    tstl::delta_vector vec;
+    std::uint64_t ts = 1700000000000ull;
+    for (int i = 0; i < 1000000; ++i) {
+        ts += static_cast<std::uint64_t>(i % 16);
+        vec.push_back(ts);
+    }
+    EXPECT_EQ(vec.back(), ts);
+    EXPECT_LT(vec.memory_usage().total(), 1000000 * sizeof(std::uint64_t) / 10);
+    std::uint64_t sum = 0;
+    for (auto x : vec) {
+        sum += x - 1700000000000ull;
+    }
+    EXPECT_GT(sum, 0);
+
+    tstl::delta_vector empty;
+    EXPECT_TRUE(empty.begin() == empty.end());
+    EXPECT_TRUE(empty.lower_bound(5) == empty.end());
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TEST_TEST_DYNAMIC_BITSET
+#define TEST_TEST_DYNAMIC_BITSET
+
+#include "../src/dynamic_bitset.hpp"
+#include <random>
+#include <vector>
+
+TEST(DynamicBitsetTest, All) {
+    tstl::dynamic_bitset bits(130);
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.num_blocks(), 3);
+    EXPECT_TRUE(bits.none());
+    EXPECT_EQ(bits.find_first(), tstl::dynamic_bitset::npos);
+
+    bits.set(0).set(63).set(64).set(129);
+    EXPECT_EQ(bits.count(), 4);
+    EXPECT_TRUE(bits[63]);
+    EXPECT_FALSE(bits[62]);
+    EXPECT_TRUE(bits.test(129));
+    EXPECT_THROW(bits.test(130), std::out_of_range);
+    EXPECT_EQ(bits.find_first(), 0);
+    EXPECT_EQ(bits.find_next(0), 63);
+    EXPECT_EQ(bits.find_next(63), 64);
+    EXPECT_EQ(bits.find_next(64), 129);
+    EXPECT_EQ(bits.find_next(129), tstl::dynamic_bitset::npos);
+    bits.reset(63).flip(1);
+    EXPECT_EQ(bits.find_next(0), 1);
+    EXPECT_EQ(bits.find_next(1), 64);
+
+    // 末尾字中超出 size() 的位保持为 0
+    bits.flip();
+    EXPECT_EQ(bits.count(), 130 - 4);
+    bits.set();
+    EXPECT_TRUE(bits.all());
+    EXPECT_EQ(bits.count(), 130);
+    EXPECT_EQ((~bits).count(), 0);
+
+    tstl::dynamic_bitset grown(3, true);
+    grown.resize(70, true);
+    EXPECT_EQ(grown.count(), 70);
+    grown.resize(5);
+    grown.resize(200);
+    EXPECT_EQ(grown.count(), 5);
+    grown.push_back(true);
+    EXPECT_EQ(grown.size(), 201);
+    EXPECT_TRUE(grown[200]);
+
+    tstl::dynamic_bitset str("0110010");
+    EXPECT_EQ(str.to_string(), "0110010");
+    EXPECT_THROW(tstl::dynamic_bitset("01x"), std::invalid_argument);
+}
+
+TEST(DynamicBitsetTest, SetOperations) {
+    std::mt19937_64 gen(46);
+    for (std::size_t n : {0, 1, 63, 64, 65, 255, 256, 1000, 4099}) {
+        std::vector<bool> va(n);
+        std::vector<bool> vb(n);
+        tstl::dynamic_bitset a(n);
+        tstl::dynamic_bitset b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            va[i] = gen() % 3 == 0;
+            vb[i] = gen() % 2 == 0;
+            a.set(i, va[i]);
+            b.set(i, vb[i]);
+        }
+        std::size_t cnt_and = 0, cnt_or = 0, cnt_xor = 0, cnt_andnot = 0, cnt_a = 0;
+        std::vector<std::size_t> ones;
+        for (std::size_t i = 0; i < n; ++i) {
+            cnt_and += va[i] && vb[i];
+            cnt_or += va[i] || vb[i];
+            cnt_xor += va[i] != vb[i];
+            cnt_andnot += va[i] && !vb[i];
+            cnt_a += va[i];
+            if (va[i]) {
+                ones.push_back(i);
+            }
+        }
+        EXPECT_EQ(a.count(), cnt_a);
+        EXPECT_EQ(and_count(a, b), cnt_and);
+        EXPECT_EQ(or_count(a, b), cnt_or);
+        EXPECT_EQ(xor_count(a, b), cnt_xor);
+        EXPECT_EQ(andnot_count(a, b), cnt_andnot);
+        EXPECT_EQ(a.intersects(b), cnt_and != 0);
+
+        tstl::dynamic_bitset r = a & b;
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(r[i], va[i] && vb[i]);
+        }
+        EXPECT_EQ((a | b).count(), cnt_or);
+        EXPECT_EQ((a ^ b).count(), cnt_xor);
+        EXPECT_EQ(andnot(a, b).count(), cnt_andnot);
+        r.assign_or(a, b);
+        EXPECT_EQ(r, a | b);
+
+        tstl::dynamic_bitset c = a;
+        c &= b;
+        EXPECT_EQ(c, a & b);
+        c = a;
+        c |= b;
+        EXPECT_EQ(c, a | b);
+        c = a;
+        c ^= b;
+        EXPECT_EQ(c, a ^ b);
+        c = a;
+        c.andnot(b);
+        EXPECT_EQ(c, andnot(a, b));
+
+        // 遍历为 1 的位的三种方式结果一致
+        std::vector<std::size_t> got;
+        for (std::size_t i : a.ones()) {
+            got.push_back(i);
+        }
+        EXPECT_EQ(got, ones);
+        got.clear();
+        a.for_each_one([&got](std::size_t i) { got.push_back(i); });
+        EXPECT_EQ(got, ones);
+        got.clear();
+        for (std::size_t i = a.find_first(); i != tstl::dynamic_bitset::npos; i = a.find_next(i)) {
+            got.push_back(i);
+        }
+        EXPECT_EQ(got, ones);
+    }
+    tstl::dynamic_bitset a(10);
+    tstl::dynamic_bitset b(11);
+    EXPECT_THROW(a &= b, std::invalid_argument);
+    EXPECT_THROW(and_count(a, b), std::invalid_argument);
+
+    // 1000 万位只占约 1.2 MB
+    tstl::dynamic_bitset big(10000000);
+    EXPECT_EQ(big.memory_usage().payload, 156250 * sizeof(std::uint64_t));
+}
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef TEST_TEST_EXTERNAL_SORT
+#define TEST_TEST_EXTERNAL_SORT
+
+#include "../src/external_sort.hpp"
+#include "../src/vector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(ExternalSortTest, QuickSort) {
+    // 有序、逆序与大量重复的输入不会退化
+    tstl::vector<int> vec;
+    for (int i = 0; i < 1000000; ++i) {
+        vec.push_back(i);
+    }
+    tstl::sort(vec.begin(), vec.end(), std::greater<int>());
+    EXPECT_TRUE(std::is_sorted(vec.begin(), vec.end(), std::greater<int>()));
+    tstl::sort(vec.begin(), vec.end());
+    EXPECT_TRUE(std::is_sorted(vec.begin(), vec.end()));
+
+    std::mt19937 gen(43);
+    for (auto &x : vec) {
+        x = static_cast<int>(gen() % 10);
+    }
+    tstl::sort(vec.begin(), vec.end());
+    EXPECT_TRUE(std::is_sorted(vec.begin(), vec.end()));
+    EXPECT_EQ(std::count(vec.begin(), vec.end(), 0) > 0, true);
+
+    for (int n = 0; n < 40; ++n) {
+        std::vector<int> small(n);
+        for (auto &x : small) {
+            x = static_cast<int>(gen() % 8);
+        }
+        std::vector<int> expect = small;
+        std::sort(expect.begin(), expect.end());
+        tstl::sort(small.data(), small.data() + small.size());
+        EXPECT_EQ(small, expect);
+    }
+}
+
+// McIlroy 的对抗比较器：元素的值在第一次需要区分时才确定，迫使快速排序每轮只分出少量元素
+struct sort_adversary {
+    std::vector<int> val;
+    int gas;
+    int solid = 0;
+    int candidate = 0;
+    long comparisons = 0;
+
+    explicit sort_adversary(int n) : val(n, n), gas(n) {
+    }
+    bool less(int x, int y) {
+        ++comparisons;
+        if (val[x] == gas && val[y] == gas) {
+            val[x == candidate ? x : y] = solid++;
+        }
+        if (val[x] == gas) {
+            candidate = x;
+        } else if (val[y] == gas) {
+            candidate = y;
+        }
+        return val[x] < val[y];
+    }
+};
+
+TEST(ExternalSortTest, QuickSortWorstCase) {
+    const int n = 20000;
+    sort_adversary adv(n);
+    std::vector<int> idx(n);
+    for (int i = 0; i < n; ++i) {
+        idx[i] = i;
+    }
+    tstl::sort(idx.begin(), idx.end(), [&adv](int x, int y) { return adv.less(x, y); });
+    // 超过深度限制后改用堆排序，比较次数为 O(n log n)，远小于 n^2 / 4
+    EXPECT_LT(adv.comparisons, 40L * n * 15);
+    for (int i = 1; i < n; ++i) {
+        EXPECT_LT(adv.val[idx[i - 1]], adv.val[idx[i]]);
+    }
+}
+
+TEST(ExternalSortTest, Iterators) {
+    std::mt19937_64 gen(431);
+    std::vector<std::uint64_t> input(300000);
+    for (auto &x : input) {
+        x = gen() % 100000;
+    }
+    std::vector<std::uint64_t> expect = input;
+    std::sort(expect.begin(), expect.end());
+
+    // 全部放得进内存
+    std::vector<std::uint64_t> out;
+    tstl::external_sort(input.begin(), input.end(), std::back_inserter(out));
+    EXPECT_EQ(out, expect);
+
+    // 每段 8192 个元素，共 37 段；每轮至多归并 2 段，需要多轮归并
+    out.clear();
+    tstl::external_sort(input.begin(), input.end(), std::back_inserter(out),
+                        std::less<std::uint64_t>(), 64 * 1024, testing::TempDir().c_str());
+    EXPECT_EQ(out, expect);
+
+    out.clear();
+    tstl::external_sort(input.begin(), input.end(), std::back_inserter(out),
+                        std::greater<std::uint64_t>(), 4 * 1024 * 1024);
+    std::reverse(expect.begin(), expect.end());
+    EXPECT_EQ(out, expect);
+
+    out.clear();
+    tstl::external_sort(input.begin(), input.begin(), std::back_inserter(out),
+                        std::less<std::uint64_t>(), 64);
+    EXPECT_TRUE(out.empty());
+}
+
+struct external_sort_record {
+    std::uint32_t key;
+    std::uint32_t seq;
+    char payload[24];
+};
+
+TEST(ExternalSortTest, File) {
+    const std::string in = testing::TempDir() + "tstl_external_sort_in.bin";
+    const std::string out = testing::TempDir() + "tstl_external_sort_out.bin";
+    std::mt19937 gen(4311);
+    std::vector<external_sort_record> records(100000);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        records[i].key = gen() % 5000;
+        records[i].seq = static_cast<std::uint32_t>(i);
+        std::snprintf(records[i].payload, sizeof(records[i].payload), "%u", records[i].seq);
+    }
+    std::FILE *f = std::fopen(in.c_str(), "wb");
+    std::fwrite(records.data(), sizeof(external_sort_record), records.size(), f);
+    std::fclose(f);
+
+    auto by_key = [](const external_sort_record &a, const external_sort_record &b) {
+        return a.key < b.key;
+    };
+    tstl::external_sort_file<external_sort_record>(in.c_str(), out.c_str(), by_key, 256 * 1024);
+
+    std::vector<external_sort_record> sorted(records.size() + 1);
+    f = std::fopen(out.c_str(), "rb");
+    std::size_t n = std::fread(sorted.data(), sizeof(external_sort_record), sorted.size(), f);
+    std::fclose(f);
+    ASSERT_EQ(n, records.size());
+    sorted.resize(n);
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), by_key));
+    std::vector<int> seen(records.size());
+    for (const auto &r : sorted) {
+        EXPECT_EQ(std::to_string(r.seq), r.payload);
+        ++seen[r.seq];
+    }
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), 1), records.size());
+
+    std::remove(in.c_str());
+    std::remove(out.c_str());
+    EXPECT_THROW(tstl::external_sort_file<int>(in.c_str(), out.c_str()), std::system_error);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TEST_TEST_GROUPED_MULTIMAP
+#define TEST_TEST_GROUPED_MULTIMAP
+
+#include "../src/grouped_multimap.hpp"
+#include <map>
+#include <random>
+#include <string>
+
+template <class K, class V>
+using grouped_multimap = tstl::grouped_multimap<K, V, std::less<K>>;
+
+TEST(GroupedMultimapTest, All) {
+    grouped_multimap<int, std::string> mp = {{2, "b"}, {1, "a"}, {2, "c"}};
+    mp.insert({2, "d"});
+    mp.emplace(3, 2, 'e');
+    EXPECT_EQ(mp.size(), 5);
+    EXPECT_EQ(mp.group_count(), 3);
+    EXPECT_EQ(mp.count(2), 3);
+    EXPECT_EQ(mp.count(4), 0);
+    EXPECT_TRUE(mp.contains(1));
+
+    // 同键值的元素按插入顺序连续存放
+    auto range = mp.equal_range(2);
+    ASSERT_EQ(range.size(), 3);
+    EXPECT_EQ(range[0], "b");
+    EXPECT_EQ(range[1], "c");
+    EXPECT_EQ(range.back(), "d");
+    EXPECT_EQ(range.data() + 1, &range[1]);
+    range[0] = "x";
+    EXPECT_EQ(mp.equal_range(2).front(), "x");
+    EXPECT_EQ(mp.equal_range(3).front(), "ee");
+    EXPECT_TRUE(mp.equal_range(4).empty());
+
+    const auto &cmp = mp;
+    tstl::span<const std::string> crange = cmp.equal_range(1);
+    EXPECT_EQ(crange.size(), 1);
+
+    int keys[] = {1, 2, 3};
+    int i = 0;
+    for (auto it = mp.begin(); it != mp.end(); ++it, ++i) {
+        EXPECT_EQ(it->first, keys[i]);
+    }
+
+    grouped_multimap<int, std::string> copied(mp);
+    EXPECT_EQ(mp.erase(2), 3);
+    EXPECT_EQ(mp.erase(2), 0);
+    EXPECT_EQ(mp.size(), 2);
+    EXPECT_EQ(mp.group_count(), 2);
+    EXPECT_EQ(copied.count(2), 3);
+
+    grouped_multimap<int, std::string> moved(std::move(copied));
+    EXPECT_TRUE(copied.empty());
+    EXPECT_EQ(moved.size(), 5);
+    grouped_multimap<int, std::string> &self = moved;
+    moved = std::move(self);
+    EXPECT_EQ(moved.size(), 5);
+    EXPECT_FALSE(moved.empty());
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(moved.begin(), moved.end());
+}
+
+TEST(GroupedMultimapTest, SkewedKeys) {
+    std::mt19937 gen(3);
+    grouped_multimap<int, int> mp;
+    std::multimap<int, int> model;
+    for (int i = 0; i < 20000; ++i) {
+        // 少数键值占据大部分元素
+        int key = gen() % 4 == 0 ? static_cast<int>(gen() % 1000) : static_cast<int>(gen() % 8);
+        mp.emplace(key, i);
+        model.emplace(key, i);
+    }
+    EXPECT_EQ(mp.size(), model.size());
+    for (int key = 0; key < 1000; ++key) {
+        auto range = mp.equal_range(key);
+        auto expect = model.equal_range(key);
+        EXPECT_EQ(range.size(), model.count(key));
+        EXPECT_TRUE(std::equal(range.begin(), range.end(), expect.first,
+                               [](int v, const std::pair<const int, int> &kv) {
+                                   return v == kv.second;
+                               }));
+    }
+    mp.shrink_to_fit();
+    EXPECT_EQ(mp.count(0), model.count(0));
+}
+
+#endif
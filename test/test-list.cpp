@@ -93,6 +93,51 @@ TEST(ListTest, Sort) {
         l.sort([](int a, int b) { return a > b; });
         list<int> expect_2 = {9, 8, 7, 5, 4, 2, 2, 1};
         EXPECT_EQ(l, expect_2);
+    } {
+        // 稳定：键相同的元素保持原有相对顺序
+        list<std::pair<int, int>> l;
+        for (int i = 0; i < 1000; ++i) {
+            l.push_back({(i * 7) % 10, i});
+        }
+        l.sort([](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+            return a.first < b.first;
+        });
+        auto prev = l.front();
+        for (auto it = ++l.begin(); it != l.end(); prev = *it++) {
+            EXPECT_TRUE(prev.first < it->first ||
+                        (prev.first == it->first && prev.second < it->second));
+        }
+    } {
+        // 比较抛出异常时所有元素仍在链表中
+        list<int> l;
+        for (int i = 0; i < 300; ++i) {
+            l.push_back(300 - i);
+        }
+        int calls = 0;
+        EXPECT_THROW(l.sort([&calls](int a, int b) {
+            if (++calls == 1000) {
+                throw std::runtime_error("cmp");
+            }
+            return a < b;
+        }),
+                     std::runtime_error);
+        EXPECT_EQ(l.size(), 300);
+        long sum = 0;
+        int count = 0;
+        for (int v : l) {
+            sum += v;
+            ++count;
+        }
+        EXPECT_EQ(count, 300);
+        EXPECT_EQ(sum, 300 * 301 / 2);
+        count = 0;
+        for (auto it = l.rbegin(); it != l.rend(); ++it) {
+            ++count;
+        }
+        EXPECT_EQ(count, 300);
+        l.sort();
+        EXPECT_EQ(l.front(), 1);
+        EXPECT_EQ(l.back(), 300);
     } {
         list<int> l1 = {1, 3, 5};
         list<int> l2 = {2, 4, 6};
@@ -0,0 +1,85 @@
+#ifndef TEST_TEST_MAPPED_VECTOR
+#define TEST_TEST_MAPPED_VECTOR
+
+#include "../src/mapped_vector.hpp"
+#include "../src/vector.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <system_error>
+
+TEST(MappedVectorTest, All) {
+    const std::string path = testing::TempDir() + "tstl_mapped_vector_test.bin";
+    std::remove(path.c_str());
+    using mvec = tstl::mapped_vector<std::uint64_t>;
+
+    {
+        mvec vec(path.c_str(), mvec::read_write);
+        EXPECT_TRUE(vec.empty());
+        for (std::uint64_t i = 0; i < 100000; ++i) {
+            vec.push_back(i * i);
+        }
+        // 追加的元素来自映射本身，扩容后仍要读到正确的值
+        vec.push_back(vec.back());
+        vec.append(vec.data(), vec.data() + 10);
+        EXPECT_EQ(vec.size(), 100011);
+        EXPECT_EQ(vec[100000], 99999ull * 99999ull);
+        EXPECT_EQ(vec[100010], 81);
+        vec.resize(100005);
+        vec.flush();
+    }
+
+    {
+        // 只读映射是私有的，写入元素不会影响文件与其他映射
+        mvec writable_view(path.c_str());
+        writable_view[0] = 42;
+        *writable_view.begin() += 1;
+        EXPECT_EQ(writable_view.front(), 43);
+
+        const mvec vec(path.c_str());
+        EXPECT_FALSE(vec.writable());
+        EXPECT_EQ(vec.size(), 100005);
+        EXPECT_EQ(vec.capacity(), 100005);
+        EXPECT_EQ(vec.front(), 0);
+        EXPECT_EQ(vec.at(1000), 1000000);
+        EXPECT_THROW(vec.at(100005), std::out_of_range);
+        EXPECT_THROW(writable_view.push_back(1), std::logic_error);
+        std::uint64_t sum = 0;
+        for (auto x : vec) {
+            sum += x;
+        }
+        tstl::vector<std::uint64_t> copy(vec.begin(), vec.end());
+        EXPECT_EQ(copy.size(), 100005);
+        EXPECT_EQ(copy[100002], 1);
+        EXPECT_EQ(*vec.rbegin(), 9);
+
+        // 多个只读映射共享同一文件
+        mvec other(path.c_str());
+        EXPECT_EQ(other.size(), vec.size());
+        const mvec &shared = other;
+        EXPECT_EQ(shared[4321], vec[4321]);
+
+        const mvec moved(std::move(other));
+        EXPECT_FALSE(other.is_open());
+        EXPECT_EQ(moved.back(), 9);
+        EXPECT_NE(sum, 0);
+    }
+
+    // 以读写模式重新打开后继续追加
+    {
+        mvec vec(path.c_str(), mvec::read_write);
+        vec.push_back(7);
+        EXPECT_EQ(vec.size(), 100006);
+    }
+    {
+        const mvec vec(path.c_str());
+        EXPECT_EQ(vec.back(), 7);
+    }
+
+    // 元素大小不符或文件不存在
+    EXPECT_THROW(tstl::mapped_vector<std::uint32_t>(path.c_str()), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(mvec(path.c_str()), std::system_error);
+}
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef TEST_TEST_MEMORY_RESOURCE
+#define TEST_TEST_MEMORY_RESOURCE
+
+#include "../src/memory/memory_resource.hpp"
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/multimap.hpp"
+#include "../src/vector.hpp"
+#include <cstdint>
+#include <string>
+
+// 记录经过自身的字节数，用于确认嵌套容器的内存来自同一个资源
+class TrackingResource : public tstl::pmr::memory_resource {
+  public:
+    std::size_t live = 0;
+    std::size_t allocations = 0;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+        live += bytes;
+        ++allocations;
+        return tstl::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override {
+        live -= bytes;
+        tstl::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(MemoryResourceTest, MonotonicBuffer) {
+    alignas(16) char buffer[256];
+    tstl::pmr::monotonic_buffer_resource res(buffer, sizeof(buffer),
+                                             tstl::pmr::null_memory_resource());
+    void *a = res.allocate(10, 1);
+    void *b = res.allocate(16, 16);
+    EXPECT_EQ(a, buffer);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 16, 0);
+    EXPECT_THROW(res.allocate(512), std::bad_alloc);
+    res.release();
+    EXPECT_EQ(res.allocate(10, 1), buffer);
+
+    TrackingResource upstream;
+    {
+        tstl::pmr::monotonic_buffer_resource mono(&upstream);
+        tstl::pmr::vector<int> vec(&mono);
+        for (int i = 0; i < 10000; ++i) {
+            vec.push_back(i);
+        }
+        EXPECT_EQ(vec[9999], 9999);
+        EXPECT_GT(upstream.live, 10000 * sizeof(int));
+
+        // 块大小翻倍会溢出的请求直接抛出 std::bad_alloc
+        EXPECT_THROW(mono.allocate(std::size_t(-1) - 8), std::bad_alloc);
+        EXPECT_THROW(mono.allocate(std::size_t(-1) / 2 + 1), std::bad_alloc);
+    }
+    EXPECT_EQ(upstream.live, 0);
+}
+
+TEST(MemoryResourceTest, UnsynchronizedPool) {
+    TrackingResource upstream;
+    {
+        tstl::pmr::unsynchronized_pool_resource pool(&upstream);
+        void *a = pool.allocate(24, 8);
+        pool.deallocate(a, 24, 8);
+        EXPECT_EQ(pool.allocate(32, 8), a);
+        void *big = pool.allocate(100000, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(big) % 64, 0);
+        pool.deallocate(big, 100000, 64);
+        void *big2 = pool.allocate(100000, 64);
+        static_cast<char *>(big2)[99999] = 1;
+        // big2 未释放，由 release() 一并归还
+
+        tstl::pmr::list<std::string> lst(&pool);
+        for (int i = 0; i < 1000; ++i) {
+            lst.push_back(std::to_string(i));
+        }
+        lst.clear();
+        std::size_t allocations = upstream.allocations;
+        for (int i = 0; i < 1000; ++i) {
+            lst.push_back(std::to_string(i));
+        }
+        EXPECT_EQ(upstream.allocations, allocations);
+        EXPECT_THROW(pool.allocate(std::size_t(-1) - 8, 64), std::bad_alloc);
+    }
+    EXPECT_EQ(upstream.live, 0);
+
+    // 过大的选项被截断
+    tstl::pmr::pool_options opts;
+    opts.max_blocks_per_chunk = std::size_t(-1);
+    opts.largest_required_pool_block = std::size_t(-1);
+    tstl::pmr::unsynchronized_pool_resource huge(opts, &upstream);
+    EXPECT_LT(huge.options().largest_required_pool_block, std::size_t(-1) / 2);
+    huge.deallocate(huge.allocate(8), 8);
+}
+
+TEST(MemoryResourceTest, NestedPropagation) {
+    TrackingResource res;
+    {
+        tstl::pmr::vector<tstl::pmr::list<int>> vl(&res);
+        tstl::pmr::list<int> outside; // 使用默认资源
+        outside.push_back(1);
+        vl.push_back(outside);
+        vl.emplace_back();
+        vl[1].push_back(2);
+        EXPECT_EQ(vl[0].get_allocator().resource(), &res);
+        EXPECT_EQ(vl[1].get_allocator().resource(), &res);
+        EXPECT_EQ(outside.get_allocator().resource(), tstl::pmr::get_default_resource());
+        EXPECT_EQ(vl[0].front(), 1);
+
+        tstl::pmr::multimap<int, tstl::pmr::vector<int>> mp(&res);
+        mp.emplace(1, tstl::pmr::vector<int>{1, 2, 3});
+        tstl::pmr::vector<int> v;
+        v.push_back(4);
+        mp.insert(std::make_pair(2, v));
+        EXPECT_EQ(mp.find(1)->second.get_allocator().resource(), &res);
+        EXPECT_EQ(mp.find(2)->second.get_allocator().resource(), &res);
+        EXPECT_EQ(mp.find(2)->second[0], 4);
+
+        tstl::pmr::deque<tstl::pmr::vector<int>> dv(&res);
+        dv.push_back(v);
+        EXPECT_EQ(dv.front().get_allocator().resource(), &res);
+
+        std::size_t live = res.live;
+        {
+            // 不同资源的容器属于同一类型
+            tstl::pmr::unsynchronized_pool_resource pool;
+            tstl::pmr::vector<tstl::pmr::list<int>> other(&pool);
+            other.push_back(outside);
+            EXPECT_EQ(other[0].get_allocator().resource(), &pool);
+            EXPECT_EQ(res.live, live);
+        }
+    }
+    EXPECT_EQ(res.live, 0);
+}
+
+TEST(MemoryResourceTest, CrossResourceMoveAssign) {
+    TrackingResource r1, r2;
+    {
+        tstl::pmr::vector<int> a(&r1), b(&r2);
+        for (int i = 0; i < 100; ++i) {
+            b.push_back(i);
+        }
+        a = std::move(b);
+        // 分配器不随移动转移，a 的存储仍来自 r1
+        EXPECT_EQ(a.get_allocator().resource(), &r1);
+        EXPECT_EQ(a.size(), 100);
+        EXPECT_EQ(a[99], 99);
+        EXPECT_TRUE(b.empty());
+        a.reserve(1000);
+
+        tstl::pmr::deque<std::string> c(&r1), d(&r2);
+        for (int i = 0; i < 1000; ++i) {
+            d.push_back(std::to_string(i));
+        }
+        c = std::move(d);
+        EXPECT_EQ(c.get_allocator().resource(), &r1);
+        EXPECT_EQ(c.size(), 1000);
+        EXPECT_EQ(c.back(), "999");
+        EXPECT_TRUE(d.empty());
+        c.push_front("x");
+
+        // 同一资源时直接接管存储
+        tstl::pmr::vector<int> e(&r1);
+        const int *data = a.data();
+        e = std::move(a);
+        EXPECT_EQ(e.data(), data);
+    }
+    EXPECT_EQ(r1.live, 0);
+
+    // 逐个移动元素时抛出异常，已分配的缓冲区与 map 全部归还
+    struct throwing_move {
+        int value;
+        explicit throwing_move(int v) : value(v) {
+        }
+        throwing_move(throwing_move &&rhs) : value(rhs.value) {
+            if (value == 700) {
+                throw std::runtime_error("throwing_move");
+            }
+        }
+    };
+    {
+        tstl::pmr::deque<throwing_move> src(&r2);
+        for (int i = 0; i < 1000; ++i) {
+            src.emplace_back(i);
+        }
+        using alloc = tstl::pmr::polymorphic_allocator<throwing_move>;
+        EXPECT_THROW(tstl::pmr::deque<throwing_move>(std::move(src), alloc(&r1)),
+                     std::runtime_error);
+        EXPECT_EQ(r1.live, 0);
+    }
+
+    // 分配器不随移动转移且可能不相等时，移动赋值可能分配内存，不能声明为 noexcept
+    static_assert(std::is_nothrow_move_assignable<tstl::list<int>>::value, "");
+    static_assert(std::is_nothrow_move_assignable<tstl::multimap<int, int>>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<tstl::pmr::list<int>>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<tstl::pmr::multimap<int, int>>::value, "");
+    {
+        tstl::pmr::list<int> full(&r2);
+        tstl::pmr::multimap<int, int> full_map(&r2);
+        for (int i = 0; i < 10; ++i) {
+            full.push_back(i);
+            full_map.emplace(i, i);
+        }
+        // 缓冲区只够放下末尾结点与头结点，之后的分配全部失败
+        alignas(std::max_align_t) unsigned char buf[128];
+        tstl::pmr::monotonic_buffer_resource tight(buf, sizeof(buf),
+                                                   tstl::pmr::null_memory_resource());
+        tstl::pmr::list<int> lst(&tight);
+        tstl::pmr::multimap<int, int> mp(&tight);
+        EXPECT_THROW(lst = std::move(full), std::bad_alloc);
+        EXPECT_THROW(mp = std::move(full_map), std::bad_alloc);
+    }
+}
+
+TEST(MemoryResourceTest, CrossResourceMerge) {
+    TrackingResource r1, r2;
+    {
+        tstl::pmr::multimap<int, std::string> a(&r1), b(&r2);
+        for (int i = 0; i < 100; ++i) {
+            a.emplace(i, "a");
+            b.emplace(i + 50, "b");
+        }
+        // 结点不能跨资源转移，元素被复制到 a 的资源中
+        a.merge(b);
+        EXPECT_EQ(a.size(), 200);
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(r2.live, 0);
+        EXPECT_EQ(a.lower_bound(50)->second, "a");
+        EXPECT_EQ((++a.lower_bound(50))->second, "b");
+
+        tstl::pmr::multimap<int, std::string> c(&r2), d(&r2);
+        c.emplace(1000, "c");
+        d.emplace(-1, "d");
+        a.join(c);
+        a.union_with(d);
+        EXPECT_EQ(a.size(), 202);
+        EXPECT_TRUE(c.empty());
+        EXPECT_TRUE(d.empty());
+        EXPECT_EQ(a.begin()->second, "d");
+        EXPECT_EQ(a.rbegin()->second, "c");
+        EXPECT_EQ(r2.live, 0);
+    }
+    EXPECT_EQ(r1.live, 0);
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef TEST_TEST_MMAP_ALLOCATOR
+#define TEST_TEST_MMAP_ALLOCATOR
+
+#include "../src/memory/mmap_allocator.hpp"
+#include "../src/deque.hpp"
+#include "../src/vector.hpp"
+#include <cstdint>
+#include <string>
+
+TEST(MmapAllocatorTest, All) {
+    tstl::mmap_allocator<std::uint32_t> alloc;
+    // 小请求交给 operator new
+    std::uint32_t *small = alloc.allocate(16);
+    small[15] = 1;
+    alloc.deallocate(small, 16);
+
+    // 大请求使用映射，起始地址按大页对齐
+    const std::size_t n = (std::size_t(4) << 20) / sizeof(std::uint32_t);
+    std::uint32_t *p = alloc.allocate(n);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % TSTL_HUGE_PAGE_SIZE, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        p[i] = static_cast<std::uint32_t>(i * 7);
+    }
+
+    // 映射之间的调整与映射和堆之间的调整都保留原有数据
+    p = alloc.reallocate(p, n, 3 * n);
+    p[3 * n - 1] = 5;
+    p = alloc.reallocate(p, 3 * n, 100);
+    for (std::size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(p[i], i * 7);
+    }
+    p = alloc.reallocate(p, 100, n);
+    EXPECT_EQ(p[99], 99 * 7);
+    alloc.deallocate(p, n);
+
+    EXPECT_TRUE(alloc == tstl::mmap_allocator<char>());
+}
+
+TEST(MmapAllocatorTest, Vector) {
+    tstl::vector<int, tstl::mmap_allocator<int>> vec;
+    for (int i = 0; i < 3000000; ++i) {
+        vec.push_back(i);
+    }
+    EXPECT_EQ(vec.size(), 3000000);
+    EXPECT_EQ(vec.back(), 2999999);
+    vec.reserve(8000000);
+    EXPECT_EQ(vec.capacity(), 8000000);
+    for (int i = 0; i < 3000000; i += 1000) {
+        EXPECT_EQ(vec[i], i);
+    }
+
+    // 扩容时插入的元素引用旧存储中的元素
+    tstl::vector<int, tstl::mmap_allocator<int, true>> pop;
+    pop.push_back(41);
+    pop.emplace_back(pop.back() + 1);
+    pop.insert(pop.begin(), pop.back());
+    EXPECT_EQ(pop[0], 42);
+    EXPECT_EQ(pop[1], 41);
+    EXPECT_EQ(pop[2], 42);
+    for (int i = 0; i < 1000000; ++i) {
+        pop.emplace_back(pop[i]);
+    }
+    EXPECT_EQ(pop.back(), pop[pop.size() - 4]);
+
+    // 不可平凡复制的元素仍逐个移动
+    tstl::vector<std::string, tstl::mmap_allocator<std::string>> strs;
+    for (int i = 0; i < 200000; ++i) {
+        strs.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(strs[123456], "123456");
+
+    tstl::deque<int, tstl::mmap_allocator<int>> deq;
+    for (int i = 0; i < 100000; ++i) {
+        deq.push_front(i);
+    }
+    EXPECT_EQ(deq.front(), 99999);
+    EXPECT_EQ(deq.back(), 0);
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef TEST_TEST_MONOTONIC_ARENA
+#define TEST_TEST_MONOTONIC_ARENA
+
+#include "../src/memory/monotonic_arena.hpp"
+#include "../src/vector.hpp"
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/multimap.hpp"
+#include "../src/pairing_heap.hpp"
+#include "../src/unordered_map.hpp"
+#include <cstdint>
+#include <string>
+
+TEST(MonotonicArenaTest, All) {
+    tstl::monotonic_arena arena(256);
+    EXPECT_EQ(arena.capacity(), 0);
+
+    void *a = arena.allocate(3, 1);
+    void *b = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0);
+    EXPECT_EQ(static_cast<char *>(b) - static_cast<char *>(a), 8);
+
+    // 超出当前块的请求会申请新块，之前分配的内存保持有效
+    void *big = arena.allocate(10000, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(big) % 64, 0);
+    std::size_t cap = arena.capacity();
+    EXPECT_GE(cap, 10000 + 256);
+
+    // reset 后复用原有内存块，不再向系统申请
+    arena.reset();
+    EXPECT_EQ(arena.allocate(3, 1), a);
+    arena.allocate(10000, 64);
+    EXPECT_EQ(arena.capacity(), cap);
+
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0);
+    EXPECT_NE(arena.allocate(16), nullptr);
+}
+
+TEST(MonotonicArenaTest, Containers) {
+    tstl::monotonic_arena arena;
+    for (int round = 0; round < 3; ++round) {
+        {
+            tstl::arena_allocator<int> alloc(arena);
+            tstl::vector<int, tstl::arena_allocator<int>> vec(alloc);
+            tstl::deque<int, tstl::arena_allocator<int>> deq(alloc);
+            tstl::list<int, tstl::arena_allocator<int>> lst(alloc);
+            for (int i = 0; i < 5000; ++i) {
+                vec.push_back(i);
+                deq.push_front(i);
+                lst.push_back(i);
+            }
+            EXPECT_EQ(vec.size(), 5000);
+            EXPECT_EQ(deq.front(), 4999);
+            EXPECT_EQ(deq.back(), 0);
+            EXPECT_EQ(lst.size(), 5000);
+            EXPECT_EQ(lst.back(), 4999);
+            EXPECT_EQ(vec.get_allocator(), alloc);
+            EXPECT_EQ(lst.get_allocator(), alloc);
+
+            using map_alloc = tstl::arena_allocator<std::pair<const int, std::string>>;
+            tstl::multimap<int, std::string, std::less<int>, map_alloc> mp{map_alloc(arena)};
+            for (int i = 0; i < 1000; ++i) {
+                mp.emplace(i % 100, std::to_string(i));
+            }
+            EXPECT_EQ(mp.size(), 1000);
+            EXPECT_EQ(mp.count(7), 10);
+            EXPECT_EQ(mp.find(42)->second, "42");
+
+            auto copy = mp;
+            EXPECT_EQ(copy.get_allocator(), mp.get_allocator());
+            auto upper = copy.split(50);
+            EXPECT_EQ(copy.size(), 500);
+            EXPECT_EQ(upper.size(), 500);
+            EXPECT_EQ(upper.get_allocator(), mp.get_allocator());
+
+            auto nh = mp.extract(3);
+            EXPECT_EQ(nh.key(), 3);
+            EXPECT_EQ(nh.get_allocator(), mp.get_allocator());
+            mp.insert(std::move(nh));
+            EXPECT_EQ(mp.size(), 1000);
+
+            mp.clear();
+            EXPECT_TRUE(mp.empty());
+        }
+        arena.reset();
+    }
+
+    // 元素可平凡析构时，清空不遍历结点
+    tstl::multimap<int, int, std::less<int>, tstl::arena_allocator<std::pair<const int, int>>>
+        ints{tstl::arena_allocator<std::pair<const int, int>>(arena)};
+    for (int i = 0; i < 100; ++i) {
+        ints.emplace(i, i);
+    }
+    ints.clear();
+    EXPECT_TRUE(ints.empty());
+    ints.emplace(1, 1);
+    EXPECT_EQ(ints.size(), 1);
+}
+
+// arena_allocator 的 swap 同时经 ADL 找到 tstl::swap 与 std::swap，容器内部必须限定调用
+TEST(MonotonicArenaTest, SwapAndSort) {
+    tstl::monotonic_arena arena1;
+    tstl::monotonic_arena arena2;
+
+    tstl::list<int, tstl::arena_allocator<int>> l1{tstl::arena_allocator<int>(arena1)};
+    tstl::list<int, tstl::arena_allocator<int>> l2{tstl::arena_allocator<int>(arena2)};
+    for (int i = 0; i < 100; ++i) {
+        l1.push_back((i * 37) % 100);
+    }
+    l2.push_back(-1);
+    l1.swap(l2);
+    EXPECT_EQ(l1.size(), 1);
+    EXPECT_EQ(l2.size(), 100);
+    EXPECT_EQ(l2.get_allocator().arena(), &arena1);
+    EXPECT_EQ(l1.get_allocator().arena(), &arena2);
+
+    // 分配器不可默认构造，sort 不得创建临时链表
+    l2.sort();
+    int expect = 0;
+    for (int v : l2) {
+        EXPECT_EQ(v, expect++);
+    }
+    l2.sort(std::greater<int>());
+    EXPECT_EQ(l2.front(), 99);
+    EXPECT_EQ(l2.back(), 0);
+
+    using map_alloc = tstl::arena_allocator<std::pair<const int, int>>;
+    tstl::multimap<int, int, std::less<int>, map_alloc> m1{map_alloc(arena1)};
+    tstl::multimap<int, int, std::less<int>, map_alloc> m2{map_alloc(arena2)};
+    m1.emplace(1, 1);
+    m1.swap(m2);
+    EXPECT_TRUE(m1.empty());
+    EXPECT_EQ(m2.size(), 1);
+    EXPECT_EQ(m2.get_allocator().arena(), &arena1);
+
+    m1.emplace(2, 2);
+    auto nh1 = m1.extract(2);
+    auto nh2 = m2.extract(1);
+    nh1.swap(nh2);
+    EXPECT_EQ(nh1.key(), 1);
+    EXPECT_EQ(nh2.key(), 2);
+    EXPECT_EQ(nh1.get_allocator().arena(), &arena1);
+    EXPECT_EQ(nh2.get_allocator().arena(), &arena2);
+
+    using hash_alloc = tstl::arena_allocator<std::pair<const int, int>>;
+    using hash_map = tstl::unordered_map<int, int, std::hash<int>, std::equal_to<int>, hash_alloc>;
+    hash_map h1(8, std::hash<int>(), std::equal_to<int>(), hash_alloc(arena1));
+    hash_map h2(8, std::hash<int>(), std::equal_to<int>(), hash_alloc(arena2));
+    h1.emplace(1, 10);
+    h1.swap(h2);
+    EXPECT_TRUE(h1.empty());
+    EXPECT_EQ(h2.at(1), 10);
+    EXPECT_EQ(h2.get_allocator().arena(), &arena1);
+
+    // arena_allocator 随复制赋值传播
+    using heap = tstl::pairing_heap<int, std::less<int>, tstl::arena_allocator<int>>;
+    heap q1{std::less<int>(), tstl::arena_allocator<int>(arena1)};
+    heap q2{std::less<int>(), tstl::arena_allocator<int>(arena2)};
+    q1.push(3);
+    q1.push(1);
+    q2 = q1;
+    EXPECT_EQ(q2.get_allocator().arena(), &arena1);
+    EXPECT_EQ(q2.top(), 1);
+    q2.swap(q1);
+    EXPECT_EQ(q2.size(), 2);
+}
+
+#endif
@@ -2,6 +2,12 @@
 #define TEST_TEST_MULTIMAP
 
 #include "../src/multimap.hpp"
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 template <class K, class V>
 using multimap = tstl::multimap<K, V, std::less<K>>;
@@ -17,4 +23,315 @@ TEST(MultimapTest, All) {
     EXPECT_EQ(mp, expect);
 }
 
+TEST(MultimapTest, ExtractAndInsertNode) {
+    multimap<int, int> mp = {{1, 2}, {2, 3}, {3, 4}, {3, 5}};
+    auto nh = mp.extract(3);
+    EXPECT_FALSE(nh.empty());
+    EXPECT_EQ(nh.key(), 3);
+    EXPECT_EQ(nh.mapped(), 4);
+    EXPECT_TRUE(mp.extract(5).empty());
+
+    multimap<int, int> other;
+    const int *addr = &nh.mapped();
+    nh.key() = 0;
+    auto it = other.insert(std::move(nh));
+    EXPECT_TRUE(nh.empty());
+    EXPECT_EQ(&it->second, addr);
+
+    other.insert(mp.extract(mp.begin()));
+    multimap<int, int> expect_1 = {{2, 3}, {3, 5}};
+    multimap<int, int> expect_2 = {{0, 4}, {1, 2}};
+    EXPECT_EQ(mp, expect_1);
+    EXPECT_EQ(other, expect_2);
+}
+
+TEST(MultimapTest, Merge) {
+    multimap<int, int> mp = {{1, 1}, {3, 1}, {5, 1}};
+    multimap<int, int> src = {{0, 2}, {3, 2}, {3, 3}, {4, 2}, {6, 2}};
+    mp.merge(src);
+    multimap<int, int> expect = {{0, 2}, {1, 1}, {3, 1}, {3, 2}, {3, 3}, {4, 2}, {5, 1}, {6, 2}};
+    EXPECT_EQ(mp, expect);
+    EXPECT_TRUE(src.empty());
+    EXPECT_EQ(mp.size(), 8);
+
+    src.insert({7, 7});
+    src.merge(mp);
+    expect.insert({7, 7});
+    EXPECT_EQ(src, expect);
+    EXPECT_TRUE(mp.empty());
+}
+
+// 只能与 std::string 比较、不能转换为 std::string 的查找键
+struct StringProbe {
+    const char *str;
+};
+
+struct TransparentLess {
+    using is_transparent = void;
+    bool operator()(const std::string &lhs, const std::string &rhs) const {
+        return lhs < rhs;
+    }
+    bool operator()(const std::string &lhs, const StringProbe &rhs) const {
+        return lhs.compare(rhs.str) < 0;
+    }
+    bool operator()(const StringProbe &lhs, const std::string &rhs) const {
+        return rhs.compare(lhs.str) > 0;
+    }
+};
+
+TEST(MultimapTest, TransparentLookup) {
+    tstl::multimap<std::string, int, TransparentLess> mp = {
+        {"apple", 1}, {"banana", 2}, {"banana", 3}, {"cherry", 4}};
+    EXPECT_EQ(mp.find(StringProbe{"cherry"})->second, 4);
+    EXPECT_EQ(mp.find(StringProbe{"durian"}), mp.end());
+    EXPECT_EQ(mp.count(StringProbe{"banana"}), 2);
+    EXPECT_EQ(mp.lower_bound(StringProbe{"b"})->first, "banana");
+    EXPECT_EQ(mp.upper_bound(StringProbe{"banana"})->first, "cherry");
+    auto range = mp.equal_range(StringProbe{"banana"});
+    EXPECT_EQ(tstl::distance(range.first, range.second), 2);
+    EXPECT_EQ(mp.find(std::string("apple"))->second, 1);
+
+    tstl::multimap<std::string, int, std::less<>> mp2 = {{"x", 1}};
+    EXPECT_EQ(mp2.count("x"), 1);
+}
+
+TEST(MultimapTest, CompactNode) {
+    // 颜色存放在父节点指针的最低位，基本节点只有三个指针
+    using node_base = tstl::rb_tree_node_base<std::pair<const int, int>>;
+    using node = tstl::rb_tree_node<std::pair<const int, int>>;
+    EXPECT_EQ(sizeof(node_base), 3 * sizeof(void *));
+    EXPECT_EQ(sizeof(node), 3 * sizeof(void *) + sizeof(std::pair<const int, int>));
+
+    multimap<int, int> mp;
+    for (int i = 0; i < 1000; ++i) {
+        mp.insert({(i * 7919) % 1000, i});
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        mp.erase(mp.find(i));
+    }
+    multimap<int, int> moved(std::move(mp));
+    multimap<int, int> copied(moved);
+    EXPECT_TRUE(mp.empty());
+    EXPECT_EQ(moved.size(), 500);
+    EXPECT_EQ(moved, copied);
+    int expect_key = 1;
+    for (auto it = copied.begin(); it != copied.end(); ++it, expect_key += 2) {
+        EXPECT_EQ(it->first, expect_key);
+    }
+    EXPECT_EQ((--copied.end())->first, 999);
+    tstl::swap(mp, copied);
+    EXPECT_EQ(mp, moved);
+    EXPECT_TRUE(copied.empty());
+}
+
+// 复制到第 limit 次时抛出异常
+struct ThrowOnCopy {
+    static int copies;
+    static int limit;
+    int v;
+    explicit ThrowOnCopy(int x) : v(x) {}
+    ThrowOnCopy(const ThrowOnCopy &rhs) : v(rhs.v) {
+        if (++copies == limit) {
+            throw std::runtime_error("copy");
+        }
+    }
+};
+int ThrowOnCopy::copies = 0;
+int ThrowOnCopy::limit = -1;
+
+TEST(MultimapTest, CopyAndClearLargeTree) {
+    // 顺序插入得到最深的右侧链
+    multimap<int, int> mp;
+    for (int i = 0; i < 100000; ++i) {
+        mp.insert({i, -i});
+    }
+    multimap<int, int> copied(mp);
+    EXPECT_EQ(copied.size(), 100000);
+    EXPECT_EQ(copied, mp);
+    EXPECT_EQ(copied.begin()->first, 0);
+    EXPECT_EQ((--copied.end())->first, 99999);
+    copied.clear();
+    EXPECT_TRUE(copied.empty());
+    EXPECT_EQ(copied.begin(), copied.end());
+    copied = mp;
+    EXPECT_EQ(copied, mp);
+
+    // 复制中途抛出异常时，已复制的结点全部释放，源树不受影响
+    using throwing_map = multimap<int, ThrowOnCopy>;
+    throwing_map src;
+    for (int i = 0; i < 100; ++i) {
+        src.emplace(i, ThrowOnCopy(i));
+    }
+    ThrowOnCopy::copies = 0;
+    ThrowOnCopy::limit = 50;
+    EXPECT_THROW(throwing_map dst(src), std::runtime_error);
+    ThrowOnCopy::limit = -1;
+    EXPECT_EQ(src.size(), 100);
+    EXPECT_EQ((--src.end())->second.v, 99);
+}
+
+// 检查红黑树的性质，返回子树的黑高，性质被破坏时返回 -1
+template <class NodePtr>
+int check_rb_subtree(NodePtr x, NodePtr parent) {
+    if (x == nullptr) {
+        return 0;
+    }
+    if (x->parent() != parent) {
+        return -1;
+    }
+    if (tstl::rb_tree_is_red(x) && ((x->left && tstl::rb_tree_is_red(x->left)) ||
+                                    (x->right && tstl::rb_tree_is_red(x->right)))) {
+        return -1;
+    }
+    int hl = check_rb_subtree(x->left, x);
+    int hr = check_rb_subtree(x->right, x);
+    if (hl < 0 || hl != hr) {
+        return -1;
+    }
+    return hl + (tstl::rb_tree_is_red(x) ? 0 : 1);
+}
+
+template <class Map>
+bool is_valid_rb_tree(Map &mp) {
+    auto header = mp.end().node;
+    auto root = header->parent();
+    if (root == nullptr) {
+        return mp.empty() && mp.begin() == mp.end();
+    }
+    return !tstl::rb_tree_is_red(root) && check_rb_subtree(root, header) > 0 &&
+           header->left == tstl::rb_tree_min(root) && header->right == tstl::rb_tree_max(root) &&
+           static_cast<std::size_t>(tstl::distance(mp.begin(), mp.end())) == mp.size();
+}
+
+TEST(MultimapTest, JoinAndSplit) {
+    multimap<int, int> mp;
+    for (int i = 0; i < 10000; ++i) {
+        mp.insert({(i * 7919) % 5000, i});
+    }
+    multimap<int, int> expect(mp);
+
+    auto hi = mp.split(2500);
+    EXPECT_TRUE(is_valid_rb_tree(mp));
+    EXPECT_TRUE(is_valid_rb_tree(hi));
+    EXPECT_EQ(mp.size(), 5000);
+    EXPECT_EQ(hi.size(), 5000);
+    EXPECT_EQ((--mp.end())->first, 2499);
+    EXPECT_EQ(hi.begin()->first, 2500);
+
+    auto top = hi.split(4990);
+    EXPECT_EQ(top.size(), 20);
+    EXPECT_EQ(hi.size(), 4980);
+    auto none = top.split(-1);
+    EXPECT_TRUE(top.empty());
+    EXPECT_EQ(none.size(), 20);
+
+    // 黑高相差悬殊的两棵树连接
+    mp.join(hi);
+    EXPECT_TRUE(hi.empty());
+    EXPECT_TRUE(is_valid_rb_tree(mp));
+    mp.join(none);
+    EXPECT_TRUE(is_valid_rb_tree(mp));
+    EXPECT_EQ(mp, expect);
+
+    multimap<int, int> single = {{10000, 0}};
+    mp.join(single);
+    EXPECT_TRUE(is_valid_rb_tree(mp));
+    EXPECT_EQ((--mp.end())->first, 10000);
+    EXPECT_EQ(mp.size(), 10001);
+}
+
+TEST(MultimapTest, SetOperations) {
+    // 足够大的树，多核机器上会走并行路径
+    const int n = 1 << 17;
+    std::mt19937 gen(7);
+    multimap<int, int> a;
+    multimap<int, int> b;
+    std::multimap<int, int> sa;
+    std::multimap<int, int> sb;
+    for (int i = 0; i < n; ++i) {
+        int ka = static_cast<int>(gen() % (n * 2));
+        int kb = static_cast<int>(gen() % (n * 2));
+        a.insert({ka, i});
+        sa.insert({ka, i});
+        b.insert({kb, -i});
+        sb.insert({kb, -i});
+    }
+    auto same = [](const multimap<int, int> &lhs, const std::multimap<int, int> &rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    };
+
+    multimap<int, int> inter(a);
+    inter.intersect_with(b);
+    std::multimap<int, int> sinter;
+    for (auto &kv : sa) {
+        if (sb.count(kv.first) != 0) {
+            sinter.insert(kv);
+        }
+    }
+    EXPECT_TRUE(is_valid_rb_tree(inter));
+    EXPECT_TRUE(same(inter, sinter));
+
+    multimap<int, int> diff(a);
+    diff.subtract(b);
+    std::multimap<int, int> sdiff;
+    for (auto &kv : sa) {
+        if (sb.count(kv.first) == 0) {
+            sdiff.insert(kv);
+        }
+    }
+    EXPECT_TRUE(is_valid_rb_tree(diff));
+    EXPECT_TRUE(same(diff, sdiff));
+    EXPECT_EQ(inter.size() + diff.size(), a.size());
+
+    // 键值相等时 b 的元素排在 a 的元素之后，与 merge 一致
+    a.union_with(b);
+    sa.merge(sb);
+    EXPECT_TRUE(b.empty());
+    EXPECT_TRUE(is_valid_rb_tree(a));
+    EXPECT_TRUE(same(a, sa));
+
+    multimap<int, int> small = {{3, 1}, {3, 2}, {5, 0}};
+    multimap<int, int> other = {{3, 9}};
+    small.intersect_with(other);
+    EXPECT_EQ(small.size(), 2);
+    small.subtract(small);
+    EXPECT_TRUE(small.empty());
+    small.union_with(multimap<int, int>{{1, 1}});
+    EXPECT_EQ(small.size(), 1);
+    EXPECT_TRUE(is_valid_rb_tree(small));
+}
+
+TEST(MultimapTest, BatchLookup) {
+    std::mt19937 gen(11);
+    multimap<int, int> mp;
+    for (int i = 0; i < 3000; ++i) {
+        mp.emplace(static_cast<int>(gen() % 4000) * 2, i);
+    }
+    // 个数不是批量大小的整数倍，包含命中、未命中与超过最大键值的查找
+    std::vector<int> keys;
+    for (int i = 0; i < 1003; ++i) {
+        keys.push_back(static_cast<int>(gen() % 8100));
+    }
+    std::vector<multimap<int, int>::iterator> found;
+    mp.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+    ASSERT_EQ(found.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(found[i] == mp.find(keys[i]));
+    }
+
+    const auto &cmp = mp;
+    std::vector<multimap<int, int>::const_iterator> lower(keys.size());
+    auto last = cmp.lower_bound_batch(keys.begin(), keys.end(), lower.begin());
+    EXPECT_TRUE(last == lower.end());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_TRUE(lower[i] == cmp.lower_bound(keys[i]));
+    }
+
+    multimap<int, int> empty;
+    found.clear();
+    empty.find_batch(keys.begin(), keys.begin() + 3, std::back_inserter(found));
+    ASSERT_EQ(found.size(), 3);
+    EXPECT_TRUE(found[0] == empty.end());
+}
+
 #endif
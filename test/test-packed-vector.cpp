@@ -0,0 +1,74 @@
+#ifndef TEST_TEST_PACKED_VECTOR
+#define TEST_TEST_PACKED_VECTOR
+
+#include "../src/packed_vector.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST(PackedVectorTest, All) {
+    std::mt19937_64 gen(44);
+    for (unsigned width = 0; width <= 64; ++width) {
+        const std::uint64_t mask = tstl::_bit_mask(width);
+        std::vector<std::uint64_t> expect(300);
+        tstl::packed_vector vec(width);
+        for (auto &x : expect) {
+            x = gen() & mask;
+            vec.push_back(x);
+        }
+        ASSERT_EQ(vec.size(), expect.size());
+        for (std::size_t i = 0; i < expect.size(); ++i) {
+            ASSERT_EQ(vec[i], expect[i]) << "width " << width << " index " << i;
+        }
+        // 整组解压与首尾不满一组的部分
+        std::vector<std::uint64_t> out(expect.size());
+        vec.unpack(0, expect.size(), out.data());
+        EXPECT_EQ(out, expect);
+        vec.unpack(37, 200, out.data());
+        EXPECT_TRUE(std::equal(out.begin(), out.begin() + 200, expect.begin() + 37));
+
+        // 修改不影响相邻元素
+        vec.set(100, mask);
+        expect[100] = mask;
+        EXPECT_EQ(vec[99], expect[99]);
+        EXPECT_EQ(vec[100], expect[100]);
+        EXPECT_EQ(vec[101], expect[101]);
+        EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expect.begin()));
+        if (width < 64) {
+            EXPECT_THROW(vec.push_back(mask + 1), std::out_of_range);
+        }
+    }
+}
+
+TEST(PackedVectorTest, Construct) {
+    tstl::vector<std::uint64_t> src = {3, 1000, 7, 0, 1023};
+    tstl::packed_vector vec(src.begin(), src.end());
+    EXPECT_EQ(vec.width(), 10);
+    EXPECT_EQ(vec.size(), 5);
+    EXPECT_EQ(vec.at(4), 1023);
+    EXPECT_THROW(vec.at(5), std::out_of_range);
+    EXPECT_EQ(vec.end() - vec.begin(), 5);
+    EXPECT_EQ(vec.begin()[1], 1000);
+
+    tstl::packed_vector filled(3, 1000, 5);
+    EXPECT_EQ(filled.size(), 1000);
+    EXPECT_EQ(filled[999], 5);
+    filled.resize(10);
+    filled.resize(20, 2);
+    EXPECT_EQ(filled[9], 5);
+    EXPECT_EQ(filled[10], 2);
+    filled.pop_back();
+    EXPECT_EQ(filled.size(), 19);
+    EXPECT_THROW(tstl::packed_vector(65), std::out_of_range);
+
+    // 100 万个 20 位的值只占约 2.5 MB
+    tstl::packed_vector big(20);
+    big.reserve(1000000);
+    for (std::uint64_t i = 0; i < 1000000; ++i) {
+        big.push_back(i);
+    }
+    EXPECT_EQ(big.memory_usage().payload, 2500000);
+    EXPECT_LT(big.memory_usage().total(), 2600000);
+}
+
+#endif
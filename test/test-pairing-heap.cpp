@@ -0,0 +1,146 @@
+#ifndef TEST_TEST_PAIRING_HEAP
+#define TEST_TEST_PAIRING_HEAP
+
+#include "../src/pairing_heap.hpp"
+#include "../src/memory/memory_resource.hpp"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <vector>
+
+TEST(PairingHeapTest, All) {
+    std::mt19937 gen(48);
+    tstl::pairing_heap<int> heap;
+    std::multiset<int> expect;
+    std::vector<tstl::pairing_heap<int>::handle_type> handles;
+    for (int round = 0; round < 20000; ++round) {
+        int op = static_cast<int>(gen() % 10);
+        if (op < 4 || handles.empty()) {
+            int x = static_cast<int>(gen() % 100000);
+            handles.push_back(heap.push(x));
+            expect.insert(x);
+        } else if (op < 6) {
+            // 弹出堆顶，同时去掉它的句柄
+            auto top = heap.top_handle();
+            ASSERT_EQ(heap.top(), *expect.begin());
+            handles.erase(std::find(handles.begin(), handles.end(), top));
+            expect.erase(expect.begin());
+            heap.pop();
+        } else {
+            std::size_t i = gen() % handles.size();
+            auto h = handles[i];
+            int old = *h;
+            expect.erase(expect.find(old));
+            if (op < 8) {
+                int x = old - static_cast<int>(gen() % 1000);
+                heap.decrease_key(h, x);
+                expect.insert(x);
+            } else if (op < 9) {
+                int x = static_cast<int>(gen() % 100000);
+                heap.update(h, x);
+                expect.insert(x);
+            } else {
+                heap.erase(h);
+                handles.erase(handles.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        ASSERT_EQ(heap.size(), expect.size());
+        if (!heap.empty()) {
+            ASSERT_EQ(heap.top(), *expect.begin());
+        }
+    }
+    std::multiset<int> seen;
+    heap.for_each([&seen](int x) { seen.insert(x); });
+    EXPECT_EQ(seen, expect);
+
+    // 复制得到相同的元素，互不影响
+    tstl::pairing_heap<int> copy = heap;
+    EXPECT_EQ(copy.size(), heap.size());
+    for (int x : expect) {
+        ASSERT_EQ(copy.top(), x);
+        copy.pop();
+    }
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(heap.size(), expect.size());
+
+    auto h = heap.top_handle();
+    EXPECT_THROW(heap.decrease_key(h, *h + 1), std::invalid_argument);
+}
+
+TEST(PairingHeapTest, Merge) {
+    tstl::pairing_heap<int, std::greater<int>> a;
+    tstl::pairing_heap<int, std::greater<int>> b;
+    for (int i = 0; i < 100; ++i) {
+        a.push(i * 2);
+    }
+    auto h = b.push(7);
+    for (int i = 0; i < 100; ++i) {
+        b.push(i * 2 + 1);
+    }
+    a.merge(b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(a.size(), 201);
+    EXPECT_EQ(a.top(), 199);
+    // b 的句柄在合并后仍然有效
+    a.update(h, 1000);
+    EXPECT_EQ(a.top(), 1000);
+    a.update(h, -5);
+    for (int i = 199; i >= 0; --i) {
+        ASSERT_EQ(a.top(), i);
+        a.pop();
+    }
+    EXPECT_EQ(a.top(), -5);
+
+    tstl::pairing_heap<int, std::greater<int>> moved(std::move(a));
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(moved.size(), 1);
+    a = moved;
+    swap(a, b);
+    EXPECT_EQ(b.top(), -5);
+    EXPECT_EQ(moved.memory_usage().payload, sizeof(int));
+
+    b.erase(b.top_handle());
+    EXPECT_TRUE(b.empty());
+
+    // 分配器不随移动转移且不相等时逐个移动元素
+    using pmr_heap = tstl::pairing_heap<int, std::less<int>,
+                                        tstl::pmr::polymorphic_allocator<int>>;
+    tstl::pmr::unsynchronized_pool_resource r1, r2;
+    pmr_heap p1(std::less<int>(), &r1);
+    pmr_heap p2(std::less<int>(), &r2);
+    for (int i = 0; i < 100; ++i) {
+        p2.push(i);
+    }
+    p1 = std::move(p2);
+    EXPECT_EQ(p1.get_allocator().resource(), &r1);
+    EXPECT_EQ(p1.size(), 100);
+    EXPECT_EQ(p1.top(), 0);
+    EXPECT_TRUE(p2.empty());
+    pmr_heap p3(std::less<int>(), &r1);
+    p3 = std::move(p1);
+    EXPECT_EQ(p3.size(), 100);
+    p3.pop();
+    EXPECT_EQ(p3.top(), 1);
+
+    // 复制赋值与交换同样不传播多态分配器
+    pmr_heap p4(std::less<int>(), &r2);
+    p4.push(-1);
+    p4 = p3;
+    EXPECT_EQ(p4.get_allocator().resource(), &r2);
+    EXPECT_EQ(p4.size(), 99);
+    EXPECT_EQ(p4.top(), 1);
+    pmr_heap p5(std::less<int>(), &r2);
+    p5.swap(p4);
+    EXPECT_EQ(p5.get_allocator().resource(), &r2);
+    EXPECT_EQ(p5.size(), 99);
+    EXPECT_TRUE(p4.empty());
+
+    // 很深的结构也不会在析构时耗尽栈
+    tstl::pairing_heap<int> deep;
+    for (int i = 0; i < 1000000; ++i) {
+        deep.push(-i);
+    }
+}
+
+#endif
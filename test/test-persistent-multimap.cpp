@@ -0,0 +1,162 @@
+#ifndef TEST_TEST_PERSISTENT_MULTIMAP
+#define TEST_TEST_PERSISTENT_MULTIMAP
+
+#include "../src/persistent_multimap.hpp"
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+template <class K, class V>
+using persistent_multimap = tstl::persistent_multimap<K, V, std::less<K>>;
+
+// 检查可持久化红黑树的性质，返回子树的黑高，性质被破坏时返回 -1
+template <class NodePtr>
+int check_persistent_subtree(NodePtr x) {
+    if (x == nullptr) {
+        return 0;
+    }
+    bool red = x->color == tstl::rb_tree_red;
+    if (red && ((x->left && x->left->color == tstl::rb_tree_red) ||
+                (x->right && x->right->color == tstl::rb_tree_red))) {
+        return -1;
+    }
+    int hl = check_persistent_subtree(x->left.get());
+    int hr = check_persistent_subtree(x->right.get());
+    if (hl < 0 || hl != hr) {
+        return -1;
+    }
+    return hl + (red ? 0 : 1);
+}
+
+template <class Tree>
+bool is_valid_persistent_tree(const Tree &tree) {
+    if (tree.empty()) {
+        return tree.begin() == tree.end();
+    }
+    auto root = tree.begin().root;
+    return root->color == tstl::rb_tree_black && check_persistent_subtree(root) > 0 &&
+           static_cast<std::size_t>(tstl::distance(tree.begin(), tree.end())) == tree.size();
+}
+
+TEST(PersistentMultimapTest, InsertErase) {
+    persistent_multimap<int, int> mp = {{3, 0}, {1, 0}, {2, 0}, {1, 1}};
+    auto s0 = mp.snapshot();
+    EXPECT_EQ(s0.size(), 4);
+    EXPECT_EQ(s0.count(1), 2);
+    EXPECT_EQ(s0.find(1)->second, 0);
+    EXPECT_EQ(s0.find(4), s0.end());
+    EXPECT_EQ(s0.lower_bound(2)->first, 2);
+    EXPECT_EQ(s0.upper_bound(2)->first, 3);
+
+    mp.insert({1, 2});
+    mp.emplace(0, 0);
+    EXPECT_EQ(mp.erase(3), 1);
+    EXPECT_EQ(mp.erase(5), 0);
+    auto s1 = mp.snapshot();
+
+    // 旧快照保持不变
+    std::vector<std::pair<const int, int>> expect0 = {{1, 0}, {1, 1}, {2, 0}, {3, 0}};
+    std::vector<std::pair<const int, int>> expect1 = {{0, 0}, {1, 0}, {1, 1}, {1, 2}, {2, 0}};
+    EXPECT_TRUE(std::equal(s0.begin(), s0.end(), expect0.begin()));
+    EXPECT_EQ(s1.size(), expect1.size());
+    EXPECT_TRUE(std::equal(s1.begin(), s1.end(), expect1.begin()));
+
+    mp.update([](persistent_multimap<int, int>::snapshot_type &tree) {
+        tree.erase_multi(1);
+        tree.insert_multi({9, 9});
+    });
+    EXPECT_EQ(mp.size(), 3);
+    EXPECT_EQ(s1.count(1), 3);
+    mp.clear();
+    EXPECT_TRUE(mp.empty());
+    EXPECT_EQ(s1.size(), 5);
+}
+
+TEST(PersistentMultimapTest, RandomVersions) {
+    std::mt19937 gen(11);
+    persistent_multimap<int, int> mp;
+    std::multimap<int, int> model;
+    std::vector<std::pair<persistent_multimap<int, int>::snapshot_type, std::multimap<int, int>>>
+        versions;
+    for (int i = 0; i < 4000; ++i) {
+        int key = static_cast<int>(gen() % 500);
+        if (gen() % 3 == 0) {
+            // 删除一个键值相同的元素
+            mp.update([&](persistent_multimap<int, int>::snapshot_type &tree) {
+                if (tree.erase_one(key)) {
+                    model.erase(model.find(key));
+                }
+            });
+        } else {
+            mp.insert({key, i});
+            model.insert({key, i});
+        }
+        if (i % 200 == 0) {
+            versions.emplace_back(mp.snapshot(), model);
+        }
+    }
+    versions.emplace_back(mp.snapshot(), model);
+    for (auto &v : versions) {
+        EXPECT_TRUE(is_valid_persistent_tree(v.first));
+        EXPECT_EQ(v.first.size(), v.second.size());
+        // 键值的顺序一致，键值相等的元素间的顺序不做要求
+        EXPECT_TRUE(std::equal(v.first.begin(), v.first.end(), v.second.begin(),
+                               [](const std::pair<const int, int> &a,
+                                  const std::pair<const int, int> &b) {
+                                   return a.first == b.first;
+                               }));
+        // 从查找结果开始遍历，回溯时需要从根重建祖先
+        for (int key = 0; key < 500; key += 37) {
+            EXPECT_EQ(tstl::distance(v.first.lower_bound(key), v.first.end()),
+                      std::distance(v.second.lower_bound(key), v.second.end()));
+        }
+    }
+}
+
+TEST(PersistentMultimapTest, ConcurrentReaders) {
+    persistent_multimap<int, int> mp;
+    for (int i = 0; i < 1000; ++i) {
+        mp.insert({i, i});
+    }
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto snap = mp.snapshot();
+                // 每个版本中 key 与 value 之和恒为 0 或 key 等于 value
+                std::size_t n = 0;
+                int prev = -1;
+                for (auto &kv : snap) {
+                    if (kv.first < prev || (kv.second != kv.first && kv.second != -kv.first)) {
+                        ++bad;
+                    }
+                    prev = kv.first;
+                    ++n;
+                }
+                if (n != snap.size()) {
+                    ++bad;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) {
+        mp.update([&](persistent_multimap<int, int>::snapshot_type &tree) {
+            tree.erase_multi(i);
+            tree.insert_multi({i, -i});
+        });
+    }
+    done = true;
+    for (auto &th : readers) {
+        th.join();
+    }
+    EXPECT_EQ(bad.load(), 0);
+    auto snap = mp.snapshot();
+    EXPECT_EQ(snap.size(), 1000);
+    EXPECT_EQ(snap.find(999)->second, -999);
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef TEST_TEST_POOL_ALLOCATOR
+#define TEST_TEST_POOL_ALLOCATOR
+
+#include "../src/memory/pool_allocator.hpp"
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/multimap.hpp"
+#include "../src/vector.hpp"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(PoolAllocatorTest, All) {
+    tstl::pool_allocator<std::uint64_t> alloc;
+    std::uint64_t *a = alloc.allocate(1);
+    std::uint64_t *b = alloc.allocate(1);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % alignof(std::uint64_t), 0);
+    *a = 1;
+    *b = 2;
+    // 同一级别中刚释放的对象最先被复用
+    alloc.deallocate(a, 1);
+    EXPECT_EQ(alloc.allocate(1), a);
+    alloc.deallocate(a, 1);
+    alloc.deallocate(b, 1);
+
+    // 超出内存池范围的请求交给 operator new
+    std::uint64_t *big = alloc.allocate(1000);
+    big[999] = 3;
+    alloc.deallocate(big, 1000);
+
+    EXPECT_TRUE(alloc == tstl::pool_allocator<char>());
+}
+
+TEST(PoolAllocatorTest, Containers) {
+    tstl::list<std::string, tstl::pool_allocator<std::string>> lst;
+    tstl::deque<int, tstl::pool_allocator<int>> deq;
+    tstl::multimap<int, int, std::less<int>, tstl::pool_allocator<std::pair<const int, int>>> mp;
+    for (int i = 0; i < 10000; ++i) {
+        lst.push_back(std::to_string(i));
+        deq.push_front(i);
+        mp.emplace(i % 100, i);
+        if (i % 3 == 0) {
+            lst.pop_front();
+            deq.pop_back();
+            mp.erase(mp.begin());
+        }
+    }
+    EXPECT_EQ(lst.size(), 6666);
+    EXPECT_EQ(lst.back(), "9999");
+    EXPECT_EQ(deq.size(), 6666);
+    EXPECT_EQ(deq.front(), 9999);
+    EXPECT_EQ(mp.size(), 6666);
+
+    auto copy = lst;
+    lst.clear();
+    EXPECT_EQ(copy.size(), 6666);
+    EXPECT_EQ(copy.front(), "3334");
+}
+
+// 结点在一个线程中分配，在另一个线程中释放
+TEST(PoolAllocatorTest, CrossThread) {
+    using list_type = tstl::list<int, tstl::pool_allocator<int>>;
+    tstl::vector<list_type> lists(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&lists, t] {
+            for (int i = 0; i < 20000; ++i) {
+                lists[t].push_back(i);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_EQ(lists[t].size(), 20000);
+    }
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&lists, t] { lists[3 - t].clear(); });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    for (int i = 0; i < 1000; ++i) {
+        lists[0].push_back(i);
+    }
+    EXPECT_EQ(lists[0].back(), 999);
+}
+
+// 先于线程缓存构造的 thread_local 对象在缓存析构之后才析构，其中的分配与释放经过全局内存池
+struct pool_late_holder {
+    tstl::list<int, tstl::pool_allocator<int>> *lst = nullptr;
+    ~pool_late_holder() {
+        lst->push_back(2);
+        delete lst;
+    }
+};
+
+TEST(PoolAllocatorTest, AfterCacheDestroyed) {
+    std::thread th([] {
+        static thread_local pool_late_holder holder;
+        holder.lst = new tstl::list<int, tstl::pool_allocator<int>>();
+        holder.lst->push_back(1);
+    });
+    th.join();
+    tstl::list<int, tstl::pool_allocator<int>> lst;
+    lst.push_back(3);
+    EXPECT_EQ(lst.front(), 3);
+}
+
+#endif
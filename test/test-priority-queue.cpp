@@ -0,0 +1,110 @@
+#ifndef TEST_TEST_PRIORITY_QUEUE
+#define TEST_TEST_PRIORITY_QUEUE
+
+#include "../src/algorithm.hpp"
+#include "../src/queue.hpp"
+#include "../src/vector.hpp"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(HeapTest, Algorithms) {
+    std::mt19937 gen(47);
+    for (int n : {0, 1, 2, 3, 10, 100, 1001}) {
+        tstl::vector<int> v;
+        for (int i = 0; i < n; ++i) {
+            v.push_back(static_cast<int>(gen() % 50));
+        }
+        tstl::vector<int> sorted = v;
+        std::sort(sorted.data(), sorted.data() + sorted.size());
+
+        tstl::make_heap(v.begin(), v.end());
+        EXPECT_TRUE(tstl::is_heap(v.begin(), v.end()));
+        if (n > 0) {
+            EXPECT_EQ(v.front(), sorted.back());
+        }
+        tstl::sort_heap(v.begin(), v.end());
+        EXPECT_EQ(v, sorted);
+        if (n > 2) {
+            EXPECT_TRUE(tstl::is_heap_until(v.begin(), v.end()) != v.end());
+        }
+
+        // 逐个 push_heap 后逐个 pop_heap，按降序得到各元素
+        tstl::vector<int> h;
+        for (int x : sorted) {
+            h.push_back(x);
+            tstl::push_heap(h.begin(), h.end(), std::greater<int>());
+            ASSERT_TRUE(tstl::is_heap(h.begin(), h.end(), std::greater<int>()));
+        }
+        for (int i = 0; i < n; ++i) {
+            tstl::pop_heap(h.begin(), h.end() - i, std::greater<int>());
+            ASSERT_EQ(*(h.end() - i - 1), sorted[i]);
+        }
+    }
+}
+
+template <std::size_t Arity>
+void test_priority_queue_arity() {
+    std::mt19937 gen(470 + Arity);
+    tstl::priority_queue<int, tstl::vector<int>, std::less<int>, Arity> pq;
+    std::vector<int> expect;
+    for (int i = 0; i < 3000; ++i) {
+        int x = static_cast<int>(gen() % 1000);
+        pq.push(x);
+        expect.push_back(x);
+        if (i % 3 == 0) {
+            std::sort(expect.begin(), expect.end());
+            ASSERT_EQ(pq.top(), expect.back());
+            pq.pop();
+            expect.pop_back();
+        }
+    }
+    // 少量与大量元素的批量加入
+    tstl::vector<int> few = {5000, -1, 7};
+    pq.push_range(few.begin(), few.end());
+    expect.insert(expect.end(), few.data(), few.data() + few.size());
+    tstl::vector<int> many;
+    for (int i = 0; i < 5000; ++i) {
+        many.push_back(static_cast<int>(gen() % 10000));
+    }
+    pq.push_range(many.begin(), many.end());
+    expect.insert(expect.end(), many.data(), many.data() + many.size());
+
+    std::sort(expect.begin(), expect.end(), std::greater<int>());
+    ASSERT_EQ(pq.size(), expect.size());
+    for (int x : expect) {
+        ASSERT_EQ(pq.top(), x);
+        pq.pop();
+    }
+    EXPECT_TRUE(pq.empty());
+}
+
+TEST(PriorityQueueTest, All) {
+    test_priority_queue_arity<2>();
+    test_priority_queue_arity<3>();
+    test_priority_queue_arity<4>();
+    test_priority_queue_arity<8>();
+
+    // 小顶堆与由已有容器构造
+    tstl::vector<std::string> words = {"pear", "apple", "fig", "kiwi"};
+    tstl::priority_queue<std::string, tstl::vector<std::string>, std::greater<std::string>, 4> pq(
+        std::greater<std::string>(), std::move(words));
+    EXPECT_EQ(pq.size(), 4);
+    EXPECT_EQ(pq.top(), "apple");
+    pq.emplace("banana");
+    pq.pop();
+    EXPECT_EQ(pq.top(), "banana");
+
+    tstl::vector<int> src = {3, 1, 4, 1, 5, 9, 2, 6};
+    tstl::priority_queue<int> from_range(src.begin(), src.end());
+    tstl::priority_queue<int> other;
+    other.push(100);
+    swap(from_range, other);
+    EXPECT_EQ(from_range.top(), 100);
+    EXPECT_EQ(other.top(), 9);
+    EXPECT_EQ(other.size(), 8);
+}
+
+#endif
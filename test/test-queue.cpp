@@ -0,0 +1,47 @@
+#ifndef TEST_TEST_QUEUE
+#define TEST_TEST_QUEUE
+
+#include "../src/deque.hpp"
+#include "../src/list.hpp"
+#include "../src/queue.hpp"
+#include <string>
+
+TEST(QueueTest, All) {
+    tstl::queue<int> q;
+    EXPECT_TRUE(q.empty());
+    for (int i = 0; i < 1000; ++i) {
+        q.push(i);
+    }
+    q.emplace(1000);
+    EXPECT_EQ(q.size(), 1001);
+    EXPECT_EQ(q.front(), 0);
+    EXPECT_EQ(q.back(), 1000);
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_EQ(q.front(), i);
+        q.pop();
+    }
+    EXPECT_EQ(q.front(), 500);
+
+    tstl::queue<int> copy = q;
+    EXPECT_TRUE(copy == q);
+    copy.pop();
+    EXPECT_TRUE(copy != q);
+    swap(copy, q);
+    EXPECT_EQ(q.front(), 501);
+    EXPECT_EQ(copy.front(), 500);
+
+    // 由容器移动构造，不复制元素
+    tstl::deque<std::string> d = {"a", "b", "c"};
+    const std::string *first = &d.front();
+    tstl::queue<std::string> moved(std::move(d));
+    EXPECT_EQ(&moved.front(), first);
+    EXPECT_EQ(moved.back(), "c");
+
+    tstl::queue<int, tstl::list<int>> lq;
+    lq.push(1);
+    lq.push(2);
+    lq.pop();
+    EXPECT_EQ(lq.front(), 2);
+}
+
+#endif
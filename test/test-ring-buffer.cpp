@@ -0,0 +1,161 @@
+#ifndef TEST_TEST_RING_BUFFER
+#define TEST_TEST_RING_BUFFER
+
+#include "../src/ring_buffer.hpp"
+#include "../src/memory/memory_resource.hpp"
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(RingBufferTest, All) {
+    tstl::ring_buffer<int> rb(5);
+    EXPECT_EQ(rb.capacity(), 8);
+    EXPECT_THROW(tstl::ring_buffer<int>(0), std::invalid_argument);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(rb.push_back(i));
+    }
+    EXPECT_TRUE(rb.full());
+    EXPECT_FALSE(rb.push_back(8));
+    EXPECT_EQ(rb.front(), 0);
+    EXPECT_EQ(rb.back(), 7);
+    rb.pop_front();
+    rb.pop_front();
+    EXPECT_TRUE(rb.emplace_back(8));
+    EXPECT_EQ(rb[0], 2);
+    EXPECT_EQ(rb.at(6), 8);
+    EXPECT_THROW(rb.at(7), std::out_of_range);
+
+    // 回绕后分为两段
+    tstl::ring_buffer<int>::const_spans view = rb.peek_n(100);
+    EXPECT_EQ(view.size(), 7);
+    EXPECT_EQ(view.first.size(), 6);
+    EXPECT_EQ(view.second.size(), 1);
+    EXPECT_EQ(view.second[0], 8);
+
+    tstl::ring_buffer<int>::spans popped = rb.pop_n(3);
+    EXPECT_EQ(popped.size(), 3);
+    EXPECT_EQ(popped.first[0], 2);
+    EXPECT_EQ(popped.first[2], 4);
+    EXPECT_EQ(rb.size(), 4);
+
+    int src[] = {100, 101, 102, 103, 104, 105};
+    tstl::ring_buffer<int>::spans written = rb.push_n(src, 6);
+    EXPECT_EQ(written.size(), 4);
+    EXPECT_TRUE(rb.full());
+    EXPECT_EQ(rb.back(), 103);
+    rb.clear();
+    EXPECT_TRUE(rb.empty());
+}
+
+TEST(RingBufferTest, Overwrite) {
+    std::mt19937 gen(49);
+    tstl::ring_buffer<std::string> rb(16, tstl::ring_buffer<std::string>::overwrite_oldest);
+    std::deque<std::string> expect;
+    std::vector<std::string> src;
+    for (int round = 0; round < 5000; ++round) {
+        int op = static_cast<int>(gen() % 4);
+        if (op == 0) {
+            std::string s = std::to_string(round);
+            EXPECT_TRUE(rb.push_back(s));
+            expect.push_back(s);
+        } else if (op == 1) {
+            src.assign(gen() % 40, std::to_string(round));
+            for (std::size_t i = 0; i < src.size(); ++i) {
+                src[i] += "-" + std::to_string(i);
+                expect.push_back(src[i]);
+            }
+            auto w = rb.push_n(src.data(), src.size());
+            EXPECT_EQ(w.size(), std::min<std::size_t>(src.size(), 16));
+        } else if (op == 2) {
+            std::size_t n = gen() % 10;
+            auto p = rb.pop_n(n);
+            while (expect.size() > 16) {
+                expect.pop_front();
+            }
+            ASSERT_EQ(p.size(), std::min(n, expect.size()));
+            for (std::size_t i = 0; i < p.size(); ++i) {
+                const std::string &s =
+                    i < p.first.size() ? p.first[i] : p.second[i - p.first.size()];
+                ASSERT_EQ(s, expect.front());
+                expect.pop_front();
+            }
+        } else if (!rb.empty()) {
+            while (expect.size() > 16) {
+                expect.pop_front();
+            }
+            ASSERT_EQ(rb.front(), expect.front());
+            rb.pop_front();
+            expect.pop_front();
+        }
+        while (expect.size() > 16) {
+            expect.pop_front();
+        }
+        ASSERT_EQ(rb.size(), expect.size());
+        for (std::size_t i = 0; i < expect.size(); ++i) {
+            ASSERT_EQ(rb[i], expect[i]);
+        }
+    }
+    tstl::ring_buffer<std::string> copy = rb;
+    EXPECT_EQ(copy.size(), rb.size());
+    tstl::ring_buffer<std::string> moved = std::move(copy);
+    EXPECT_EQ(moved.size(), rb.size());
+    EXPECT_EQ(moved.memory_usage().payload, rb.size() * sizeof(std::string));
+
+    // 被移动后的对象容量为 0，加入元素一律失败
+    EXPECT_EQ(copy.capacity(), 0);
+    EXPECT_FALSE(copy.push_back("x"));
+    EXPECT_FALSE(copy.emplace_back("y"));
+    EXPECT_EQ(copy.push_n(src.data(), src.size()).size(), 0);
+    EXPECT_TRUE(copy.empty());
+    tstl::ring_buffer<std::string> empty_copy = copy;
+    EXPECT_EQ(empty_copy.capacity(), 0);
+    copy = moved;
+    EXPECT_EQ(copy.size(), rb.size());
+
+    EXPECT_THROW(tstl::ring_buffer<char>(std::size_t(-1)), std::length_error);
+}
+
+// 多态分配器不随复制、移动与交换传播：容量相同时复用已有槽位，否则用自己的分配器重新分配
+TEST(RingBufferTest, Allocator) {
+    using pmr_ring = tstl::ring_buffer<std::string, tstl::pmr::polymorphic_allocator<std::string>>;
+    tstl::pmr::unsynchronized_pool_resource r1, r2;
+    pmr_ring a(8, pmr_ring::reject, &r1);
+    pmr_ring b(8, pmr_ring::overwrite_oldest, &r2);
+    for (int i = 0; i < 10; ++i) {
+        b.push_back(std::to_string(i));
+    }
+
+    a.push_back("old");
+    const std::string *slot = &a.front();
+    a = b;
+    EXPECT_EQ(a.get_allocator().resource(), &r1);
+    EXPECT_EQ(a.mode(), pmr_ring::overwrite_oldest);
+    EXPECT_EQ(a.size(), 8);
+    EXPECT_EQ(a.front(), "2");
+    EXPECT_EQ(&a.front(), slot);
+
+    pmr_ring c(2, pmr_ring::reject, &r1);
+    c = std::move(b);
+    EXPECT_EQ(c.get_allocator().resource(), &r1);
+    EXPECT_EQ(c.capacity(), 8);
+    EXPECT_EQ(c.back(), "9");
+    EXPECT_TRUE(b.empty());
+
+    // 分配器相等时直接接管槽位
+    pmr_ring d(4, pmr_ring::reject, &r1);
+    const std::string *front = &c.front();
+    d = std::move(c);
+    EXPECT_EQ(&d.front(), front);
+    EXPECT_EQ(c.capacity(), 0);
+
+    pmr_ring e(4, pmr_ring::reject, &r1);
+    e.swap(d);
+    EXPECT_EQ(e.size(), 8);
+    EXPECT_EQ(e.get_allocator().resource(), &r1);
+
+    static_assert(std::is_nothrow_move_assignable<tstl::ring_buffer<int>>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<pmr_ring>::value, "");
+}
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef TEST_TEST_SERIALIZE
+#define TEST_TEST_SERIALIZE
+
+#include "../src/serialize.hpp"
+#include <sstream>
+#include <string>
+
+template <class T>
+T serialize_round_trip(const T &value) {
+    std::stringstream ss;
+    tstl::serialize(ss, value);
+    T result;
+    tstl::deserialize(ss, result);
+    EXPECT_EQ(ss.peek(), std::char_traits<char>::eof());
+    return result;
+}
+
+TEST(SerializeTest, Sequence) {
+    tstl::vector<int> vec;
+    tstl::deque<double> deq;
+    tstl::list<std::string> lst;
+    for (int i = 0; i < 5000; ++i) {
+        vec.push_back(i * 3);
+        deq.push_front(i * 0.5);
+        lst.push_back(std::to_string(i));
+    }
+    // 首尾缓冲区都不满
+    deq.pop_back();
+
+    auto vec2 = serialize_round_trip(vec);
+    EXPECT_EQ(vec2.size(), vec.size());
+    EXPECT_TRUE(vec2 == vec);
+
+    auto deq2 = serialize_round_trip(deq);
+    EXPECT_TRUE(deq2 == deq);
+
+    auto lst2 = serialize_round_trip(lst);
+    EXPECT_TRUE(lst2 == lst);
+
+    tstl::vector<std::string> strs = {"", "a", "hello"};
+    EXPECT_TRUE(serialize_round_trip(strs) == strs);
+    EXPECT_TRUE(serialize_round_trip(tstl::vector<int>()).empty());
+
+    // 嵌套容器
+    tstl::vector<tstl::vector<int>> nested(3, vec);
+    nested[1].clear();
+    auto nested2 = serialize_round_trip(nested);
+    EXPECT_EQ(nested2.size(), 3);
+    EXPECT_TRUE(nested2[0] == vec);
+    EXPECT_TRUE(nested2[1].empty());
+}
+
+TEST(SerializeTest, Associative) {
+    tstl::multimap<int, std::string> mp;
+    for (int i = 0; i < 3000; ++i) {
+        mp.emplace(i % 700, std::to_string(i));
+    }
+    auto mp2 = serialize_round_trip(mp);
+    EXPECT_TRUE(mp2 == mp);
+    EXPECT_TRUE(is_valid_rb_tree(mp2));
+    // 重建的树仍能正常插入与删除
+    for (int i = 0; i < 1000; ++i) {
+        mp2.emplace(i, "x");
+        mp2.erase(mp2.begin());
+    }
+    EXPECT_EQ(mp2.size(), mp.size());
+    EXPECT_TRUE(is_valid_rb_tree(mp2));
+
+    for (int n = 0; n < 70; ++n) {
+        tstl::multimap<int, int> small;
+        for (int i = 0; i < n; ++i) {
+            small.emplace(i, -i);
+        }
+        auto small2 = serialize_round_trip(small);
+        EXPECT_TRUE(small2 == small);
+        EXPECT_TRUE(is_valid_rb_tree(small2));
+        small2.emplace(n / 2, 0);
+        EXPECT_EQ(small2.size(), n + 1);
+    }
+
+    tstl::unordered_map<std::string, int> um;
+    tstl::unordered_set<int> us;
+    for (int i = 0; i < 1000; ++i) {
+        um.emplace(std::to_string(i), i);
+        us.insert(i * 7);
+    }
+    auto um2 = serialize_round_trip(um);
+    EXPECT_EQ(um2.size(), 1000);
+    EXPECT_EQ(um2.at("123"), 123);
+    auto us2 = serialize_round_trip(us);
+    EXPECT_EQ(us2.size(), 1000);
+    EXPECT_EQ(us2.count(49), 1);
+}
+
+TEST(SerializeTest, Truncated) {
+    tstl::vector<int> vec(100, 1);
+    std::stringstream ss;
+    tstl::serialize(ss, vec);
+    std::string data = ss.str();
+    std::stringstream cut(data.substr(0, data.size() - 1));
+    EXPECT_THROW(tstl::deserialize(cut, vec), std::runtime_error);
+
+    tstl::multimap<int, std::string> mp;
+    mp.emplace(1, "one");
+    mp.emplace(2, "two");
+    std::stringstream ms;
+    tstl::serialize(ms, mp);
+    data = ms.str();
+    std::stringstream mcut(data.substr(0, data.size() - 2));
+    EXPECT_THROW(tstl::deserialize(mcut, mp), std::runtime_error);
+    EXPECT_TRUE(mp.empty());
+
+    // 键值乱序与不可信的元素个数
+    tstl::multimap<int, int> ints;
+    std::stringstream bad;
+    tstl::serialize(bad, tstl::vector<std::pair<int, int>>{{1, 0}, {3, 0}, {2, 0}});
+    EXPECT_THROW(tstl::deserialize(bad, ints), std::runtime_error);
+    EXPECT_TRUE(ints.empty());
+    std::stringstream huge;
+    tstl::serialize(huge, tstl::vector<std::pair<int, int>>{{1, 0}});
+    data = huge.str();
+    data[7] = '\x7f';
+    std::stringstream hcut(data);
+    EXPECT_THROW(tstl::deserialize(hcut, ints), std::runtime_error);
+
+    // 每种容器读到不可信的元素个数时都抛出 std::runtime_error，而不是先按它分配内存
+    std::string forged(8, '\0');
+    forged[5] = '\x01';
+    forged += std::string(16, 'x');
+    auto expect_rejected = [&forged](auto &&value) {
+        std::stringstream in(forged);
+        EXPECT_THROW(tstl::deserialize(in, value), std::runtime_error);
+    };
+    expect_rejected(std::string());
+    expect_rejected(tstl::vector<int>());
+    expect_rejected(tstl::vector<std::string>());
+    expect_rejected(tstl::deque<int>());
+    expect_rejected(tstl::deque<std::string>());
+    expect_rejected(tstl::list<int>());
+    expect_rejected(tstl::unordered_map<int, int>());
+    expect_rejected(tstl::unordered_set<int>());
+}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef TEST_TEST_SOA_VECTOR
+#define TEST_TEST_SOA_VECTOR
+
+#include "../src/soa_vector.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST(SoaVectorTest, All) {
+    tstl::soa_vector<int, double, std::string> soa;
+    EXPECT_TRUE(soa.empty());
+    std::vector<std::tuple<int, double, std::string>> expect;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 2 == 0) {
+            soa.emplace_back(i, i * 0.5, std::to_string(i));
+        } else {
+            soa.push_back(std::make_tuple(i, i * 0.5, std::to_string(i)));
+        }
+        expect.emplace_back(i, i * 0.5, std::to_string(i));
+    }
+    ASSERT_EQ(soa.size(), 1000);
+    EXPECT_GE(soa.capacity(), 1000);
+    EXPECT_EQ(std::get<2>(soa[123]), "123");
+    EXPECT_EQ(std::get<0>(soa.back()), 999);
+    EXPECT_THROW(soa.at(1000), std::out_of_range);
+
+    // 列视图连续存放
+    tstl::span<int> ids = soa.column<0>();
+    ASSERT_EQ(ids.size(), 1000);
+    EXPECT_EQ(&ids[999] - &ids[0], 999);
+    for (int &id : ids) {
+        id *= 2;
+    }
+    for (auto &row : expect) {
+        std::get<0>(row) *= 2;
+    }
+    const auto &csoa = soa;
+    tstl::span<const double> prices = csoa.column<1>();
+    EXPECT_EQ(prices[10], 5.0);
+
+    // 通过引用修改与结构化绑定
+    std::get<1>(soa[5]) = -1.0;
+    std::get<1>(expect[5]) = -1.0;
+    std::size_t n = 0;
+    for (auto [id, price, name] : soa) {
+        EXPECT_EQ(id, std::get<0>(expect[n]));
+        EXPECT_EQ(price, std::get<1>(expect[n]));
+        EXPECT_EQ(name, std::get<2>(expect[n]));
+        ++n;
+    }
+    EXPECT_EQ(n, 1000);
+
+    // erase
+    auto it = soa.erase(soa.begin() + 10);
+    expect.erase(expect.begin() + 10);
+    EXPECT_EQ(it.index(), 10);
+    soa.erase(soa.begin() + 100, soa.begin() + 200);
+    expect.erase(expect.begin() + 100, expect.begin() + 200);
+    soa.pop_back();
+    expect.pop_back();
+    ASSERT_EQ(soa.size(), expect.size());
+    for (std::size_t i = 0; i < expect.size(); ++i) {
+        ASSERT_EQ(decltype(soa)::value_type(soa[i]), expect[i]);
+    }
+
+    auto copy = soa;
+    EXPECT_TRUE(copy == soa);
+    std::get<2>(copy[0]) = "x";
+    EXPECT_TRUE(copy != soa);
+    soa.clear();
+    EXPECT_TRUE(soa.empty());
+    EXPECT_EQ(soa.column<2>().size(), 0);
+}
+
+TEST(SoaVectorTest, Sort) {
+    std::mt19937 gen(45);
+    tstl::soa_vector<int, int> soa;
+    std::vector<std::pair<int, int>> expect;
+    for (int i = 0; i < 5000; ++i) {
+        int key = static_cast<int>(gen() % 100);
+        soa.emplace_back(key, i);
+        expect.emplace_back(key, i);
+    }
+    soa.sort();
+    std::sort(expect.begin(), expect.end());
+    for (std::size_t i = 0; i < expect.size(); ++i) {
+        ASSERT_EQ(std::get<0>(soa[i]), expect[i].first);
+        ASSERT_EQ(std::get<1>(soa[i]), expect[i].second);
+    }
+
+    // 只按第二列降序排序，第一列随行移动
+    soa.sort_by<1>(std::greater<int>());
+    for (std::size_t i = 0; i < expect.size(); ++i) {
+        ASSERT_EQ(std::get<1>(soa[i]), 4999 - static_cast<int>(i));
+    }
+    auto row = std::find(expect.begin(), expect.end(), std::make_pair(std::get<0>(soa[7]), 4992));
+    EXPECT_TRUE(row != expect.end());
+
+    soa.sort([](const auto &a, const auto &b) { return std::get<1>(a) < std::get<1>(b); });
+    EXPECT_EQ(std::get<1>(soa.front()), 0);
+    EXPECT_EQ(std::get<1>(soa.back()), 4999);
+
+    tstl::soa_vector<int, std::string> sized(3);
+    EXPECT_EQ(std::get<1>(sized[2]), "");
+    sized.resize(5);
+    EXPECT_EQ(sized.column<0>().size(), 5);
+}
+
+// 复制时按计数抛出异常、移动可能抛出异常的元素
+struct soa_throwing {
+    static int copies_left;
+    int value;
+
+    soa_throwing(int v) : value(v) {
+    }
+    soa_throwing(const soa_throwing &other) : value(other.value) {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+    soa_throwing(soa_throwing &&other) : value(other.value) {
+    }
+    soa_throwing &operator=(const soa_throwing &) = default;
+    soa_throwing &operator=(soa_throwing &&) = default;
+};
+
+int soa_throwing::copies_left = -1;
+
+TEST(SoaVectorTest, Aliasing) {
+    tstl::soa_vector<std::string, int> v;
+    v.emplace_back(std::string(100, 'x'), 1);
+    for (int i = 0; i < 100; ++i) {
+        // 参数引用已有的行，扩容时不能先释放旧的列
+        v.emplace_back(std::get<0>(v[0]), std::get<1>(v.back()));
+    }
+    ASSERT_EQ(v.size(), 101);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        ASSERT_EQ(std::get<0>(v[i]), std::string(100, 'x'));
+        ASSERT_EQ(std::get<1>(v[i]), 1);
+    }
+
+    // 某一列扩容失败时，各列的容量与内容保持不变
+    tstl::soa_vector<std::string, soa_throwing> w;
+    w.reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        w.emplace_back(std::to_string(i), i);
+    }
+    soa_throwing::copies_left = 2;
+    EXPECT_THROW(w.reserve(100), std::runtime_error);
+    soa_throwing::copies_left = -1;
+    EXPECT_EQ(w.capacity(), 4);
+    EXPECT_EQ(w.column<0>().size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(std::get<0>(w[i]), std::to_string(i));
+        EXPECT_EQ(std::get<1>(w[i]).value, i);
+    }
+    w.reserve(100);
+    EXPECT_EQ(w.capacity(), 100);
+    EXPECT_EQ(std::get<0>(w[3]), "3");
+}
+
+#endif
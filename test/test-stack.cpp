@@ -6,6 +6,7 @@
 #include "../src/stack.hpp"
 #include "../src/list.hpp"
 #include "../src/algorithm.hpp"
+#include <string>
 
 template <class T>
 using container = tstl::vector<T, std::allocator<T>>;
@@ -77,4 +78,42 @@ TEST(StackTest, Swap) {
     EXPECT_EQ(dump(s2), c2);
 }
 
+TEST(StackTest, Compare) {
+    tstl::stack<int> s1({1, 2, 3});
+    tstl::stack<int> s2({1, 2, 4});
+    EXPECT_TRUE(s1 != s2);
+    EXPECT_TRUE(s1 < s2);
+    EXPECT_TRUE(s2 > s1);
+    EXPECT_TRUE(s1 <= s2);
+    EXPECT_FALSE(s1 >= s2);
+    EXPECT_TRUE(s1 <= s1);
+    EXPECT_TRUE(s1 >= s1);
+}
+
+TEST(StackTest, DefaultContainer) {
+    tstl::stack<std::string> s;
+    s.push("0");
+    const std::string *bottom = &s.top();
+    for (int i = 1; i < 5000; ++i) {
+        s.push(std::to_string(i));
+    }
+    int src[] = {1, 2, 3};
+    tstl::stack<int> ints;
+    ints.push_range(src, src + 3);
+    EXPECT_EQ(ints.top(), 3);
+    ints.pop_n(2);
+    EXPECT_EQ(ints.top(), 1);
+    s.pop_n(4999);
+    EXPECT_EQ(s.top(), "0");
+    EXPECT_EQ(&s.top(), bottom);
+
+    // 由容器移动构造，不复制元素
+    tstl::chunked_storage<std::string> c = {"a", "b"};
+    const std::string *top = &c.back();
+    tstl::stack<std::string> moved(std::move(c));
+    EXPECT_EQ(&moved.top(), top);
+    tstl::stack<std::string> alloc_moved(std::move(moved), std::allocator<std::string>());
+    EXPECT_EQ(&alloc_moved.top(), top);
+}
+
 #endif
@@ -0,0 +1,176 @@
+#ifndef TEST_TEST_UNORDERED_MAP
+#define TEST_TEST_UNORDERED_MAP
+
+#include "../src/unordered_map.hpp"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+template <class K, class V>
+using unordered_map = tstl::unordered_map<K, V>;
+
+TEST(UnorderedMapTest, All) {
+    unordered_map<std::string, int> mp = {{"a", 1}, {"b", 2}, {"a", 3}};
+    EXPECT_EQ(mp.size(), 2);
+    EXPECT_EQ(mp.at("a"), 1);
+    EXPECT_THROW(mp.at("z"), std::out_of_range);
+    mp["c"] = 4;
+    mp["a"] += 10;
+    EXPECT_EQ(mp["a"], 11);
+    EXPECT_EQ(mp.size(), 3);
+
+    EXPECT_FALSE(mp.insert({"b", 5}).second);
+    EXPECT_TRUE(mp.emplace("d", 6).second);
+    EXPECT_FALSE(mp.try_emplace("d", 7).second);
+    EXPECT_EQ(mp["d"], 6);
+    EXPECT_FALSE(mp.insert_or_assign("d", 8).second);
+    EXPECT_EQ(mp["d"], 8);
+    EXPECT_TRUE(mp.contains("c"));
+    EXPECT_EQ(mp.count("e"), 0);
+    EXPECT_TRUE(mp.find("e") == mp.end());
+
+    auto range = mp.equal_range("b");
+    EXPECT_EQ(range.first->second, 2);
+    EXPECT_TRUE(++range.first == range.second);
+
+    int sum = 0;
+    for (auto &kv : mp) {
+        sum += kv.second;
+    }
+    EXPECT_EQ(sum, 11 + 2 + 4 + 8);
+
+    unordered_map<std::string, int> copied(mp);
+    EXPECT_EQ(copied, mp);
+    EXPECT_EQ(mp.erase("a"), 1);
+    EXPECT_EQ(mp.erase("a"), 0);
+    EXPECT_NE(copied, mp);
+    auto it = mp.erase(mp.find("b"));
+    EXPECT_EQ(mp.size(), 2);
+    for (; it != mp.end(); ++it) {
+        EXPECT_NE(it->first, "b");
+    }
+
+    unordered_map<std::string, int> moved(std::move(copied));
+    EXPECT_TRUE(copied.empty());
+    EXPECT_TRUE(copied.begin() == copied.end());
+    EXPECT_EQ(moved.size(), 4);
+    tstl::swap(moved, copied);
+    EXPECT_EQ(copied.size(), 4);
+    copied.clear();
+    EXPECT_TRUE(copied.empty());
+    EXPECT_TRUE(copied.begin() == copied.end());
+    copied["x"] = 1;
+    EXPECT_EQ(copied.size(), 1);
+}
+
+TEST(UnorderedMapTest, RandomOperations) {
+    // 键值范围较小，插入与删除交替进行，产生大量墓碑与按原容量的重建
+    std::mt19937 gen(5);
+    unordered_map<int, int> mp;
+    std::unordered_map<int, int> expect;
+    for (int i = 0; i < 200000; ++i) {
+        int key = static_cast<int>(gen() % 5000);
+        switch (gen() % 4) {
+        case 0:
+        case 1:
+            mp[key] = i;
+            expect[key] = i;
+            break;
+        case 2:
+            EXPECT_EQ(mp.erase(key), expect.erase(key));
+            break;
+        default: {
+            auto it = mp.find(key);
+            auto sit = expect.find(key);
+            ASSERT_EQ(it == mp.end(), sit == expect.end());
+            if (sit != expect.end()) {
+                EXPECT_EQ(it->second, sit->second);
+            }
+        }
+        }
+    }
+    EXPECT_EQ(mp.size(), expect.size());
+    EXPECT_LE(mp.load_factor(), mp.max_load_factor());
+    std::size_t n = 0;
+    for (auto &kv : mp) {
+        EXPECT_EQ(expect.at(kv.first), kv.second);
+        ++n;
+    }
+    EXPECT_EQ(n, expect.size());
+
+    mp.reserve(100000);
+    EXPECT_GE(mp.bucket_count(), 100000);
+    auto buckets = mp.bucket_count();
+    for (int i = 0; i < 100000; ++i) {
+        mp[i] = i;
+    }
+    EXPECT_EQ(mp.bucket_count(), buckets);
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(mp.at(i), i);
+    }
+    for (int i = 0; i < 100000; i += 2) {
+        mp.erase(i);
+    }
+    mp.rehash(0);
+    EXPECT_EQ(mp.size(), 50000);
+    EXPECT_LT(mp.bucket_count(), buckets);
+    EXPECT_EQ(mp.count(1), 1);
+    EXPECT_EQ(mp.count(2), 0);
+}
+
+TEST(UnorderedMapTest, ThrowDuringRehash) {
+    // 扩容时元素只能复制，复制中途失败则哈希表保持原状
+    unordered_map<int, ThrowOnCopy> mp;
+    int n = 0;
+    while (n < 20 || mp.size() < mp.bucket_count() - mp.bucket_count() / 8) {
+        mp.try_emplace(n, n);
+        ++n;
+    }
+    auto buckets = mp.bucket_count();
+    ThrowOnCopy::copies = 0;
+    ThrowOnCopy::limit = 10;
+    EXPECT_THROW(mp.try_emplace(n, n), std::runtime_error);
+    ThrowOnCopy::limit = -1;
+    EXPECT_EQ(mp.size(), static_cast<std::size_t>(n));
+    EXPECT_EQ(mp.bucket_count(), buckets);
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(mp.at(i).v, i);
+    }
+    mp.try_emplace(n, n);
+    EXPECT_EQ(mp.at(n).v, n);
+}
+
+// 调用次数达到 limit 时抛出异常的哈希函数
+struct ThrowingHash {
+    static int calls;
+    static int limit;
+    std::size_t operator()(int key) const {
+        if (limit >= 0 && calls++ >= limit) {
+            throw std::runtime_error("ThrowingHash");
+        }
+        return std::hash<int>()(key);
+    }
+};
+int ThrowingHash::calls = 0;
+int ThrowingHash::limit = -1;
+
+TEST(UnorderedMapTest, ThrowingHashDuringRehash) {
+    // 哈希函数可能抛出异常时扩容复制元素，即使元素移动构造不抛出，原表的元素也不会被移走
+    tstl::unordered_map<int, std::string, ThrowingHash> mp;
+    int n = 0;
+    while (n < 20 || mp.size() < mp.bucket_count() - mp.bucket_count() / 8) {
+        mp.try_emplace(n, std::string(40, 'a' + n % 26));
+        ++n;
+    }
+    ThrowingHash::calls = 0;
+    ThrowingHash::limit = 10;
+    EXPECT_THROW(mp.try_emplace(n, "x"), std::runtime_error);
+    ThrowingHash::limit = -1;
+    EXPECT_EQ(mp.size(), static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        ASSERT_EQ(mp.at(i), std::string(40, 'a' + i % 26));
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TEST_TEST_UNORDERED_SET
+#define TEST_TEST_UNORDERED_SET
+
+#include "../src/unordered_set.hpp"
+#include <random>
+#include <set>
+#include <string>
+
+TEST(UnorderedSetTest, All) {
+    tstl::unordered_set<std::string> st = {"a", "b", "a"};
+    EXPECT_EQ(st.size(), 2);
+    EXPECT_TRUE(st.insert("c").second);
+    EXPECT_FALSE(st.emplace("c").second);
+    EXPECT_TRUE(st.contains("a"));
+    EXPECT_EQ(*st.find("b"), "b");
+    EXPECT_EQ(st.erase("a"), 1);
+    EXPECT_FALSE(st.contains("a"));
+
+    std::mt19937 gen(9);
+    tstl::unordered_set<unsigned> ust;
+    std::set<unsigned> expect;
+    for (int i = 0; i < 50000; ++i) {
+        unsigned key = gen() % 20000;
+        if (gen() % 3 == 0) {
+            EXPECT_EQ(ust.erase(key), expect.erase(key));
+        } else {
+            EXPECT_EQ(ust.insert(key).second, expect.insert(key).second);
+        }
+    }
+    EXPECT_EQ(ust.size(), expect.size());
+    std::set<unsigned> seen(ust.begin(), ust.end());
+    EXPECT_EQ(seen, expect);
+
+    tstl::unordered_set<unsigned> copied(ust);
+    EXPECT_EQ(copied, ust);
+    copied.erase(copied.begin(), copied.end());
+    EXPECT_TRUE(copied.empty());
+}
+
+#endif
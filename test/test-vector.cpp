@@ -173,6 +173,16 @@ TEST(VectorTest, Resize) {
     }
 }
 
+TEST(VectorTest, Reserve) {
+    vec<std::string> v = {"a", "b"};
+    v.reserve(100);
+    EXPECT_GE(v.capacity(), 100);
+    EXPECT_EQ(v.size(), 2);
+    EXPECT_EQ(v[1], "b");
+    v.reserve(1);
+    EXPECT_GE(v.capacity(), 100);
+}
+
 TEST(VectorTest, Swap) {
     vec<int> v1 = {1, 2, 3};
     vec<int> v2 = {4, 5};
@@ -183,4 +193,18 @@ TEST(VectorTest, Swap) {
     EXPECT_EQ(v2, expect_2);
 }
 
+TEST(VectorTest, MoveAndDestroy) {
+    auto counter = std::make_shared<int>(0);
+    {
+        vec<std::shared_ptr<int>> v1(3, counter);
+        EXPECT_EQ(counter.use_count(), 4);
+        vec<std::shared_ptr<int>> v2(std::move(v1));
+        EXPECT_TRUE(v1.empty());
+        EXPECT_EQ(v2.size(), 3);
+        EXPECT_EQ(counter.use_count(), 4);
+    }
+    // 析构时销毁全部元素
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
 #endif
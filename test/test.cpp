@@ -9,6 +9,28 @@
 #include "test-deque.cpp"
 #include "test-list.cpp"
 #include "test-multimap.cpp"
+#include "test-persistent-multimap.cpp"
+#include "test-grouped-multimap.cpp"
+#include "test-unordered-map.cpp"
+#include "test-unordered-set.cpp"
+#include "test-concurrent-hash-map.cpp"
+#include "test-monotonic-arena.cpp"
+#include "test-pool-allocator.cpp"
+#include "test-counting-allocator.cpp"
+#include "test-memory-resource.cpp"
+#include "test-mmap-allocator.cpp"
+#include "test-mapped-vector.cpp"
+#include "test-serialize.cpp"
+#include "test-external-sort.cpp"
+#include "test-packed-vector.cpp"
+#include "test-delta-vector.cpp"
+#include "test-soa-vector.cpp"
+#include "test-dynamic-bitset.cpp"
+#include "test-priority-queue.cpp"
+#include "test-pairing-heap.cpp"
+#include "test-queue.cpp"
+#include "test-ring-buffer.cpp"
+#include "test-chunked-storage.cpp"
 
 int main(int argc, char **argv) {
     printf("Running main() from %s\n", __FILE__);
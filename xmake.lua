@@ -8,4 +8,13 @@ target("test")
     add_files("test/test.cpp")
     add_cxxflags("-g", "-Wall", "-Wextra", "-Wshadow", "-fsanitize=address")
     add_ldflags("-fsanitize=address")
+    add_syslinks("pthread")
     add_packages("gtest")
+
+target("bench")
+    set_kind("binary")
+    set_default(false)
+    set_optimize("fastest")
+    add_headerfiles("src/**.hpp")
+    add_files("bench/bench.cpp")
+    add_syslinks("pthread")